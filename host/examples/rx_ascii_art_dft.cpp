@@ -8,6 +8,7 @@
 #include "ascii_art_dft.hpp" //implementation
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/utils/safe_main.hpp>
+#include <uhd/utils/spectrum_monitor.hpp>
 #include <uhd/utils/thread.hpp>
 #include <curses.h>
 #include <boost/format.hpp>
@@ -25,7 +26,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
 {
     // variables to be set by po
     std::string args, ant, subdev, ref;
-    size_t num_bins;
+    size_t num_bins, num_avgs;
     double rate, freq, gain, bw, frame_rate, step;
     float ref_lvl, dyn_rng;
     bool show_controls;
@@ -46,6 +47,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         // display parameters
         ("num-bins", po::value<size_t>(&num_bins)->default_value(512), "the number of bins in the DFT")
         ("frame-rate", po::value<double>(&frame_rate)->default_value(5), "frame rate of the display (fps)")
+        ("avg", po::value<size_t>(&num_avgs)->default_value(1), "the number of DFTs averaged per estimate")
         ("ref-lvl", po::value<float>(&ref_lvl)->default_value(0), "reference level for the display (dB)")
         ("dyn-rng", po::value<float>(&dyn_rng)->default_value(60), "dynamic range for the display (dB)")
         ("ref", po::value<std::string>(&ref)->default_value("internal"), "reference source (internal, external, mimo)")
@@ -171,6 +173,11 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     // allocate recv buffer and metatdata
     uhd::rx_metadata_t md;
     std::vector<std::complex<float>> buff(num_bins);
+
+    // all received samples are fed into the spectrum monitor, the display
+    // shows its latest estimate
+    uhd::spectrum_monitor::sptr monitor = uhd::spectrum_monitor::make(
+        num_bins, uhd::spectrum_monitor::WINDOW_BLACKMAN_HARRIS, num_avgs);
     //------------------------------------------------------------------
     //-- Initialize
     //------------------------------------------------------------------
@@ -183,7 +190,7 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     //------------------------------------------------------------------
     while (true) {
         // read a buffer's worth of samples every iteration
-        size_t num_rx_samps = rx_stream->recv(&buff.front(), buff.size(), md);
+        size_t num_rx_samps = monitor->recv(*rx_stream, &buff.front(), buff.size(), md);
         if (num_rx_samps != buff.size())
             continue;
 
@@ -191,12 +198,13 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
         if (high_resolution_clock::now() < next_refresh) {
             continue;
         }
+
+        // get the latest dft and create the ascii art frame
+        ascii_art_dft::log_pwr_dft_type lpdft(monitor->get_psd());
+        if (lpdft.empty())
+            continue;
         next_refresh = high_resolution_clock::now()
                        + std::chrono::microseconds(int64_t(1e6 / frame_rate));
-
-        // calculate the dft and create the ascii art frame
-        ascii_art_dft::log_pwr_dft_type lpdft(
-            ascii_art_dft::log_pwr_dft(&buff.front(), num_rx_samps));
         std::string frame = ascii_art_dft::dft_to_plot(lpdft,
             COLS,
             (show_controls ? LINES - 6 : LINES),
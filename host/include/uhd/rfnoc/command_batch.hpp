@@ -0,0 +1,135 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_RFNOC_COMMAND_BATCH_HPP
+#define INCLUDED_LIBUHD_RFNOC_COMMAND_BATCH_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/rfnoc/register_iface.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace uhd { namespace rfnoc {
+
+/*! A batch of timed register writes across one or more blocks
+ *
+ * Register writes to several blocks (e.g., a radio and a DDC) are collected
+ * in the batch, and then executed together at a single time. On commit(),
+ * the writes for every block are sent as back-to-back control packets, with
+ * only the first packet per block carrying the timestamp. Then, the batch
+ * waits for the completion of all writes at once. This avoids waiting for
+ * one round trip per register write, which is what limits, e.g., the hop
+ * rate when retuning at a time in the future.
+ *
+ * All register interfaces in a batch should belong to the same device,
+ * otherwise the writes are not aligned in time.
+ *
+ * ~~~{.cpp}
+ * uhd::rfnoc::command_batch batch(tune_time);
+ * batch.poke32(radio->regs(), radio_freq_addr, radio_freq_word);
+ * batch.poke32(ddc->regs(), ddc_freq_addr, ddc_freq_word);
+ * batch.commit();
+ * ~~~
+ *
+ * A command_batch holds references to the register interfaces it was given.
+ * The blocks must outlive the batch. This class is not thread-safe.
+ */
+class UHD_API command_batch
+{
+public:
+    /*! Create an empty batch
+     *
+     * \param time The time at which the writes in this batch are executed.
+     *             If ASAP, writes are executed as soon as they arrive.
+     */
+    command_batch(const uhd::time_spec_t& time = uhd::time_spec_t::ASAP);
+
+    //! Set the time at which the writes in this batch are executed
+    void set_time(const uhd::time_spec_t& time);
+
+    //! Return the time at which the writes in this batch are executed
+    uhd::time_spec_t get_time() const;
+
+    /*! Add a 32-bit register write to the batch
+     *
+     * \param regs The register interface of the block, e.g., block->regs()
+     * \param addr The byte address of the register to write to
+     * \param data New value of this register
+     */
+    void poke32(register_iface& regs, uint32_t addr, uint32_t data);
+
+    /*! Add a write of two consecutive 32-bit registers to the batch
+     *
+     * \param regs The register interface of the block, e.g., block->regs()
+     * \param addr The byte address of the lower 32-bit register
+     * \param data New value of the register(s)
+     */
+    void poke64(register_iface& regs, uint32_t addr, uint64_t data);
+
+    /*! Add multiple 32-bit register writes to the batch
+     *
+     * \param regs The register interface of the block, e.g., block->regs()
+     * \param addrs The byte addresses of the registers to write to
+     * \param data New values of these registers. The lengths of data and addr
+     *             must match.
+     * \throws uhd::value_error if lengths of data and addr don't match
+     */
+    void multi_poke32(register_iface& regs,
+        const std::vector<uint32_t>& addrs,
+        const std::vector<uint32_t>& data);
+
+    /*! Add writes to multiple consecutive 32-bit registers to the batch
+     *
+     * \param regs The register interface of the block, e.g., block->regs()
+     * \param first_addr The byte address of the first register to write
+     * \param data New values of these registers
+     */
+    void block_poke32(
+        register_iface& regs, uint32_t first_addr, const std::vector<uint32_t>& data);
+
+    //! Return the total number of register writes in this batch
+    size_t size() const;
+
+    //! Return true if this batch contains no writes
+    bool empty() const;
+
+    //! Remove all writes from this batch without sending them
+    void clear();
+
+    /*! Send all writes in this batch and clear it
+     *
+     * The writes for all blocks are sent first. If \p wait is true, this then
+     * waits until all writes were executed. When queuing several batches
+     * ahead of time (e.g., a hopping schedule), only the last commit() needs
+     * to wait; it also collects the completion status of earlier batches to
+     * the same blocks.
+     *
+     * \param wait Wait for the completion of all writes
+     * \throws op_failed if a transaction fails
+     * \throws op_timeout if no response is received
+     * \throws op_seqerr if a sequence error occurs
+     * \throws op_timeerr if a time error occurs (late command)
+     */
+    void commit(bool wait = true);
+
+private:
+    struct block_writes_t
+    {
+        register_iface* regs;
+        std::vector<uint32_t> addrs;
+        std::vector<uint32_t> data;
+    };
+
+    block_writes_t& _get_writes(register_iface& regs);
+
+    uhd::time_spec_t _time;
+    std::vector<block_writes_t> _writes;
+};
+
+}} /* namespace uhd::rfnoc */
+
+#endif /* INCLUDED_LIBUHD_RFNOC_COMMAND_BATCH_HPP */
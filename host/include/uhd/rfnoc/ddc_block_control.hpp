@@ -8,6 +8,7 @@
 #define INCLUDED_LIBUHD_DDC_BLOCK_CONTROL_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
 #include <uhd/types/ranges.hpp>
 #include <uhd/rfnoc/noc_block_base.hpp>
 #include <boost/optional.hpp>
@@ -118,6 +119,15 @@ public:
      */
     virtual double set_output_rate(const double rate, const size_t chan) = 0;
 
+    /*! Return the rate planner of this block
+     *
+     * The planner holds the precomputed register settings for every valid
+     * decimation. It can be used to compute the settings and actual values for
+     * many rate and frequency requests without changing the state of this
+     * block. Pass get_input_rate() as the DSP rate to plan().
+     */
+    virtual const dsp_rate_planner& get_rate_planner() const = 0;
+
     /**************************************************************************
      * Streaming-Related API Calls
      *************************************************************************/
@@ -0,0 +1,163 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_RFNOC_DSP_RATE_PLANNER_HPP
+#define INCLUDED_LIBUHD_RFNOC_DSP_RATE_PLANNER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/types/ranges.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace uhd { namespace rfnoc {
+
+/*! Rate and frequency planner for the DDC and DUC blocks
+ *
+ * The DDC and DUC blocks change the sampling rate using a chain of halfband
+ * filters followed by a CIC filter, and shift the signal using a CORDIC. This
+ * class precomputes, for every valid decimation (or interpolation), the
+ * register settings and the resulting gain correction. It can then map a
+ * (rate, frequency) request to the exact register values and the actual rate
+ * and frequency in constant time.
+ *
+ * A planner does not access any hardware, and it does not modify the state of
+ * a block. Applications that sweep through many settings can therefore use it
+ * to evaluate candidate settings without running the property resolution for
+ * each of them. The planner of a block is available through
+ * ddc_block_control::get_rate_planner() and
+ * duc_block_control::get_rate_planner().
+ *
+ * ~~~{.cpp}
+ * const auto& planner = ddc->get_rate_planner();
+ * const double input_rate = ddc->get_input_rate(chan);
+ * for (const double freq : freqs) {
+ *     auto plan = planner.plan(input_rate, rate, freq);
+ *     // plan.freq, plan.rate are the values the DDC would use
+ * }
+ * ~~~
+ */
+class UHD_API dsp_rate_planner
+{
+public:
+    //! The type of rate change performed by the DSP chain
+    enum rate_change_type_t {
+        //! Output rate = input rate / decimation (DDC)
+        DECIMATION,
+        //! Input rate = output rate * interpolation (DUC)
+        INTERPOLATION
+    };
+
+    //! Precomputed settings for one decimation or interpolation value
+    struct rate_setting_t
+    {
+        //! Decimation or interpolation
+        int rate_change = 1;
+        //! Number of enabled halfband filters
+        uint32_t num_halfbands = 0;
+        //! Rate change performed by the CIC
+        uint32_t cic_rate_change = 1;
+        //! Value of the decimation/interpolation register
+        uint32_t rate_word = 1;
+        //! Value of the IQ scaling register
+        uint32_t scale_word = 0;
+        //! Gain of the DSP chain (CIC and CORDIC) before scaling correction
+        double dsp_gain = 1.0;
+        //! Gain remaining after the scaling correction, corrected on the host
+        double residual_scaling = 1.0;
+    };
+
+    //! A complete plan for a (rate, frequency) request
+    struct plan_t
+    {
+        //! Settings for the coerced decimation or interpolation
+        rate_setting_t setting;
+        //! Actual sampling rate on the host side of the block
+        double rate = 0.0;
+        //! Actual frequency shift of the CORDIC
+        double freq = 0.0;
+        //! Value of the frequency register
+        uint32_t freq_word = 0;
+    };
+
+    /*! Precompute the settings for a DDC or DUC
+     *
+     * \param type DECIMATION for a DDC, INTERPOLATION for a DUC
+     * \param num_halfbands The number of halfband filters in the block
+     * \param cic_max_rate_change The maximum decimation or interpolation of the
+     *                            CIC filter
+     */
+    dsp_rate_planner(const rate_change_type_t type,
+        const size_t num_halfbands,
+        const size_t cic_max_rate_change);
+
+    //! Return the type of rate change this planner was created for
+    rate_change_type_t get_type() const;
+
+    /*! Return all valid decimation or interpolation values
+     *
+     * The values are in ascending order.
+     */
+    const uhd::meta_range_t& get_valid_rate_changes() const;
+
+    /*! Return the closest valid decimation or interpolation value
+     *
+     * If the requested value lies halfway between two valid values, the
+     * smaller one is chosen.
+     *
+     * \throws uhd::value_error if \p requested_rate_change is negative
+     */
+    int coerce_rate_change(const double requested_rate_change) const;
+
+    /*! Return the precomputed settings for a decimation or interpolation value
+     *
+     * \throws uhd::value_error if \p rate_change is not a valid value
+     */
+    const rate_setting_t& get_rate_setting(const int rate_change) const;
+
+    /*! Plan a sampling rate and a frequency shift
+     *
+     * \param dsp_rate The sampling rate on the radio side of the block, i.e.,
+     *                 the input rate of a DDC, or the output rate of a DUC.
+     *                 This is the rate the CORDIC runs at.
+     * \param requested_rate The requested rate on the host side of the block,
+     *                       i.e., the output rate of a DDC, or the input rate
+     *                       of a DUC. The decimation or interpolation is
+     *                       coerced to match this rate as closely as possible.
+     * \param requested_freq The requested frequency shift in Hz
+     * \returns The register settings and the actual values for this request
+     * \throws uhd::value_error if either rate is not positive
+     */
+    plan_t plan(const double dsp_rate,
+        const double requested_rate,
+        const double requested_freq) const;
+
+    /*! Plan a frequency shift at a given decimation or interpolation
+     *
+     * \param dsp_rate The sampling rate on the radio side of the block
+     * \param rate_change A valid decimation or interpolation value
+     * \param requested_freq The requested frequency shift in Hz
+     * \throws uhd::value_error if \p rate_change is not a valid value
+     */
+    plan_t plan_rate_change(
+        const double dsp_rate, const int rate_change, const double requested_freq) const;
+
+private:
+    const rate_change_type_t _type;
+
+    //! The valid rate changes, as returned by get_valid_rate_changes()
+    uhd::meta_range_t _valid_rate_changes;
+
+    //! Settings per rate change. Invalid rate changes have rate_change == 0.
+    std::vector<rate_setting_t> _settings;
+
+    //! For every integer k, the closest valid rate change <= k and >= k
+    std::vector<int> _lower_valid;
+    std::vector<int> _upper_valid;
+};
+
+}} /* namespace uhd::rfnoc */
+
+#endif /* INCLUDED_LIBUHD_RFNOC_DSP_RATE_PLANNER_HPP */
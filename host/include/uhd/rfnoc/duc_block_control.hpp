@@ -8,6 +8,7 @@
 #define INCLUDED_LIBUHD_DUC_BLOCK_CONTROL_HPP
 
 #include <uhd/config.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
 #include <uhd/rfnoc/noc_block_base.hpp>
 #include <uhd/types/ranges.hpp>
 #include <uhd/types/time_spec.hpp>
@@ -116,6 +117,15 @@ public:
      * \returns the coerced sampling rate at this block's output
      */
     virtual double set_input_rate(const double rate, const size_t chan) = 0;
+
+    /*! Return the rate planner of this block
+     *
+     * The planner holds the precomputed register settings for every valid
+     * interpolation. It can be used to compute the settings and actual values for
+     * many rate and frequency requests without changing the state of this
+     * block. Pass get_output_rate() as the DSP rate to plan().
+     */
+    virtual const dsp_rate_planner& get_rate_planner() const = 0;
 };
 
 }} // namespace uhd::rfnoc
@@ -314,6 +314,55 @@ public:
      */
     virtual uint16_t get_port_num() const = 0;
 
+    /*! Send multiple 32-bit register writes as one batch of commands, without
+     * waiting for them to complete.
+     *
+     * The first write is executed at \p time, all following writes are
+     * executed back-to-back right after it. Unlike multi_poke32() with an
+     * ACK, this call returns as soon as the commands are sent. Call
+     * wait_for_batch() to wait for their completion. This makes it possible
+     * to send batches to multiple register interfaces (i.e., blocks) first,
+     * and then wait for all of them at once (see uhd::rfnoc::command_batch).
+     *
+     * Other transactions may be issued on this register interface (also from
+     * other threads) before wait_for_batch() is called. Batches are tracked
+     * per thread: wait_for_batch() only waits for the batches sent by the
+     * thread that calls it. A batch that is never waited for does not use up
+     * any resources once it was executed, but its first error is kept and
+     * reported by the next call to wait_for_batch().
+     *
+     * The default implementation calls multi_poke32() with an ACK, i.e., it
+     * returns only once the batch was executed.
+     *
+     * \param addrs The byte addresses of the registers to write to
+     *              (each truncated to 20 bits).
+     * \param data New values of these registers. The lengths of data and addr
+     *             must match.
+     * \param time The time at which the first transaction should be executed.
+     *
+     * \throws uhd::value_error if lengths of data and addr don't match
+     */
+    virtual void batch_poke32(const std::vector<uint32_t>& addrs,
+        const std::vector<uint32_t>& data,
+        uhd::time_spec_t time = uhd::time_spec_t::ASAP)
+    {
+        multi_poke32(addrs, data, time, true);
+    }
+
+    /*! Wait for all writes the calling thread sent with batch_poke32() to
+     * complete
+     *
+     * If the calling thread has no batch outstanding, this returns
+     * immediately. Errors of batches sent by other threads are not reported
+     * here.
+     *
+     * \throws op_failed if a transaction fails
+     * \throws op_timeout if no response is received
+     * \throws op_seqerr if a sequence error occurs
+     * \throws op_timeerr if a time error occurs (late command)
+     */
+    virtual void wait_for_batch() {}
+
 }; // class register_iface
 
 }} /* namespace uhd::rfnoc */
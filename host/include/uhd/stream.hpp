@@ -16,6 +16,7 @@
 #include <uhd/utils/noncopyable.hpp>
 #include <memory>
 #include <boost/utility.hpp>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -129,6 +130,16 @@ struct UHD_API stream_args_t
      * Users should specify this option to request smaller than default
      * packets, probably with the intention of reducing packet latency.
      *
+     * - tx_pacing: spreads the TX packets of a burst out in time instead of
+     * sending them as fast as flow control allows. The value is the pacing rate
+     * relative to the sample rate, e.g., 1.1 sends at 110% of the sample rate.
+     * This avoids line-rate bursts that can overflow the buffers of switches
+     * when several devices share a link. Only supported by RFNoC devices.
+     *
+     * - tx_pacing_burst: the number of packets that may be sent back-to-back
+     * when pacing with tx_pacing. Defaults to 1. The achieved gaps between
+     * the packets are reported by tx_streamer::get_pacing_stats().
+     *
      * - noclear: Used by tx_dsp_core_200 and rx_dsp_core_200
      *
      * The following are not implemented, but are listed for conceptual purposes:
@@ -162,6 +173,23 @@ struct UHD_API stream_args_t
     std::vector<size_t> channels;
 };
 
+/*!
+ * A read-only view of the samples of one received packet, lent to the caller
+ * by rx_streamer::recv_view().
+ */
+struct rx_view_t
+{
+    //! Pointers to the samples, one per channel. They remain valid until the
+    //! view is returned with rx_streamer::release_view().
+    std::vector<const void*> buffs;
+
+    //! Number of samples (per channel) the pointers refer to
+    size_t num_samps = 0;
+
+    //! Identifies the lent buffers within the streamer
+    size_t handle = 0;
+};
+
 /*!
  * The RX streamer is the host interface to receiving samples.
  * It represents the layer between the samples on the host
@@ -226,6 +254,119 @@ public:
         const double timeout  = 0.1,
         const bool one_packet = false) = 0;
 
+    /*!
+     * Receive multiple packets at once.
+     *
+     * This is a variant of recv() which amortizes the per-call overhead over
+     * many packets, which is useful at high packet rates (small spp). Up to
+     * \p max_num_packets complete packets are written back-to-back into the
+     * buffers. For every packet, one entry of \p packet_infos is filled with
+     * the sample offset, number of samples, time and burst/vector flags of
+     * that packet.
+     *
+     * Only the first packet is waited for (using \p timeout). After that,
+     * only packets that are already available are returned. Reception stops
+     * after a packet with an end-of-burst flag, or when the buffers don't have
+     * space for another full packet (see get_max_num_samps()).
+     *
+     * The metadata is filled just like for recv() with one_packet set to true,
+     * i.e., it describes the first packet. If an error occurs after at least
+     * one packet was received, the error is returned on the next call.
+     *
+     * The default implementation calls recv() once with one_packet set to
+     * true and returns at most one packet. Streamer implementations may
+     * override it to process packets in batches.
+     *
+     * \param buffs a vector of writable memory to fill with samples
+     * \param nsamps_per_buff the size of each buffer in number of samples
+     * \param metadata data to fill describing the first packet, or the error
+     * \param packet_infos array of at least \p max_num_packets elements
+     * \param max_num_packets maximum number of packets to receive
+     * \param timeout the timeout in seconds to wait for the first packet
+     * \return the number of packets received (entries of \p packet_infos
+     *         written), or 0 on error
+     */
+    virtual size_t recv_bulk(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        rx_packet_info_t* packet_infos,
+        const size_t max_num_packets,
+        const double timeout = 0.1);
+
+    /*!
+     * Returns whether this streamer supports recv_view(). Streamers can lend
+     * out their receive buffers only when the host format matches the
+     * over-the-wire format, i.e., when no conversion is required.
+     */
+    virtual bool supports_recv_view(void) const;
+
+    /*!
+     * Receive one packet without copying its samples.
+     *
+     * Instead of converting samples into caller buffers like recv(), the
+     * streamer lends the caller read-only pointers to the samples inside its
+     * receive buffers. The view must be returned with release_view() once the
+     * samples have been consumed. Several views may be held at once, and they
+     * may be released in any order.
+     *
+     * Buffers that are lent out are not available to receive new packets, and
+     * their space is not credited back to the device until they are released.
+     * Holding on to too many views therefore stalls the stream and eventually
+     * causes overruns.
+     *
+     * The metadata is filled like for recv() with one_packet set to true. If
+     * a previous call to recv() left part of a packet unread, the rest of that
+     * packet is lent out.
+     *
+     * Like recv(), this call is not thread-safe. release_view() must not be
+     * called concurrently with receive calls on the same streamer.
+     *
+     * \param view returns the sample pointers and the number of samples
+     * \param metadata data to fill describing the packet
+     * \param timeout the timeout in seconds to wait for a packet
+     * \return the number of samples per channel in the view, or 0 on error
+     * \throws uhd::not_implemented_error if supports_recv_view() is false
+     */
+    virtual size_t recv_view(
+        rx_view_t& view, rx_metadata_t& metadata, const double timeout = 0.1);
+
+    /*!
+     * Return a view obtained from recv_view() to the streamer.
+     *
+     * \param view the view to return. Its pointers are invalid afterwards.
+     * \throws uhd::value_error if the view is not currently lent out
+     */
+    virtual void release_view(rx_view_t& view);
+
+    /*!
+     * Get a receive handle for a single channel of this streamer.
+     *
+     * Normally, the channels of a streamer are received in lockstep: every
+     * call to recv() returns the same number of samples for all channels, and
+     * a channel without data stalls all others. If the streamer was created
+     * with the stream arg `independent_channels=1`, the channels are not aligned.
+     * Instead, every channel is received through its own single-channel
+     * handle, which has its own buffers, flow control, and metadata. Handles of
+     * different channels may be used concurrently from different threads, but
+     * like any streamer, a single handle must not be used by several threads
+     * at once. The receive calls of the streamer itself are not available in
+     * this mode.
+     *
+     * Calling issue_stream_cmd() on a handle only affects its channel. An
+     * overrun stops all channels, and streaming is restarted once every
+     * channel has read the samples that were buffered before the overrun.
+     *
+     * The handle may be kept after this streamer is destroyed, but it can no
+     * longer be controlled: issue_stream_cmd() then throws a
+     * uhd::runtime_error.
+     *
+     * \param chan the channel index within this streamer
+     * \return a single-channel streamer for the channel
+     * \throws uhd::not_implemented_error if the streamer was not created with
+     *         independent channels
+     */
+    virtual rx_streamer::sptr get_channel_streamer(const size_t chan);
+
     /*!
      * Issue a stream command to the usrp device.
      * This tells the usrp to send samples into the host.
@@ -238,6 +379,36 @@ public:
      * \param stream_cmd the stream command to issue
      */
     virtual void issue_stream_cmd(const stream_cmd_t& stream_cmd) = 0;
+
+    //! Flow control statistics, summed over all channels of a streamer
+    struct flow_control_stats_t
+    {
+        //! Number of flow control responses sent to the device
+        uint64_t num_resps_sent = 0;
+        //! Number of times a due response was held back for lack of a send buffer
+        uint64_t num_resps_deferred = 0;
+        //! Number of bytes received
+        uint64_t num_bytes_received = 0;
+
+        //! Returns the number of responses sent per megabyte (1e6 bytes) received
+        double get_resps_per_mb() const
+        {
+            return num_bytes_received == 0
+                       ? 0.0
+                       : double(num_resps_sent) * 1e6 / double(num_bytes_received);
+        }
+    };
+
+    /*!
+     * Get the statistics of the flow control responses this streamer sent to
+     * the device. They show the effect of the fc_resp_batch_ratio and
+     * fc_resp_min_interval_us transport args. The values may be read while
+     * another thread is receiving.
+     *
+     * \throws uhd::not_implemented_error if the streamer does not report flow
+     *         control statistics
+     */
+    virtual flow_control_stats_t get_flow_control_stats(void) const;
 };
 
 /*!
@@ -302,6 +473,76 @@ public:
      */
     virtual bool recv_async_msg(
         async_metadata_t& async_metadata, double timeout = 0.1) = 0;
+
+    //! Callback for asynchronous messages from this TX stream
+    typedef std::function<void(const async_metadata_t&)> async_msg_callback_t;
+
+    /*!
+     * Deliver asynchronous messages from this TX stream to a callback.
+     *
+     * While a callback is registered, messages are passed to it as soon as
+     * they arrive, instead of being queued for recv_async_msg(). The callback
+     * is called from a UHD-internal thread, so it must be thread-safe and
+     * return quickly. It must not call set_async_msg_callback().
+     *
+     * \param callback the callback, or an empty function to queue messages for
+     *                 recv_async_msg() again
+     * \throws uhd::not_implemented_error if the streamer does not support
+     *         callbacks
+     */
+    virtual void set_async_msg_callback(const async_msg_callback_t& callback);
+
+    /*!
+     * Get a file descriptor that becomes readable when asynchronous messages
+     * are queued.
+     *
+     * This allows waiting for messages in an application's own event loop
+     * (e.g., with epoll()) instead of polling recv_async_msg(). The descriptor
+     * is a Linux eventfd: Reading 8 bytes from it returns the number of
+     * messages queued since the last read and makes it non-readable again.
+     * Messages that were already queued when the descriptor was first
+     * requested are counted as one, so it is readable right away. The
+     * messages themselves are then retrieved with recv_async_msg() and a zero
+     * timeout. The descriptor is owned by the streamer and must not be closed.
+     *
+     * \return the file descriptor
+     * \throws uhd::not_implemented_error if the streamer or the platform does
+     *         not support it
+     */
+    virtual int get_async_msg_fd(void);
+
+    /*!
+     * Get the number of asynchronous messages that were dropped because the
+     * queue for recv_async_msg() was full. When the queue is full, the oldest
+     * message is dropped.
+     */
+    virtual size_t get_num_dropped_async_msgs(void) const;
+
+    //! Statistics of the gaps between consecutive packets of paced bursts
+    struct pacing_stats_t
+    {
+        //! The number of gaps that were measured
+        size_t num_gaps = 0;
+        //! Smallest gap in seconds
+        double min_gap = 0.0;
+        //! Largest gap in seconds
+        double max_gap = 0.0;
+        //! Average gap in seconds
+        double avg_gap = 0.0;
+        //! Average gap in seconds that the pacing rate asked for
+        double avg_target_gap = 0.0;
+    };
+
+    /*!
+     * Get the statistics of the packet gaps achieved with the tx_pacing
+     * stream argument. The gaps between bursts are not counted. All values
+     * are zero if pacing is disabled. This may be called while another
+     * thread sends.
+     *
+     * \throws uhd::not_implemented_error if the streamer does not support
+     *         pacing
+     */
+    virtual pacing_stats_t get_pacing_stats(void) const;
 };
 
 } // namespace uhd
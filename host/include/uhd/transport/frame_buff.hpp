@@ -56,12 +56,52 @@ public:
         _packet_size = size;
     }
 
+    /*!
+     * Attaches caller-owned memory that is sent directly after the first
+     * packet_size() bytes of the frame buffer. This lets a send link gather a
+     * packet from a header in the frame buffer and a payload that lives
+     * elsewhere, without copying the payload. Only links that report
+     * supports_send_gather() accept frame buffers with an attached payload.
+     *
+     * \param payload Pointer to the payload, or nullptr to detach it
+     * \param size Size of the payload in bytes
+     */
+    void set_gather_payload(const void* payload, size_t size)
+    {
+        _gather_payload      = payload;
+        _gather_payload_size = size;
+    }
+
+    /*!
+     * Returns the payload attached with set_gather_payload()
+     * \return pointer to the attached payload, or nullptr if none
+     */
+    const void* gather_payload() const
+    {
+        return _gather_payload;
+    }
+
+    /*!
+     * Returns the size of the payload attached with set_gather_payload()
+     * \return the size of the attached payload in bytes
+     */
+    size_t gather_payload_size() const
+    {
+        return _gather_payload_size;
+    }
+
 protected:
     /*! Pointer to data of current frame */
     void* _data = nullptr;
 
     /*! Size of packet in current frame */
     size_t _packet_size = 0;
+
+    /*! Caller-owned payload sent after the packet in the current frame */
+    const void* _gather_payload = nullptr;
+
+    /*! Size of the caller-owned payload */
+    size_t _gather_payload_size = 0;
 };
 
 }} // namespace uhd::transport
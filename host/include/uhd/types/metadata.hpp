@@ -155,6 +155,34 @@ struct UHD_API rx_metadata_t
     std::string strerror(void) const;
 };
 
+/*!
+ * Compact per-packet RX metadata.
+ *
+ * An array of these is filled by rx_streamer::recv_bulk(), one entry for every
+ * packet that was received. All entries refer to the same set of receive
+ * buffers; the offset field locates the samples of a packet within them.
+ */
+struct rx_packet_info_t
+{
+    //! Offset (in samples) of the first sample of this packet in the buffers
+    size_t offset = 0;
+
+    //! Number of samples (per channel) contained in this packet
+    size_t num_samps = 0;
+
+    //! Has time specification?
+    bool has_time_spec = false;
+
+    //! Time of the first sample of this packet
+    time_spec_t time_spec;
+
+    //! This packet was the last packet of a burst
+    bool end_of_burst = false;
+
+    //! This packet was the last packet of a vector
+    bool end_of_vector = false;
+};
+
 /*!
  * TX metadata structure for describing received IF data.
  * Includes time specification, and start and stop burst flags.
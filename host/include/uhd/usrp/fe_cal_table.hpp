@@ -0,0 +1,111 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_USRP_FE_CAL_TABLE_HPP
+#define INCLUDED_UHD_USRP_FE_CAL_TABLE_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <complex>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace uhd { namespace usrp {
+
+/*! Frontend calibration table
+ *
+ * Holds the IQ balance or DC offset corrections of a daughterboard frontend,
+ * as measured by the uhd_cal_* utilities at a number of LO frequencies.
+ * Corrections for other LO frequencies are linearly interpolated, and below
+ * the first (above the last) calibration point, the correction of that point
+ * is used.
+ *
+ * Tables are stored in a compact binary format (.bin files), which is loaded
+ * by memory-mapping the file. Besides the calibration points, the file holds a
+ * lookup table which maps uniformly spaced frequency buckets to the
+ * calibration points, so get_correction() takes constant time regardless of
+ * the number of calibration points. The legacy CSV files can still be loaded,
+ * and converted with uhd_cal_import.
+ *
+ * A table is immutable after it was created, so it may be used from any
+ * number of threads at once.
+ */
+class UHD_API fe_cal_table : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<fe_cal_table> sptr;
+
+    //! One calibration point
+    struct point_t
+    {
+        //! LO frequency in Hz
+        double lo_freq;
+        //! Real part of the correction
+        double corr_real;
+        //! Imaginary part of the correction
+        double corr_imag;
+    };
+
+    virtual ~fe_cal_table(void);
+
+    /*! Create a table from a list of calibration points
+     *
+     * \param points The calibration points, in any order
+     * \param serial The serial of the daughterboard
+     * \param timestamp The time of the calibration (seconds since the epoch)
+     * \throws uhd::value_error if \p points is empty
+     */
+    static sptr make(const std::vector<point_t>& points,
+        const std::string& serial = "",
+        const int64_t timestamp   = 0);
+
+    /*! Parse a table from a legacy calibration CSV file
+     *
+     * \throws uhd::value_error if the file does not contain any calibration
+     *         points
+     */
+    static sptr make_from_csv(std::istream& csv);
+
+    /*! Load a table from a file
+     *
+     * Files ending in .csv are parsed as legacy CSV files, all other files are
+     * memory-mapped as binary files.
+     *
+     * \throws uhd::runtime_error if the file can't be read or is invalid
+     */
+    static sptr load(const std::string& path);
+
+    /*! Return the correction for an LO frequency
+     *
+     * \param lo_freq The actual LO frequency in Hz
+     */
+    virtual std::complex<double> get_correction(const double lo_freq) const = 0;
+
+    //! Return the calibration points, sorted by LO frequency
+    virtual std::vector<point_t> get_points(void) const = 0;
+
+    //! Return the serial of the calibrated daughterboard
+    virtual std::string get_serial(void) const = 0;
+
+    //! Return the time of the calibration (seconds since the epoch)
+    virtual int64_t get_timestamp(void) const = 0;
+
+    /*! Write the table to a binary file
+     *
+     * An existing file is replaced rather than overwritten, so tables that
+     * other processes loaded from it stay valid.
+     *
+     * \throws uhd::runtime_error if the file can't be written
+     */
+    virtual void save(const std::string& path) const = 0;
+};
+
+}} // namespace uhd::usrp
+
+#endif /* INCLUDED_UHD_USRP_FE_CAL_TABLE_HPP */
@@ -0,0 +1,158 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_RX_CAPTURE_RING_HPP
+#define INCLUDED_UHD_UTILS_RX_CAPTURE_RING_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace uhd {
+
+/*! Pre-trigger capture of received samples into a ring buffer
+ *
+ * The capture ring continuously receives from an rx_streamer into a ring
+ * buffer per channel, which holds the most recent get_capacity() samples.
+ * The ring is indexed by the timestamps of the received packets, so a time
+ * window can be looked up when a trigger occurs, including samples from
+ * before the trigger. trigger() exports such a window, either to a callback
+ * or to files.
+ *
+ * The export runs in a thread of its own, so reception continues while the
+ * window is exported. The window is frozen from the trigger on: New samples
+ * never overwrite it. If the ring runs full with the window still being
+ * exported, new samples are dropped instead (see get_num_dropped_samps()),
+ * and the ring indexes the gap by the timestamps of the packets that follow.
+ * Windows may reach into the future; the export then waits for the samples to
+ * arrive. If no samples arrive for one second, the export ends early.
+ *
+ * Memory: The ring takes get_num_channels() * get_capacity() samples of the
+ * CPU format, e.g., 4 GB for 10 s of two channels at 50 Msps in sc16. On
+ * Linux, the memory is backed by huge pages if possible (explicit huge pages,
+ * or else transparent huge pages), to reduce TLB misses.
+ *
+ * The capture ring owns the streamer. The application issues the stream
+ * command, but must not call recv() itself.
+ */
+class UHD_API rx_capture_ring : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<rx_capture_ring> sptr;
+
+    /*! Callback to which the samples of an exported window are passed
+     *
+     * A window is passed in chunks of contiguous samples of one channel. The
+     * chunks of each channel are passed in order. A gap in the samples
+     * (e.g., due to an overflow) is visible from the timestamps of the chunks.
+     *
+     * \param chan The channel of the samples
+     * \param buff The samples, in the CPU format of the streamer
+     * \param nsamps The number of samples
+     * \param time_spec The time of the first sample
+     */
+    typedef std::function<void(const size_t chan,
+        const void* buff,
+        const size_t nsamps,
+        const time_spec_t& time_spec)>
+        export_callback_t;
+
+    //! Result of an export
+    struct export_result_t
+    {
+        //! The time of the first exported sample
+        time_spec_t start_time;
+        //! The number of samples exported per channel
+        size_t nsamps = 0;
+        //! False if the callback threw an exception, the files could not be
+        //  written, or the samples of the window stopped arriving
+        bool success = false;
+    };
+
+    virtual ~rx_capture_ring(void);
+
+    /*! Create a capture ring, which starts receiving right away
+     *
+     * \param rx_stream The streamer from which to receive
+     * \param cpu_format The CPU format of \p rx_stream (e.g., "sc16")
+     * \param samp_rate The sample rate of the stream, which is used to look
+     *                  up timestamps
+     * \param capacity The size of the ring in samples per channel
+     * \throws uhd::value_error if \p samp_rate or \p capacity are invalid
+     * \throws uhd::os_error if the memory could not be allocated
+     */
+    static sptr make(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double samp_rate,
+        const size_t capacity);
+
+    //! Return the number of channels
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! Return the size of the ring in samples per channel
+    virtual size_t get_capacity(void) const = 0;
+
+    //! Return true if the ring is backed by explicit huge pages. Transparent
+    //  huge pages are requested otherwise, but can't be checked for.
+    virtual bool uses_huge_pages(void) const = 0;
+
+    //! Return the number of samples per channel received so far
+    virtual size_t get_num_recvd_samps(void) const = 0;
+
+    /*! Return the number of samples per channel which were dropped because
+     *  the ring was full of a frozen window
+     */
+    virtual size_t get_num_dropped_samps(void) const = 0;
+
+    /*! Export a time window to a callback
+     *
+     * Only one window can be exported at a time. The parts of the window that
+     * are no longer in the ring (or that were never received) are skipped.
+     *
+     * \param start_time The time of the first sample of the window
+     * \param nsamps The number of samples of the window per channel, at most
+     *               get_capacity()
+     * \param callback The callback which receives the samples, called from the
+     *                 export thread
+     * \return false if an export is already in progress, true otherwise
+     * \throws uhd::value_error if \p nsamps is invalid
+     */
+    virtual bool trigger(const time_spec_t& start_time,
+        const size_t nsamps,
+        const export_callback_t& callback) = 0;
+
+    /*! Export a time window to files
+     *
+     * The samples of every channel are written to a file of their own, in the
+     * format of rx_samples_to_file. With a single channel, the file is \p path,
+     * with more channels, the files are \p path followed by a period and the
+     * channel number.
+     *
+     * \return false if an export is already in progress, true otherwise
+     * \throws uhd::value_error if \p nsamps is invalid
+     */
+    virtual bool trigger(
+        const time_spec_t& start_time, const size_t nsamps, const std::string& path) = 0;
+
+    /*! Wait until the current export is done
+     *
+     * \param timeout The maximum time to wait in seconds
+     * \return true if no export is in progress, false on timeout
+     */
+    virtual bool wait_for_export(const double timeout) = 0;
+
+    //! Return the result of the last completed export
+    virtual export_result_t get_last_export(void) const = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_RX_CAPTURE_RING_HPP */
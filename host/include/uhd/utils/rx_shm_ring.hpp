@@ -0,0 +1,159 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_RX_SHM_RING_HPP
+#define INCLUDED_UHD_UTILS_RX_SHM_RING_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace uhd {
+
+/*! Publish received samples to other processes through shared memory
+ *
+ * Only one process can own a streamer. To process the samples of one radio in
+ * several processes, the publisher receives from the streamer once and writes
+ * the samples into a ring in shared memory. Any number of local processes can
+ * attach to the ring with an rx_shm_consumer, and read the samples at their own
+ * pace. The samples are not copied or re-packetized on the way.
+ *
+ * The ring is a memfd, which holds the most recent get_capacity() samples per
+ * channel, along with the timestamps of the received packets. Consumers map it
+ * read-only, and never write to it: The publisher doesn't wait for consumers,
+ * and every consumer detects on its own when it fell behind so far that the
+ * samples it was about to read were overwritten (see
+ * rx_shm_consumer::get_num_overruns()). Consumers wait for new samples on a
+ * futex in the ring, so they don't have to poll.
+ *
+ * Consumers attach by the path returned by get_path(), which refers to the
+ * memfd through the /proc file system of the publishing process. Alternatively,
+ * the file descriptor returned by get_fd() can be passed to the consumer
+ * process (e.g., over a Unix domain socket), which then attaches by the path
+ * /proc/self/fd/<fd>.
+ *
+ * Samples only enter the ring through the receive thread of the publisher.
+ * The application still starts and stops streaming with issue_stream_cmd(),
+ * but any samples it receives on its own are missing from the ring.
+ *
+ * This is only available on Linux.
+ */
+class UHD_API rx_shm_publisher : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<rx_shm_publisher> sptr;
+
+    virtual ~rx_shm_publisher(void);
+
+    /*! Create a publisher, which starts receiving right away
+     *
+     * \param rx_stream The streamer from which to receive
+     * \param cpu_format The CPU format of \p rx_stream (e.g., "sc16")
+     * \param samp_rate The sample rate of the stream, which is passed on to the
+     *                  consumers
+     * \param capacity The size of the ring in samples per channel
+     * \throws uhd::value_error if \p samp_rate or \p capacity are invalid
+     * \throws uhd::os_error if the shared memory could not be created
+     * \throws uhd::not_implemented_error if not on Linux
+     */
+    static sptr make(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double samp_rate,
+        const size_t capacity);
+
+    //! Return the path by which consumers attach to the ring
+    virtual std::string get_path(void) const = 0;
+
+    //! Return the file descriptor of the ring. It is valid for the lifetime of
+    //  the publisher.
+    virtual int get_fd(void) const = 0;
+
+    //! Return the number of channels
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! Return the size of the ring in samples per channel
+    virtual size_t get_capacity(void) const = 0;
+
+    //! Return the number of samples per channel published so far
+    virtual uint64_t get_num_recvd_samps(void) const = 0;
+};
+
+/*! Read samples from a ring of an rx_shm_publisher, possibly in another process
+ *
+ * Every consumer reads all samples which are published after it attached,
+ * independently of the other consumers.
+ */
+class UHD_API rx_shm_consumer : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<rx_shm_consumer> sptr;
+
+    virtual ~rx_shm_consumer(void);
+
+    /*! Attach to a ring
+     *
+     * \param path The path of the ring, see rx_shm_publisher::get_path()
+     * \throws uhd::os_error if the ring could not be opened
+     * \throws uhd::value_error if \p path is not a ring of an rx_shm_publisher
+     * \throws uhd::not_implemented_error if not on Linux
+     */
+    static sptr make(const std::string& path);
+
+    //! Return the number of channels
+    virtual size_t get_num_channels(void) const = 0;
+
+    //! Return the size of the ring in samples per channel
+    virtual size_t get_capacity(void) const = 0;
+
+    //! Return the CPU format of the samples
+    virtual std::string get_cpu_format(void) const = 0;
+
+    //! Return the sample rate of the stream
+    virtual double get_samp_rate(void) const = 0;
+
+    /*! Read samples
+     *
+     * This works like uhd::rx_streamer::recv(), but waits only if no samples
+     * are available: It returns the samples which were published so far, up to
+     * \p nsamps_per_buff. The samples of one call are contiguous in time, i.e.,
+     * a call stops short before a gap.
+     *
+     * The metadata reports these errors:
+     * - ERROR_CODE_TIMEOUT: No samples were published within \p timeout, or
+     *   the publisher is gone (see is_closed()).
+     * - ERROR_CODE_OVERFLOW: Samples are missing before the next call. Either
+     *   the streamer of the publisher overflowed, or this consumer fell behind
+     *   and samples were overwritten. In the latter case, the consumer skips
+     *   ahead to the newer half of the ring, and get_num_overruns() is
+     *   incremented.
+     *
+     * \param buffs The buffers for the samples of every channel
+     * \param nsamps_per_buff The maximum number of samples per channel
+     * \param metadata The metadata of the samples
+     * \param timeout The maximum time to wait for samples in seconds
+     * \return The number of samples per channel read
+     */
+    virtual size_t recv(const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout = 0.1) = 0;
+
+    //! Return the number of times this consumer fell behind the publisher
+    virtual size_t get_num_overruns(void) const = 0;
+
+    //! Return true if the publisher is gone. The samples in the ring can still
+    //  be read.
+    virtual bool is_closed(void) const = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_RX_SHM_RING_HPP */
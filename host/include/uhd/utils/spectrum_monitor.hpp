@@ -0,0 +1,145 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_SPECTRUM_MONITOR_HPP
+#define INCLUDED_UHD_UTILS_SPECTRUM_MONITOR_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace uhd {
+
+/*! Streaming power spectral density (PSD) estimator
+ *
+ * A spectrum monitor is fed with a continuous stream of samples, either by
+ * calling push() with the samples received from an rx_streamer, or by using
+ * recv() in place of rx_streamer::recv(). The samples are split into
+ * consecutive frames of get_fft_size() samples. Every frame is windowed and
+ * transformed, and the power spectra of get_num_averages() frames are
+ * averaged into one PSD estimate. The latest estimate can be read with
+ * get_psd() at any time, e.g., by a display thread.
+ *
+ * The FFT is an iterative radix-4 FFT with precomputed twiddle factors, so
+ * a single core can compute the PSD of the full sample stream at typical
+ * streaming rates.
+ *
+ * The PSD is returned in dBFS, assuming samples in the range [-1.0, 1.0]. The
+ * bins are in FFT order, i.e., the first bin is DC, and the second half of
+ * the bins holds the negative frequencies.
+ *
+ * Thread safety: push() and recv() must not be called concurrently. get_psd()
+ * and get_num_psds() may be called from any thread.
+ */
+class UHD_API spectrum_monitor : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<spectrum_monitor> sptr;
+
+    //! Window functions which are applied to each frame before the FFT
+    enum window_type_t {
+        WINDOW_RECTANGULAR,
+        WINDOW_HANN,
+        WINDOW_HAMMING,
+        WINDOW_BLACKMAN_HARRIS
+    };
+
+    virtual ~spectrum_monitor(void);
+
+    /*! Create a new spectrum monitor
+     *
+     * \param fft_size The number of bins of the PSD. Must be a power of two,
+     *                 and at least 2.
+     * \param window The window function
+     * \param num_averages The number of frames averaged into one PSD estimate
+     * \throws uhd::value_error if \p fft_size or \p num_averages are invalid
+     */
+    static sptr make(const size_t fft_size,
+        const window_type_t window = WINDOW_BLACKMAN_HARRIS,
+        const size_t num_averages  = 1);
+
+    //! Return the number of bins of the PSD
+    virtual size_t get_fft_size(void) const = 0;
+
+    //! Return the number of frames that are averaged into one PSD estimate
+    virtual size_t get_num_averages(void) const = 0;
+
+    /*! Set the number of frames that are averaged into one PSD estimate
+     *
+     * This discards the frames that were accumulated so far.
+     *
+     * \throws uhd::value_error if \p num_averages is zero
+     */
+    virtual void set_num_averages(const size_t num_averages) = 0;
+
+    /*! Feed samples into the spectrum monitor
+     *
+     * Samples that don't make up a complete frame are stored, and are
+     * combined with the samples of the next call.
+     *
+     * \param samps The samples
+     * \param nsamps The number of samples
+     */
+    virtual void push(const std::complex<float>* samps, const size_t nsamps) = 0;
+
+    /*! Receive samples from \p rx_stream and feed them into the monitor
+     *
+     * This is a tap on an rx_streamer: It calls rx_stream.recv() with the
+     * given arguments, and passes the samples of channel \p chan to push().
+     * The streamer must use the fc32 CPU format.
+     *
+     * \param rx_stream The streamer to receive from
+     * \param buffs The receive buffers, see rx_streamer::recv()
+     * \param nsamps_per_buff The size of each buffer in number of samples
+     * \param metadata The receive metadata, see rx_streamer::recv()
+     * \param timeout The timeout in seconds to wait for a packet
+     * \param chan The channel that is fed into the monitor
+     * \return the number of samples received
+     */
+    virtual size_t recv(rx_streamer& rx_stream,
+        const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout = 0.1,
+        const size_t chan    = 0) = 0;
+
+    /*! Return the latest PSD estimate
+     *
+     * \return The PSD in dBFS, get_fft_size() bins in FFT order. If no
+     *         estimate is available yet, an empty vector is returned.
+     */
+    virtual std::vector<float> get_psd(void) const = 0;
+
+    /*! Return the number of PSD estimates computed so far
+     *
+     * This can be used to check if get_psd() would return a new estimate.
+     */
+    virtual size_t get_num_psds(void) const = 0;
+
+    /*! Discard all stored samples and frames, and the latest PSD estimate
+     */
+    virtual void reset(void) = 0;
+
+    /*! Compute the PSD of a single frame
+     *
+     * This does not use or modify the state of the monitor, but it uses the
+     * same FFT and window. It must not be called concurrently with push() or
+     * recv().
+     *
+     * \param samps get_fft_size() samples
+     * \param log_pwr Array of get_fft_size() bins for the PSD in dBFS
+     */
+    virtual void compute_psd(const std::complex<float>* samps, float* log_pwr) = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_SPECTRUM_MONITOR_HPP */
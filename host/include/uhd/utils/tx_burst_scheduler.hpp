@@ -0,0 +1,170 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_UTILS_TX_BURST_SCHEDULER_HPP
+#define INCLUDED_UHD_UTILS_TX_BURST_SCHEDULER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/time_spec.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace uhd {
+
+/*! Time-ordered scheduler for timed TX bursts
+ *
+ * Applications which transmit timed bursts (e.g., for TDD) normally have to
+ * call tx_streamer::send() for every burst themselves, early enough for the
+ * burst to reach the device before its start time, but not so early that the
+ * device buffer fills up with bursts of the far future. The burst scheduler
+ * takes over this job: Bursts are handed to schedule() at any time ahead,
+ * together with their start time. Their samples are copied into buffers of
+ * the scheduler, and the bursts are kept in a queue ordered by start time.
+ * A thread of the scheduler then sends each burst, with start of burst, time
+ * spec, and end of burst set, once the device time is within the lead time
+ * of the burst's start time. While the streamer has no flow control credit,
+ * send() blocks, so the bursts are fed just as fast as the device consumes
+ * them.
+ *
+ * The scheduler does not query the device time for every burst. Instead, it
+ * extrapolates the device time that was passed to make() or
+ * set_device_time() using the host clock. Calling set_device_time() now and
+ * then keeps the clocks from drifting apart.
+ *
+ * A burst is late if the device time is past its start time when it is sent.
+ * Late bursts are not sent, because the device would discard them anyway, but
+ * reported as dropped. For every burst, a burst_info_t is passed to the burst
+ * callback, and the statistics over all bursts are available from
+ * get_stats().
+ *
+ * Thread safety: All methods may be called from any thread. The tx_streamer
+ * must not be used by the application while the scheduler exists.
+ */
+class UHD_API tx_burst_scheduler : uhd::noncopyable
+{
+public:
+    typedef std::shared_ptr<tx_burst_scheduler> sptr;
+
+    //! Report of a single burst
+    struct burst_info_t
+    {
+        //! The value returned by schedule() for this burst
+        size_t burst_id = 0;
+        //! The start time of the burst
+        time_spec_t time_spec;
+        //! The number of samples of the burst
+        size_t nsamps = 0;
+        //! The number of samples accepted by the streamer
+        size_t nsamps_sent = 0;
+        //! The time in seconds between handing the burst to the streamer and
+        //  its start time. Negative if the burst was late.
+        double lead_time = 0.0;
+        //! True if the burst was not sent, because it was late or send()
+        //  threw an exception
+        bool dropped = false;
+    };
+
+    //! Statistics over all bursts since the last call to reset_stats()
+    struct stats_t
+    {
+        //! The number of bursts that were sent
+        size_t num_sent = 0;
+        //! The number of bursts that were dropped
+        size_t num_dropped = 0;
+        //! The smallest lead time of a sent burst in seconds
+        double min_lead_time = 0.0;
+        //! The largest lead time of a sent burst in seconds
+        double max_lead_time = 0.0;
+        //! The average lead time of the sent bursts in seconds
+        double avg_lead_time = 0.0;
+    };
+
+    //! Callback which receives the report of every burst
+    typedef std::function<void(const burst_info_t&)> burst_callback_t;
+
+    virtual ~tx_burst_scheduler(void);
+
+    /*! Create a new burst scheduler, which starts sending right away
+     *
+     * \param tx_stream The streamer to which the bursts are sent
+     * \param cpu_format The CPU format of \p tx_stream (e.g., "fc32"), which
+     *                   determines the size of the samples
+     * \param device_time The current time of the device, e.g., from
+     *                    multi_usrp::get_time_now()
+     * \param lead_time The time in seconds by which bursts are sent ahead of
+     *                  their start time
+     * \throws uhd::value_error if \p lead_time is not positive
+     */
+    static sptr make(tx_streamer::sptr tx_stream,
+        const std::string& cpu_format,
+        const time_spec_t& device_time,
+        const double lead_time = 0.01);
+
+    /*! Update the current time of the device
+     *
+     * This corrects the drift between the host clock and the device clock, or
+     * follows a change of the device time.
+     */
+    virtual void set_device_time(const time_spec_t& device_time) = 0;
+
+    //! Return the lead time in seconds
+    virtual double get_lead_time(void) const = 0;
+
+    /*! Set the time in seconds by which bursts are sent ahead of their start
+     *  time
+     *
+     * \throws uhd::value_error if \p lead_time is not positive
+     */
+    virtual void set_lead_time(const double lead_time) = 0;
+
+    /*! Schedule a burst for transmission
+     *
+     * The samples are copied, so the buffers may be reused right away. Bursts
+     * may be scheduled in any order, they are sent in the order of their start
+     * times. Bursts with the same start time are sent in the order in which
+     * they were scheduled.
+     *
+     * \param buffs One buffer per channel of the streamer
+     * \param nsamps The number of samples per buffer, must not be zero
+     * \param time_spec The start time of the burst
+     * \return the ID of the burst, which identifies it in the burst reports
+     * \throws uhd::value_error if \p buffs or \p nsamps are invalid
+     */
+    virtual size_t schedule(const tx_streamer::buffs_type& buffs,
+        const size_t nsamps,
+        const time_spec_t& time_spec) = 0;
+
+    //! Return the number of bursts which were scheduled, but not sent yet
+    virtual size_t get_num_pending(void) const = 0;
+
+    /*! Wait until all scheduled bursts were sent
+     *
+     * \param timeout The maximum time to wait in seconds
+     * \return true if all bursts were sent, false on timeout
+     */
+    virtual bool wait_idle(const double timeout) = 0;
+
+    /*! Set the callback which receives the report of every burst
+     *
+     * The callback is called from the thread of the scheduler, so it should
+     * return quickly to not delay the following bursts.
+     */
+    virtual void set_burst_callback(const burst_callback_t& callback) = 0;
+
+    //! Return the statistics over all bursts since the last reset
+    virtual stats_t get_stats(void) const = 0;
+
+    //! Reset the statistics
+    virtual void reset_stats(void) = 0;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHD_UTILS_TX_BURST_SCHEDULER_HPP */
@@ -0,0 +1,277 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_CONVERT_INLINE_CONVERTER_HPP
+#define INCLUDED_LIBUHD_CONVERT_INLINE_CONVERTER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <stdint.h>
+#include <complex>
+#include <cstring>
+#include <typeinfo>
+#ifdef __SSE2__
+#    include <emmintrin.h>
+#endif
+
+namespace uhd { namespace convert {
+
+namespace detail {
+
+#ifdef __SSE2__
+//! Priority of the SSE2 converters in lib/convert (PRIORITY_SIMD)
+static const priority_type PRIORITY_SSE2 = 3;
+
+//! Convert 4 samples at a time, as many as fit into nsamps, starting at i
+template <bool aligned>
+UHD_FORCE_INLINE void chdr_sc16_to_fc32_sse2(const std::complex<int16_t>* input,
+    std::complex<float>* output,
+    size_t& i,
+    const size_t nsamps,
+    const __m128 scalar)
+{
+    const __m128i zeroi = _mm_setzero_si128();
+    for (; i + 3 < nsamps; i += 4) {
+        const __m128i tmpi =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+        // Unpack the values into the upper 16 bits, the scalar compensates for
+        // the shift
+        const __m128i tmpilo = _mm_unpacklo_epi16(zeroi, tmpi);
+        const __m128i tmpihi = _mm_unpackhi_epi16(zeroi, tmpi);
+
+        const __m128 tmplo = _mm_mul_ps(_mm_cvtepi32_ps(tmpilo), scalar);
+        const __m128 tmphi = _mm_mul_ps(_mm_cvtepi32_ps(tmpihi), scalar);
+
+        float* out = reinterpret_cast<float*>(output + i);
+        if (aligned) {
+            _mm_store_ps(out + 0, tmplo);
+            _mm_store_ps(out + 4, tmphi);
+        } else {
+            _mm_storeu_ps(out + 0, tmplo);
+            _mm_storeu_ps(out + 4, tmphi);
+        }
+    }
+}
+
+//! Convert 4 samples at a time, as many as fit into nsamps, starting at i
+template <bool aligned>
+UHD_FORCE_INLINE void fc32_to_chdr_sc16_sse2(const std::complex<float>* input,
+    std::complex<int16_t>* output,
+    size_t& i,
+    const size_t nsamps,
+    const __m128 scalar)
+{
+    for (; i + 3 < nsamps; i += 4) {
+        const float* in = reinterpret_cast<const float*>(input + i);
+        const __m128 tmplo = aligned ? _mm_load_ps(in + 0) : _mm_loadu_ps(in + 0);
+        const __m128 tmphi = aligned ? _mm_load_ps(in + 4) : _mm_loadu_ps(in + 4);
+
+        // Convert with rounding, and saturate when packing to 16 bits
+        const __m128i tmpilo = _mm_cvtps_epi32(_mm_mul_ps(tmplo, scalar));
+        const __m128i tmpihi = _mm_cvtps_epi32(_mm_mul_ps(tmphi, scalar));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+            _mm_packs_epi32(tmpilo, tmpihi));
+    }
+}
+#endif
+
+} // namespace detail
+
+/*!
+ * Convert CHDR sc16 samples to fc32
+ *
+ * This is the conversion of the sc16_chdr -> fc32 converter, and produces the
+ * same results regardless of which converter is selected.
+ */
+UHD_FORCE_INLINE void chdr_sc16_to_fc32(const std::complex<int16_t>* input,
+    std::complex<float>* output,
+    const size_t nsamps,
+    const float scale_factor)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128 scalar = _mm_set_ps1(scale_factor / (1 << 16));
+    // Dispatch according to the alignment of the output for the fastest stores
+    switch (size_t(output) & 0xf) {
+        case 0x0:
+            detail::chdr_sc16_to_fc32_sse2<true>(input, output, i, nsamps, scalar);
+            break;
+        case 0x8:
+            // Convert the first sample to align the remainder to 16 bytes
+            if (nsamps > 0) {
+                output[0] = std::complex<float>(float(input[0].real()) * scale_factor,
+                    float(input[0].imag()) * scale_factor);
+                i++;
+            }
+            detail::chdr_sc16_to_fc32_sse2<true>(input, output, i, nsamps, scalar);
+            break;
+        default:
+            detail::chdr_sc16_to_fc32_sse2<false>(input, output, i, nsamps, scalar);
+    }
+#endif
+    for (; i < nsamps; i++) {
+        output[i] = std::complex<float>(float(input[i].real()) * scale_factor,
+            float(input[i].imag()) * scale_factor);
+    }
+}
+
+#ifdef __SSE2__
+/*!
+ * Convert fc32 samples to CHDR sc16
+ *
+ * This is the conversion of the SSE2 fc32 -> sc16_chdr converter. The bulk of
+ * the samples is rounded to the nearest integer and saturated, the remainder
+ * is truncated.
+ */
+UHD_FORCE_INLINE void fc32_to_chdr_sc16(const std::complex<float>* input,
+    std::complex<int16_t>* output,
+    const size_t nsamps,
+    const float scale_factor)
+{
+    size_t i            = 0;
+    const __m128 scalar = _mm_set_ps1(scale_factor);
+    // Dispatch according to the alignment of the input for the fastest loads
+    switch (size_t(input) & 0xf) {
+        case 0x0:
+            detail::fc32_to_chdr_sc16_sse2<true>(input, output, i, nsamps, scalar);
+            break;
+        case 0x8:
+            // Convert the first sample to align the remainder to 16 bytes
+            if (nsamps > 0) {
+                output[0] =
+                    std::complex<int16_t>(int16_t(input[0].real() * scale_factor),
+                        int16_t(input[0].imag() * scale_factor));
+                i++;
+            }
+            detail::fc32_to_chdr_sc16_sse2<true>(input, output, i, nsamps, scalar);
+            break;
+        default:
+            detail::fc32_to_chdr_sc16_sse2<false>(input, output, i, nsamps, scalar);
+    }
+    for (; i < nsamps; i++) {
+        output[i] = std::complex<int16_t>(int16_t(input[i].real() * scale_factor),
+            int16_t(input[i].imag() * scale_factor));
+    }
+}
+#endif
+
+/*!
+ * Converter for the per-packet conversions of the streamers
+ *
+ * The streamers convert every packet separately. With small packets, the
+ * virtual call into the converter and the construction of its buffer vectors
+ * take up a noticeable part of the time spent per packet. For the most common
+ * CHDR conversions, this class calls the conversion directly, so it can be
+ * inlined into the streamer. These are:
+ *
+ * - Conversions between a CHDR format and the same host format, which are
+ *   copies
+ * - sc16_chdr -> fc32
+ * - fc32 -> sc16_chdr (only if the SSE2 converter is available)
+ *
+ * All other conversions use the converter from the converter registry. The
+ * same applies if a converter with a higher priority than the built-in one was
+ * registered for a conversion, so that custom converters are always used.
+ */
+class inline_converter
+{
+public:
+    inline_converter(const id_type& id)
+        : _converter(get_converter(id)()), _kind(_get_kind(id, _converter))
+    {
+        if (_kind == kind_t::COPY) {
+            _bytes_per_item = get_bytes_per_item(id.input_format);
+        }
+    }
+
+    //! Set the scale factor (used in floating point conversions)
+    void set_scalar(const double scalar)
+    {
+        _converter->set_scalar(scalar);
+        _scale_factor = float(scalar);
+    }
+
+    //! Convert num items from in to out
+    UHD_FORCE_INLINE void conv(const void* in, void* out, const size_t num)
+    {
+        switch (_kind) {
+            case kind_t::COPY:
+                std::memcpy(out, in, num * _bytes_per_item);
+                break;
+            case kind_t::SC16_CHDR_TO_FC32:
+                chdr_sc16_to_fc32(static_cast<const std::complex<int16_t>*>(in),
+                    static_cast<std::complex<float>*>(out),
+                    num,
+                    _scale_factor);
+                break;
+#ifdef __SSE2__
+            case kind_t::FC32_TO_SC16_CHDR:
+                fc32_to_chdr_sc16(static_cast<const std::complex<float>*>(in),
+                    static_cast<std::complex<int16_t>*>(out),
+                    num,
+                    _scale_factor);
+                break;
+#endif
+            default:
+                _converter->conv(in, out, num);
+        }
+    }
+
+private:
+    enum class kind_t { GENERIC, COPY, SC16_CHDR_TO_FC32, FC32_TO_SC16_CHDR };
+
+    //! Return true if the given converter is the one registered with prio
+    static bool _is_registered(
+        const id_type& id, const converter::sptr& conv, const priority_type prio)
+    {
+        try {
+            const converter::sptr builtin = get_converter(id, prio)();
+            return typeid(*conv) == typeid(*builtin);
+        } catch (const uhd::key_error&) {
+            return false;
+        }
+    }
+
+    static kind_t _get_kind(const id_type& id, const converter::sptr& conv)
+    {
+        if (id.num_inputs != 1 || id.num_outputs != 1) {
+            return kind_t::GENERIC;
+        }
+        // The CHDR -> host copies are generated with PRIORITY_GENERAL
+        if ((id.input_format == id.output_format + "_chdr"
+                || id.output_format == id.input_format + "_chdr")
+            && _is_registered(id, conv, 0)) {
+            return kind_t::COPY;
+        }
+#ifdef __SSE2__
+        if (id.input_format == "sc16_chdr" && id.output_format == "fc32"
+            && _is_registered(id, conv, detail::PRIORITY_SSE2)) {
+            return kind_t::SC16_CHDR_TO_FC32;
+        }
+        if (id.input_format == "fc32" && id.output_format == "sc16_chdr"
+            && _is_registered(id, conv, detail::PRIORITY_SSE2)) {
+            return kind_t::FC32_TO_SC16_CHDR;
+        }
+#else
+        if (id.input_format == "sc16_chdr" && id.output_format == "fc32"
+            && _is_registered(id, conv, 0)) {
+            return kind_t::SC16_CHDR_TO_FC32;
+        }
+#endif
+        return kind_t::GENERIC;
+    }
+
+    converter::sptr _converter;
+    kind_t _kind;
+    size_t _bytes_per_item = 0;
+    float _scale_factor    = 1.0;
+};
+
+}} // namespace uhd::convert
+
+#endif /* INCLUDED_LIBUHD_CONVERT_INLINE_CONVERTER_HPP */
@@ -0,0 +1,203 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_RFNOC_CHDR_CAPTURE_ANALYZER_HPP
+#define INCLUDED_UHDLIB_RFNOC_CHDR_CAPTURE_ANALYZER_HPP
+
+#include <uhd/types/endianness.hpp>
+#include <uhd/utils/noncopyable.hpp>
+#include <uhdlib/rfnoc/rfnoc_common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace uhd { namespace rfnoc { namespace chdr {
+
+/*! Read-only view of a pcap capture file
+ *
+ * The file is memory-mapped, so packets are never copied out of the page
+ * cache, and a capture can be processed by multiple threads at once. Both the
+ * microsecond and the nanosecond pcap formats, in either byte order, are
+ * supported. The link type must be Ethernet or Linux cooked capture (which is
+ * what "tcpdump -i any" produces).
+ */
+class pcap_file : uhd::noncopyable
+{
+public:
+    //! A UDP datagram from the capture
+    struct udp_record_t
+    {
+        //! Capture time in seconds
+        double time;
+        //! Pointer to the UDP payload, inside the memory-mapped file
+        const uint8_t* data;
+        //! Number of bytes of the UDP payload in the capture
+        size_t size;
+    };
+
+    /*!
+     * \param filename Path to the pcap file
+     * \throws uhd::runtime_error if the file can't be mapped or is not a pcap
+     *         file with a supported link type
+     */
+    pcap_file(const std::string& filename);
+    ~pcap_file();
+
+    //! Return the number of records (frames) in the capture
+    size_t get_num_records() const
+    {
+        return _num_records;
+    }
+
+    /*! Return all IPv4/UDP datagrams with a given source or destination port
+     *
+     * This only walks the record headers, which is fast even for large files.
+     * Fragmented IP packets are skipped.
+     *
+     * \param udp_port The UDP port, or 0 for all ports
+     */
+    std::vector<udp_record_t> get_udp_records(const uint16_t udp_port = 0) const;
+
+private:
+    void _unmap();
+
+    int _fd              = -1;
+    const uint8_t* _base = nullptr;
+    size_t _size         = 0;
+    bool _swapped        = false;
+    bool _nanosecond     = false;
+    uint32_t _linktype   = 0;
+    size_t _num_records  = 0;
+};
+
+//! Arguments for analyze_capture()
+struct capture_analyzer_args_t
+{
+    //! CHDR width of the captured link
+    chdr_w_t chdr_w = CHDR_W_64;
+    //! Byte order of the captured link. UDP links use big-endian.
+    endianness_t endianness = ENDIANNESS_BIG;
+    //! Number of worker threads, or 0 to use one per CPU
+    size_t num_threads = 0;
+    //! Size of a sample in bytes, or 0 to disable timestamp continuity checks
+    size_t bytes_per_item = 4;
+    //! Tick rate of the timestamps in Hz, or 0 if unknown
+    double tick_rate = 0.0;
+    //! Length of the intervals for the throughput histogram in seconds
+    double throughput_interval = 1e-3;
+};
+
+//! Running statistics of a quantity (Welford's algorithm)
+struct running_stats_t
+{
+    size_t count = 0;
+    double mean  = 0.0;
+    double m2    = 0.0;
+    double min   = std::numeric_limits<double>::max();
+    double max   = std::numeric_limits<double>::lowest();
+
+    void add(const double value);
+
+    //! Return the standard deviation, or 0 if there are fewer than two values
+    double get_stddev() const;
+};
+
+//! One stream status from a stream endpoint, for the flow control timeline
+struct fc_sample_t
+{
+    //! Capture time in seconds
+    double time;
+    //! Buffer capacity of the endpoint in bytes
+    uint64_t capacity_bytes;
+    //! Number of bytes the endpoint has consumed
+    uint64_t xfer_count_bytes;
+    //! Number of bytes sent to the endpoint, as seen in the capture
+    uint64_t sent_bytes;
+    //! Free buffer space at the endpoint: capacity - (sent - consumed)
+    int64_t credits_bytes;
+};
+
+/*! Statistics of the traffic to and from one stream endpoint
+ *
+ * A stream is identified by the EPID of the endpoint that receives its data.
+ * It includes the data and stream command packets addressed to that endpoint,
+ * and the stream status packets it sends back. Control and management packets
+ * are counted for the endpoint they are addressed to.
+ */
+struct stream_stats_t
+{
+    sep_id_t epid = 0;
+
+    //! \name Packet counts
+    //! \{
+    size_t num_data_pkts = 0;
+    size_t num_strs_pkts = 0;
+    size_t num_strc_pkts = 0;
+    size_t num_ctrl_pkts = 0;
+    size_t num_mgmt_pkts = 0;
+    //! Packets where the capture holds fewer bytes than the CHDR length
+    size_t num_truncated_pkts = 0;
+    //! \}
+
+    //! Sum of the CHDR lengths of all data packets
+    uint64_t data_bytes = 0;
+    //! Sum of the payload sizes of all data packets
+    uint64_t payload_bytes = 0;
+    //! Capture time of the first and the last data packet
+    double first_time = 0.0;
+    double last_time  = 0.0;
+
+    //! \name Sequence numbers of the data packets
+    //! \{
+    //! Number of times the sequence number jumped ahead
+    size_t num_seq_gaps = 0;
+    //! Number of packets that were skipped by these jumps
+    uint64_t num_lost_pkts = 0;
+    //! Number of packets that were repeated or arrived out of order
+    size_t num_seq_reorders = 0;
+    //! \}
+
+    //! \name Timestamps of the data packets
+    //! \{
+    //! Number of packets whose timestamp does not follow the previous packet
+    // (only within bursts, and only if the item size is known)
+    size_t num_ts_discontinuities = 0;
+    //! Time between consecutive data packets, in seconds
+    running_stats_t interarrival;
+    //! Capture time minus timestamp, in seconds (only if the tick rate is known).
+    // The spread of this quantity is the timestamp jitter.
+    running_stats_t ts_offset;
+    //! \}
+
+    //! \name Flow control
+    //! \{
+    //! Stream status packets with an error status
+    size_t num_strs_errors = 0;
+    std::vector<fc_sample_t> fc_timeline;
+    //! \}
+
+    //! Data bytes per throughput interval, starting at first_time
+    std::vector<uint64_t> throughput_bytes;
+};
+
+/*! Analyze the CHDR traffic in a capture
+ *
+ * The datagrams are sharded across worker threads by stream endpoint, so every
+ * stream is analyzed by exactly one thread, in capture order.
+ *
+ * \param records The datagrams that contain CHDR packets, one packet each
+ * \param args The analyzer arguments
+ * \return The statistics for every stream, sorted by EPID
+ */
+std::vector<stream_stats_t> analyze_capture(
+    const std::vector<pcap_file::udp_record_t>& records,
+    const capture_analyzer_args_t& args);
+
+}}} // namespace uhd::rfnoc::chdr
+
+#endif /* INCLUDED_UHDLIB_RFNOC_CHDR_CAPTURE_ANALYZER_HPP */
@@ -151,6 +151,36 @@ public:
         return reinterpret_cast<data_t*>(get_payload_ptr());
     }
 
+    //! Deserialize the payload of this packet into a specific payload type
+    //
+    // The byte order is dispatched once per packet rather than once per word,
+    // which avoids the indirect calls of the conv_to_host() function object.
+    template <typename payload_t>
+    inline void deserialize_payload(payload_t& payload) const
+    {
+        const uint64_t* buff   = get_payload_const_ptr_as<uint64_t>();
+        const size_t num_elems = get_payload_size() / sizeof(uint64_t);
+        if (get_byte_order() == uhd::ENDIANNESS_BIG) {
+            payload.template deserialize<uhd::ENDIANNESS_BIG>(buff, num_elems);
+        } else {
+            payload.template deserialize<uhd::ENDIANNESS_LITTLE>(buff, num_elems);
+        }
+    }
+
+    //! Serialize a specific payload type into the payload section of this packet
+    //
+    // \return The number of bytes written
+    template <typename payload_t>
+    inline size_t serialize_payload(const payload_t& payload)
+    {
+        uint64_t* buff = get_payload_ptr_as<uint64_t>();
+        if (get_byte_order() == uhd::ENDIANNESS_BIG) {
+            return payload.template serialize<uhd::ENDIANNESS_BIG>(
+                buff, get_mtu_bytes());
+        }
+        return payload.template serialize<uhd::ENDIANNESS_LITTLE>(buff, get_mtu_bytes());
+    }
+
     //! Return a function to convert a word of type data_t to host order
     template <typename data_t>
     const std::function<data_t(data_t)> conv_to_host() const
@@ -202,9 +232,7 @@ public:
     {
         payload.populate_header(header);
         _chdr_pkt->refresh(pkt_buff, header);
-        size_t bytes_copied = payload.serialize(_chdr_pkt->get_payload_ptr_as<uint64_t>(),
-            _chdr_pkt->get_mtu_bytes(),
-            _chdr_pkt->conv_from_host<uint64_t>());
+        const size_t bytes_copied = _chdr_pkt->serialize_payload(payload);
         _chdr_pkt->update_payload_size(bytes_copied);
         header = _chdr_pkt->get_chdr_header();
     }
@@ -219,18 +247,14 @@ public:
     inline payload_t get_payload() const
     {
         payload_t payload;
-        payload.deserialize(_chdr_pkt->get_payload_const_ptr_as<uint64_t>(),
-            _chdr_pkt->get_payload_size() / sizeof(uint64_t),
-            _chdr_pkt->conv_to_host<uint64_t>());
+        _chdr_pkt->deserialize_payload(payload);
         return payload;
     }
 
     //! Fills the CHDR payload into the specified parameter
     inline void fill_payload(payload_t& payload) const
     {
-        payload.deserialize(_chdr_pkt->get_payload_const_ptr_as<uint64_t>(),
-            _chdr_pkt->get_payload_size() / sizeof(uint64_t),
-            _chdr_pkt->conv_to_host<uint64_t>());
+        _chdr_pkt->deserialize_payload(payload);
     }
 
 private:
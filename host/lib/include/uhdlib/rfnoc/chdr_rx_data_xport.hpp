@@ -9,12 +9,16 @@
 
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
+#include <uhd/stream.hpp>
+#include <uhd/types/device_addr.hpp>
 #include <uhdlib/rfnoc/chdr_packet.hpp>
 #include <uhdlib/rfnoc/chdr_types.hpp>
 #include <uhdlib/rfnoc/rfnoc_common.hpp>
 #include <uhdlib/rfnoc/rx_flow_ctrl_state.hpp>
 #include <uhdlib/transport/io_service.hpp>
 #include <uhdlib/transport/link_if.hpp>
+#include <atomic>
+#include <chrono>
 #include <memory>
 
 namespace uhd { namespace rfnoc {
@@ -43,13 +47,17 @@ public:
     /*! Send a flow control response packet
      *
      * \param send_link the link to use to send the packet
-     * \counts transfer counts for packet contents
+     * \param counts transfer counts for packet contents
+     * \param timeout_ms timeout to wait for a send buffer
+     * \return false if no send buffer was available, true otherwise
      */
-    void send_strs(transport::send_link_if* send_link, const stream_buff_params_t& counts)
+    bool send_strs(transport::send_link_if* send_link,
+        const stream_buff_params_t& counts,
+        const int32_t timeout_ms = 0)
     {
-        auto buff = send_link->get_send_buff(0);
+        auto buff = send_link->get_send_buff(timeout_ms);
         if (!buff) {
-            throw uhd::runtime_error("rx_flowctrl timed out getting a send buffer");
+            return false;
         }
 
         chdr::chdr_header header;
@@ -65,6 +73,7 @@ public:
 
         buff->set_packet_size(size);
         send_link->release_send_buff(std::move(buff));
+        return true;
     }
 
 private:
@@ -120,8 +129,15 @@ public:
     {
         stream_buff_params_t buff_capacity;
         stream_buff_params_t freq;
+        //! Transfer counts to accumulate before a response is sent
+        stream_buff_params_t resp_batch = {0, 0};
+        //! Minimum time between two flow control responses
+        std::chrono::microseconds resp_min_interval{0};
     };
 
+    //! Flow control statistics
+    using fc_stats_t = uhd::rx_streamer::flow_control_stats_t;
+
     /*! Configure stream endpoint route and flow control
      *
      * \param io_srv The service that will schedule the xport I/O
@@ -151,6 +167,19 @@ public:
         const stream_buff_params_t& fc_headroom,
         const bool lossy_xport);
 
+    /*! Read options for coalescing flow control responses
+     *
+     * Reads the following transport args into fc_params:
+     * - fc_resp_batch_ratio: fraction of the buffer capacity whose transfers
+     *   are accumulated before a response is sent.
+     * - fc_resp_min_interval_us: minimum time between two responses.
+     *
+     * \param xport_args The transport args
+     * \param fc_params The flow control parameters to update
+     */
+    static void read_fc_coalescing_args(
+        const uhd::device_addr_t& xport_args, fc_params_t& fc_params);
+
     /*! Constructor
      *
      * \param io_srv The service that will schedule the xport I/O
@@ -182,6 +211,28 @@ public:
         return _max_payload_size;
     }
 
+    /*! Returns the number of frames reserved from the recv link
+     *
+     * \return the maximum number of buffers that can be held at once
+     */
+    size_t get_num_recv_frames() const
+    {
+        return _num_recv_frames;
+    }
+
+    /*! Returns flow control statistics
+     *
+     * \return counts of flow control responses and of received data
+     */
+    fc_stats_t get_fc_stats() const
+    {
+        fc_stats_t stats;
+        stats.num_resps_sent     = _num_fc_resps_sent.load(std::memory_order_relaxed);
+        stats.num_resps_deferred = _num_fc_resps_deferred.load(std::memory_order_relaxed);
+        stats.num_bytes_received = _num_bytes_received.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     /*!
      * Gets an RX frame buffer containing a recv packet
      *
@@ -247,9 +298,7 @@ private:
 
         if (type == chdr::PKT_TYPE_STRC) {
             chdr::strc_payload strc;
-            strc.deserialize(_recv_packet_cb->get_payload_const_ptr_as<uint64_t>(),
-                _recv_packet_cb->get_payload_size() / sizeof(uint64_t),
-                _recv_packet_cb->conv_to_host<uint64_t>());
+            _recv_packet_cb->deserialize_payload(strc);
 
             const stream_buff_params_t strc_counts = {
                 strc.num_bytes, static_cast<uint32_t>(strc.num_pkts)};
@@ -279,6 +328,8 @@ private:
                    || type == chdr::PKT_TYPE_DATA_WITH_TS) {
             // Update state that we received a packet
             _fc_state.data_received(packet_size_rounded);
+            _num_bytes_received.fetch_add(
+                packet_size_rounded, std::memory_order_relaxed);
 
             // If this is a data packet, just claim it by returning true. The
             // I/O service will queue this packet in the recv_io_if.
@@ -314,13 +365,25 @@ private:
     /*!
      * Sends a flow control response packet if necessary.
      *
+     * If no send buffer is available, the response is held back until the
+     * next call, unless the sender may be running out of buffer space.
+     *
      * \param send_link the send link for flow control messages
      */
     void _send_fc_response(transport::send_link_if* send_link)
     {
         if (_fc_state.fc_resp_due()) {
-            _fc_sender.send_strs(send_link, _fc_state.get_xfer_counts());
-            _fc_state.fc_resp_sent();
+            const int32_t timeout_ms =
+                _fc_state.fc_resp_urgent() ? fc_resp_urgent_timeout_ms : 0;
+
+            if (_fc_sender.send_strs(send_link, _fc_state.get_xfer_counts(), timeout_ms)) {
+                _fc_state.fc_resp_sent();
+                _num_fc_resps_sent.fetch_add(1, std::memory_order_relaxed);
+            } else if (timeout_ms != 0) {
+                throw uhd::runtime_error("rx_flowctrl timed out getting a send buffer");
+            } else {
+                _num_fc_resps_deferred.fetch_add(1, std::memory_order_relaxed);
+            }
         }
     }
 
@@ -379,6 +442,9 @@ private:
         return ((pkt_size_bytes + _chdr_w_bytes - 1) / _chdr_w_bytes) * _chdr_w_bytes;
     }
 
+    // Time to wait for a send buffer for a response that can't be held back
+    static constexpr int32_t fc_resp_urgent_timeout_ms = 100;
+
     // Interface to the I/O service
     transport::recv_io_if::sptr _recv_io;
 
@@ -388,6 +454,9 @@ private:
     // Maximum data payload in bytes
     size_t _max_payload_size = 0;
 
+    // Number of frames reserved from the recv link
+    size_t _num_recv_frames = 0;
+
     // Sequence number for data packets
     uint16_t _data_seq_num = 0;
 
@@ -405,6 +474,11 @@ private:
 
     //! The CHDR width in bytes.
     size_t _chdr_w_bytes;
+
+    // Flow control statistics, written only by the I/O service
+    std::atomic<uint64_t> _num_fc_resps_sent{0};
+    std::atomic<uint64_t> _num_fc_resps_deferred{0};
+    std::atomic<uint64_t> _num_bytes_received{0};
 };
 
 }} // namespace uhd::rfnoc
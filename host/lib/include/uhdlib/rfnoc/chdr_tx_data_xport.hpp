@@ -195,6 +195,18 @@ public:
         }
     }
 
+    /*!
+     * Returns whether send buffers may carry a gather payload, i.e., whether
+     * the payload of a packet can be sent directly from caller-owned memory
+     * (see frame_buff::set_gather_payload()).
+     *
+     * \return whether gather sends are supported
+     */
+    bool supports_send_gather() const
+    {
+        return _send_io->supports_send_gather();
+    }
+
     /*!
      * Configure a function to call to enqueue async msgs
      *
@@ -215,6 +227,14 @@ public:
         _send_io->release_send_buff(std::move(buff));
     }
 
+    /*!
+     * Make sure the released TX data packets leave the host
+     */
+    void flush_send_buffs()
+    {
+        _send_io->flush_send_buffs();
+    }
+
     /*!
      * Writes header into frame buffer and returns payload pointer
      *
@@ -271,9 +291,7 @@ private:
 
         if (type == chdr::PKT_TYPE_STRS) {
             chdr::strs_payload strs;
-            strs.deserialize(_recv_packet->get_payload_const_ptr_as<uint64_t>(),
-                _recv_packet->get_payload_size() / sizeof(uint64_t),
-                _recv_packet->conv_to_host<uint64_t>());
+            _recv_packet->deserialize_payload(strs);
 
             _fc_state.update_dest_recv_count(
                 {strs.xfer_count_bytes, static_cast<uint32_t>(strs.xfer_count_pkts)});
@@ -327,7 +345,8 @@ private:
         // If the packet size is not a multiple of the word size, then we will
         // still occupy an integer multiple of word size bytes in the FPGA, so
         // we need to calculate appropriately.
-        const size_t packet_size_rounded = _round_pkt_size(buff->packet_size());
+        const size_t packet_size_rounded =
+            _round_pkt_size(buff->packet_size() + buff->gather_payload_size());
         send_link->release_send_buff(std::move(buff));
 
         _fc_state.data_sent(packet_size_rounded);
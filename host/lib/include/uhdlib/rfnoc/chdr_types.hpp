@@ -7,10 +7,15 @@
 #ifndef INCLUDED_RFNOC_CHDR_TYPES_HPP
 #define INCLUDED_RFNOC_CHDR_TYPES_HPP
 
+#include <uhd/exception.hpp>
 #include <uhd/types/endianness.hpp>
 #include <uhd/utils/byteswap.hpp>
 #include <uhdlib/rfnoc/rfnoc_common.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <initializer_list>
 #include <list>
 #include <memory>
 #include <vector>
@@ -245,6 +250,153 @@ enum ctrl_opcode_t {
     OP_USER6       = 0xF,
 };
 
+//! Storage for the data words of a control transaction
+//
+// A control transaction carries at most MAX_SIZE data words, so this container
+// stores them inline and never allocates. It mimics the subset of the
+// std::vector interface that is used on control payloads.
+class ctrl_data_vtr_t
+{
+public:
+    //! Maximum number of data words in a control transaction (num_data is 4 bits)
+    static constexpr size_t MAX_SIZE = 15;
+
+    using value_type     = uint32_t;
+    using iterator       = uint32_t*;
+    using const_iterator = const uint32_t*;
+
+    ctrl_data_vtr_t() = default;
+
+    ctrl_data_vtr_t(std::initializer_list<uint32_t> init)
+    {
+        assign(init.begin(), init.end());
+    }
+
+    ctrl_data_vtr_t(const std::vector<uint32_t>& vtr)
+    {
+        assign(vtr.begin(), vtr.end());
+    }
+
+    //! Replace the contents with the words in the range [first, last)
+    template <typename input_it_t>
+    inline void assign(input_it_t first, input_it_t last)
+    {
+        const size_t new_size = static_cast<size_t>(std::distance(first, last));
+        UHD_ASSERT_THROW(new_size <= MAX_SIZE);
+        std::copy(first, last, _data.begin());
+        _size = new_size;
+    }
+
+    //! Resize the container. New words are zero-initialized.
+    inline void resize(size_t new_size)
+    {
+        UHD_ASSERT_THROW(new_size <= MAX_SIZE);
+        if (new_size > _size) {
+            std::fill(_data.begin() + _size, _data.begin() + new_size, 0);
+        }
+        _size = new_size;
+    }
+
+    inline void push_back(uint32_t value)
+    {
+        UHD_ASSERT_THROW(_size < MAX_SIZE);
+        _data[_size++] = value;
+    }
+
+    inline void clear()
+    {
+        _size = 0;
+    }
+
+    inline size_t size() const
+    {
+        return _size;
+    }
+
+    inline bool empty() const
+    {
+        return _size == 0;
+    }
+
+    inline uint32_t& operator[](size_t i)
+    {
+        return _data[i];
+    }
+
+    inline const uint32_t& operator[](size_t i) const
+    {
+        return _data[i];
+    }
+
+    inline uint32_t& at(size_t i)
+    {
+        if (i >= _size) {
+            throw uhd::index_error("ctrl_data_vtr_t: Index out of range");
+        }
+        return _data[i];
+    }
+
+    inline const uint32_t& at(size_t i) const
+    {
+        if (i >= _size) {
+            throw uhd::index_error("ctrl_data_vtr_t: Index out of range");
+        }
+        return _data[i];
+    }
+
+    inline uint32_t* data()
+    {
+        return _data.data();
+    }
+
+    inline const uint32_t* data() const
+    {
+        return _data.data();
+    }
+
+    inline iterator begin()
+    {
+        return _data.data();
+    }
+
+    inline iterator end()
+    {
+        return _data.data() + _size;
+    }
+
+    inline const_iterator begin() const
+    {
+        return _data.data();
+    }
+
+    inline const_iterator end() const
+    {
+        return _data.data() + _size;
+    }
+
+    //! Return a copy of the data words as a std::vector
+    inline std::vector<uint32_t> to_vector() const
+    {
+        return std::vector<uint32_t>(begin(), end());
+    }
+
+    //! Comparison operator (==)
+    inline bool operator==(const ctrl_data_vtr_t& rhs) const
+    {
+        return (_size == rhs._size) && std::equal(begin(), end(), rhs.begin());
+    }
+
+    //! Comparison operator (!=)
+    inline bool operator!=(const ctrl_data_vtr_t& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    std::array<uint32_t, MAX_SIZE> _data;
+    size_t _size = 0;
+};
+
 class ctrl_payload
 {
 public: // Members
@@ -262,8 +414,8 @@ public: // Members
     uint16_t src_epid = 0;
     //! Address for transaction (20 bits)
     uint32_t address = 0;
-    //! Data for transaction (vector of 32 bits)
-    std::vector<uint32_t> data_vtr = {0};
+    //! Data for transaction (vector of 32 bits, stored inline)
+    ctrl_data_vtr_t data_vtr = {0};
     //! Byte-enable mask for transaction (4 bits)
     uint8_t byte_enable = 0xF;
     //! Operation code (4 bits)
@@ -286,32 +438,22 @@ public: // Functions
         size_t max_size_bytes,
         const std::function<uint64_t(uint64_t)>& conv_byte_order) const;
 
-    //! Serialize the payload to a uint64_t buffer (no conversion function)
+    //! Serialize the payload to a uint64_t buffer in the given byte order
+    //
+    // The byte order is resolved at compile time, so this and the other
+    // templated serialize() and deserialize() overloads in this file are
+    // faster than the ones that take a conversion function.
     template <endianness_t endianness>
-    size_t serialize(uint64_t* buff, size_t max_size_bytes) const
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::htonx<uint64_t>(x)
-                                                       : uhd::htowx<uint64_t>(x);
-        };
-        return serialize(buff, max_size_bytes, conv_byte_order);
-    }
+    size_t serialize(uint64_t* buff, size_t max_size_bytes) const;
 
     //! Deserialize the payload from a uint64_t buffer
     void deserialize(const uint64_t* buff,
         size_t num_elems,
         const std::function<uint64_t(uint64_t)>& conv_byte_order);
 
-    //! Deserialize the payload from a uint64_t buffer (no conversion function)
+    //! Deserialize the payload from a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    void deserialize(const uint64_t* buff, size_t num_elems)
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::ntohx<uint64_t>(x)
-                                                       : uhd::wtohx<uint64_t>(x);
-        };
-        deserialize(buff, num_elems, conv_byte_order);
-    }
+    void deserialize(const uint64_t* buff, size_t num_elems);
 
     // Return whether or not we have a valid timestamp
     bool has_timestamp() const
@@ -358,6 +500,16 @@ private:
     static constexpr size_t STATUS_OFFSET      = 30;
     static constexpr size_t LO_DATA_OFFSET     = 0;
     static constexpr size_t HI_DATA_OFFSET     = 32;
+
+    template <typename conv_byte_order_t>
+    size_t _serialize(uint64_t* buff,
+        size_t max_size_bytes,
+        const conv_byte_order_t& conv_byte_order) const;
+
+    template <typename conv_byte_order_t>
+    void _deserialize(const uint64_t* buff,
+        size_t num_elems,
+        const conv_byte_order_t& conv_byte_order);
 };
 
 //----------------------------------------------------
@@ -407,32 +559,18 @@ public: // Functions
         size_t max_size_bytes,
         const std::function<uint64_t(uint64_t)>& conv_byte_order) const;
 
-    //! Serialize the payload to a uint64_t buffer (no conversion function)
+    //! Serialize the payload to a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    size_t serialize(uint64_t* buff, size_t max_size_bytes) const
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::htonx<uint64_t>(x)
-                                                       : uhd::htowx<uint64_t>(x);
-        };
-        return serialize(buff, max_size_bytes, conv_byte_order);
-    }
+    size_t serialize(uint64_t* buff, size_t max_size_bytes) const;
 
     //! Deserialize the payload from a uint64_t buffer
     void deserialize(const uint64_t* buff,
         size_t num_elems,
         const std::function<uint64_t(uint64_t)>& conv_byte_order);
 
-    //! Deserialize the payload from a uint64_t buffer (no conversion function)
+    //! Deserialize the payload from a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    void deserialize(const uint64_t* buff, size_t num_elems)
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::ntohx<uint64_t>(x)
-                                                       : uhd::wtohx<uint64_t>(x);
-        };
-        deserialize(buff, num_elems, conv_byte_order);
-    }
+    void deserialize(const uint64_t* buff, size_t num_elems);
 
     //! Comparison operator (==)
     bool operator==(const strs_payload& rhs) const;
@@ -463,6 +601,16 @@ private:
     static constexpr size_t XFER_COUNT_PKTS_OFFSET = 24;
     static constexpr size_t BUFF_INFO_OFFSET       = 0;
     static constexpr size_t STATUS_INFO_OFFSET     = 16;
+
+    template <typename conv_byte_order_t>
+    size_t _serialize(uint64_t* buff,
+        size_t max_size_bytes,
+        const conv_byte_order_t& conv_byte_order) const;
+
+    template <typename conv_byte_order_t>
+    void _deserialize(const uint64_t* buff,
+        size_t num_elems,
+        const conv_byte_order_t& conv_byte_order);
 };
 
 //----------------------------------------------------
@@ -506,32 +654,18 @@ public: // Functions
         size_t max_size_bytes,
         const std::function<uint64_t(uint64_t)>& conv_byte_order) const;
 
-    //! Serialize the payload to a uint64_t buffer (no conversion function)
+    //! Serialize the payload to a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    size_t serialize(uint64_t* buff, size_t max_size_bytes) const
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::htonx<uint64_t>(x)
-                                                       : uhd::htowx<uint64_t>(x);
-        };
-        return serialize(buff, max_size_bytes, conv_byte_order);
-    }
+    size_t serialize(uint64_t* buff, size_t max_size_bytes) const;
 
     //! Deserialize the payload from a uint64_t buffer
     void deserialize(const uint64_t* buff,
         size_t num_elems,
         const std::function<uint64_t(uint64_t)>& conv_byte_order);
 
-    //! Deserialize the payload from a uint64_t buffer (no conversion function)
+    //! Deserialize the payload from a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    void deserialize(const uint64_t* buff, size_t num_elems)
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::ntohx<uint64_t>(x)
-                                                       : uhd::wtohx<uint64_t>(x);
-        };
-        deserialize(buff, num_elems, conv_byte_order);
-    }
+    void deserialize(const uint64_t* buff, size_t num_elems);
 
     //! Comparison operator (==)
     bool operator==(const strc_payload& rhs) const;
@@ -556,6 +690,16 @@ private:
     static constexpr size_t OP_CODE_OFFSET  = 16;
     static constexpr size_t OP_DATA_OFFSET  = 20;
     static constexpr size_t NUM_PKTS_OFFSET = 24;
+
+    template <typename conv_byte_order_t>
+    size_t _serialize(uint64_t* buff,
+        size_t max_size_bytes,
+        const conv_byte_order_t& conv_byte_order) const;
+
+    template <typename conv_byte_order_t>
+    void _deserialize(const uint64_t* buff,
+        size_t num_elems,
+        const conv_byte_order_t& conv_byte_order);
 };
 
 //----------------------------------------------------
@@ -719,6 +863,20 @@ public:
         const std::function<uint64_t(uint64_t)>& conv_byte_order);
 
 private:
+    friend class mgmt_payload;
+
+    //! Serialize this hop into buff, return the number of words written
+    template <typename conv_byte_order_t>
+    size_t _serialize(uint64_t* buff,
+        size_t max_num_elems,
+        const conv_byte_order_t& conv_byte_order) const;
+
+    //! Deserialize this hop from buff, return the number of words consumed
+    template <typename conv_byte_order_t>
+    size_t _deserialize(const uint64_t* buff,
+        size_t num_elems,
+        const conv_byte_order_t& conv_byte_order);
+
     std::vector<mgmt_op_t> _ops;
 };
 
@@ -777,32 +935,18 @@ public:
         size_t max_size_bytes,
         const std::function<uint64_t(uint64_t)>& conv_byte_order) const;
 
-    //! Serialize the payload to a uint64_t buffer (no conversion function)
+    //! Serialize the payload to a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    size_t serialize(uint64_t* buff, size_t max_size_bytes) const
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::htonx<uint64_t>(x)
-                                                       : uhd::htowx<uint64_t>(x);
-        };
-        return serialize(buff, max_size_bytes, conv_byte_order);
-    }
+    size_t serialize(uint64_t* buff, size_t max_size_bytes) const;
 
     //! Deserialize the payload from a uint64_t buffer
     void deserialize(const uint64_t* buff,
         size_t num_elems,
         const std::function<uint64_t(uint64_t)>& conv_byte_order);
 
-    //! Deserialize the payload from a uint64_t buffer (no conversion function)
+    //! Deserialize the payload from a uint64_t buffer in the given byte order
     template <endianness_t endianness>
-    void deserialize(const uint64_t* buff, size_t num_elems)
-    {
-        auto conv_byte_order = [](uint64_t x) -> uint64_t {
-            return (endianness == uhd::ENDIANNESS_BIG) ? uhd::ntohx<uint64_t>(x)
-                                                       : uhd::wtohx<uint64_t>(x);
-        };
-        deserialize(buff, num_elems, conv_byte_order);
-    }
+    void deserialize(const uint64_t* buff, size_t num_elems);
 
     //! Return a string representation of this object
     const std::string to_string() const;
@@ -818,6 +962,16 @@ private:
     uint16_t _protover = 0;
     chdr_w_t _chdr_w   = CHDR_W_64;
     std::vector<mgmt_hop_t> _hops;
+
+    template <typename conv_byte_order_t>
+    size_t _serialize(uint64_t* buff,
+        size_t max_size_bytes,
+        const conv_byte_order_t& conv_byte_order) const;
+
+    template <typename conv_byte_order_t>
+    void _deserialize(const uint64_t* buff,
+        size_t num_elems,
+        const conv_byte_order_t& conv_byte_order);
 };
 
 }}} // namespace uhd::rfnoc::chdr
@@ -31,6 +31,8 @@ public:
      */
     rfnoc_rx_streamer(const size_t num_ports, const uhd::stream_args_t stream_args);
 
+    ~rfnoc_rx_streamer();
+
     /*! Returns a unique identifier string for this node. In every RFNoC graph,
      * no two nodes cannot have the same ID. Returns a string in the form of
      * "RxStreamer#0".
@@ -85,6 +87,22 @@ public:
      */
     void connect_channel(const size_t channel, chdr_rx_data_xport::uptr xport);
 
+    /*! Returns the flow control statistics, summed over all channels
+     *
+     * Overrides method in rx_streamer.
+     */
+    flow_control_stats_t get_flow_control_stats() const;
+
+protected:
+    /*! Issues a stream command to a single channel
+     *
+     * Overrides method in rx_streamer_impl, used with independent channels.
+     *
+     * \param chan The streamer channel to which to issue the command
+     * \param stream_cmd the stream command to issue
+     */
+    void issue_channel_stream_cmd(const size_t chan, const stream_cmd_t& stream_cmd);
+
 private:
     void _register_props(const size_t chan, const std::string& otw_format);
 
@@ -108,6 +126,10 @@ private:
     // Stream args provided at construction
     const uhd::stream_args_t _stream_args;
 
+    // Connected transports, owned by rx_streamer_impl. Only used to read
+    // their flow control statistics.
+    std::vector<const chdr_rx_data_xport*> _fc_xports;
+
     std::atomic<bool> _overrun_handling_mode{false};
     size_t _overrun_channel = 0;
 };
@@ -89,6 +89,24 @@ public:
      */
     bool recv_async_msg(uhd::async_metadata_t& async_metadata, double timeout);
 
+    /*! Deliver asynchronous messages to a callback instead of queueing them
+     *
+     *  Implementation of tx_streamer API method.
+     */
+    void set_async_msg_callback(const async_msg_callback_t& callback);
+
+    /*! Get an eventfd that is signaled when asynchronous messages are queued
+     *
+     *  Implementation of tx_streamer API method.
+     */
+    int get_async_msg_fd(void);
+
+    /*! Get the number of messages dropped because the queue was full
+     *
+     *  Implementation of tx_streamer API method.
+     */
+    size_t get_num_dropped_async_msgs(void) const;
+
 private:
     void _register_props(const size_t chan, const std::string& otw_format);
 
@@ -9,6 +9,8 @@
 
 #include <uhd/utils/log.hpp>
 #include <uhdlib/rfnoc/rfnoc_common.hpp>
+#include <algorithm>
+#include <chrono>
 
 namespace uhd { namespace rfnoc {
 
@@ -19,10 +21,33 @@ public:
     //! Constructor
     rx_flow_ctrl_state(
         const rfnoc::sep_id_pair_t epids, const stream_buff_params_t fc_freq)
-        : _fc_freq(fc_freq), _epids(epids)
+        : _fc_freq(fc_freq), _resp_batch(fc_freq), _epids(epids)
     {
     }
 
+    /*! Configure coalescing of flow control responses
+     *
+     * By default, a response is sent as soon as the transfer counts have
+     * advanced by the flow control frequency. Coalescing holds responses back
+     * to send fewer of them. No more than half of the buffer capacity is ever
+     * held back, so that the sender always has room to keep sending.
+     *
+     * \param capacity The buffer capacity of the receive link
+     * \param batch Transfer counts to accumulate before a response is sent
+     *              (count-based). Values below the flow control frequency
+     *              have no effect.
+     * \param min_interval Minimum time between two responses (time-based)
+     */
+    void set_coalescing(const stream_buff_params_t capacity,
+        const stream_buff_params_t batch,
+        const std::chrono::microseconds min_interval)
+    {
+        _resp_urgent = {capacity.bytes / 2, capacity.packets / 2};
+        _resp_batch  = {std::max(_fc_freq.bytes, std::min(batch.bytes, _resp_urgent.bytes)),
+            std::max(_fc_freq.packets, std::min(batch.packets, _resp_urgent.packets))};
+        _resp_min_interval = min_interval;
+    }
+
     //! Resynchronize with transfer counts from the sender
     void resynchronize(const stream_buff_params_t counts)
     {
@@ -67,18 +92,35 @@ public:
     //! Returns whether a flow control response is needed
     bool fc_resp_due() const
     {
-        stream_buff_params_t accum_counts = {
-            _xfer_counts.bytes - _last_fc_resp_counts.bytes,
-            _xfer_counts.packets - _last_fc_resp_counts.packets};
+        const stream_buff_params_t accum_counts = _get_accum_counts();
+
+        if (accum_counts.bytes < _resp_batch.bytes
+            && accum_counts.packets < _resp_batch.packets) {
+            return false;
+        }
 
-        return accum_counts.bytes >= _fc_freq.bytes
-               || accum_counts.packets >= _fc_freq.packets;
+        if (_resp_min_interval.count() == 0 || _is_urgent(accum_counts)) {
+            return true;
+        }
+
+        return std::chrono::steady_clock::now() - _last_fc_resp_time
+               >= _resp_min_interval;
+    }
+
+    //! Returns whether so much buffer space is held back that the sender may
+    //! have to stop sending
+    bool fc_resp_urgent() const
+    {
+        return _is_urgent(_get_accum_counts());
     }
 
     //! Update state after flow control response was sent
     void fc_resp_sent()
     {
         _last_fc_resp_counts = _xfer_counts;
+        if (_resp_min_interval.count() != 0) {
+            _last_fc_resp_time = std::chrono::steady_clock::now();
+        }
     }
 
     //! Returns counts for completed transfers
@@ -100,6 +142,18 @@ public:
     }
 
 private:
+    stream_buff_params_t _get_accum_counts() const
+    {
+        return {_xfer_counts.bytes - _last_fc_resp_counts.bytes,
+            _xfer_counts.packets - _last_fc_resp_counts.packets};
+    }
+
+    bool _is_urgent(const stream_buff_params_t& accum_counts) const
+    {
+        return accum_counts.bytes >= _resp_urgent.bytes
+               || accum_counts.packets >= _resp_urgent.packets;
+    }
+
     // Counts for data received, including any data still in use
     stream_buff_params_t _recv_counts{0, 0};
 
@@ -112,6 +166,16 @@ private:
     // Frequency of flow control responses
     stream_buff_params_t _fc_freq{0, 0};
 
+    // Counts to accumulate before a response is sent
+    stream_buff_params_t _resp_batch{0, 0};
+
+    // Counts above which responses are never held back
+    stream_buff_params_t _resp_urgent{0, 0};
+
+    // Minimum time between two responses, and time of the last response
+    std::chrono::microseconds _resp_min_interval{0};
+    std::chrono::steady_clock::time_point _last_fc_resp_time;
+
     // Endpoint ID for log messages
     const sep_id_pair_t _epids;
 };
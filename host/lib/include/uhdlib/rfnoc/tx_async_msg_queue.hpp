@@ -9,21 +9,35 @@
 
 #include <uhd/types/metadata.hpp>
 #include <boost/lockfree/queue.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 namespace uhd { namespace rfnoc {
 
 /*!
  *  Implements queue of async messages originating from the tx data transport
  *  and from the rfnoc graph.
+ *
+ *  Messages can be pushed from several threads concurrently. The queue holds
+ *  at most capacity messages. When it is full, the oldest message is dropped
+ *  to make room for the new one, and counted in get_num_dropped().
  */
 class tx_async_msg_queue
 {
 public:
     using sptr = std::shared_ptr<tx_async_msg_queue>;
 
+    //! Callback to which messages are delivered instead of queueing them
+    using callback_t = std::function<void(const async_metadata_t&)>;
+
     //! Constructor
     tx_async_msg_queue(size_t capacity);
 
+    //! Destructor, closes the event file descriptor
+    ~tx_async_msg_queue();
+
     /*!
      *  Retrieve async message from queue
      *
@@ -36,12 +50,54 @@ public:
     /*!
      *  Push an async message onto the queue
      *
+     * If a callback is set, the message is passed to the callback instead.
+     *
      * \param async_metadata the metadata to be pushed
      */
     void enqueue(const async_metadata_t& async_metadata);
 
+    /*!
+     *  Set the callback to which all following messages are delivered
+     *
+     * Messages that were queued before remain available through
+     * recv_async_msg().
+     *
+     * \param callback the callback, or an empty function to queue messages
+     *                 again
+     */
+    void set_callback(const callback_t& callback);
+
+    /*!
+     *  Get an eventfd that is signaled for every queued message
+     *
+     * The file descriptor is created on the first call. If messages are
+     * already queued at that point, it is signaled once for all of them. It
+     * remains owned by the queue.
+     *
+     * \throws uhd::not_implemented_error if eventfd is not available
+     */
+    int get_event_fd();
+
+    //! Return the number of messages that were dropped because the queue was
+    //  full
+    size_t get_num_dropped() const
+    {
+        return _num_dropped.load();
+    }
+
 private:
     boost::lockfree::queue<async_metadata_t> _queue;
+
+    //! The callback, if any. Accessed with std::atomic_load/store only, so it
+    //  can be replaced while messages are enqueued.
+    std::shared_ptr<callback_t> _callback;
+
+    //! The eventfd, or -1 if none was requested
+    std::atomic<int> _event_fd{-1};
+    //! Serializes the creation of the eventfd
+    std::mutex _event_fd_mutex;
+
+    std::atomic<size_t> _num_dropped{0};
 };
 
 }} // namespace uhd::rfnoc
@@ -0,0 +1,193 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_ALIGNMENT_TRACKER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_ALIGNMENT_TRACKER_HPP
+
+#include <uhd/config.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
+namespace uhd { namespace transport {
+
+/*!
+ * Bookkeeping for the time alignment of multi-channel rx streams.
+ *
+ * The tracker holds the alignment time (the newest timestamp seen so far) and
+ * the set of channels that don't have a packet with that timestamp yet. The
+ * set is a two-level bitmask: one bit per channel, plus one summary bit per
+ * 64 channels. Finding the next pending channel takes two bit scans (for up
+ * to 4096 channels), and processing a packet takes a compare and a bit clear,
+ * regardless of the number of channels.
+ *
+ * When a packet with a newer timestamp arrives, all other channels become
+ * pending again. This takes one store per 64 channels. Note that the tracker
+ * does not touch the buffers of the other channels: they now hold stale
+ * packets, which the caller releases when it gets to those channels.
+ */
+class alignment_tracker
+{
+public:
+    //! The outcome of checking a packet's timestamp
+    enum result_t {
+        //! The timestamp matches the alignment time
+        ALIGNED,
+        //! The timestamp is newer than the alignment time, and is now the
+        // alignment time. All other channels are pending again.
+        NEW_TIME,
+        //! The timestamp is older than the alignment time. The packet must
+        // be dropped, and the channel stays pending.
+        OLDER
+    };
+
+    alignment_tracker(const size_t num_chans)
+        : _num_chans(num_chans)
+        , _pending((num_chans + 63) / 64, 0)
+        , _summary((_pending.size() + 63) / 64, 0)
+    {
+        reset();
+    }
+
+    //! Return the number of channels
+    size_t size() const
+    {
+        return _num_chans;
+    }
+
+    //! Start a new alignment: all channels pending, and no alignment time
+    void reset()
+    {
+        _time_valid = false;
+        _set_all_pending();
+    }
+
+    //! Forget the alignment time, so the next timestamp becomes the new one.
+    // Use this when time went backwards, e.g., because it was set while
+    // streaming.
+    void invalidate_time()
+    {
+        _time_valid = false;
+    }
+
+    //! Return true if the alignment time is valid
+    bool is_time_valid() const
+    {
+        return _time_valid;
+    }
+
+    //! Return the alignment time
+    uint64_t get_time() const
+    {
+        return _time;
+    }
+
+    //! Return true if no channel is pending
+    bool done() const
+    {
+        return _num_pending == 0;
+    }
+
+    //! Return the number of pending channels
+    size_t get_num_pending() const
+    {
+        return _num_pending;
+    }
+
+    //! Return true if the channel is pending
+    bool is_pending(const size_t chan) const
+    {
+        return (_pending[chan / 64] >> (chan % 64)) & 1;
+    }
+
+    //! Return the lowest pending channel. Must not be called when done().
+    size_t next_pending() const
+    {
+        size_t summary_idx = 0;
+        while (_summary[summary_idx] == 0) {
+            summary_idx++;
+        }
+        const size_t word_idx = summary_idx * 64 + _ctz(_summary[summary_idx]);
+        return word_idx * 64 + _ctz(_pending[word_idx]);
+    }
+
+    //! Mark a channel as aligned regardless of the time, e.g., for packets
+    // without a timestamp
+    void set_aligned(const size_t chan)
+    {
+        const size_t word_idx = chan / 64;
+        const uint64_t bit    = uint64_t(1) << (chan % 64);
+        if (_pending[word_idx] & bit) {
+            _pending[word_idx] &= ~bit;
+            _num_pending--;
+            if (_pending[word_idx] == 0) {
+                _summary[word_idx / 64] &= ~(uint64_t(1) << (word_idx % 64));
+            }
+        }
+    }
+
+    //! Check the timestamp of a packet on a channel
+    result_t update(const size_t chan, const uint64_t time)
+    {
+        if (!_time_valid || time > _time) {
+            _time_valid = true;
+            _time       = time;
+            _set_all_pending();
+            set_aligned(chan);
+            return NEW_TIME;
+        }
+        if (time == _time) {
+            set_aligned(chan);
+            return ALIGNED;
+        }
+        return OLDER;
+    }
+
+private:
+    static UHD_INLINE size_t _ctz(const uint64_t word)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return index;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    //! Set the bits of the first num_bits bits of a bitmask
+    static void _set_bits(std::vector<uint64_t>& words, const size_t num_bits)
+    {
+        for (size_t i = 0; i < words.size(); i++) {
+            const size_t bits_left = num_bits - i * 64;
+            words[i] = bits_left >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits_left) - 1;
+        }
+    }
+
+    void _set_all_pending()
+    {
+        _set_bits(_pending, _num_chans);
+        _set_bits(_summary, _pending.size());
+        _num_pending = _num_chans;
+    }
+
+    size_t _num_chans;
+    size_t _num_pending = 0;
+    bool _time_valid    = false;
+    uint64_t _time      = 0;
+
+    //! One bit per channel, set if the channel is pending
+    std::vector<uint64_t> _pending;
+    //! One bit per word of _pending, set if the word is not zero
+    std::vector<uint64_t> _summary;
+};
+
+}} // namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_ALIGNMENT_TRACKER_HPP */
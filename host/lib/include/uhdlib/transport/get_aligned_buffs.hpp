@@ -9,7 +9,7 @@
 
 #include <uhd/exception.hpp>
 #include <uhd/utils/log.hpp>
-#include <boost/dynamic_bitset.hpp>
+#include <uhdlib/transport/alignment_tracker.hpp>
 #include <boost/format.hpp>
 
 namespace uhd { namespace transport {
@@ -26,6 +26,12 @@ constexpr size_t ALIGNMENT_FAILURE_THRESHOLD = 1000;
  * transports for each channel and discards any packets whose tsf does not
  * match those of other channels due to dropped packets. Packets that do not
  * have a tsf are not checked for alignment and never dropped.
+ *
+ * The work per received packet does not depend on the number of channels:
+ * the alignment state is kept in an alignment_tracker, and when a newer tsf
+ * restarts the alignment, the packets already aligned to the old tsf are not
+ * released right away, but when their channel is visited again. Only when time
+ * goes backwards, which is rare, are the held packets released right away.
  */
 template <typename transport_t, bool ignore_seq_err = false>
 class get_aligned_buffs
@@ -46,20 +52,18 @@ public:
         , _frame_buffs(frame_buffs)
         , _infos(infos)
         , _prev_tsf(_xports.size(), 0)
-        , _channels_to_align(_xports.size())
+        , _tracker(_xports.size())
     {
     }
 
     alignment_result_t operator()(const int32_t timeout_ms)
     {
         // Clear state
-        _channels_to_align.set();
-        bool time_valid   = false;
-        uint64_t tsf      = 0;
+        _tracker.reset();
         size_t iterations = 0;
 
-        while (_channels_to_align.any()) {
-            const size_t chan = _channels_to_align.find_first();
+        while (!_tracker.done()) {
+            const size_t chan = _tracker.next_pending();
             auto& xport       = _xports[chan];
             auto& info        = _infos[chan];
             auto& frame_buff  = _frame_buffs[chan];
@@ -94,52 +98,47 @@ public:
                 // receive a packet that comes before the previous packet in
                 // time. This would cause the alignment logic to discard future
                 // received packets. Therefore, when this occurs, we reset the
-                // info to restart the alignment.
+                // info to restart the alignment. The packets held by the other
+                // channels are from before the time change. They are released
+                // here, otherwise they would restore the old time when their
+                // channel is visited again.
                 if (time_out_of_order) {
-                    time_valid = false;
-                }
-
-                // Check if the time is larger than packets received for other
-                // channels, and if so, use this time to align all channels
-                if (!time_valid || info.tsf > tsf) {
-                    // If we haven't found a set of aligned packets after many
-                    // iterations, return an alignment failure
-                    if (iterations++ > ALIGNMENT_FAILURE_THRESHOLD) {
-                        UHD_LOGGER_ERROR("STREAMER")
-                            << "The rx streamer failed to time-align packets.";
-                        return ALIGNMENT_FAILURE;
-                    }
-
-                    // Release buffers for channels aligned previously. Keep
-                    // buffers that don't have a tsf since we don't need to
-                    // align those.
+                    _tracker.invalidate_time();
                     for (size_t i = 0; i < _xports.size(); i++) {
-                        if (!_channels_to_align.test(i) && _infos[i].has_tsf) {
+                        if (i != chan && _frame_buffs[i] && _infos[i].has_tsf) {
                             _xports[i]->release_recv_buff(std::move(_frame_buffs[i]));
                             _frame_buffs[i] = nullptr;
                         }
                     }
-
-                    // Mark only this channel as aligned and save its tsf
-                    _channels_to_align.set();
-                    _channels_to_align.reset(chan);
-                    time_valid = true;
-                    tsf        = info.tsf;
                 }
 
-                // Check if the time matches that of other aligned channels
-                else if (info.tsf == tsf) {
-                    _channels_to_align.reset(chan);
-                }
+                // If the time is larger than that of the packets received for
+                // other channels, this time is used to align all channels. The
+                // channels aligned previously are pending again, and their
+                // buffers get released when they are visited.
+                switch (_tracker.update(chan, info.tsf)) {
+                    case alignment_tracker::NEW_TIME:
+                        // If we haven't found a set of aligned packets after
+                        // many iterations, return an alignment failure
+                        if (iterations++ > ALIGNMENT_FAILURE_THRESHOLD) {
+                            UHD_LOGGER_ERROR("STREAMER")
+                                << "The rx streamer failed to time-align packets.";
+                            return ALIGNMENT_FAILURE;
+                        }
+                        break;
+
+                    case alignment_tracker::ALIGNED:
+                        break;
 
-                // Otherwise, time is smaller than other channels, release the buffer
-                else {
-                    _xports[chan]->release_recv_buff(std::move(_frame_buffs[chan]));
-                    _frame_buffs[chan] = nullptr;
+                    // Time is smaller than other channels, release the buffer
+                    case alignment_tracker::OLDER:
+                        _xports[chan]->release_recv_buff(std::move(_frame_buffs[chan]));
+                        _frame_buffs[chan] = nullptr;
+                        break;
                 }
             } else {
                 // Packet doesn't have a tsf, just mark it as aligned
-                _channels_to_align.reset(chan);
+                _tracker.set_aligned(chan);
             }
 
             // If this packet had a sequence error, stop to return the error.
@@ -167,8 +166,8 @@ private:
     // Time of previous packet for each channel
     std::vector<uint64_t> _prev_tsf;
 
-    // Keeps track of channels that are aligned
-    boost::dynamic_bitset<> _channels_to_align;
+    // Keeps track of the alignment time and the channels that are aligned
+    alignment_tracker _tracker;
 };
 
 }} // namespace uhd::transport
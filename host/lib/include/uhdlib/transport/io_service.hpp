@@ -236,6 +236,27 @@ public:
      */
     virtual void release_send_buff(frame_buff::uptr buff) = 0;
 
+    /*!
+     * Returns whether release_send_buff() accepts frame buffers with a gather
+     * payload (see frame_buff::set_gather_payload()). This requires a link
+     * that supports gather sends, and an I/O service that sends the packet
+     * before release_send_buff() returns, since the attached payload is owned
+     * by the caller.
+     *
+     * \return whether gather sends are supported
+     */
+    virtual bool supports_send_gather() const
+    {
+        return false;
+    }
+
+    /*!
+     * Make sure the released send buffers leave the host, even if the link
+     * holds back packets to send them in batches. Callers should flush
+     * when they don't release another buffer right away.
+     */
+    virtual void flush_send_buffs() {}
+
     /*!
      * Get number of send frames reserved by this I/O interface.
      *
@@ -113,6 +113,7 @@ public:
 
         // Reset buff and re-add to free pool
         buff_ptr->set_packet_size(0);
+        buff_ptr->set_gather_payload(nullptr, 0);
         _free_send_buffs.push(buff_ptr);
     }
 
@@ -66,6 +66,24 @@ public:
         return true;
     }
 
+    /*!
+     * Returns whether this link can send frame buffers that have a payload
+     * attached with frame_buff::set_gather_payload(). Such links send the
+     * attached payload directly from the caller's memory when the buffer is
+     * released, and detach it afterwards.
+     */
+    virtual bool supports_send_gather() const
+    {
+        return false;
+    }
+
+    /*!
+     * Send the packets that the link holds back to send them in batches.
+     * Links that send every packet when its buffer is released don't need to
+     * implement this.
+     */
+    virtual void flush_send_buffs() {}
+
     send_link_if()                    = default;
     send_link_if(const send_link_if&) = delete;
     send_link_if& operator=(const send_link_if&) = delete;
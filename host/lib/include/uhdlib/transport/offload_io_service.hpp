@@ -8,6 +8,7 @@
 #define INCLUDED_UHDLIB_TRANSPORT_OFFLOAD_IO_SERVICE_HPP
 
 #include <uhdlib/transport/io_service.hpp>
+#include <cstdint>
 #include <vector>
 
 namespace uhd { namespace transport {
@@ -24,7 +25,7 @@ class offload_io_service : public io_service
 public:
     enum client_type_t { RECV_ONLY, SEND_ONLY, BOTH_SEND_AND_RECV };
 
-    enum wait_mode_t { POLL, BLOCK };
+    enum wait_mode_t { POLL, BLOCK, ADAPTIVE };
 
     /*!
      * Options for configuring offload I/O service
@@ -37,7 +38,67 @@ public:
         client_type_t client_type = BOTH_SEND_AND_RECV;
         //! The thread behavior when waiting for incoming packets If set to
         //! BLOCK, the client type must be set to either RECV_ONLY or SEND_ONLY.
+        //! If set to ADAPTIVE, the thread polls while there is work to do,
+        //! and once idle it spins, then yields, then parks until woken.
         wait_mode_t wait_mode = POLL;
+        //! ADAPTIVE only: time to keep spinning after the last unit of work
+        uint32_t adaptive_spin_us = 50;
+        //! ADAPTIVE only: time to keep yielding once the spin budget is used
+        uint32_t adaptive_yield_us = 200;
+        //! ADAPTIVE only: upper bound on the time the thread stays parked. A
+        //! thread that has to watch several links checks all of them every
+        //! millisecond while parked.
+        int32_t adaptive_park_timeout_ms = 10;
+        //! Number of offload threads. If greater than one, links are given a
+        //! home thread, and threads whose own links are idle steal work from
+        //! busy peers. A link is never serviced by two threads at once, so the
+        //! order of its buffers is preserved. Requires the POLL wait mode.
+        size_t num_threads = 1;
+        //! Per-thread CPU affinity lists, used instead of cpu_affinity_list
+        //! for the threads that have an entry.
+        std::vector<std::vector<size_t>> thread_cpu_affinity_lists;
+    };
+
+    /*!
+     * Offload thread wait statistics
+     *
+     * Time spent by the offload thread in each of its states. Only gathered
+     * when the I/O service is configured with the ADAPTIVE wait mode. The
+     * statistics are logged at debug level when the I/O service is destroyed.
+     */
+    struct wait_stats_t
+    {
+        //! Time spent in loop iterations that moved at least one buffer
+        uint64_t busy_ns = 0;
+        //! Time spent spinning while idle
+        uint64_t spin_ns = 0;
+        //! Time spent yielding the CPU while idle
+        uint64_t yield_ns = 0;
+        //! Time spent parked
+        uint64_t park_ns = 0;
+        //! Number of times the thread parked
+        uint64_t num_parks = 0;
+        //! Number of parks that ended because work arrived, not by timeout
+        uint64_t num_wakeups = 0;
+    };
+
+    /*!
+     * Offload thread load counters
+     *
+     * Only gathered when the I/O service runs more than one offload thread.
+     * The counters are logged at debug level when the I/O service is
+     * destroyed.
+     */
+    struct thread_load_t
+    {
+        //! Number of buffers the thread moved between links and clients
+        uint64_t num_buffs = 0;
+        //! Number of those buffers that belong to links homed on other threads
+        uint64_t num_stolen_buffs = 0;
+        //! Number of passes over the clients that did not move any buffer
+        uint64_t num_idle_passes = 0;
+        //! Number of links currently homed on the thread
+        uint64_t num_links = 0;
     };
 
     /*!
@@ -51,6 +112,21 @@ public:
      *          in its own thread.
      */
     static sptr make(io_service::sptr io_srv, const params_t& params);
+
+    /*!
+     * Returns the wait statistics of the offload thread
+     *
+     * \return A snapshot of the time spent by the thread in each state
+     */
+    virtual wait_stats_t get_wait_stats() const = 0;
+
+    /*!
+     * Returns the load counters of each offload thread
+     *
+     * \return One entry per offload thread, empty if the service runs a
+     *         single thread
+     */
+    virtual std::vector<thread_load_t> get_thread_load() const = 0;
 };
 
 }} // namespace uhd::transport
@@ -13,8 +13,12 @@
 #include <uhd/stream.hpp>
 #include <uhd/types/endianness.hpp>
 #include <uhd/utils/log.hpp>
+#include <uhdlib/convert/inline_converter.hpp>
 #include <uhdlib/transport/rx_streamer_zero_copy.hpp>
+#include <atomic>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace uhd { namespace transport {
@@ -72,11 +76,14 @@ private:
 template <typename transport_t, bool ignore_seq_err = false>
 class rx_streamer_impl : public rx_streamer
 {
+    class channel_streamer;
+
 public:
     //! Constructor
     rx_streamer_impl(const size_t num_ports, const uhd::stream_args_t stream_args)
         : _zero_copy_streamer(num_ports)
         , _in_buffs(num_ports)
+        , _bulk_in_buffs(num_ports)
     {
         if (stream_args.cpu_format.empty()) {
             throw uhd::value_error("[rx_stream] Must provide a cpu_format!");
@@ -85,6 +92,8 @@ public:
             throw uhd::value_error("[rx_stream] Must provide a otw_format!");
         }
         _setup_converters(num_ports, stream_args);
+        // Without conversion, the payload of a packet can be used as is
+        _recv_view = (stream_args.cpu_format == stream_args.otw_format);
         _zero_copy_streamer.set_samp_rate(_samp_rate);
         _zero_copy_streamer.set_bytes_per_item(_convert_info.bytes_per_otw_item);
 
@@ -92,6 +101,24 @@ public:
             _spp = stream_args.args.cast<size_t>("spp", _spp);
             _mtu = _spp * _convert_info.bytes_per_otw_item;
         }
+
+        if (stream_args.args.cast<bool>("independent_channels", false)) {
+            // Every channel gets a streamer of its own, which owns the channel's
+            // transport. This streamer only distributes the configuration.
+            uhd::stream_args_t chan_args = stream_args;
+            chan_args.args.pop("independent_channels");
+            _parent_link         = std::make_shared<parent_link_t>();
+            _parent_link->parent = this;
+            for (size_t chan = 0; chan < num_ports; chan++) {
+                _channel_streamers.push_back(
+                    std::make_shared<channel_streamer>(_parent_link, chan, chan_args));
+            }
+        }
+    }
+
+    virtual ~rx_streamer_impl()
+    {
+        _detach_channel_streamers();
     }
 
     //! Connect a new channel to the streamer
@@ -99,7 +126,15 @@ public:
     virtual void connect_channel(const size_t channel, typename transport_t::uptr xport)
     {
         const size_t mtu = xport->get_max_payload_size();
-        _zero_copy_streamer.connect_channel(channel, std::move(xport));
+        if (_channel_streamers.empty()) {
+            _zero_copy_streamer.connect_channel(channel, std::move(xport));
+        } else {
+            if (channel >= _channel_streamers.size()) {
+                throw uhd::index_error(
+                    "Port number indexes beyond the number of streamer ports");
+            }
+            _channel_streamers[channel]->connect_channel(0, std::move(xport));
+        }
 
         if (mtu < _mtu) {
             set_mtu(mtu);
@@ -133,6 +168,7 @@ public:
         const double timeout,
         const bool one_packet)
     {
+        _check_aligned();
         if (_error_metadata_cache.check(metadata)) {
             return 0;
         }
@@ -189,11 +225,197 @@ public:
         return total_samps_recv;
     }
 
+    //! Implementation of rx_streamer API method
+    size_t recv_bulk(const uhd::rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        uhd::rx_metadata_t& metadata,
+        uhd::rx_packet_info_t* packet_infos,
+        const size_t max_num_packets,
+        const double timeout)
+    {
+        _check_aligned();
+        if (_error_metadata_cache.check(metadata)) {
+            return 0;
+        }
+
+        metadata.reset();
+        if (max_num_packets == 0) {
+            return 0;
+        }
+
+        const int32_t timeout_ms = static_cast<int32_t>(timeout * 1000);
+
+        // If a previous call to recv left part of a packet in the buffers, or
+        // if the buffers can't hold a full packet, fall back to receiving a
+        // single (possibly fragmented) packet.
+        if (_buff_samps_remaining != 0 || nsamps_per_buff < _spp) {
+            uhd::rx_metadata_t eov_metadata;
+            detail::eov_data_wrapper eov_positions(eov_metadata);
+            const size_t num_samps = _recv_one_packet(
+                buffs, nsamps_per_buff, metadata, eov_positions, timeout_ms);
+            if (num_samps == 0) {
+                return 0;
+            }
+            packet_infos[0]               = uhd::rx_packet_info_t();
+            packet_infos[0].num_samps     = num_samps;
+            packet_infos[0].has_time_spec = metadata.has_time_spec;
+            packet_infos[0].time_spec     = metadata.time_spec;
+            packet_infos[0].end_of_burst  = metadata.end_of_burst;
+            packet_infos[0].end_of_vector = eov_metadata.eov_positions_count > 0;
+            return 1;
+        }
+
+        // Acquire as many packets as will fit into the buffers
+        const size_t num_packets_to_recv =
+            std::min(max_num_packets, nsamps_per_buff / _spp);
+        for (auto& chan_buffs : _bulk_in_buffs) {
+            if (chan_buffs.size() < num_packets_to_recv) {
+                chan_buffs.resize(num_packets_to_recv);
+            }
+        }
+
+        uhd::rx_metadata_t stop_metadata;
+        const size_t num_packets =
+            _zero_copy_streamer.get_bulk_recv_buffs(_bulk_in_buffs,
+                packet_infos,
+                num_packets_to_recv,
+                metadata,
+                stop_metadata,
+                timeout_ms);
+
+        // Errors that occur after the first packet are returned on the next
+        // call, like recv does for multi-packet reads
+        if (num_packets != 0
+            && stop_metadata.error_code != rx_metadata_t::ERROR_CODE_NONE) {
+            _error_metadata_cache.store(stop_metadata);
+        }
+
+        // Convert all packets of one channel before moving on to the next one
+        for (size_t chan = 0; chan < get_num_channels(); chan++) {
+            char* out = reinterpret_cast<char*>(buffs[chan]);
+            for (size_t pkt = 0; pkt < num_packets; pkt++) {
+                _converters[chan].conv(_bulk_in_buffs[chan][pkt],
+                    out + packet_infos[pkt].offset * _convert_info.bytes_per_cpu_item,
+                    packet_infos[pkt].num_samps);
+            }
+        }
+        _zero_copy_streamer.release_bulk_recv_buffs();
+
+        for (size_t pkt = 0; pkt < num_packets; pkt++) {
+            metadata.end_of_burst |= packet_infos[pkt].end_of_burst;
+        }
+
+        return num_packets;
+    }
+
+    //! Implementation of rx_streamer API method
+    bool supports_recv_view() const
+    {
+        return _recv_view && _channel_streamers.empty();
+    }
+
+    //! Implementation of rx_streamer API method
+    size_t recv_view(
+        uhd::rx_view_t& view, uhd::rx_metadata_t& metadata, const double timeout)
+    {
+        if (!_recv_view) {
+            throw uhd::not_implemented_error(
+                "recv_view() requires the cpu_format to match the otw_format");
+        }
+        _check_aligned();
+        if (_error_metadata_cache.check(metadata)) {
+            return 0;
+        }
+
+        if (_buff_samps_remaining == 0) {
+            detail::eov_data_wrapper eov_positions(metadata);
+            _buff_samps_remaining = _zero_copy_streamer.get_recv_buffs(
+                _in_buffs, metadata, eov_positions, static_cast<int32_t>(timeout * 1000));
+            if (_buff_samps_remaining == 0) {
+                return 0;
+            }
+            metadata.more_fragments  = false;
+            metadata.fragment_offset = 0;
+        } else {
+            // Lend out the rest of a packet that recv() only read partially
+            metadata = _last_fragment_metadata;
+            metadata.time_spec += time_spec_t::from_ticks(
+                _fragment_offset_in_samps - metadata.fragment_offset, _samp_rate);
+            metadata.more_fragments  = false;
+            metadata.fragment_offset = _fragment_offset_in_samps;
+        }
+
+        view.buffs.assign(_in_buffs.begin(), _in_buffs.end());
+        view.num_samps        = _buff_samps_remaining;
+        view.handle           = _zero_copy_streamer.lend_recv_buffs();
+        _buff_samps_remaining = 0;
+        return view.num_samps;
+    }
+
+    //! Implementation of rx_streamer API method
+    void release_view(uhd::rx_view_t& view)
+    {
+        _check_aligned();
+        _zero_copy_streamer.release_lent_recv_buffs(view.handle);
+        view.buffs.clear();
+        view.num_samps = 0;
+    }
+
+    //! Implementation of rx_streamer API method
+    rx_streamer::sptr get_channel_streamer(const size_t chan)
+    {
+        if (_channel_streamers.empty()) {
+            throw uhd::not_implemented_error(
+                "get_channel_streamer() requires the independent_channels stream arg");
+        }
+        if (chan >= _channel_streamers.size()) {
+            throw uhd::index_error("Channel index beyond the number of streamer ports");
+        }
+        return _channel_streamers[chan];
+    }
+
 protected:
+    /*! Disconnects the channel streamers from this streamer
+     *
+     * The channel streamers may outlive this streamer. Once detached, their
+     * stream commands throw and their overruns are ignored. Derived classes
+     * that override issue_channel_stream_cmd() call this from their destructor,
+     * so the channel streamers can't call into a partially destroyed object.
+     */
+    void _detach_channel_streamers()
+    {
+        if (_parent_link) {
+            std::lock_guard<std::mutex> lock(_parent_link->mutex);
+            _parent_link->parent = nullptr;
+        }
+    }
+
+    //! Returns true if the channels are received by separate channel streamers
+    bool has_independent_channels() const
+    {
+        return !_channel_streamers.empty();
+    }
+
+    /*! Issues a stream command to a single channel
+     *
+     * Called by the channel streamers when the streamer has independent
+     * channels. Streamers that support independent channels must override
+     * this.
+     */
+    virtual void issue_channel_stream_cmd(
+        const size_t /*chan*/, const stream_cmd_t& /*stream_cmd*/)
+    {
+        throw uhd::not_implemented_error(
+            "This streamer does not support per-channel stream commands");
+    }
+
     //! Configures scaling factor for conversion
     void set_scale_factor(const size_t chan, const double scale_factor)
     {
-        _converters[chan]->set_scalar(scale_factor);
+        _converters[chan].set_scalar(scale_factor);
+        if (!_channel_streamers.empty()) {
+            _channel_streamers[chan]->set_scale_factor(0, scale_factor);
+        }
     }
 
     //! Returns the maximum payload size
@@ -207,6 +429,9 @@ protected:
     {
         _mtu = mtu;
         _spp = _mtu / _convert_info.bytes_per_otw_item;
+        for (auto& chan_streamer : _channel_streamers) {
+            chan_streamer->set_mtu(mtu);
+        }
     }
 
     //! Configures sample rate for conversion of timestamp
@@ -214,30 +439,57 @@ protected:
     {
         _samp_rate = rate;
         _zero_copy_streamer.set_samp_rate(rate);
+        for (auto& chan_streamer : _channel_streamers) {
+            chan_streamer->set_samp_rate(rate);
+        }
     }
 
     //! Configures tick rate for conversion of timestamp
     void set_tick_rate(const double rate)
     {
         _zero_copy_streamer.set_tick_rate(rate);
+        for (auto& chan_streamer : _channel_streamers) {
+            chan_streamer->set_tick_rate(rate);
+        }
     }
 
     //! Notifies the streamer that an overrun has occured
     void set_stopped_due_to_overrun()
     {
+        // With independent channels, the overrun handler is called once all
+        // channels have read the packets buffered before the overrun
+        _num_overrun_channels = _channel_streamers.size();
+        for (auto& chan_streamer : _channel_streamers) {
+            chan_streamer->set_stopped_due_to_overrun();
+        }
         _zero_copy_streamer.set_stopped_due_to_overrun();
     }
 
-    //! Notifies the streamer that an overrun has occured
+    //! Notifies the streamer that a late command has occured
     void set_stopped_due_to_late_command()
     {
+        for (auto& chan_streamer : _channel_streamers) {
+            chan_streamer->set_stopped_due_to_late_command();
+        }
         _zero_copy_streamer.set_stopped_due_to_late_command();
     }
 
+    //! Notifies the streamer that a late command has occured on a channel. With
+    //! aligned channels, this affects all channels.
+    void set_stopped_due_to_late_command(const size_t chan)
+    {
+        if (_channel_streamers.empty()) {
+            _zero_copy_streamer.set_stopped_due_to_late_command();
+        } else {
+            _channel_streamers.at(chan)->set_stopped_due_to_late_command();
+        }
+    }
+
     //! Provides a callback to handle overruns
     void set_overrun_handler(
         typename rx_streamer_zero_copy<transport_t>::overrun_handler_t handler)
     {
+        _overrun_handler = handler;
         _zero_copy_streamer.set_overrun_handler(handler);
     }
 
@@ -250,6 +502,28 @@ private:
         size_t otw_item_bit_width;
     };
 
+    //! Throws if the channels are received by separate channel streamers
+    UHD_FORCE_INLINE void _check_aligned() const
+    {
+        if (!_channel_streamers.empty()) {
+            throw uhd::runtime_error("This streamer has independent channels, receive "
+                                     "through get_channel_streamer() instead");
+        }
+    }
+
+    //! Called by the channel streamers when they have handled an overrun
+    void _handle_channel_overrun()
+    {
+        size_t num_channels = _num_overrun_channels.load();
+        while (num_channels != 0
+               && !_num_overrun_channels.compare_exchange_weak(
+                   num_channels, num_channels - 1)) {
+        }
+        if (num_channels == 1 && _overrun_handler) {
+            _overrun_handler();
+        }
+    }
+
     //! Receive a single packet
     UHD_FORCE_INLINE size_t _recv_one_packet(const uhd::rx_streamer::buffs_type& buffs,
         const size_t nsamps_per_buff,
@@ -277,8 +551,7 @@ private:
             // Convert samples to the streamer's output format
             for (size_t i = 0; i < get_num_channels(); i++) {
                 char* b = reinterpret_cast<char*>(buffs[i]);
-                const uhd::rx_streamer::buffs_type out_buffs(b + buffer_offset_bytes);
-                _convert_to_out_buff(out_buffs, i, num_samps);
+                _convert_to_out_buff(b + buffer_offset_bytes, i, num_samps);
             }
 
             _buff_samps_remaining -= num_samps;
@@ -300,13 +573,11 @@ private:
 
     //! Convert samples for one channel into its buffer
     UHD_FORCE_INLINE void _convert_to_out_buff(
-        const uhd::rx_streamer::buffs_type& out_buffs,
-        const size_t chan,
-        const size_t num_samps)
+        void* out_buff, const size_t chan, const size_t num_samps)
     {
         const char* buffer_ptr = reinterpret_cast<const char*>(_in_buffs[chan]);
 
-        _converters[chan]->conv(buffer_ptr, out_buffs, num_samps);
+        _converters[chan].conv(buffer_ptr, out_buff, num_samps);
 
         // Advance the pointer for the source buffer
         _in_buffs[chan] =
@@ -350,8 +621,8 @@ private:
         _convert_info = info;
 
         for (size_t i = 0; i < num_ports; i++) {
-            _converters.push_back(convert::get_converter(id)());
-            _converters.back()->set_scalar(1 / 32767.0);
+            _converters.emplace_back(id);
+            _converters.back().set_scalar(1 / 32767.0);
         }
     }
 
@@ -359,7 +630,10 @@ private:
     convert_info _convert_info;
 
     // Converters
-    std::vector<uhd::convert::converter::sptr> _converters;
+    std::vector<uhd::convert::inline_converter> _converters;
+
+    // Whether packets can be lent out with recv_view
+    bool _recv_view = false;
 
     // Implementation of frame buffer management and packet info
     rx_streamer_zero_copy<transport_t, ignore_seq_err> _zero_copy_streamer;
@@ -367,6 +641,10 @@ private:
     // Container for buffer pointers used in recv method
     std::vector<const void*> _in_buffs;
 
+    // Container for buffer pointers used in recv_bulk method, indexed
+    // [channel][packet]
+    std::vector<std::vector<const void*>> _bulk_in_buffs;
+
     // Sample rate used to calculate metadata time_spec_t
     double _samp_rate = 1.0;
 
@@ -385,6 +663,61 @@ private:
     // Fragment (partially read packet) information
     size_t _fragment_offset_in_samps = 0;
     rx_metadata_t _last_fragment_metadata;
+
+    // Reference from the channel streamers to this streamer, which is cleared
+    // when this streamer is destroyed
+    struct parent_link_t
+    {
+        std::mutex mutex;
+        rx_streamer_impl* parent = nullptr;
+    };
+    std::shared_ptr<parent_link_t> _parent_link;
+
+    // Streamers of the individual channels, if the channels are independent
+    std::vector<std::shared_ptr<channel_streamer>> _channel_streamers;
+
+    // Callback for overruns
+    typename rx_streamer_zero_copy<transport_t>::overrun_handler_t _overrun_handler;
+
+    // Number of channel streamers that have yet to handle an overrun
+    std::atomic<size_t> _num_overrun_channels{0};
+};
+
+/*!
+ * Streamer for a single channel of a streamer with independent channels
+ */
+template <typename transport_t, bool ignore_seq_err>
+class rx_streamer_impl<transport_t, ignore_seq_err>::channel_streamer
+    : public rx_streamer_impl<transport_t, ignore_seq_err>
+{
+public:
+    channel_streamer(std::shared_ptr<parent_link_t> parent_link,
+        const size_t chan,
+        const uhd::stream_args_t& stream_args)
+        : rx_streamer_impl(1, stream_args), _parent_link(parent_link), _chan(chan)
+    {
+        this->set_overrun_handler([link = parent_link]() {
+            std::lock_guard<std::mutex> lock(link->mutex);
+            if (link->parent) {
+                link->parent->_handle_channel_overrun();
+            }
+        });
+    }
+
+    void issue_stream_cmd(const stream_cmd_t& stream_cmd)
+    {
+        std::lock_guard<std::mutex> lock(_parent_link->mutex);
+        if (!_parent_link->parent) {
+            throw uhd::runtime_error(
+                "Cannot issue a stream command, the streamer of this channel was "
+                "destroyed");
+        }
+        _parent_link->parent->issue_channel_stream_cmd(_chan, stream_cmd);
+    }
+
+private:
+    std::shared_ptr<parent_link_t> _parent_link;
+    const size_t _chan;
 };
 
 }} // namespace uhd::transport
@@ -14,6 +14,7 @@
 #include <uhdlib/transport/get_aligned_buffs.hpp>
 #include <boost/format.hpp>
 #include <atomic>
+#include <limits>
 #include <vector>
 
 namespace uhd { namespace transport {
@@ -94,12 +95,20 @@ public:
         : _xports(num_ports)
         , _frame_buffs(num_ports)
         , _infos(num_ports)
+        , _bulk_frame_buffs(num_ports)
+        , _bulk_payloads(num_ports)
         , _get_aligned_buffs(_xports, _frame_buffs, _infos)
     {
     }
 
     ~rx_streamer_zero_copy()
     {
+        release_bulk_recv_buffs();
+        for (size_t handle = 0; handle < _lent_frame_buffs.size(); handle++) {
+            if (_lent_frame_buffs[handle][0]) {
+                release_lent_recv_buffs(handle);
+            }
+        }
         for (size_t i = 0; i < _frame_buffs.size(); i++) {
             if (_frame_buffs[i]) {
                 _xports[i]->release_recv_buff(std::move(_frame_buffs[i]));
@@ -120,7 +129,8 @@ public:
                 "Streamer port number is already connected to a port");
         }
 
-        _xports[port] = std::move(xport);
+        _num_recv_frames = std::min(_num_recv_frames, xport->get_num_recv_frames());
+        _xports[port]    = std::move(xport);
     }
 
     //! Returns number of channels handled by this streamer
@@ -209,6 +219,12 @@ public:
 
         metadata.reset();
 
+        // The links would have no frame to receive into
+        if (_num_lent_buffs + _bulk_frame_buffs[0].size() >= _num_recv_frames) {
+            throw uhd::runtime_error(
+                "All receive buffers of the streamer are held, release some first");
+        }
+
         // Try to get buffs with a 0 timeout first. This avoids needing to check
         // if radios are stopped due to overrun when packets are available.
         auto result = _get_aligned_buffs(0);
@@ -283,6 +299,127 @@ public:
         return _last_read_time_info.num_samps;
     }
 
+    /*!
+     * Gets up to max_num_packets sets of time-aligned buffers, one buffer per
+     * channel in each set. Only the first set is waited for, the rest are
+     * only acquired if already available. Acquisition stops after a packet
+     * with end-of-burst set. The buffers are held until
+     * release_bulk_recv_buffs() is called.
+     *
+     * \param buffs returns the payload pointers, indexed [channel][packet]
+     * \param packet_infos returns the metadata of each packet
+     * \param max_num_packets maximum number of packets per channel
+     * \param metadata returns the metadata of the first packet, or the error
+     *        if no packets could be acquired
+     * \param stop_metadata returns the error that ended acquisition after
+     *        the first packet, if any
+     * \param timeout_ms timeout in milliseconds for the first packet
+     * \return the number of packets acquired per channel
+     */
+    size_t get_bulk_recv_buffs(std::vector<std::vector<const void*>>& buffs,
+        rx_packet_info_t* packet_infos,
+        const size_t max_num_packets,
+        rx_metadata_t& metadata,
+        rx_metadata_t& stop_metadata,
+        const int32_t timeout_ms)
+    {
+        // EOV positions are reported per packet, so the wrapper stays empty
+        rx_metadata_t eov_metadata;
+        detail::eov_data_wrapper eov_positions(eov_metadata);
+
+        stop_metadata.reset();
+        size_t num_packets = 0;
+        size_t offset      = 0;
+        while (num_packets < max_num_packets) {
+            // Stop when the links have no frame left for another packet
+            if (num_packets != 0 && _num_lent_buffs + num_packets >= _num_recv_frames) {
+                break;
+            }
+            rx_metadata_t& md = (num_packets == 0) ? metadata : stop_metadata;
+            const size_t num_samps = get_recv_buffs(
+                _bulk_payloads, md, eov_positions, num_packets == 0 ? timeout_ms : 0);
+            if (num_samps == 0) {
+                break;
+            }
+
+            for (size_t chan = 0; chan < _xports.size(); chan++) {
+                buffs[chan][num_packets] = _bulk_payloads[chan];
+                _bulk_frame_buffs[chan].push_back(std::move(_frame_buffs[chan]));
+            }
+
+            auto& info         = packet_infos[num_packets];
+            info.offset        = offset;
+            info.num_samps     = num_samps;
+            info.has_time_spec = md.has_time_spec;
+            info.time_spec     = md.time_spec;
+            info.end_of_burst  = md.end_of_burst;
+            info.end_of_vector = _infos[0].eov;
+
+            offset += num_samps;
+            num_packets++;
+            if (md.end_of_burst) {
+                break;
+            }
+        }
+
+        return num_packets;
+    }
+
+    /*!
+     * Release all packets acquired by get_bulk_recv_buffs()
+     */
+    void release_bulk_recv_buffs()
+    {
+        for (size_t chan = 0; chan < _xports.size(); chan++) {
+            for (auto& buff : _bulk_frame_buffs[chan]) {
+                _xports[chan]->release_recv_buff(std::move(buff));
+            }
+            _bulk_frame_buffs[chan].clear();
+        }
+    }
+
+    /*!
+     * Lend out the buffers of the current packet, which were acquired by
+     * get_recv_buffs(). They are held until release_lent_recv_buffs() is
+     * called with the returned handle.
+     *
+     * \return a handle that identifies the lent buffers
+     */
+    size_t lend_recv_buffs()
+    {
+        size_t handle;
+        if (_free_lent_handles.empty()) {
+            handle = _lent_frame_buffs.size();
+            _lent_frame_buffs.emplace_back(_xports.size());
+        } else {
+            handle = _free_lent_handles.back();
+            _free_lent_handles.pop_back();
+        }
+        for (size_t chan = 0; chan < _xports.size(); chan++) {
+            _lent_frame_buffs[handle][chan] = std::move(_frame_buffs[chan]);
+        }
+        _num_lent_buffs++;
+        return handle;
+    }
+
+    /*!
+     * Release the buffers lent out by lend_recv_buffs()
+     *
+     * \param handle the handle returned by lend_recv_buffs()
+     */
+    void release_lent_recv_buffs(const size_t handle)
+    {
+        if (handle >= _lent_frame_buffs.size() || !_lent_frame_buffs[handle][0]) {
+            throw uhd::value_error("Releasing receive buffers that are not lent out");
+        }
+        for (size_t chan = 0; chan < _xports.size(); chan++) {
+            _xports[chan]->release_recv_buff(std::move(_lent_frame_buffs[handle][chan]));
+            _lent_frame_buffs[handle][chan] = typename transport_t::buff_t::uptr();
+        }
+        _free_lent_handles.push_back(handle);
+        _num_lent_buffs--;
+    }
+
     /*!
      * Release the packet for the specified channel
      *
@@ -354,6 +491,23 @@ private:
     // Packet info corresponding to the packets in flight
     std::vector<typename transport_t::packet_info_t> _infos;
 
+    // Storage for buffers acquired by get_bulk_recv_buffs, per channel
+    std::vector<std::vector<typename transport_t::buff_t::uptr>> _bulk_frame_buffs;
+
+    // Scratch space for the payload pointers of one set of bulk buffers
+    std::vector<const void*> _bulk_payloads;
+
+    // Storage for buffers lent out by lend_recv_buffs(), indexed
+    // [handle][channel]. Unused handles are kept in _free_lent_handles.
+    std::vector<std::vector<typename transport_t::buff_t::uptr>> _lent_frame_buffs;
+    std::vector<size_t> _free_lent_handles;
+
+    // Number of sets of buffers lent out
+    size_t _num_lent_buffs = 0;
+
+    // Smallest number of frames any transport can hold at once
+    size_t _num_recv_frames = std::numeric_limits<size_t>::max();
+
     // Rate used in conversion of timestamp to time_spec_t
     double _tick_rate = 1.0;
 
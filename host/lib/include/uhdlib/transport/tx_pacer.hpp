@@ -0,0 +1,182 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_TRANSPORT_TX_PACER_HPP
+#define INCLUDED_LIBUHD_TRANSPORT_TX_PACER_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/stream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace uhd { namespace transport {
+
+/*!
+ * Software pacing for the packets of a tx streamer.
+ *
+ * Without pacing, the streamer sends packets as fast as the flow control
+ * credit allows, i.e., at line rate until the device buffer is full. When
+ * several devices share an uplink, these bursts can overflow the buffers of
+ * switches. The pacer spreads the packets of a burst out to a configured
+ * rate, with a token bucket of a configurable depth: Up to the given number
+ * of packets may be sent back-to-back, after that, every packet has to wait
+ * for the tokens of its samples.
+ *
+ * Packets are delayed by sleeping for the bulk of the wait and busy-waiting
+ * for the rest. The busy-wait time is calibrated to the sleep overshoot of
+ * the system, so the delays are accurate to the resolution of the clock
+ * without spinning for the whole gap.
+ *
+ * The pacer also measures the achieved gaps between the packets of a burst.
+ */
+class tx_pacer
+{
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    //! Statistics of the gaps between consecutive packets of a burst
+    using stats_t = uhd::tx_streamer::pacing_stats_t;
+
+    //! Return true if pacing is enabled
+    bool is_enabled() const
+    {
+        return _rate > 0.0;
+    }
+
+    /*! Set the rate to which the packets are paced
+     *
+     * \param rate The rate in items per second. Zero disables pacing.
+     */
+    void set_rate(const double rate)
+    {
+        _rate = rate;
+        if (is_enabled() && _spin_time == clock_t::duration::max()) {
+            _calibrate();
+        }
+    }
+
+    //! Set the number of packets which may be sent back-to-back
+    void set_burst_size(const size_t num_packets)
+    {
+        _burst_size = std::max<size_t>(num_packets, 1);
+    }
+
+    /*!
+     * Wait until the next packet may be sent, and account for it
+     *
+     * \param nitems The number of items in the packet
+     */
+    UHD_FORCE_INLINE void pace(const size_t nitems)
+    {
+        const clock_t::duration interval = std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(nitems / _rate));
+        const clock_t::duration bucket_depth =
+            interval * static_cast<clock_t::rep>(_burst_size - 1);
+
+        if (_in_burst) {
+            _wait_until(_next_time);
+        }
+        const clock_t::time_point now = clock_t::now();
+
+        if (_in_burst) {
+            const double gap = std::chrono::duration<double>(now - _last_time).count();
+            std::lock_guard<std::mutex> lock(_stats_mutex);
+            if (_stats.num_gaps == 0) {
+                _stats.min_gap = gap;
+                _stats.max_gap = gap;
+            } else {
+                _stats.min_gap = std::min(_stats.min_gap, gap);
+                _stats.max_gap = std::max(_stats.max_gap, gap);
+            }
+            _stats.num_gaps++;
+            _sum_gap += gap;
+            _sum_target_gap += std::chrono::duration<double>(_last_interval).count();
+            // Unused tokens accumulate up to the depth of the bucket
+            _next_time = std::max(_next_time, now - bucket_depth);
+        } else {
+            // A new burst starts with a full bucket
+            _next_time = now - bucket_depth;
+        }
+        _next_time += interval;
+
+        _last_time     = now;
+        _last_interval = interval;
+        _in_burst      = true;
+    }
+
+    //! Mark the end of a burst. The gap to the next packet is not measured,
+    //  and the bucket is full again for the next burst.
+    void end_burst()
+    {
+        _in_burst = false;
+    }
+
+    //! Return the gap statistics. May be called while another thread paces.
+    stats_t get_stats() const
+    {
+        std::lock_guard<std::mutex> lock(_stats_mutex);
+        stats_t stats = _stats;
+        if (stats.num_gaps > 0) {
+            stats.avg_gap        = _sum_gap / stats.num_gaps;
+            stats.avg_target_gap = _sum_target_gap / stats.num_gaps;
+        }
+        return stats;
+    }
+
+private:
+    UHD_FORCE_INLINE void _wait_until(const clock_t::time_point time)
+    {
+        clock_t::time_point now = clock_t::now();
+        if (now < time && time - now > _spin_time) {
+            std::this_thread::sleep_for(time - now - _spin_time);
+        }
+        while (clock_t::now() < time) {
+        }
+    }
+
+    //! Determine how long before the end of a wait to stop sleeping. This is
+    //  the largest overshoot of a short sleep, plus some margin.
+    void _calibrate()
+    {
+        constexpr size_t NUM_SLEEPS = 10;
+        const auto sleep_time       = std::chrono::microseconds(10);
+        clock_t::duration max_overshoot(0);
+        for (size_t i = 0; i < NUM_SLEEPS; i++) {
+            const clock_t::time_point start = clock_t::now();
+            std::this_thread::sleep_for(sleep_time);
+            max_overshoot = std::max(max_overshoot, clock_t::now() - start - sleep_time);
+        }
+        _spin_time = 2 * max_overshoot;
+    }
+
+    //! The rate in items per second, or zero if pacing is disabled
+    double _rate = 0.0;
+    //! The depth of the token bucket in packets
+    size_t _burst_size = 1;
+    //! The time before the end of a wait during which we busy-wait
+    clock_t::duration _spin_time = clock_t::duration::max();
+
+    //! True if the last packet was not the end of a burst
+    bool _in_burst = false;
+    //! The earliest time at which the next packet may be sent
+    clock_t::time_point _next_time;
+    //! The time at which the last packet was sent, and its interval
+    clock_t::time_point _last_time;
+    clock_t::duration _last_interval;
+
+    //! Protects the statistics, which are read by other threads
+    mutable std::mutex _stats_mutex;
+    stats_t _stats;
+    double _sum_gap        = 0.0;
+    double _sum_target_gap = 0.0;
+};
+
+}} // namespace uhd::transport
+
+#endif /* INCLUDED_LIBUHD_TRANSPORT_TX_PACER_HPP */
@@ -11,7 +11,10 @@
 #include <uhd/convert.hpp>
 #include <uhd/stream.hpp>
 #include <uhd/types/metadata.hpp>
+#include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
+#include <uhdlib/convert/inline_converter.hpp>
+#include <uhdlib/transport/tx_pacer.hpp>
 #include <uhdlib/transport/tx_streamer_zero_copy.hpp>
 #include <limits>
 #include <vector>
@@ -116,11 +119,35 @@ public:
             _spp = stream_args.args.cast<size_t>("spp", _spp);
             _mtu = _spp * _convert_info.bytes_per_otw_item;
         }
+
+        if (stream_args.args.has_key("tx_pacing")) {
+            _pacing_factor = stream_args.args.cast<double>("tx_pacing", 0.0);
+            if (_pacing_factor <= 0.0) {
+                throw uhd::value_error("tx_pacing must be a positive factor");
+            }
+            _pacer.set_burst_size(
+                stream_args.args.cast<size_t>("tx_pacing_burst", size_t(1)));
+        }
+    }
+
+    ~tx_streamer_impl()
+    {
+        if (_pacer.is_enabled()) {
+            const auto stats = _pacer.get_stats();
+            if (stats.num_gaps > 0) {
+                UHD_LOG_DEBUG("STREAMER",
+                    "TX pacing: " << stats.num_gaps << " gaps, min/avg/max "
+                                  << stats.min_gap * 1e6 << "/" << stats.avg_gap * 1e6
+                                  << "/" << stats.max_gap * 1e6 << " us, target "
+                                  << stats.avg_target_gap * 1e6 << " us");
+            }
+        }
     }
 
     virtual void connect_channel(const size_t channel, typename transport_t::uptr xport)
     {
         const size_t mtu = xport->get_max_payload_size();
+        _gather_send     = _gather_send && xport->supports_send_gather();
         _zero_copy_streamer.connect_channel(channel, std::move(xport));
 
         if (mtu < _mtu) {
@@ -147,6 +174,74 @@ public:
     }
 
     size_t send(const uhd::tx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        const uhd::tx_metadata_t& metadata,
+        const double timeout)
+    {
+        const size_t nsamps_sent = _send(buffs, nsamps_per_buff, metadata, timeout);
+        // Links may hold back packets to send them in batches. No more packets
+        // follow before the next call, so they need to go out now.
+        _zero_copy_streamer.flush_send_buffs();
+        return nsamps_sent;
+    }
+
+    pacing_stats_t get_pacing_stats(void) const
+    {
+        return _pacer.get_stats();
+    }
+
+protected:
+    //! Returns the tick rate for conversion of timestamp
+    double get_tick_rate() const
+    {
+        return _zero_copy_streamer.get_tick_rate();
+    }
+
+    //! Returns the maximum payload size
+    size_t get_mtu() const
+    {
+        return _mtu;
+    }
+
+    //! Sets the MTU and calculates spp
+    void set_mtu(const size_t mtu)
+    {
+        _mtu = mtu;
+        _spp = _mtu / _convert_info.bytes_per_otw_item;
+    }
+
+    //! Configures scaling factor for conversion
+    void set_scale_factor(const size_t chan, const double scale_factor)
+    {
+        _converters[chan].set_scalar(scale_factor);
+    }
+
+    //! Configures sample rate for conversion of timestamp and pacing
+    void set_samp_rate(const double rate)
+    {
+        _samp_rate = rate;
+        if (_pacing_factor > 0.0) {
+            _pacer.set_rate(_pacing_factor * rate);
+        }
+    }
+
+    //! Configures tick rate for conversion of timestamp
+    void set_tick_rate(const double rate)
+    {
+        _zero_copy_streamer.set_tick_rate(rate);
+    }
+
+private:
+    //! Converter and associated item sizes
+    struct convert_info
+    {
+        size_t bytes_per_otw_item;
+        size_t bytes_per_cpu_item;
+        size_t otw_item_bit_width;
+    };
+
+    //! Send the samples of a send() call
+    size_t _send(const uhd::tx_streamer::buffs_type& buffs,
         const size_t nsamps_per_buff,
         const uhd::tx_metadata_t& metadata_,
         const double timeout)
@@ -313,53 +408,6 @@ public:
         return total_nsamps_sent;
     }
 
-protected:
-    //! Returns the tick rate for conversion of timestamp
-    double get_tick_rate() const
-    {
-        return _zero_copy_streamer.get_tick_rate();
-    }
-
-    //! Returns the maximum payload size
-    size_t get_mtu() const
-    {
-        return _mtu;
-    }
-
-    //! Sets the MTU and calculates spp
-    void set_mtu(const size_t mtu)
-    {
-        _mtu = mtu;
-        _spp = _mtu / _convert_info.bytes_per_otw_item;
-    }
-
-    //! Configures scaling factor for conversion
-    void set_scale_factor(const size_t chan, const double scale_factor)
-    {
-        _converters[chan]->set_scalar(scale_factor);
-    }
-
-    //! Configures sample rate for conversion of timestamp
-    void set_samp_rate(const double rate)
-    {
-        _samp_rate = rate;
-    }
-
-    //! Configures tick rate for conversion of timestamp
-    void set_tick_rate(const double rate)
-    {
-        _zero_copy_streamer.set_tick_rate(rate);
-    }
-
-private:
-    //! Converter and associated item sizes
-    struct convert_info
-    {
-        size_t bytes_per_otw_item;
-        size_t bytes_per_cpu_item;
-        size_t otw_item_bit_width;
-    };
-
     //! Convert samples for one channel and sends a packet
     size_t _send_one_packet(const uhd::tx_streamer::buffs_type& buffs,
         const size_t buffer_offset_in_samps,
@@ -377,9 +425,25 @@ private:
 
         size_t byte_offset = buffer_offset_in_samps * _convert_info.bytes_per_cpu_item;
 
+        if (_pacer.is_enabled()) {
+            _pace(num_samples, metadata.end_of_burst);
+        }
+
+        if (_gather_send) {
+            // The caller's samples are already in the wire format, so the link
+            // sends them straight from the caller's buffers
+            const size_t payload_bytes = num_samples * _convert_info.bytes_per_otw_item;
+            for (size_t i = 0; i < get_num_channels(); i++) {
+                const void* input_ptr =
+                    static_cast<const uint8_t*>(buffs[i]) + byte_offset;
+                _zero_copy_streamer.release_send_buff(i, input_ptr, payload_bytes);
+            }
+            return num_samples;
+        }
+
         for (size_t i = 0; i < get_num_channels(); i++) {
             const void* input_ptr = static_cast<const uint8_t*>(buffs[i]) + byte_offset;
-            _converters[i]->conv(input_ptr, _out_buffs[i], num_samples);
+            _converters[i].conv(input_ptr, _out_buffs[i], num_samples);
 
             _zero_copy_streamer.release_send_buff(i);
         }
@@ -387,6 +451,17 @@ private:
         return num_samples;
     }
 
+    //! Wait for the turn of the next packet. Links must not hold back paced
+    //  packets, so the previous packet is flushed first.
+    void _pace(const size_t num_samples, const bool eob)
+    {
+        _zero_copy_streamer.flush_send_buffs();
+        _pacer.pace(num_samples);
+        if (eob) {
+            _pacer.end_burst();
+        }
+    }
+
     //! Create converters and initialize _bytes_per_cpu_item
     void _setup_converters(const size_t num_chans, const uhd::stream_args_t stream_args)
     {
@@ -418,9 +493,14 @@ private:
 
         _convert_info = info;
 
+        // CHDR converters between identical formats are plain copies (the
+        // endianness is adapted in the FPGA), so the payload can be sent
+        // directly from the caller's buffers if all transports support it.
+        _gather_send = (stream_args.cpu_format == stream_args.otw_format);
+
         for (size_t i = 0; i < num_chans; i++) {
-            _converters.push_back(convert::get_converter(id)());
-            _converters.back()->set_scalar(32767.0);
+            _converters.emplace_back(id);
+            _converters.back().set_scalar(32767.0);
         }
     }
 
@@ -428,7 +508,10 @@ private:
     convert_info _convert_info;
 
     // Converters
-    std::vector<uhd::convert::converter::sptr> _converters;
+    std::vector<uhd::convert::inline_converter> _converters;
+
+    // Send payloads from the caller's buffers instead of converting them
+    bool _gather_send = false;
 
     // Manages frame buffers and packet info
     tx_streamer_zero_copy<transport_t> _zero_copy_streamer;
@@ -452,6 +535,12 @@ private:
 
     // Metadata cache for send calls with no data
     detail::tx_metadata_cache _metadata_cache;
+
+    // Pacing rate relative to the sample rate, or zero if pacing is disabled
+    double _pacing_factor = 0.0;
+
+    // Spreads the packets of a burst to the pacing rate
+    tx_pacer _pacer;
 };
 
 }} // namespace uhd::transport
@@ -133,6 +133,38 @@ public:
         _frame_buffs[channel].second = 0;
     }
 
+    /*!
+     * Send the packet for the specified channel, with the payload taken
+     * directly from caller-owned memory rather than from the frame buffer.
+     * The frame buffer only holds the packet header. The transport must
+     * support gather sends.
+     *
+     * \param channel the channel for which to release the packet
+     * \param payload pointer to the wire-formatted payload
+     * \param payload_bytes size of the payload in bytes
+     */
+    UHD_FORCE_INLINE void release_send_buff(
+        const size_t channel, const void* payload, const size_t payload_bytes)
+    {
+        auto& buff = _frame_buffs[channel];
+        buff.first->set_packet_size(buff.second - payload_bytes);
+        buff.first->set_gather_payload(payload, payload_bytes);
+        _xports[channel]->release_send_buff(std::move(buff.first));
+
+        buff.first  = nullptr;
+        buff.second = 0;
+    }
+
+    /*!
+     * Make sure the released packets of all channels leave the host
+     */
+    void flush_send_buffs()
+    {
+        for (auto& xport : _xports) {
+            xport->flush_send_buffs();
+        }
+    }
+
 private:
     // Transports for each channel
     std::vector<typename transport_t::uptr> _xports;
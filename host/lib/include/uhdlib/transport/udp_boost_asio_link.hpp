@@ -15,6 +15,7 @@
 #include <uhdlib/transport/links.hpp>
 #include <uhdlib/transport/udp_common.hpp>
 #include <boost/asio.hpp>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -23,10 +24,44 @@ namespace uhd { namespace transport {
 class udp_boost_asio_frame_buff : public frame_buff
 {
 public:
-    udp_boost_asio_frame_buff(void* mem)
+    static constexpr size_t NO_INDEX = ~size_t(0);
+
+    udp_boost_asio_frame_buff(void* mem) : _mem(mem)
     {
         _data = mem;
     }
+
+    /*!
+     * Point the frame buffer at other memory. With segmentation offload,
+     * frame buffers are not tied to memory.
+     */
+    void attach(void* mem, const size_t index)
+    {
+        _data  = mem;
+        _index = index;
+    }
+
+    void detach()
+    {
+        _data  = nullptr;
+        _index = NO_INDEX;
+    }
+
+    //! Index of the attached memory (send slot or receive chunk)
+    size_t get_index() const
+    {
+        return _index;
+    }
+
+    //! The memory the frame buffer was created with
+    void* get_own_mem() const
+    {
+        return _mem;
+    }
+
+private:
+    void* _mem;
+    size_t _index = NO_INDEX;
 };
 
 class udp_boost_asio_adapter_info : public adapter_info
@@ -66,12 +101,20 @@ public:
      * \param params Values for frame sizes, num frames, and buffer sizes
      * \param[out] recv_socket_buff_size Returns the recv socket buffer size
      * \param[out] send_socket_buff_size Returns the send socket buffer size
+     * \param enable_gso Batch sent packets of equal size, and send them with
+     *                   UDP generic segmentation offload (Linux only)
+     * \param enable_gro Receive with UDP generic receive offload, and split
+     *                   coalesced datagrams into frames (Linux only)
      */
     static sptr make(const std::string& addr,
         const std::string& port,
         const link_params_t& params,
         size_t& recv_socket_buff_size,
-        size_t& send_socket_buff_size);
+        size_t& send_socket_buff_size,
+        const bool enable_gso = false,
+        const bool enable_gro = false);
+
+    ~udp_boost_asio_link();
 
     /*! Return the local port of the UDP connection. Port is in host byte order.
      *
@@ -102,6 +145,40 @@ public:
         return _adapter_id;
     }
 
+    /*!
+     * Returns whether this link can send gather payloads
+     */
+    bool supports_send_gather() const
+    {
+#ifdef UHD_PLATFORM_WIN32
+        return false;
+#else
+        return true;
+#endif
+    }
+
+    /*!
+     * Send the packets held back for a GSO send
+     */
+    void flush_send_buffs()
+    {
+#ifdef UHD_PLATFORM_LINUX
+        _gso_flush();
+#endif
+    }
+
+    //! Returns whether sent packets are batched into GSO sends
+    bool is_gso_enabled() const
+    {
+        return _gso_max_segments > 0;
+    }
+
+    //! Returns whether received packets may be coalesced by GRO
+    bool is_gro_enabled() const
+    {
+        return _gro_enabled;
+    }
+
 private:
     using recv_link_base_t = recv_link_base<udp_boost_asio_link>;
     using send_link_base_t = send_link_base<udp_boost_asio_link>;
@@ -110,8 +187,11 @@ private:
     friend recv_link_base_t;
     friend send_link_base_t;
 
-    udp_boost_asio_link(
-        const std::string& addr, const std::string& port, const link_params_t& params);
+    udp_boost_asio_link(const std::string& addr,
+        const std::string& port,
+        const link_params_t& params,
+        const bool enable_gso,
+        const bool enable_gro);
 
     size_t resize_recv_socket_buffer(size_t num_bytes);
     size_t resize_send_socket_buffer(size_t num_bytes);
@@ -119,26 +199,234 @@ private:
     // Methods called by recv_link_base
     UHD_FORCE_INLINE size_t get_recv_buff_derived(frame_buff& buff, int32_t timeout_ms)
     {
+#ifdef UHD_PLATFORM_LINUX
+        // A response can't arrive for packets that are still held back, so
+        // send them before waiting. Polling leaves the batch intact.
+        if (timeout_ms != 0 && !_gso_slots.empty()) {
+            _gso_flush();
+        }
+        if (_gro_enabled) {
+            return _gro_get_recv_buff(
+                static_cast<udp_boost_asio_frame_buff&>(buff), timeout_ms);
+        }
+#endif
         return recv_udp_packet(_sock_fd, buff.data(), get_recv_frame_size(), timeout_ms);
     }
 
-    UHD_FORCE_INLINE void release_recv_buff_derived(frame_buff& /*buff*/)
+    UHD_FORCE_INLINE void release_recv_buff_derived(frame_buff& buff)
     {
-        // No-op
+#ifdef UHD_PLATFORM_LINUX
+        if (_gro_enabled) {
+            _gro_release_recv_buff(static_cast<udp_boost_asio_frame_buff&>(buff));
+        }
+#endif
     }
 
     // Methods called by send_link_base
     UHD_FORCE_INLINE bool get_send_buff_derived(
-        frame_buff& /*buff*/, int32_t /*timeout_ms*/)
+        frame_buff& buff, int32_t /*timeout_ms*/)
     {
+#ifdef UHD_PLATFORM_LINUX
+        auto& udp_buff = static_cast<udp_boost_asio_frame_buff&>(buff);
+        // A frame that was released without a packet keeps its slot
+        if (is_gso_enabled()
+            && udp_buff.get_index() == udp_boost_asio_frame_buff::NO_INDEX) {
+            if (_gso_free_slots.empty()) {
+                _gso_flush();
+            }
+            const size_t slot = _gso_free_slots.back();
+            _gso_free_slots.pop_back();
+            udp_buff.attach(_send_memory_pool->at(slot), slot);
+        }
+#endif
         return true;
     }
 
     UHD_FORCE_INLINE void release_send_buff_derived(frame_buff& buff)
     {
+#ifdef UHD_PLATFORM_LINUX
+        if (is_gso_enabled()) {
+            _gso_release_send_buff(static_cast<udp_boost_asio_frame_buff&>(buff));
+            return;
+        }
+#endif
+#ifndef UHD_PLATFORM_WIN32
+        if (buff.gather_payload()) {
+            send_udp_packet_gather(_sock_fd,
+                buff.data(),
+                buff.packet_size(),
+                buff.gather_payload(),
+                buff.gather_payload_size());
+            return;
+        }
+#endif
         send_udp_packet(_sock_fd, buff.data(), buff.packet_size());
     }
 
+#ifdef UHD_PLATFORM_LINUX
+    /**************************************************************************
+     * GSO: Released packets are held back in a batch, as long as they have the
+     * same size. Their memory is sent with a single system call once the batch
+     * is full, a packet of another size is released, or the caller flushes.
+     * Since frame buffers are reused right away, they are not tied to memory:
+     * each one gets a free send slot attached.
+     *************************************************************************/
+    UHD_FORCE_INLINE void _gso_release_send_buff(udp_boost_asio_frame_buff& buff)
+    {
+        const size_t slot = buff.get_index();
+        const size_t len  = buff.packet_size();
+        buff.detach();
+
+        // The caller owns a gather payload, so it must be sent right away
+        if (buff.gather_payload()) {
+            _gso_flush();
+            send_udp_packet_gather(_sock_fd,
+                _send_memory_pool->at(slot),
+                len,
+                buff.gather_payload(),
+                buff.gather_payload_size());
+            _gso_free_slots.push_back(slot);
+            return;
+        }
+
+        if (!_gso_slots.empty()
+            && (len > _gso_seg_size || _gso_bytes + len > UDP_MAX_GSO_BYTES)) {
+            _gso_flush();
+        }
+        if (_gso_slots.empty()) {
+            _gso_seg_size = len;
+        }
+        iovec iov;
+        iov.iov_base = _send_memory_pool->at(slot);
+        iov.iov_len  = len;
+        _gso_iovs.push_back(iov);
+        _gso_slots.push_back(slot);
+        _gso_bytes += len;
+
+        // Only the last segment may be shorter
+        if (len < _gso_seg_size || _gso_slots.size() >= _gso_max_segments
+            || _gso_bytes + _gso_seg_size > UDP_MAX_GSO_BYTES) {
+            _gso_flush();
+        }
+    }
+
+    void _gso_flush();
+
+    /**************************************************************************
+     * GRO: Datagrams are received into a circular arena. Every receive takes
+     * up to UDP_MAX_GSO_BYTES, and is tracked as a chunk. The coalesced
+     * datagrams of a chunk are handed out as frames without copying, and a
+     * chunk's memory is reused once all of its frames, and all chunks before
+     * it, are released.
+     *
+     * A frame that is held for long keeps all newer chunks from being reused.
+     * When the arena is full, datagrams are received into a bounce buffer
+     * behind the arena instead, and copied into the frame buffers' own memory.
+     *************************************************************************/
+    struct gro_chunk_t
+    {
+        size_t offset;
+        size_t size;
+        size_t num_frames;
+    };
+
+    UHD_FORCE_INLINE size_t _gro_get_recv_buff(
+        udp_boost_asio_frame_buff& buff, int32_t timeout_ms)
+    {
+        if (_gro_seg_offset == _gro_seg_end) {
+            const size_t reserved = _gro_reserve();
+            const size_t offset   = reserved == NO_SPACE ? _gro_arena_size : reserved;
+            size_t seg_size;
+            const size_t len = recv_udp_packets_gro(
+                _sock_fd, _gro_arena + offset, seg_size, timeout_ms);
+            if (len == 0) {
+                return 0;
+            }
+            _gro_seg_copy = reserved == NO_SPACE;
+            if (!_gro_seg_copy) {
+                gro_chunk_t& chunk = _gro_chunks[_gro_chunk_tail % _gro_chunks.size()];
+                chunk.offset       = offset;
+                chunk.size = (len + GRO_CHUNK_ALIGN - 1) & ~(GRO_CHUNK_ALIGN - 1);
+                chunk.num_frames = 0;
+                _gro_chunk_tail++;
+                _gro_arena_tail = offset + chunk.size;
+            }
+            _gro_seg_offset = offset;
+            _gro_seg_end    = offset + len;
+            _gro_seg_size   = seg_size;
+        }
+
+        if (_gro_seg_copy) {
+            const size_t len = std::min(_gro_seg_size, _gro_seg_end - _gro_seg_offset);
+            const size_t frame_len = std::min(len, get_recv_frame_size());
+            buff.attach(buff.get_own_mem(), udp_boost_asio_frame_buff::NO_INDEX);
+            std::memcpy(buff.get_own_mem(), _gro_arena + _gro_seg_offset, frame_len);
+            _gro_seg_offset += len;
+            return frame_len;
+        }
+
+        const size_t chunk_index = _gro_chunk_tail - 1;
+        _gro_chunks[chunk_index % _gro_chunks.size()].num_frames++;
+        buff.attach(_gro_arena + _gro_seg_offset, chunk_index);
+        const size_t len = std::min(_gro_seg_size, _gro_seg_end - _gro_seg_offset);
+        _gro_seg_offset += len;
+        return std::min(len, get_recv_frame_size());
+    }
+
+    UHD_FORCE_INLINE void _gro_release_recv_buff(udp_boost_asio_frame_buff& buff)
+    {
+        // Copied frames don't hold any chunk
+        if (buff.get_index() == udp_boost_asio_frame_buff::NO_INDEX) {
+            buff.detach();
+            return;
+        }
+        _gro_chunks[buff.get_index() % _gro_chunks.size()].num_frames--;
+        buff.detach();
+        // Reclaim the memory of the oldest chunks that have no frames left.
+        // The newest chunk may still have datagrams to hand out.
+        while (_gro_chunk_head != _gro_chunk_tail) {
+            const gro_chunk_t& chunk = _gro_chunks[_gro_chunk_head % _gro_chunks.size()];
+            if (chunk.num_frames != 0
+                || (_gro_chunk_head + 1 == _gro_chunk_tail && !_gro_seg_copy
+                       && _gro_seg_offset != _gro_seg_end)) {
+                break;
+            }
+            _gro_chunk_head++;
+        }
+        if (_gro_chunk_head == _gro_chunk_tail) {
+            _gro_arena_head = 0;
+            _gro_arena_tail = 0;
+        } else {
+            _gro_arena_head = _gro_chunks[_gro_chunk_head % _gro_chunks.size()].offset;
+        }
+    }
+
+    //! Returns the arena offset for the next receive, or NO_SPACE
+    UHD_FORCE_INLINE size_t _gro_reserve() const
+    {
+        const size_t num_chunks = _gro_chunk_tail - _gro_chunk_head;
+        if (num_chunks == 0) {
+            return 0;
+        }
+        if (num_chunks == _gro_chunks.size()) {
+            return NO_SPACE;
+        }
+        // The used part of the arena wraps around if the newest chunk is
+        // located before the oldest one
+        if (_gro_arena_tail > _gro_arena_head) {
+            if (_gro_arena_size - _gro_arena_tail >= UDP_MAX_GSO_BYTES) {
+                return _gro_arena_tail;
+            }
+            return _gro_arena_head >= UDP_MAX_GSO_BYTES ? 0 : NO_SPACE;
+        }
+        return _gro_arena_head - _gro_arena_tail >= UDP_MAX_GSO_BYTES ? _gro_arena_tail
+                                                                     : NO_SPACE;
+    }
+
+    static constexpr size_t NO_SPACE        = ~size_t(0);
+    static constexpr size_t GRO_CHUNK_ALIGN = 64;
+#endif
+
     buffer_pool::sptr _recv_memory_pool;
     buffer_pool::sptr _send_memory_pool;
 
@@ -149,6 +437,32 @@ private:
     std::shared_ptr<boost::asio::ip::udp::socket> _socket;
     int _sock_fd;
     adapter_id_t _adapter_id;
+
+    size_t _gso_max_segments = 0;
+    bool _gro_enabled        = false;
+
+#ifdef UHD_PLATFORM_LINUX
+    // GSO state, see _gso_release_send_buff()
+    std::vector<size_t> _gso_free_slots;
+    std::vector<size_t> _gso_slots;
+    std::vector<iovec> _gso_iovs;
+    size_t _gso_seg_size = 0;
+    size_t _gso_bytes    = 0;
+
+    // GRO state, see _gro_get_recv_buff()
+    buffer_pool::sptr _gro_arena_pool;
+    char* _gro_arena       = nullptr;
+    size_t _gro_arena_size = 0;
+    size_t _gro_arena_head = 0;
+    size_t _gro_arena_tail = 0;
+    std::vector<gro_chunk_t> _gro_chunks;
+    size_t _gro_chunk_head = 0;
+    size_t _gro_chunk_tail = 0;
+    size_t _gro_seg_offset = 0;
+    size_t _gro_seg_end    = 0;
+    size_t _gro_seg_size   = 0;
+    bool _gro_seg_copy     = false;
+#endif
 };
 
 }} // namespace uhd::transport
@@ -16,7 +16,15 @@
 #include <uhdlib/transport/links.hpp>
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
+#include <cstring>
 #include <thread>
+#ifndef UHD_PLATFORM_WIN32
+#    include <sys/socket.h>
+#    include <sys/uio.h>
+#endif
+#ifdef UHD_PLATFORM_LINUX
+#    include <netinet/udp.h>
+#endif
 
 namespace uhd { namespace transport {
 
@@ -145,6 +153,156 @@ UHD_INLINE void send_udp_packet(int sock_fd, void* mem, size_t len)
     }
 }
 
+#ifndef UHD_PLATFORM_WIN32
+/*!
+ * Sends a single datagram made up of two memory segments (typically a packet
+ * header and a payload) without first copying them into one buffer.
+ */
+UHD_INLINE void send_udp_packet_gather(
+    int sock_fd, void* hdr, size_t hdr_len, const void* pyld, size_t pyld_len)
+{
+    iovec iov[2];
+    iov[0].iov_base = hdr;
+    iov[0].iov_len  = hdr_len;
+    iov[1].iov_base = const_cast<void*>(pyld);
+    iov[1].iov_len  = pyld_len;
+
+    msghdr msg     = {};
+    msg.msg_iov    = iov;
+    msg.msg_iovlen = 2;
+
+    const size_t len = hdr_len + pyld_len;
+
+    // Same retry logic as send_udp_packet()
+    while (true) {
+        const ssize_t ret = ::sendmsg(sock_fd, &msg, 0);
+        if (ret == ssize_t(len))
+            break;
+        if (ret == -1 and errno == ENOBUFS) {
+            std::this_thread::sleep_for(std::chrono::microseconds(1));
+            continue; // try to send again
+        }
+        if (ret == -1) {
+            throw uhd::io_error(
+                str(boost::format("send error on socket: %s") % strerror(errno)));
+        }
+        UHD_ASSERT_THROW(ret == ssize_t(len));
+    }
+}
+#endif
+
+#ifdef UHD_PLATFORM_LINUX
+//! Largest UDP payload of an IPv4 datagram, which limits GSO sends and GRO
+//! receives
+constexpr size_t UDP_MAX_GSO_BYTES = 65507;
+
+//! Largest number of segments in a GSO send (older kernels allow no more)
+constexpr size_t UDP_MAX_GSO_SEGMENTS = 64;
+
+/*!
+ * Sends several datagrams with a single system call, using UDP generic
+ * segmentation offload (Linux 4.18 or newer). The kernel splits the memory
+ * segments, taken as one buffer, into datagrams of seg_size bytes. Only the
+ * last datagram may be shorter.
+ *
+ * \param sock_fd the open socket file descriptor
+ * \param iov memory segments to send
+ * \param iovlen number of memory segments
+ * \param len total number of bytes in the memory segments
+ * \param seg_size size of the datagrams
+ * \return false if the route does not support GSO (e.g. because the NIC
+ *         can't offload checksums), in which case nothing was sent
+ */
+UHD_INLINE bool send_udp_packets_gso(
+    int sock_fd, iovec* iov, size_t iovlen, size_t len, uint16_t seg_size)
+{
+    char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+    msghdr msg         = {};
+    msg.msg_iov        = iov;
+    msg.msg_iovlen     = iovlen;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg    = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type  = UDP_SEGMENT;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(uint16_t));
+    std::memcpy(CMSG_DATA(cmsg), &seg_size, sizeof(seg_size));
+
+    // Same retry logic as send_udp_packet()
+    while (true) {
+        const ssize_t ret = ::sendmsg(sock_fd, &msg, 0);
+        if (ret == ssize_t(len))
+            return true;
+        if (ret == -1 and errno == ENOBUFS) {
+            std::this_thread::sleep_for(std::chrono::microseconds(1));
+            continue; // try to send again
+        }
+        if (ret == -1 and (errno == EIO or errno == EINVAL)) {
+            return false;
+        }
+        if (ret == -1) {
+            throw uhd::io_error(
+                str(boost::format("send error on socket: %s") % strerror(errno)));
+        }
+        UHD_ASSERT_THROW(ret == ssize_t(len));
+    }
+}
+
+/*!
+ * Receives a datagram on a socket with UDP generic receive offload enabled
+ * (Linux 5.0 or newer). The kernel may coalesce consecutive datagrams of the
+ * same size into one. All of them but the last have seg_size bytes.
+ *
+ * \param sock_fd the open socket file descriptor
+ * \param mem memory to receive into, must hold at least UDP_MAX_GSO_BYTES
+ * \param[out] seg_size size of the coalesced datagrams, or the number of
+ *             received bytes if the datagram was not coalesced
+ * \param timeout_ms the timeout duration in milliseconds
+ * \return number of received bytes, 0 on timeout
+ */
+UHD_INLINE size_t recv_udp_packets_gro(
+    int sock_fd, void* mem, size_t& seg_size, int32_t timeout_ms)
+{
+    iovec iov;
+    iov.iov_base = mem;
+    iov.iov_len  = UDP_MAX_GSO_BYTES;
+
+    char control[CMSG_SPACE(sizeof(int))];
+    msghdr msg         = {};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t len = ::recvmsg(sock_fd, &msg, MSG_DONTWAIT);
+    if (len < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+        if (!wait_for_recv_ready(sock_fd, timeout_ms)) {
+            return 0; // timeout
+        }
+        msg.msg_controllen = sizeof(control);
+        len                = ::recvmsg(sock_fd, &msg, 0);
+    }
+    if (len == 0) {
+        throw uhd::io_error("socket closed");
+    }
+    if (len < 0) {
+        throw uhd::io_error(
+            str(boost::format("recv error on socket: %s") % strerror(errno)));
+    }
+
+    seg_size = len;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP and cmsg->cmsg_type == UDP_GRO) {
+            int gso_size;
+            std::memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+            seg_size = gso_size;
+        }
+    }
+    return len;
+}
+#endif /* UHD_PLATFORM_LINUX */
+
 template <typename Opt>
 size_t get_udp_socket_buffer_size(socket_sptr socket)
 {
@@ -0,0 +1,562 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_TRANSPORT_UDP_IO_URING_LINK_HPP
+#define INCLUDED_UHDLIB_TRANSPORT_UDP_IO_URING_LINK_HPP
+
+#include <uhd/config.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/transport/buffer_pool.hpp>
+#include <uhdlib/transport/link_base.hpp>
+#include <uhdlib/transport/links.hpp>
+#include <uhdlib/transport/udp_common.hpp>
+#include <boost/asio.hpp>
+#include <linux/io_uring.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace uhd { namespace transport {
+
+namespace detail {
+
+/*!
+ * Minimal io_uring instance: the submission and completion queues of one ring,
+ * mapped into user space
+ *
+ * Submission queue entries are filled in and published without system calls.
+ * System calls are only needed to submit entries when there is no kernel
+ * polling thread (or it went to sleep), and to wait for completions.
+ *
+ * Not thread-safe: each ring is used by one thread at a time.
+ */
+class io_uring_queue
+{
+public:
+    /*!
+     * Create the ring
+     *
+     * \param sq_entries Minimum number of submission queue entries
+     * \param cq_entries Minimum number of completion queue entries
+     * \param sqpoll Try to create a kernel thread that polls the submission
+     *               queue. If that is not permitted, the ring is created
+     *               without one.
+     * \throws uhd::runtime_error if io_uring is not available
+     */
+    io_uring_queue(
+        const unsigned sq_entries, const unsigned cq_entries, const bool sqpoll);
+    ~io_uring_queue();
+
+    int get_fd() const
+    {
+        return _fd;
+    }
+
+    //! Return true if a kernel thread polls the submission queue
+    bool has_sqpoll() const
+    {
+        return _sqpoll;
+    }
+
+    //! Return a blank submission queue entry, or nullptr if the queue is full
+    UHD_FORCE_INLINE io_uring_sqe* get_sqe()
+    {
+        const unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        if (_sqe_tail - head >= _sq_entries) {
+            return nullptr;
+        }
+        const unsigned index = _sqe_tail & _sq_mask;
+        _sq_array[index]     = index;
+        _sqe_tail++;
+        io_uring_sqe* sqe = &_sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    //! Return the entry last returned by get_sqe()
+    UHD_FORCE_INLINE io_uring_sqe* last_sqe()
+    {
+        return &_sqes[(_sqe_tail - 1) & _sq_mask];
+    }
+
+    /*!
+     * Hand the entries obtained from get_sqe() to the kernel. With a polling
+     * kernel thread, this only needs a system call if the thread is asleep.
+     */
+    UHD_FORCE_INLINE void submit()
+    {
+        __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+        if (_sqpoll) {
+            // The tail must be visible before checking whether the polling
+            // thread needs to be woken up
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (__atomic_load_n(_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) {
+                _enter(0, 0, IORING_ENTER_SQ_WAKEUP, nullptr);
+            }
+        } else {
+            const unsigned to_submit = _sqe_tail - _sqe_submitted;
+            _sqe_submitted           = _sqe_tail;
+            _enter(to_submit, 0, 0, nullptr);
+        }
+    }
+
+    //! Return the oldest completion queue entry, or nullptr if there is none
+    UHD_FORCE_INLINE const io_uring_cqe* peek_cqe() const
+    {
+        const unsigned head = *_cq_head;
+        if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+            return nullptr;
+        }
+        return &_cqes[head & _cq_mask];
+    }
+
+    //! Remove the entry returned by peek_cqe() from the completion queue
+    UHD_FORCE_INLINE void pop_cqe()
+    {
+        __atomic_store_n(_cq_head, *_cq_head + 1, __ATOMIC_RELEASE);
+    }
+
+    /*!
+     * Wait for a completion queue entry
+     *
+     * \param timeout_ms Timeout in milliseconds. A negative timeout waits
+     *                   forever.
+     * \returns false on timeout
+     */
+    bool wait_cqe(const int32_t timeout_ms);
+
+private:
+    void _cleanup();
+
+    void _enter(const unsigned to_submit,
+        const unsigned min_complete,
+        const unsigned flags,
+        const io_uring_getevents_arg* arg);
+
+    int _fd      = -1;
+    bool _sqpoll = false;
+
+    void* _sq_ring      = nullptr;
+    size_t _sq_ring_len = 0;
+    void* _cq_ring      = nullptr;
+    size_t _cq_ring_len = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqes_len    = 0;
+
+    unsigned* _sq_head   = nullptr;
+    unsigned* _sq_tail   = nullptr;
+    unsigned* _sq_flags  = nullptr;
+    unsigned* _sq_array  = nullptr;
+    unsigned _sq_mask    = 0;
+    unsigned _sq_entries = 0;
+    //! Tail of the entries obtained with get_sqe()
+    unsigned _sqe_tail = 0;
+    //! Tail of the entries passed to io_uring_enter()
+    unsigned _sqe_submitted = 0;
+
+    unsigned* _cq_head  = nullptr;
+    unsigned* _cq_tail  = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+    unsigned _cq_mask   = 0;
+};
+
+} // namespace detail
+
+/*!
+ * Frame buffer of the io_uring link. Frame buffers are not tied to memory:
+ * the link attaches the memory the kernel received a packet into, or the
+ * memory of a send slot that is not in flight.
+ */
+class udp_io_uring_frame_buff : public frame_buff
+{
+public:
+    static constexpr uint16_t NO_INDEX = 0xFFFF;
+
+    void attach(void* mem, const uint16_t index)
+    {
+        _data  = mem;
+        _index = index;
+    }
+
+    void detach()
+    {
+        _data  = nullptr;
+        _index = NO_INDEX;
+    }
+
+    //! Index of the attached memory in the buffer pool
+    uint16_t get_index() const
+    {
+        return _index;
+    }
+
+private:
+    uint16_t _index = NO_INDEX;
+};
+
+/*!
+ * UDP link based on io_uring (Linux 6.0 or newer)
+ *
+ * Receive: The receive frames are handed to the kernel in a provided buffer
+ * ring, and a multishot receive stays armed on the socket. The kernel picks a
+ * frame for every datagram and posts a completion. Receiving a packet is a
+ * matter of reading the completion queue; a system call is only needed to
+ * wait when there are no packets. Released frames go back into the buffer
+ * ring. If the kernel runs out of frames, the receive is re-armed once frames
+ * are released.
+ *
+ * Send: The send frames are registered with the kernel as fixed buffers, and
+ * released frames are queued as asynchronous writes. On hosts with more than
+ * one CPU, a kernel thread polls the submission queue (if permitted), so sends
+ * are picked up without a system call. A frame is reused only after its write
+ * completed. Sends are submitted as linked chains, and only one chain is in
+ * flight at a time, so sends that fail because the socket buffer is full are
+ * retried before any later frame goes out. Frames released while a chain is in
+ * flight go out together as the next chain.
+ *
+ * With batched sends (for tx data links), released frames are held back until
+ * a batch is complete or flush_send_buffs() is called, and a release never
+ * waits for the chain in flight. Without, a frame is submitted when it is
+ * released, waiting for the chain in flight if there is one.
+ */
+class udp_io_uring_link : public recv_link_base<udp_io_uring_link>,
+                          public send_link_base<udp_io_uring_link>
+{
+public:
+    using sptr = std::shared_ptr<udp_io_uring_link>;
+
+    /*!
+     * Make a new io_uring UDP link.
+     *
+     * \param addr a string representing the destination address
+     * \param port a string representing the destination port
+     * \param params Values for frame sizes, num frames, and buffer sizes
+     * \param[out] recv_socket_buff_size Returns the recv socket buffer size
+     * \param[out] send_socket_buff_size Returns the send socket buffer size
+     * \param batch_sends Hold back released frames to submit them in batches.
+     *        The caller must call flush_send_buffs() when no more packets
+     *        follow.
+     * \throws uhd::runtime_error if the kernel does not support the io_uring
+     *         features the link needs
+     */
+    static sptr make(const std::string& addr,
+        const std::string& port,
+        const link_params_t& params,
+        size_t& recv_socket_buff_size,
+        size_t& send_socket_buff_size,
+        const bool batch_sends = false);
+
+    ~udp_io_uring_link();
+
+    //! Return the local port of the UDP connection, in host byte order
+    uint16_t get_local_port() const;
+
+    //! Return the local IP address of the UDP connection as a dotted string
+    std::string get_local_addr() const;
+
+    /*!
+     * Get the physical adapter ID used for this link
+     */
+    adapter_id_t get_send_adapter_id() const
+    {
+        return _adapter_id;
+    }
+
+    /*!
+     * Get the physical adapter ID used for this link
+     */
+    adapter_id_t get_recv_adapter_id() const
+    {
+        return _adapter_id;
+    }
+
+    /*!
+     * Returns whether this link can send gather payloads. Sends complete
+     * asynchronously, and the caller may reuse a gather payload as soon as the
+     * frame is released, so gathering is not supported.
+     */
+    bool supports_send_gather() const
+    {
+        return false;
+    }
+
+    /*!
+     * Submit the frames that are held back. If a chain of sends is in flight,
+     * this waits for it to complete first.
+     */
+    void flush_send_buffs()
+    {
+        _reap_send_completions();
+        while (!_inflight_sends.empty() && !_pending_sends.empty()) {
+            _send_ring->wait_cqe(-1);
+            _reap_send_completions();
+        }
+        if (_inflight_sends.empty()) {
+            _submit_sends();
+        }
+    }
+
+    //! Returns whether released frames are held back to be sent in batches
+    bool is_send_batching_enabled() const
+    {
+        return _send_batch_size > 1;
+    }
+
+private:
+    using recv_link_base_t = recv_link_base<udp_io_uring_link>;
+    using send_link_base_t = send_link_base<udp_io_uring_link>;
+
+    // Friend declarations to allow base classes to call private methods
+    friend recv_link_base_t;
+    friend send_link_base_t;
+
+    udp_io_uring_link(const std::string& addr,
+        const std::string& port,
+        const link_params_t& params,
+        const bool batch_sends);
+
+    size_t resize_recv_socket_buffer(size_t num_bytes);
+    size_t resize_send_socket_buffer(size_t num_bytes);
+
+    // Methods called by recv_link_base
+    UHD_FORCE_INLINE size_t get_recv_buff_derived(frame_buff& buff, int32_t timeout_ms)
+    {
+        bool waited = false;
+        while (true) {
+            const io_uring_cqe* cqe = _recv_ring->peek_cqe();
+            if (!cqe) {
+                if (!_recv_armed) {
+                    _arm_recv();
+                }
+                if (waited || timeout_ms == 0 || !_recv_ring->wait_cqe(timeout_ms)) {
+                    return 0;
+                }
+                waited = true;
+                continue;
+            }
+
+            const int32_t res    = cqe->res;
+            const uint32_t flags = cqe->flags;
+            _recv_ring->pop_cqe();
+            if (!(flags & IORING_CQE_F_MORE)) {
+                _recv_armed = false;
+            }
+
+            if (flags & IORING_CQE_F_BUFFER) {
+                const uint16_t index = flags >> IORING_CQE_BUFFER_SHIFT;
+                if (res > 0) {
+                    static_cast<udp_io_uring_frame_buff&>(buff).attach(
+                        _recv_memory_pool->at(index), index);
+                    return res;
+                }
+                // Empty datagram
+                _provide_recv_buff(index);
+            } else if (res == -EINVAL && _recv_multishot) {
+                // Multishot receive is not supported, arm one receive at a
+                // time instead
+                _recv_multishot = false;
+            } else if (res < 0 && res != -ENOBUFS) {
+                throw uhd::io_error(
+                    std::string("recv error on socket: ") + std::strerror(-res));
+            }
+        }
+    }
+
+    UHD_FORCE_INLINE void release_recv_buff_derived(frame_buff& buff)
+    {
+        auto& io_uring_buff = static_cast<udp_io_uring_frame_buff&>(buff);
+        _provide_recv_buff(io_uring_buff.get_index());
+        io_uring_buff.detach();
+        if (!_recv_armed) {
+            _arm_recv();
+        }
+    }
+
+    // Methods called by send_link_base
+    UHD_FORCE_INLINE bool get_send_buff_derived(frame_buff& buff, int32_t timeout_ms)
+    {
+        auto& io_uring_buff = static_cast<udp_io_uring_frame_buff&>(buff);
+        // A frame that was released without a packet keeps its slot
+        if (io_uring_buff.get_index() != udp_io_uring_frame_buff::NO_INDEX) {
+            return true;
+        }
+        _reap_send_completions();
+        if (_inflight_sends.empty()
+            && (_free_send_slots.empty() || !is_send_batching_enabled())) {
+            // Retry the sends that failed, and don't hold back frames when
+            // there are none left
+            _submit_sends();
+        }
+        if (_free_send_slots.empty()) {
+            if (timeout_ms == 0 || !_send_ring->wait_cqe(timeout_ms)) {
+                return false;
+            }
+            _reap_send_completions();
+            if (_inflight_sends.empty()) {
+                _submit_sends();
+            }
+            if (_free_send_slots.empty()) {
+                return false;
+            }
+        }
+        const uint16_t slot = _free_send_slots.back();
+        _free_send_slots.pop_back();
+        io_uring_buff.attach(_send_memory_pool->at(slot), slot);
+        return true;
+    }
+
+    UHD_FORCE_INLINE void release_send_buff_derived(frame_buff& buff)
+    {
+        auto& io_uring_buff = static_cast<udp_io_uring_frame_buff&>(buff);
+        const uint16_t slot = io_uring_buff.get_index();
+        _send_lens[slot]    = buff.packet_size();
+        _pending_sends.push_back(slot);
+        io_uring_buff.detach();
+        if (_pending_sends.size() < _send_batch_size) {
+            return;
+        }
+        // A send that has to be retried must not be overtaken by a later one,
+        // so only one chain of sends is in flight at a time. With batched
+        // sends, the frames stay pending until the chain completed.
+        _reap_send_completions();
+        if (!is_send_batching_enabled()) {
+            while (!_inflight_sends.empty()) {
+                _send_ring->wait_cqe(-1);
+                _reap_send_completions();
+            }
+        }
+        if (_inflight_sends.empty()) {
+            _submit_sends();
+        }
+    }
+
+    //! Put a receive frame into the provided buffer ring
+    UHD_FORCE_INLINE void _provide_recv_buff(const uint16_t index)
+    {
+        io_uring_buf& entry = _recv_buf_ring[_recv_buf_ring_tail & _recv_buf_ring_mask];
+        entry.addr = reinterpret_cast<uint64_t>(_recv_memory_pool->at(index));
+        entry.len  = uint32_t(get_recv_frame_size());
+        entry.bid  = index;
+        _recv_buf_ring_tail++;
+        // The tail of the ring overlays the reserved field of the first entry
+        __atomic_store_n(&_recv_buf_ring[0].resv, _recv_buf_ring_tail, __ATOMIC_RELEASE);
+    }
+
+    /*!
+     * Submit the pending sends as one chain. The sends of a chain are linked,
+     * so a send only starts once the previous one completed, and the sends
+     * after a failed one are cancelled.
+     */
+    UHD_FORCE_INLINE void _submit_sends()
+    {
+        if (_pending_sends.empty()) {
+            return;
+        }
+        for (const uint16_t slot : _pending_sends) {
+            // The queue has an entry for every slot, so it can't be full
+            io_uring_sqe* sqe = _send_ring->get_sqe();
+            sqe->fd           = _sock_fd;
+            sqe->addr         = reinterpret_cast<uint64_t>(_send_memory_pool->at(slot));
+            sqe->len          = uint32_t(_send_lens[slot]);
+            sqe->user_data    = slot;
+            sqe->flags        = IOSQE_IO_LINK;
+            if (_send_fixed_buffs) {
+                sqe->opcode    = IORING_OP_WRITE_FIXED;
+                sqe->buf_index = slot;
+            } else {
+                sqe->opcode = IORING_OP_SEND;
+            }
+            _inflight_sends.push_back(slot);
+        }
+        // The last entry ends the chain
+        _send_ring->last_sqe()->flags = 0;
+        _num_inflight_completions     = _pending_sends.size();
+        _pending_sends.clear();
+        _send_ring->submit();
+    }
+
+    /*!
+     * Read the completions of the chain in flight. Once the chain is done,
+     * return the slots of completed sends to the free list, and put the sends
+     * that failed because the socket buffer was full (and the ones cancelled
+     * after them) back in front of the pending sends, in their original order.
+     */
+    UHD_FORCE_INLINE void _reap_send_completions()
+    {
+        for (const io_uring_cqe* cqe = _send_ring->peek_cqe(); cqe;
+             cqe                     = _send_ring->peek_cqe()) {
+            _send_results[uint16_t(cqe->user_data)] = cqe->res;
+            _send_ring->pop_cqe();
+            _num_inflight_completions--;
+        }
+        if (_inflight_sends.empty() || _num_inflight_completions != 0) {
+            return;
+        }
+
+        int32_t error = 0;
+        for (auto it = _inflight_sends.rbegin(); it != _inflight_sends.rend(); ++it) {
+            const int32_t res = _send_results[*it];
+            if (res == -ENOBUFS || res == -EAGAIN || res == -ECANCELED) {
+                _pending_sends.push_front(*it);
+            } else {
+                _free_send_slots.push_back(*it);
+                if (res < 0) {
+                    error = res;
+                }
+            }
+        }
+        _inflight_sends.clear();
+        if (error < 0) {
+            throw uhd::io_error(
+                std::string("send error on socket: ") + std::strerror(-error));
+        }
+    }
+
+    void _arm_recv();
+
+    buffer_pool::sptr _recv_memory_pool;
+    buffer_pool::sptr _send_memory_pool;
+
+    std::vector<udp_io_uring_frame_buff> _recv_buffs;
+    std::vector<udp_io_uring_frame_buff> _send_buffs;
+
+    boost::asio::io_service _io_service;
+    std::shared_ptr<boost::asio::ip::udp::socket> _socket;
+    int _sock_fd;
+    adapter_id_t _adapter_id;
+
+    // Receive state
+    std::unique_ptr<detail::io_uring_queue> _recv_ring;
+    buffer_pool::sptr _recv_buf_ring_pool;
+    //! Entries of the provided buffer ring. io_uring_buf_ring is not used
+    //! because its flexible array member has a different layout in C++.
+    io_uring_buf* _recv_buf_ring = nullptr;
+    uint16_t _recv_buf_ring_mask = 0;
+    uint16_t _recv_buf_ring_tail = 0;
+    bool _recv_armed             = false;
+    bool _recv_multishot         = true;
+
+    // Send state
+    std::unique_ptr<detail::io_uring_queue> _send_ring;
+    bool _send_fixed_buffs = false;
+    //! Number of released frames to collect before they are submitted
+    size_t _send_batch_size = 1;
+    std::vector<uint16_t> _free_send_slots;
+    std::vector<size_t> _send_lens;
+    //! Released slots that wait for the chain in flight to complete
+    std::deque<uint16_t> _pending_sends;
+    //! Slots of the chain in flight, in the order they are sent
+    std::vector<uint16_t> _inflight_sends;
+    size_t _num_inflight_completions = 0;
+    //! Result of the last send of every slot
+    std::vector<int32_t> _send_results;
+};
+
+}} // namespace uhd::transport
+
+#endif /* INCLUDED_UHDLIB_TRANSPORT_UDP_IO_URING_LINK_HPP */
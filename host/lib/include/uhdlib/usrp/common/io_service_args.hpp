@@ -21,24 +21,46 @@ namespace uhd { namespace usrp {
  * send_offload: set to "true" to use an offload thread for TX_DATA links, "false"
  *               to use an inline I/O service.
  * recv_offload_wait_mode: set to "poll" to use a polling strategy in the offload
- *                         thread, set to "block" to use a blocking strategy.
+ *                         thread, set to "block" to use a blocking strategy,
+ *                         set to "adaptive" to spin, then yield, then park
+ *                         the offload thread while it is idle.
  * send_offload_wait_mode: set to "poll" to use a polling strategy in the offload
- *                         thread, set to "block" to use a blocking strategy.
+ *                         thread, set to "block" to use a blocking strategy,
+ *                         set to "adaptive" to spin, then yield, then park
+ *                         the offload thread while it is idle.
+ * offload_spin_us: time in microseconds an idle offload thread keeps spinning
+ *                  before it starts yielding. Only used if the I/O service is
+ *                  configured to be adaptive.
+ * offload_yield_us: time in microseconds an idle offload thread keeps yielding
+ *                   before it parks. Only used if the I/O service is
+ *                   configured to be adaptive. The time an adaptive thread
+ *                   spent busy, spinning, yielding, and parked is logged at
+ *                   debug level when its streamer is destroyed.
  * num_poll_offload_threads: set to the total number of offload threads to use for
  *                           RX_DATA and TX_DATA in this rfnoc_graph. New connections
  *                           always go to the offload thread containing the fewest
  *                           connections, with lowest numbered thread as a second
  *                           criterion. The default is 1.
+ * poll_offload_work_stealing: set to "true" to let the polling offload threads
+ *                             share all links. Each link still has a home
+ *                             thread, but threads whose links are idle service
+ *                             the links of busy threads. The default is false.
+ *                             The number of buffers each thread moved, and how
+ *                             many of them it took from other threads, is
+ *                             logged at debug level when the streamers are
+ *                             destroyed.
  * recv_offload_thread_<N>_cpu: an integer to specify cpu affinity of the offload
  *                              thread. N indicates the thread instance, starting
  *                              with 0 for each streamer and ending with the number
  *                              of transport adapters minus one. Only used if the
- *                              I/O service is configured to block.
+ *                              I/O service is configured to block or to be
+ *                              adaptive.
  * send_offload_thread_<N>_cpu: an integer to specify cpu affinity of the offload
  *                              thread. N indicates the thread instance, starting
  *                              with 0 for each streamer and ending with the number
  *                              of transport adapters minus one. Only used if the
- *                              I/O service is configured to block.
+ *                              I/O service is configured to block or to be
+ *                              adaptive.
  * poll_offload_thread_<N>_cpu: an integer to specify cpu affinity of the offload
  *                              thread. N indicates the thread instance, starting
  *                              with 0 and up to num_poll_offload_threads minus 1.
@@ -46,7 +68,7 @@ namespace uhd { namespace usrp {
  */
 struct io_service_args_t
 {
-    enum wait_mode_t { POLL, BLOCK };
+    enum wait_mode_t { POLL, BLOCK, ADAPTIVE };
 
     //! Whether to offload streaming I/O to a worker thread
     bool recv_offload = false;
@@ -54,15 +76,24 @@ struct io_service_args_t
     //! Whether to offload streaming I/O to a worker thread
     bool send_offload = false;
 
-    //! Whether the offload thread should poll or block
+    //! Whether the offload thread should poll, block, or adapt
     wait_mode_t recv_offload_wait_mode = BLOCK;
 
-    //! Whether the offload thread should poll or block
+    //! Whether the offload thread should poll, block, or adapt
     wait_mode_t send_offload_wait_mode = BLOCK;
 
+    //! Spin budget of an idle offload thread, if wait_mode is set to ADAPTIVE
+    size_t offload_spin_us = 50;
+
+    //! Yield budget of an idle offload thread, if wait_mode is set to ADAPTIVE
+    size_t offload_yield_us = 200;
+
     //! Number of polling threads to use, if wait_mode is set to POLL
     size_t num_poll_offload_threads = 1;
 
+    //! Whether polling threads can service links homed on other threads
+    bool poll_offload_work_stealing = false;
+
     //! CPU affinity of offload threads, if wait_mode is set to BLOCK
     std::map<size_t,size_t> recv_offload_thread_cpu;
 
@@ -0,0 +1,139 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_LIBUHD_USRP_COMMON_NMEA_PARSER_HPP
+#define INCLUDED_LIBUHD_USRP_COMMON_NMEA_PARSER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace uhd { namespace usrp {
+
+/*!
+ * Incremental parser for the output of GPSDOs
+ *
+ * The parser takes the raw character stream of a GPSDO in chunks of any size,
+ * assembles lines, and validates them: NMEA sentences must start with "$GP"
+ * and end with a valid checksum, and SERVO lines start with a "YY-MM-DD"
+ * date. The latest GPGGA, GPRMC, and SERVO sentences are kept in fixed-size
+ * storage, so parsing does not allocate memory.
+ *
+ * The parser is not thread-safe; the caller serializes access to it.
+ */
+class nmea_parser
+{
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    //! The sentences the parser keeps
+    enum sentence_t { GPGGA, GPRMC, SERVO, NUM_SENTENCES };
+
+    //! Longest line the parser accepts. Longer lines are discarded as malformed.
+    static constexpr size_t MAX_LINE_LEN = 255;
+
+    /*! Feed characters read from the GPSDO into the parser
+     *
+     * \param data The characters. They do not need to be complete lines.
+     * \param len The number of characters
+     * \param now The time to record for sentences completed by these characters
+     * \returns the number of sentences stored, i.e., the number of complete
+     *          lines of one of the types in sentence_t
+     */
+    size_t push(const char* data, const size_t len, const clock_t::time_point now);
+
+    //! Convenience overload of push() for strings, using the current time
+    size_t push(const std::string& data)
+    {
+        return push(data.data(), data.size(), clock_t::now());
+    }
+
+    //! Return true if a sentence of this type was received
+    bool has_sentence(const sentence_t which) const
+    {
+        return _sentences[which].count > 0;
+    }
+
+    //! Return the latest sentence of this type, or an empty string
+    std::string get_sentence(const sentence_t which) const
+    {
+        const auto& slot = _sentences[which];
+        return std::string(slot.data.data(), slot.len);
+    }
+
+    //! Return the time at which the latest sentence of this type was received
+    clock_t::time_point get_time(const sentence_t which) const
+    {
+        return _sentences[which].time;
+    }
+
+    /*! Return the number of sentences of this type received so far
+     *
+     * This number can be used to wait for the next sentence of a type.
+     */
+    uint64_t get_count(const sentence_t which) const
+    {
+        return _sentences[which].count;
+    }
+
+    //! Return the number of malformed lines received so far
+    uint64_t get_num_malformed() const
+    {
+        return _num_malformed;
+    }
+
+    //! Return the latest malformed line, for diagnostics
+    std::string get_last_malformed() const
+    {
+        return std::string(_last_malformed.data(), _last_malformed_len);
+    }
+
+    /*! Look up a sentence type by name
+     *
+     * \param name The name, e.g., "GPGGA" or "SERVO"
+     * \param which Set to the sentence type if the name is known
+     * \returns true if the name is known
+     */
+    static bool get_sentence_type(const std::string& name, sentence_t& which);
+
+    //! Return true if the line is an NMEA sentence with a valid checksum
+    static bool is_nmea_sentence_ok(const char* line, const size_t len);
+
+    //! Return true if the line is a SERVO line
+    static bool is_servo_line(const char* line, const size_t len);
+
+private:
+    struct slot_t
+    {
+        std::array<char, MAX_LINE_LEN> data;
+        size_t len     = 0;
+        uint64_t count = 0;
+        clock_t::time_point time;
+    };
+
+    //! Validate and store the line in _line. Returns true if it was stored.
+    bool _handle_line(const clock_t::time_point now);
+
+    void _store(slot_t& slot, const clock_t::time_point now);
+
+    std::array<slot_t, NUM_SENTENCES> _sentences;
+
+    //! The line being assembled
+    std::array<char, MAX_LINE_LEN> _line;
+    size_t _line_len = 0;
+    //! Set when the line being assembled got too long
+    bool _line_overflow = false;
+
+    uint64_t _num_malformed = 0;
+    std::array<char, MAX_LINE_LEN> _last_malformed;
+    size_t _last_malformed_len = 0;
+};
+
+}} // namespace uhd::usrp
+
+#endif /* INCLUDED_LIBUHD_USRP_COMMON_NMEA_PARSER_HPP */
@@ -0,0 +1,76 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHDLIB_UTILS_FFT_HPP
+#define INCLUDED_UHDLIB_UTILS_FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace uhd {
+
+/*! Complex FFT for a fixed, power-of-two size
+ *
+ * This is an iterative Stockham FFT, which uses radix-4 stages and, for odd
+ * powers of two, one final radix-2 stage. The Stockham formulation produces
+ * the output in natural order, so there's no bit-reversal pass. All twiddle
+ * factors are computed once, in the constructor, and are stored in the order
+ * in which they are consumed. The innermost loops access memory contiguously,
+ * which lets the compiler vectorize them.
+ *
+ * An instance is not thread-safe, because it owns the scratch buffer used by
+ * execute(). Use one instance per thread.
+ */
+class fft
+{
+public:
+    /*!
+     * \param size The FFT size. Must be a power of two.
+     * \throws uhd::value_error if \p size is not a power of two
+     */
+    fft(const size_t size);
+
+    //! Return the FFT size
+    size_t size() const
+    {
+        return _size;
+    }
+
+    /*! Compute the forward FFT of \p data, in place
+     *
+     * The result is not normalized, i.e., the DC bin of a constant input of
+     * value 1 has the value size().
+     *
+     * \param data An array of size() samples
+     */
+    void execute(std::complex<float>* data);
+
+private:
+    struct stage_t
+    {
+        //! Length of the sub-transforms in this stage
+        size_t n;
+        //! Stride between the elements of one sub-transform
+        size_t s;
+        //! Offset of this stage's twiddles in _twiddles
+        size_t twiddle_offset;
+    };
+
+    const size_t _size;
+    //! Radix-4 stages
+    std::vector<stage_t> _stages;
+    //! Whether a final radix-2 stage is required (for odd powers of two)
+    bool _radix2_stage = false;
+    //! Twiddle factors: for every stage and every p, w^p, w^2p, w^3p
+    std::vector<std::complex<float>> _twiddles;
+    //! Scratch buffer
+    std::vector<std::complex<float>> _work;
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_UHDLIB_UTILS_FFT_HPP */
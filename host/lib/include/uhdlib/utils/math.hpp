@@ -11,6 +11,7 @@
 
 #include <uhdlib/utils/narrow.hpp>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 namespace uhd { namespace math {
@@ -13,6 +13,7 @@
 #include <uhd/exception.hpp>
 #include <boost/format.hpp>
 #include <memory>
+#include <thread>
 
 namespace {
 
@@ -0,0 +1,478 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhdlib/rfnoc/chdr_capture_analyzer.hpp>
+#include <uhdlib/rfnoc/chdr_packet.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <thread>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+using namespace uhd::rfnoc::chdr;
+
+namespace {
+
+constexpr uint32_t PCAP_MAGIC_US      = 0xA1B2C3D4;
+constexpr uint32_t PCAP_MAGIC_NS      = 0xA1B23C4D;
+constexpr size_t PCAP_GLOBAL_HDR_LEN  = 24;
+constexpr size_t PCAP_RECORD_HDR_LEN  = 16;
+constexpr uint32_t LINKTYPE_ETHERNET  = 1;
+constexpr uint32_t LINKTYPE_LINUX_SLL = 113;
+constexpr size_t ETH_HDR_LEN          = 14;
+constexpr size_t SLL_HDR_LEN          = 16;
+constexpr size_t VLAN_TAG_LEN         = 4;
+constexpr size_t UDP_HDR_LEN          = 8;
+constexpr uint16_t ETHERTYPE_IPV4     = 0x0800;
+constexpr uint16_t ETHERTYPE_VLAN     = 0x8100;
+constexpr uint8_t IP_PROTO_UDP        = 17;
+
+//! Number of bytes of every packet that are copied for decoding. This covers
+// the header, the timestamp and the stream status and command payloads for
+// every CHDR width, but not the data payload, which is never touched.
+constexpr size_t PKT_PREFIX_LEN = 1024;
+
+inline uint32_t load_u32(const uint8_t* p, const bool swapped)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return swapped ? uhd::byteswap(value) : value;
+}
+
+inline uint16_t load_be16(const uint8_t* p)
+{
+    return uint16_t(p[0] << 8 | p[1]);
+}
+
+/*! Analyzes the packets of the streams of one shard
+ */
+class shard_analyzer
+{
+public:
+    shard_analyzer(const capture_analyzer_args_t& args)
+        : _args(args)
+        , _pkt_factory(args.chdr_w, args.endianness)
+        , _pkt(_pkt_factory.make_generic())
+        , _strs_pkt(_pkt_factory.make_strs())
+        , _strc_pkt(_pkt_factory.make_strc())
+        , _prefix(PKT_PREFIX_LEN / sizeof(uint64_t))
+    {
+    }
+
+    //! Return the EPID of the stream that a packet belongs to
+    sep_id_t get_stream_epid(const pcap_file::udp_record_t& record)
+    {
+        const chdr_header header = _load_header(record.data);
+        if (header.get_pkt_type() == PKT_TYPE_STRS && _load_prefix(record)) {
+            // Stream status comes from the endpoint that receives the stream
+            _strs_pkt->refresh(_prefix.data());
+            _strs_pkt->fill_payload(_strs);
+            return _strs.src_epid;
+        }
+        return header.get_dst_epid();
+    }
+
+    //! Process the next packet of a stream. Packets must be passed in capture order.
+    void process(const sep_id_t epid, const pcap_file::udp_record_t& record)
+    {
+        stream_state_t& stream = _streams[epid];
+        stream.stats.epid      = epid;
+        if (record.size < sizeof(uint64_t)) {
+            stream.stats.num_truncated_pkts++;
+            return;
+        }
+        const chdr_header header = _load_header(record.data);
+        if (header.get_length() > record.size) {
+            stream.stats.num_truncated_pkts++;
+        }
+        switch (header.get_pkt_type()) {
+            case PKT_TYPE_DATA_NO_TS:
+            case PKT_TYPE_DATA_WITH_TS:
+                _process_data(stream, record);
+                break;
+            case PKT_TYPE_STRS:
+                _process_strs(stream, record);
+                break;
+            case PKT_TYPE_STRC:
+                _process_strc(stream, record);
+                break;
+            case PKT_TYPE_CTRL:
+                stream.stats.num_ctrl_pkts++;
+                break;
+            case PKT_TYPE_MGMT:
+                stream.stats.num_mgmt_pkts++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    //! Move the statistics of all streams of this shard into \p result
+    void collect(std::vector<stream_stats_t>& result)
+    {
+        for (auto& stream : _streams) {
+            result.push_back(std::move(stream.second.stats));
+        }
+        _streams.clear();
+    }
+
+private:
+    struct stream_state_t
+    {
+        stream_stats_t stats;
+        bool have_prev_data   = false;
+        uint16_t prev_seq_num = 0;
+        bool prev_eob         = false;
+        bool prev_has_ts      = false;
+        uint64_t prev_ts      = 0;
+        size_t prev_nitems    = 0;
+        double prev_time      = 0.0;
+        //! Number of bytes sent since the last stream (re-)initialization
+        uint64_t sent_bytes = 0;
+    };
+
+    chdr_header _load_header(const uint8_t* data) const
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return chdr_header(_args.endianness == ENDIANNESS_BIG ? uhd::ntohx(word)
+                                                              : uhd::wtohx(word));
+    }
+
+    //! Copy the start of a packet to an aligned buffer. Returns false if the
+    // whole packet doesn't fit into the buffer, or isn't in the capture.
+    bool _load_prefix(const pcap_file::udp_record_t& record)
+    {
+        const size_t len = std::min(record.size, PKT_PREFIX_LEN);
+        std::memcpy(_prefix.data(), record.data, len);
+        return _load_header(record.data).get_length() <= len;
+    }
+
+    void _process_data(stream_state_t& stream, const pcap_file::udp_record_t& record)
+    {
+        stream_stats_t& stats = stream.stats;
+        _load_prefix(record);
+        _pkt->refresh(_prefix.data());
+        const chdr_header header = _pkt->get_chdr_header();
+        const size_t payload     = _pkt->get_payload_size();
+        const auto timestamp     = _pkt->get_timestamp();
+
+        stats.num_data_pkts++;
+        stats.data_bytes += header.get_length();
+        stats.payload_bytes += payload;
+        stream.sent_bytes += header.get_length();
+        if (stats.num_data_pkts == 1) {
+            stats.first_time = record.time;
+        }
+        stats.last_time = record.time;
+
+        // Throughput
+        if (_args.throughput_interval > 0) {
+            const size_t interval = size_t(std::max(
+                0.0, (record.time - stats.first_time) / _args.throughput_interval));
+            if (interval >= stats.throughput_bytes.size()) {
+                stats.throughput_bytes.resize(interval + 1, 0);
+            }
+            stats.throughput_bytes[interval] += header.get_length();
+        }
+
+        // Timestamps
+        if (timestamp && _args.tick_rate > 0) {
+            stats.ts_offset.add(record.time - double(*timestamp) / _args.tick_rate);
+        }
+        if (stream.have_prev_data) {
+            stats.interarrival.add(record.time - stream.prev_time);
+
+            // Sequence numbers
+            const uint16_t seq_delta =
+                header.get_seq_num() - uint16_t(stream.prev_seq_num + 1);
+            if (seq_delta != 0) {
+                if (seq_delta < 0x8000) {
+                    stats.num_seq_gaps++;
+                    stats.num_lost_pkts += seq_delta;
+                } else {
+                    stats.num_seq_reorders++;
+                }
+            }
+
+            // Within a burst, every timestamp must follow the previous packet
+            if (timestamp && stream.prev_has_ts && !stream.prev_eob
+                && _args.bytes_per_item > 0
+                && *timestamp != stream.prev_ts + stream.prev_nitems) {
+                stats.num_ts_discontinuities++;
+            }
+        }
+
+        stream.have_prev_data = true;
+        stream.prev_seq_num   = header.get_seq_num();
+        stream.prev_eob       = header.get_eob();
+        stream.prev_has_ts    = bool(timestamp);
+        stream.prev_ts        = timestamp ? *timestamp : 0;
+        stream.prev_nitems =
+            _args.bytes_per_item > 0 ? payload / _args.bytes_per_item : 0;
+        stream.prev_time = record.time;
+    }
+
+    void _process_strs(stream_state_t& stream, const pcap_file::udp_record_t& record)
+    {
+        stream_stats_t& stats = stream.stats;
+        stats.num_strs_pkts++;
+        if (!_load_prefix(record)) {
+            return;
+        }
+        _strs_pkt->refresh(_prefix.data());
+        _strs_pkt->fill_payload(_strs);
+        if (_strs.status != STRS_OKAY) {
+            stats.num_strs_errors++;
+        }
+        // If the capture doesn't contain the initialization of the stream,
+        // assume there's no data in flight when the first status is sent
+        if (stats.fc_timeline.empty() && stream.sent_bytes < _strs.xfer_count_bytes) {
+            stream.sent_bytes = _strs.xfer_count_bytes;
+        }
+        fc_sample_t sample;
+        sample.time             = record.time;
+        sample.capacity_bytes   = _strs.capacity_bytes;
+        sample.xfer_count_bytes = _strs.xfer_count_bytes;
+        sample.sent_bytes       = stream.sent_bytes;
+        sample.credits_bytes    = int64_t(_strs.capacity_bytes)
+                               - (int64_t(stream.sent_bytes)
+                                  - int64_t(_strs.xfer_count_bytes));
+        stats.fc_timeline.push_back(sample);
+    }
+
+    void _process_strc(stream_state_t& stream, const pcap_file::udp_record_t& record)
+    {
+        stream.stats.num_strc_pkts++;
+        if (!_load_prefix(record)) {
+            return;
+        }
+        _strc_pkt->refresh(_prefix.data());
+        _strc_pkt->fill_payload(_strc);
+        // Initialization resets the transfer counts of the endpoint
+        if (_strc.op_code == STRC_INIT) {
+            stream.sent_bytes = 0;
+        }
+    }
+
+    const capture_analyzer_args_t _args;
+    chdr_packet_factory _pkt_factory;
+    chdr_packet::uptr _pkt;
+    chdr_strs_packet::uptr _strs_pkt;
+    chdr_strc_packet::uptr _strc_pkt;
+    strs_payload _strs;
+    strc_payload _strc;
+    //! Aligned copy of the start of the current packet
+    std::vector<uint64_t> _prefix;
+    std::map<sep_id_t, stream_state_t> _streams;
+};
+
+} // namespace
+
+/******************************************************************************
+ * pcap_file
+ *****************************************************************************/
+pcap_file::pcap_file(const std::string& filename)
+{
+    _fd = ::open(filename.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        throw uhd::runtime_error("Could not open capture file " + filename);
+    }
+    struct stat file_stat;
+    if (::fstat(_fd, &file_stat) < 0 || size_t(file_stat.st_size) < PCAP_GLOBAL_HDR_LEN) {
+        ::close(_fd);
+        throw uhd::runtime_error("Invalid capture file " + filename);
+    }
+    _size     = size_t(file_stat.st_size);
+    void* map = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED) {
+        ::close(_fd);
+        throw uhd::runtime_error("Could not map capture file " + filename);
+    }
+    _base = static_cast<const uint8_t*>(map);
+    // The file is read front to back
+    ::madvise(map, _size, MADV_SEQUENTIAL);
+
+    const uint32_t magic = load_u32(_base, false);
+    if (magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS) {
+        _swapped = false;
+    } else if (magic == uhd::byteswap(PCAP_MAGIC_US)
+               || magic == uhd::byteswap(PCAP_MAGIC_NS)) {
+        _swapped = true;
+    } else {
+        _unmap();
+        throw uhd::runtime_error("Not a pcap file: " + filename);
+    }
+    _nanosecond = (load_u32(_base, _swapped) == PCAP_MAGIC_NS);
+    _linktype   = load_u32(_base + 20, _swapped);
+    if (_linktype != LINKTYPE_ETHERNET && _linktype != LINKTYPE_LINUX_SLL) {
+        _unmap();
+        throw uhd::runtime_error(
+            "Unsupported link type " + std::to_string(_linktype) + " in " + filename);
+    }
+
+    for (size_t offset = PCAP_GLOBAL_HDR_LEN; offset + PCAP_RECORD_HDR_LEN <= _size;) {
+        offset += PCAP_RECORD_HDR_LEN + load_u32(_base + offset + 8, _swapped);
+        _num_records++;
+    }
+}
+
+pcap_file::~pcap_file()
+{
+    _unmap();
+}
+
+void pcap_file::_unmap()
+{
+    if (_base) {
+        ::munmap(const_cast<uint8_t*>(_base), _size);
+        _base = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+std::vector<pcap_file::udp_record_t> pcap_file::get_udp_records(
+    const uint16_t udp_port) const
+{
+    std::vector<udp_record_t> records;
+    records.reserve(_num_records);
+    const double frac_scale = _nanosecond ? 1e-9 : 1e-6;
+    const size_t l2_hdr_len = (_linktype == LINKTYPE_ETHERNET) ? ETH_HDR_LEN
+                                                               : SLL_HDR_LEN;
+
+    for (size_t offset = PCAP_GLOBAL_HDR_LEN; offset + PCAP_RECORD_HDR_LEN <= _size;) {
+        const uint8_t* record_hdr = _base + offset;
+        const uint32_t ts_sec     = load_u32(record_hdr, _swapped);
+        const uint32_t ts_frac    = load_u32(record_hdr + 4, _swapped);
+        const size_t incl_len =
+            std::min(size_t(load_u32(record_hdr + 8, _swapped)),
+                _size - offset - PCAP_RECORD_HDR_LEN);
+        const uint8_t* frame = record_hdr + PCAP_RECORD_HDR_LEN;
+        offset += PCAP_RECORD_HDR_LEN + incl_len;
+
+        // Link layer
+        if (incl_len < l2_hdr_len) {
+            continue;
+        }
+        size_t l3_offset   = l2_hdr_len;
+        uint16_t ethertype = load_be16(frame + l2_hdr_len - 2);
+        if (ethertype == ETHERTYPE_VLAN && incl_len >= l3_offset + VLAN_TAG_LEN) {
+            ethertype = load_be16(frame + l3_offset + 2);
+            l3_offset += VLAN_TAG_LEN;
+        }
+        if (ethertype != ETHERTYPE_IPV4 || incl_len < l3_offset + 20) {
+            continue;
+        }
+
+        // IPv4
+        const uint8_t* ip_hdr   = frame + l3_offset;
+        const size_t ip_hdr_len = (ip_hdr[0] & 0x0F) * 4;
+        const bool fragmented   = (load_be16(ip_hdr + 6) & 0x3FFF) != 0;
+        if (ip_hdr[9] != IP_PROTO_UDP || fragmented
+            || incl_len < l3_offset + ip_hdr_len + UDP_HDR_LEN) {
+            continue;
+        }
+
+        // UDP
+        const uint8_t* udp_hdr = ip_hdr + ip_hdr_len;
+        if (udp_port != 0 && load_be16(udp_hdr) != udp_port
+            && load_be16(udp_hdr + 2) != udp_port) {
+            continue;
+        }
+        const size_t udp_len     = load_be16(udp_hdr + 4);
+        const size_t udp_offset  = l3_offset + ip_hdr_len + UDP_HDR_LEN;
+        const size_t payload_len = std::min(
+            udp_len < UDP_HDR_LEN ? 0 : udp_len - UDP_HDR_LEN, incl_len - udp_offset);
+        records.push_back(
+            {ts_sec + ts_frac * frac_scale, frame + udp_offset, payload_len});
+    }
+    return records;
+}
+
+/******************************************************************************
+ * Statistics
+ *****************************************************************************/
+void running_stats_t::add(const double value)
+{
+    count++;
+    const double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+double running_stats_t::get_stddev() const
+{
+    return count < 2 ? 0.0 : std::sqrt(m2 / (count - 1));
+}
+
+std::vector<stream_stats_t> uhd::rfnoc::chdr::analyze_capture(
+    const std::vector<pcap_file::udp_record_t>& records,
+    const capture_analyzer_args_t& args)
+{
+    const size_t num_threads =
+        args.num_threads ? args.num_threads
+                         : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    // Every worker walks all packets, but only processes the streams of its
+    // shard. Determining the stream of a packet only requires its header, so
+    // the workers don't step on each other, and need no synchronization.
+    std::vector<std::vector<stream_stats_t>> results(num_threads);
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(num_threads);
+    for (size_t shard = 0; shard < num_threads; shard++) {
+        workers.emplace_back([&, shard]() {
+            try {
+                shard_analyzer analyzer(args);
+                for (const auto& record : records) {
+                    if (record.size < sizeof(uint64_t)) {
+                        continue;
+                    }
+                    const sep_id_t epid = analyzer.get_stream_epid(record);
+                    if (epid % num_threads == shard) {
+                        analyzer.process(epid, record);
+                    }
+                }
+                analyzer.collect(results[shard]);
+            } catch (...) {
+                errors[shard] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<stream_stats_t> all_stats;
+    for (auto& result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(all_stats));
+    }
+    std::sort(all_stats.begin(),
+        all_stats.end(),
+        [](const stream_stats_t& lhs, const stream_stats_t& rhs) {
+            return lhs.epid < rhs.epid;
+        });
+    return all_stats;
+}
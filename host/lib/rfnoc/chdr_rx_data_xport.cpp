@@ -49,11 +49,14 @@ chdr_rx_data_xport::chdr_rx_data_xport(uhd::transport::io_service::sptr io_srv,
     _recv_packet    = pkt_factory.make_generic();
     _recv_packet_cb = pkt_factory.make_generic();
     _fc_sender.set_capacity(fc_params.buff_capacity);
+    _fc_state.set_coalescing(
+        fc_params.buff_capacity, fc_params.resp_batch, fc_params.resp_min_interval);
 
     // Calculate max payload size
     const size_t pyld_offset =
         _recv_packet->calculate_payload_offset(chdr::PKT_TYPE_DATA_WITH_TS);
     _max_payload_size = recv_link->get_recv_frame_size() - pyld_offset;
+    _num_recv_frames  = num_recv_frames;
 
     // Make data transport
     auto recv_cb =
@@ -80,7 +83,10 @@ chdr_rx_data_xport::chdr_rx_data_xport(uhd::transport::io_service::sptr io_srv,
             << "capacity bytes=" << fc_params.buff_capacity.bytes
             << ", packets=" << fc_params.buff_capacity.packets << std::endl
             << "fc frequency bytes=" << fc_params.freq.bytes
-            << ", packets=" << fc_params.freq.packets);
+            << ", packets=" << fc_params.freq.packets << std::endl
+            << "fc response batch bytes=" << fc_params.resp_batch.bytes
+            << ", packets=" << fc_params.resp_batch.packets
+            << ", min interval us=" << fc_params.resp_min_interval.count());
 }
 
 chdr_rx_data_xport::~chdr_rx_data_xport()
@@ -127,9 +133,7 @@ chdr_rx_data_xport::fc_params_t chdr_rx_data_xport::configure_sep(io_service::sp
             return false;
         }
 
-        strc.deserialize(pkt->get_payload_const_ptr_as<uint64_t>(),
-            pkt->get_payload_size() / sizeof(uint64_t),
-            pkt->conv_to_host<uint64_t>());
+        pkt->deserialize_payload(strc);
 
         if (strc.op_code != chdr::STRC_INIT) {
             throw uhd::value_error("Unexpected opcode value in STRC packet.");
@@ -146,7 +150,9 @@ chdr_rx_data_xport::fc_params_t chdr_rx_data_xport::configure_sep(io_service::sp
         // Send a strs response to configure flow control on the sender. The
         // byte and packet counts are not important since they are reset by
         // the stream endpoint on receipt of this packet.
-        fc_sender.send_strs(send_link, {0, 0});
+        if (!fc_sender.send_strs(send_link, {0, 0})) {
+            throw uhd::runtime_error("rx_flowctrl timed out getting a send buffer");
+        }
     };
 
     // Create a temporary recv_io to receive the strc init
@@ -209,3 +215,18 @@ chdr_rx_data_xport::fc_params_t chdr_rx_data_xport::configure_sep(io_service::sp
 
     return fc_params;
 }
+
+void chdr_rx_data_xport::read_fc_coalescing_args(
+    const device_addr_t& xport_args, fc_params_t& fc_params)
+{
+    const double batch_ratio = xport_args.cast<double>("fc_resp_batch_ratio", 0.0);
+    if (batch_ratio < 0.0 || batch_ratio > 1.0) {
+        throw uhd::value_error("fc_resp_batch_ratio must be between 0 and 1");
+    }
+    fc_params.resp_batch = {
+        static_cast<uint64_t>(fc_params.buff_capacity.bytes * batch_ratio),
+        static_cast<uint32_t>(fc_params.buff_capacity.packets * batch_ratio)};
+
+    fc_params.resp_min_interval =
+        std::chrono::microseconds(xport_args.cast<int64_t>("fc_resp_min_interval_us", 0));
+}
@@ -178,9 +178,7 @@ static chdr_tx_data_xport::fc_params_t configure_flow_ctrl(io_service::sptr io_s
         UHD_ASSERT_THROW(
             recv_packet->get_chdr_header().get_pkt_type() == chdr::PKT_TYPE_STRS);
         chdr::strs_payload strs;
-        strs.deserialize(recv_packet->get_payload_const_ptr_as<uint64_t>(),
-            recv_packet->get_payload_size() / sizeof(uint64_t),
-            recv_packet->conv_to_host<uint64_t>());
+        recv_packet->deserialize_payload(strs);
 
         recv_io->release_recv_buff(std::move(buff));
 
@@ -29,10 +29,67 @@ static inline constexpr field_t get_field_u64(
     return static_cast<field_t>((flat_hdr >> offset) & mask_u64(width));
 }
 
+//! Converts a word from host order to the link byte order. Unlike a
+//  std::function, this gets inlined into the (de)serializers.
+template <endianness_t endianness>
+struct conv_from_host
+{
+    inline uint64_t operator()(uint64_t x) const
+    {
+        return (endianness == ENDIANNESS_BIG) ? uhd::htonx<uint64_t>(x)
+                                              : uhd::htowx<uint64_t>(x);
+    }
+};
+
+//! Converts a word from the link byte order to host order
+template <endianness_t endianness>
+struct conv_to_host
+{
+    inline uint64_t operator()(uint64_t x) const
+    {
+        return (endianness == ENDIANNESS_BIG) ? uhd::ntohx<uint64_t>(x)
+                                              : uhd::wtohx<uint64_t>(x);
+    }
+};
+
+using conv_func_t = std::function<uint64_t(uint64_t)>;
+
+//! Defines the public serialize() and deserialize() overloads of a payload
+//  type in terms of its private, conversion-templated implementations
+#define CHDR_PAYLOAD_DEFINE_SERDES(payload_type)                                        \
+    size_t payload_type::serialize(                                                     \
+        uint64_t* buff, size_t max_size_bytes, const conv_func_t& conv_byte_order)      \
+        const                                                                           \
+    {                                                                                   \
+        return _serialize(buff, max_size_bytes, conv_byte_order);                       \
+    }                                                                                   \
+    void payload_type::deserialize(                                                     \
+        const uint64_t* buff, size_t num_elems, const conv_func_t& conv_byte_order)     \
+    {                                                                                   \
+        _deserialize(buff, num_elems, conv_byte_order);                                 \
+    }                                                                                   \
+    template <endianness_t endianness>                                                  \
+    size_t payload_type::serialize(uint64_t* buff, size_t max_size_bytes) const         \
+    {                                                                                   \
+        return _serialize(buff, max_size_bytes, conv_from_host<endianness>());          \
+    }                                                                                   \
+    template <endianness_t endianness>                                                  \
+    void payload_type::deserialize(const uint64_t* buff, size_t num_elems)              \
+    {                                                                                   \
+        _deserialize(buff, num_elems, conv_to_host<endianness>());                      \
+    }                                                                                   \
+    template size_t payload_type::serialize<ENDIANNESS_BIG>(uint64_t*, size_t) const;   \
+    template size_t payload_type::serialize<ENDIANNESS_LITTLE>(uint64_t*, size_t)       \
+        const;                                                                          \
+    template void payload_type::deserialize<ENDIANNESS_BIG>(const uint64_t*, size_t);   \
+    template void payload_type::deserialize<ENDIANNESS_LITTLE>(const uint64_t*, size_t);
+
 //----------------------------------------------------
 // CHDR Control Payload
 //----------------------------------------------------
 
+constexpr size_t ctrl_data_vtr_t::MAX_SIZE;
+
 void ctrl_payload::populate_header(chdr_header& header) const
 {
     header.set_pkt_type(PKT_TYPE_CTRL);
@@ -41,12 +98,18 @@ void ctrl_payload::populate_header(chdr_header& header) const
     header.set_num_mdata(0);
 }
 
-size_t ctrl_payload::serialize(uint64_t* buff,
+template <typename conv_byte_order_t>
+size_t ctrl_payload::_serialize(uint64_t* buff,
     size_t max_size_bytes,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order) const
+    const conv_byte_order_t& conv_byte_order) const
 {
     UHD_ASSERT_THROW((data_vtr.size() > 0 && data_vtr.size() < 16));
-    // We assume that buff has room to hold the entire packet
+    // Check up front that the packet fits, so we never write past the buffer:
+    // Control header, optional timestamp, op-word (with data[0]) and the
+    // remaining data packed two words per line
+    const size_t num_lines =
+        2 + (timestamp.is_initialized() ? 1 : 0) + (data_vtr.size() / 2);
+    UHD_ASSERT_THROW(num_lines * sizeof(uint64_t) <= max_size_bytes);
     size_t ptr = 0;
 
     // Populate control header
@@ -89,24 +152,28 @@ size_t ctrl_payload::serialize(uint64_t* buff,
                             | static_cast<uint64_t>(data_vtr[i]) << LO_DATA_OFFSET);
     }
 
-    // FIXME: This UHD_ASSERT_THROW is a bit late because memory has already been
-    // corrupted
-    UHD_ASSERT_THROW(ptr <= max_size_bytes);
     // Return bytes written
     return (ptr * sizeof(uint64_t));
 }
 
-void ctrl_payload::deserialize(const uint64_t* buff,
-    size_t max_size_bytes,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order)
+template <typename conv_byte_order_t>
+void ctrl_payload::_deserialize(const uint64_t* buff,
+    size_t num_elems,
+    const conv_byte_order_t& conv_byte_order)
 {
-    // We assume that buff has room to hold the entire packet
+    UHD_ASSERT_THROW(num_elems >= 2);
     size_t ptr = 0;
 
     // Read control header
-    uint64_t ctrl_header = conv_byte_order(buff[ptr++]);
-    data_vtr.resize(get_field_u64<size_t>(ctrl_header, NUM_DATA_OFFSET, NUM_DATA_WIDTH));
-    UHD_ASSERT_THROW((data_vtr.size() > 0 && data_vtr.size() < 16));
+    uint64_t ctrl_header  = conv_byte_order(buff[ptr++]);
+    const size_t num_data =
+        get_field_u64<size_t>(ctrl_header, NUM_DATA_OFFSET, NUM_DATA_WIDTH);
+    UHD_ASSERT_THROW((num_data > 0 && num_data < 16));
+    const bool has_time =
+        get_field_u64<bool>(ctrl_header, HAS_TIME_OFFSET, HAS_TIME_WIDTH);
+    // Make sure the entire payload is in the buffer before reading any further
+    UHD_ASSERT_THROW((2 + (has_time ? 1 : 0) + (num_data / 2)) <= num_elems);
+    data_vtr.resize(num_data);
     dst_port = get_field_u64<uint16_t>(ctrl_header, DST_PORT_OFFSET, DST_PORT_WIDTH);
     src_port = get_field_u64<uint16_t>(ctrl_header, SRC_PORT_OFFSET, SRC_PORT_WIDTH);
     seq_num  = get_field_u64<uint8_t>(ctrl_header, SEQ_NUM_OFFSET, SEQ_NUM_WIDTH);
@@ -114,7 +181,7 @@ void ctrl_payload::deserialize(const uint64_t* buff,
     src_epid = get_field_u64<uint16_t>(ctrl_header, SRC_EPID_OFFSET, SRC_EPID_WIDTH);
 
     // Read optional timestamp
-    if (get_field_u64<bool>(ctrl_header, HAS_TIME_OFFSET, HAS_TIME_WIDTH)) {
+    if (has_time) {
         timestamp = conv_byte_order(buff[ptr++]);
     } else {
         timestamp = boost::none;
@@ -122,10 +189,8 @@ void ctrl_payload::deserialize(const uint64_t* buff,
 
     // Read control operation word
     uint64_t op_word = conv_byte_order(buff[ptr++]);
-    if (data_vtr.size() > 0) {
-        data_vtr[0] = get_field_u64<uint32_t>(op_word, HI_DATA_OFFSET, 32);
-    }
-    address     = get_field_u64<uint32_t>(op_word, ADDRESS_OFFSET, ADDRESS_WIDTH);
+    data_vtr[0]      = get_field_u64<uint32_t>(op_word, HI_DATA_OFFSET, 32);
+    address          = get_field_u64<uint32_t>(op_word, ADDRESS_OFFSET, ADDRESS_WIDTH);
     byte_enable = get_field_u64<uint8_t>(op_word, BYTE_ENABLE_OFFSET, BYTE_ENABLE_WIDTH);
     op_code     = get_field_u64<ctrl_opcode_t>(op_word, OPCODE_OFFSET, OPCODE_WIDTH);
     status      = get_field_u64<ctrl_status_t>(op_word, STATUS_OFFSET, STATUS_WIDTH);
@@ -138,9 +203,10 @@ void ctrl_payload::deserialize(const uint64_t* buff,
         }
         data_vtr[i] = get_field_u64<uint32_t>(data_word, LO_DATA_OFFSET, 32);
     }
-    UHD_ASSERT_THROW(ptr <= max_size_bytes);
 }
 
+CHDR_PAYLOAD_DEFINE_SERDES(ctrl_payload)
+
 bool ctrl_payload::operator==(const ctrl_payload& rhs) const
 {
     return (dst_port == rhs.dst_port) && (src_port == rhs.src_port)
@@ -178,9 +244,10 @@ void strs_payload::populate_header(chdr_header& header) const
     header.set_num_mdata(0);
 }
 
-size_t strs_payload::serialize(uint64_t* buff,
+template <typename conv_byte_order_t>
+size_t strs_payload::_serialize(uint64_t* buff,
     size_t max_size_bytes,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order) const
+    const conv_byte_order_t& conv_byte_order) const
 {
     UHD_ASSERT_THROW(max_size_bytes >= (4 * sizeof(uint64_t)));
 
@@ -212,9 +279,10 @@ size_t strs_payload::serialize(uint64_t* buff,
     return (4 * sizeof(uint64_t));
 }
 
-void strs_payload::deserialize(const uint64_t* buff,
+template <typename conv_byte_order_t>
+void strs_payload::_deserialize(const uint64_t* buff,
     size_t num_elems,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order)
+    const conv_byte_order_t& conv_byte_order)
 {
     UHD_ASSERT_THROW(num_elems >= 4);
 
@@ -241,6 +309,8 @@ void strs_payload::deserialize(const uint64_t* buff,
     status_info = get_field_u64<uint64_t>(word3, STATUS_INFO_OFFSET, STATUS_INFO_WIDTH);
 }
 
+CHDR_PAYLOAD_DEFINE_SERDES(strs_payload)
+
 bool strs_payload::operator==(const strs_payload& rhs) const
 {
     return (src_epid == rhs.src_epid) && (status == rhs.status)
@@ -273,9 +343,10 @@ void strc_payload::populate_header(chdr_header& header) const
     header.set_num_mdata(0);
 }
 
-size_t strc_payload::serialize(uint64_t* buff,
+template <typename conv_byte_order_t>
+size_t strc_payload::_serialize(uint64_t* buff,
     size_t max_size_bytes,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order) const
+    const conv_byte_order_t& conv_byte_order) const
 {
     UHD_ASSERT_THROW(max_size_bytes >= (2 * sizeof(uint64_t)));
 
@@ -294,9 +365,10 @@ size_t strc_payload::serialize(uint64_t* buff,
     return (2 * sizeof(uint64_t));
 }
 
-void strc_payload::deserialize(const uint64_t* buff,
+template <typename conv_byte_order_t>
+void strc_payload::_deserialize(const uint64_t* buff,
     size_t num_elems,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order)
+    const conv_byte_order_t& conv_byte_order)
 {
     UHD_ASSERT_THROW(num_elems >= 2);
 
@@ -310,6 +382,8 @@ void strc_payload::deserialize(const uint64_t* buff,
     num_bytes = conv_byte_order(buff[1]);
 }
 
+CHDR_PAYLOAD_DEFINE_SERDES(strc_payload)
+
 bool strc_payload::operator==(const strc_payload& rhs) const
 {
     return (src_epid == rhs.src_epid) && (op_code == rhs.op_code)
@@ -360,6 +434,39 @@ void mgmt_hop_t::deserialize(
     } while (ops_remaining > 0);
 }
 
+template <typename conv_byte_order_t>
+size_t mgmt_hop_t::_serialize(uint64_t* buff,
+    size_t max_num_elems,
+    const conv_byte_order_t& conv_byte_order) const
+{
+    UHD_ASSERT_THROW(get_num_ops() <= max_num_elems);
+    for (size_t i = 0; i < get_num_ops(); i++) {
+        buff[i] = conv_byte_order((static_cast<uint64_t>(_ops[i].get_op_payload()) << 16)
+                                  | (static_cast<uint64_t>(_ops[i].get_op_code()) << 8)
+                                  | (static_cast<uint64_t>(get_num_ops() - i - 1) << 0));
+    }
+    return get_num_ops();
+}
+
+template <typename conv_byte_order_t>
+size_t mgmt_hop_t::_deserialize(
+    const uint64_t* buff, size_t num_elems, const conv_byte_order_t& conv_byte_order)
+{
+    _ops.clear();
+    size_t ptr           = 0;
+    size_t ops_remaining = 0;
+    do {
+        // TODO: Change this to a legit exception
+        UHD_ASSERT_THROW(ptr < num_elems);
+
+        uint64_t op_word = conv_byte_order(buff[ptr++]);
+        ops_remaining    = static_cast<size_t>(op_word & 0xFF);
+        _ops.emplace_back(static_cast<mgmt_op_t::op_code_t>((op_word >> 8) & 0xFF),
+            static_cast<uint64_t>((op_word >> 16)));
+    } while (ops_remaining > 0);
+    return ptr;
+}
+
 void mgmt_payload::populate_header(chdr_header& header) const
 {
     header.set_pkt_type(PKT_TYPE_MGMT);
@@ -370,55 +477,51 @@ void mgmt_payload::populate_header(chdr_header& header) const
     header.set_dst_epid(0);
 }
 
-size_t mgmt_payload::serialize(uint64_t* buff,
+template <typename conv_byte_order_t>
+size_t mgmt_payload::_serialize(uint64_t* buff,
     size_t max_size_bytes,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order) const
+    const conv_byte_order_t& conv_byte_order) const
 {
-    std::vector<uint64_t> target;
+    const size_t max_num_elems = max_size_bytes / sizeof(uint64_t);
+    UHD_ASSERT_THROW(max_num_elems > 0);
+    size_t ptr = 0;
     // Insert header
-    target.push_back(conv_byte_order(
+    buff[ptr++] = conv_byte_order(
         (static_cast<uint64_t>(_protover) << 48)
         | (static_cast<uint64_t>(static_cast<uint8_t>(_chdr_w) & 0x7) << 45)
         | (static_cast<uint64_t>(get_num_hops() & 0x3FF) << 16)
-        | (static_cast<uint64_t>(_src_epid) << 0)));
+        | (static_cast<uint64_t>(_src_epid) << 0));
     // Insert data from each hop
     for (const auto& hop : _hops) {
-        hop.serialize(target, conv_byte_order);
+        ptr += hop._serialize(buff + ptr, max_num_elems - ptr, conv_byte_order);
     }
-    UHD_ASSERT_THROW(target.size() <= max_size_bytes);
-
-    // We use a vector and copy just for ease of implementation
-    // These transactions are not performance critical
-    std::copy(target.begin(), target.end(), buff);
-    return (target.size() * sizeof(uint64_t));
+    return (ptr * sizeof(uint64_t));
 }
 
-void mgmt_payload::deserialize(const uint64_t* buff,
-    size_t num_elems,
-    const std::function<uint64_t(uint64_t)>& conv_byte_order)
+template <typename conv_byte_order_t>
+void mgmt_payload::_deserialize(
+    const uint64_t* buff, size_t num_elems, const conv_byte_order_t& conv_byte_order)
 {
     UHD_ASSERT_THROW(num_elems > 1);
 
-    // We use a list and copy just for ease of implementation
-    // These transactions are not performance critical
-    std::list<uint64_t> src_list(buff, buff + num_elems);
-
     _hops.clear();
 
     // Deframe the header
-    uint64_t hdr = conv_byte_order(src_list.front());
+    size_t ptr   = 0;
+    uint64_t hdr = conv_byte_order(buff[ptr++]);
     _hops.resize(static_cast<size_t>((hdr >> 16) & 0x3FF));
     _src_epid = static_cast<sep_id_t>(hdr & 0xFFFF);
     _chdr_w   = static_cast<chdr_w_t>((hdr >> 45) & 0x7);
     _protover = static_cast<uint16_t>((hdr >> 48) & 0xFFFF);
-    src_list.pop_front();
 
     // Populate all hops
     for (size_t i = 0; i < get_num_hops(); i++) {
-        _hops[i].deserialize(src_list, conv_byte_order);
+        ptr += _hops[i]._deserialize(buff + ptr, num_elems - ptr, conv_byte_order);
     }
 }
 
+CHDR_PAYLOAD_DEFINE_SERDES(mgmt_payload)
+
 const std::string mgmt_payload::to_string() const
 {
     return str(boost::format(
@@ -0,0 +1,111 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/rfnoc/command_batch.hpp>
+#include <algorithm>
+
+using namespace uhd::rfnoc;
+
+command_batch::command_batch(const uhd::time_spec_t& time) : _time(time) {}
+
+void command_batch::set_time(const uhd::time_spec_t& time)
+{
+    _time = time;
+}
+
+uhd::time_spec_t command_batch::get_time() const
+{
+    return _time;
+}
+
+void command_batch::poke32(register_iface& regs, uint32_t addr, uint32_t data)
+{
+    auto& writes = _get_writes(regs);
+    writes.addrs.push_back(addr);
+    writes.data.push_back(data);
+}
+
+void command_batch::poke64(register_iface& regs, uint32_t addr, uint64_t data)
+{
+    block_poke32(regs,
+        addr,
+        {uint32_t(data & 0xFFFFFFFF), uint32_t((data >> 32) & 0xFFFFFFFF)});
+}
+
+void command_batch::multi_poke32(register_iface& regs,
+    const std::vector<uint32_t>& addrs,
+    const std::vector<uint32_t>& data)
+{
+    if (addrs.size() != data.size()) {
+        throw uhd::value_error("addrs and data vectors must be of the same length");
+    }
+    auto& writes = _get_writes(regs);
+    writes.addrs.insert(writes.addrs.end(), addrs.begin(), addrs.end());
+    writes.data.insert(writes.data.end(), data.begin(), data.end());
+}
+
+void command_batch::block_poke32(
+    register_iface& regs, uint32_t first_addr, const std::vector<uint32_t>& data)
+{
+    auto& writes = _get_writes(regs);
+    for (size_t i = 0; i < data.size(); i++) {
+        writes.addrs.push_back(first_addr + (i * sizeof(uint32_t)));
+    }
+    writes.data.insert(writes.data.end(), data.begin(), data.end());
+}
+
+size_t command_batch::size() const
+{
+    size_t num_writes = 0;
+    for (const auto& writes : _writes) {
+        num_writes += writes.addrs.size();
+    }
+    return num_writes;
+}
+
+bool command_batch::empty() const
+{
+    return size() == 0;
+}
+
+void command_batch::clear()
+{
+    _writes.clear();
+}
+
+void command_batch::commit(bool wait)
+{
+    // Clear the batch even if sending fails, so it can't be sent twice by
+    // accident
+    std::vector<block_writes_t> writes;
+    writes.swap(_writes);
+
+    // First send the commands to all blocks, so the round trips overlap...
+    for (const auto& block_writes : writes) {
+        if (!block_writes.addrs.empty()) {
+            block_writes.regs->batch_poke32(block_writes.addrs, block_writes.data, _time);
+        }
+    }
+    // ...then wait for all of them to be executed.
+    if (wait) {
+        for (const auto& block_writes : writes) {
+            block_writes.regs->wait_for_batch();
+        }
+    }
+}
+
+command_batch::block_writes_t& command_batch::_get_writes(register_iface& regs)
+{
+    auto it = std::find_if(_writes.begin(),
+        _writes.end(),
+        [&regs](const block_writes_t& writes) { return writes.regs == &regs; });
+    if (it != _writes.end()) {
+        return *it;
+    }
+    _writes.push_back({&regs, {}, {}});
+    return _writes.back();
+}
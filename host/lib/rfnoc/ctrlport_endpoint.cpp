@@ -11,10 +11,15 @@
 #include <uhdlib/rfnoc/ctrlport_endpoint.hpp>
 #include <condition_variable>
 #include <boost/format.hpp>
+#include <boost/optional.hpp>
 #include <deque>
+#include <exception>
+#include <map>
 #include <mutex>
 #include <numeric>
-#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 
 using namespace uhd;
@@ -67,10 +72,11 @@ public:
         // Compute transaction expiration time
         auto timeout_time = start_timeout(_policy.timeout);
         // Send request
-        auto request =
-            send_request_packet(OP_WRITE, addr, {data}, timestamp, timeout_time);
+        const bool await_ack = ack || _policy.force_acks;
+        auto request         = send_request_packet(
+            OP_WRITE, addr, {data}, timestamp, timeout_time, await_ack);
         // Optionally wait for an ACK
-        if (ack || _policy.force_acks) {
+        if (await_ack) {
             wait_for_ack(request, timeout_time);
         }
     }
@@ -122,8 +128,8 @@ public:
         // Compute transaction expiration time
         auto timeout_time = start_timeout(_policy.timeout);
         // Send request
-        auto request =
-            send_request_packet(OP_READ, addr, {uint32_t(0)}, timestamp, timeout_time);
+        auto request = send_request_packet(
+            OP_READ, addr, {uint32_t(0)}, timestamp, timeout_time, true);
         // Wait for an ACK
         auto response = wait_for_ack(request, timeout_time);
         return response.data_vtr[0];
@@ -151,7 +157,7 @@ public:
             timeout_time);
         // Wait for an ACK
         auto response = wait_for_ack(request, timeout_time);
-        return response.data_vtr;
+        return response.data_vtr.to_vector();
         */
     }
 
@@ -168,13 +174,15 @@ public:
         // Compute transaction expiration time
         auto timeout_time = start_timeout(_policy.timeout);
         // Send request
-        auto request = send_request_packet(OP_POLL,
+        const bool await_ack = ack || _policy.force_acks;
+        auto request         = send_request_packet(OP_POLL,
             addr,
             {data, mask, static_cast<uint32_t>(timeout.to_ticks(_client_clk.get_freq()))},
             timestamp,
-            timeout_time);
+            timeout_time,
+            await_ack);
         // Optionally wait for an ACK
-        if (ack || _policy.force_acks) {
+        if (await_ack) {
             wait_for_ack(request, timeout_time);
         }
     }
@@ -184,17 +192,92 @@ public:
         // Compute transaction expiration time
         auto timeout_time = start_timeout(_policy.timeout);
         // Send request
-        auto request = send_request_packet(OP_SLEEP,
+        const bool await_ack = ack || _policy.force_acks;
+        auto request         = send_request_packet(OP_SLEEP,
             0,
             {static_cast<uint32_t>(duration.to_ticks(_client_clk.get_freq()))},
             uhd::time_spec_t::ASAP,
-            timeout_time);
+            timeout_time,
+            await_ack);
         // Optionally wait for an ACK
-        if (ack || _policy.force_acks) {
+        if (await_ack) {
             wait_for_ack(request, timeout_time);
         }
     }
 
+    virtual void batch_poke32(const std::vector<uint32_t>& addrs,
+        const std::vector<uint32_t>& data,
+        uhd::time_spec_t timestamp = uhd::time_spec_t::ASAP)
+    {
+        if (addrs.size() != data.size()) {
+            throw uhd::value_error("addrs and data vectors must be of the same length");
+        }
+        // A timed batch may sit in the command queue for a long time, so the
+        // timeout only covers sending the commands. The ACKs are checked as
+        // they arrive, and only the first error is kept for wait_for_batch().
+        const bool timed  = (timestamp != uhd::time_spec_t::ASAP);
+        auto timeout_time = start_timeout(timed ? MASSIVE_TIMEOUT : _policy.timeout);
+        std::vector<request_t> requests;
+        requests.reserve(addrs.size());
+        try {
+            for (size_t i = 0; i < addrs.size(); i++) {
+                requests.push_back(send_request_packet(OP_WRITE,
+                    addrs[i],
+                    {data[i]},
+                    (i == 0) ? timestamp : uhd::time_spec_t::ASAP,
+                    timeout_time,
+                    false,
+                    true));
+            }
+        } catch (...) {
+            // Nobody is going to wait for the commands that were sent
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (const auto& request : requests) {
+                drop_batched_request(request.id);
+            }
+            throw;
+        }
+    }
+
+    virtual void wait_for_batch()
+    {
+        const auto tid = std::this_thread::get_id();
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = _batches.find(tid);
+        if (it == _batches.end()) {
+            return;
+        }
+        // A timed batch may sit in the command queue for a long time
+        auto timeout_time =
+            start_timeout(it->second.timed ? MASSIVE_TIMEOUT : _policy.timeout);
+        // The batch is removed by store_response() once its last ACK arrived
+        // without an error, so look it up again each time
+        auto batch_done = [this, tid]() -> bool {
+            auto it = _batches.find(tid);
+            return it == _batches.end() || it->second.num_pending == 0;
+        };
+        if (not _resp_ready_cond.wait_until(lock, timeout_time, batch_done)) {
+            for (auto req_it = _batch_requests.begin(); req_it != _batch_requests.end();) {
+                if (req_it->second == tid) {
+                    req_it = _batch_requests.erase(req_it);
+                } else {
+                    ++req_it;
+                }
+            }
+            _batches.erase(tid);
+            throw uhd::op_timeout("Control operation timed out waiting for ACK");
+        }
+        it = _batches.find(tid);
+        if (it == _batches.end()) {
+            return;
+        }
+        const std::exception_ptr error = it->second.error;
+        _batches.erase(it);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
     virtual void register_async_msg_validator(async_msg_validator_t callback_f)
     {
         std::unique_lock<std::mutex> lock(_mutex);
@@ -227,34 +310,35 @@ public:
                 std::unique_lock<std::mutex> lock(_mutex);
                 response_status_t resp_status = RESP_VALID;
                 // Grant flow control credits
-                _buff_occupied -= get_payload_size(_req_queue.front());
+                const request_t& request = _req_queue.front();
+                _buff_occupied -= get_payload_size(request.payload);
                 _buff_free_cond.notify_one();
-                if (get_payload_size(_req_queue.front()) != get_payload_size(rx_ctrl)) {
+                if (get_payload_size(request.payload) != get_payload_size(rx_ctrl)) {
                     resp_status = RESP_SIZEERR;
                 }
+                // Hand the response to whoever waits for it
+                store_response(request, rx_ctrl, resp_status);
                 // Pop the request from the queue
                 _req_queue.pop_front();
-                // Push the response into the response queue
-                _resp_queue.push(std::make_tuple(rx_ctrl, resp_status));
-                _resp_ready_cond.notify_one();
             };
             // Function to process a response with sequence errors
             auto process_incorrect_response = [this]() {
                 std::unique_lock<std::mutex> lock(_mutex);
                 // Grant flow control credits
-                _buff_occupied -= get_payload_size(_req_queue.front());
+                const request_t& request = _req_queue.front();
+                _buff_occupied -= get_payload_size(request.payload);
                 _buff_free_cond.notify_one();
-                // Push a fabricated response into the response queue
-                ctrl_payload resp(_req_queue.front());
+                // Hand a fabricated response to whoever waits for it
+                ctrl_payload resp(request.payload);
                 resp.is_ack = true;
-                _resp_queue.push(std::make_tuple(resp, RESP_DROPPED));
-                _resp_ready_cond.notify_one();
+                store_response(request, resp, RESP_DROPPED);
                 // Pop the request from the queue
                 _req_queue.pop_front();
             };
 
             // Peek at the request queue to check the expected sequence number
-            int8_t seq_num_diff = int8_t(rx_ctrl.seq_num - _req_queue.front().seq_num);
+            int8_t seq_num_diff =
+                int8_t(rx_ctrl.seq_num - _req_queue.front().payload.seq_num);
             if (seq_num_diff == 0) { // No sequence error
                 process_correct_response();
             } else if (seq_num_diff > 0) { // Packet(s) dropped
@@ -284,7 +368,7 @@ public:
                 UHD_LOG_ERROR(
                     "CTRLEP", "Malformed async message request: Invalid num_data");
             } else {
-                if (!_validate_async_msg(rx_ctrl.address, rx_ctrl.data_vtr)) {
+                if (!_validate_async_msg(rx_ctrl.address, rx_ctrl.data_vtr.to_vector())) {
                     UHD_LOG_ERROR("CTRLEP",
                         "Malformed async message request: Async message was not "
                         "validated by block controller!");
@@ -312,8 +396,9 @@ public:
             }
             if (status == CMD_OKAY) {
                 try {
-                    _handle_async_msg(
-                        rx_ctrl.address, rx_ctrl.data_vtr, rx_ctrl.timestamp);
+                    _handle_async_msg(rx_ctrl.address,
+                        rx_ctrl.data_vtr.to_vector(),
+                        rx_ctrl.timestamp);
                 } catch (const std::exception& ex) {
                     UHD_LOG_ERROR("CTRLEP",
                         "Caught exception during async message handling: " << ex.what());
@@ -338,6 +423,17 @@ public:
     }
 
 private:
+    //! An outstanding request, and the ID under which its response is stored
+    struct request_t
+    {
+        ctrl_payload payload;
+        uint64_t id;
+    };
+    //! The software status (different from the transaction status) of the response
+    enum response_status_t { RESP_VALID, RESP_DROPPED, RESP_RTERR, RESP_SIZEERR };
+    //! A response and its status
+    using response_t = std::tuple<ctrl_payload, response_status_t>;
+
     //! Returns the length of the control payload in 32-bit words
     inline static size_t get_payload_size(const ctrl_payload& payload)
     {
@@ -353,20 +449,72 @@ private:
     //! Returns whether or not we have a timed command queued
     bool check_timed_in_queue() const
     {
-        for (auto pyld : _req_queue) {
-            if (pyld.has_timestamp()) {
+        for (const auto& request : _req_queue) {
+            if (request.payload.has_timestamp()) {
                 return true;
             }
         }
         return false;
     }
 
-    //! Sends a request control packet to a remote device
-    const ctrl_payload send_request_packet(ctrl_opcode_t op_code,
+    //! Stores the response for a request if a caller waits for it, else drops
+    // it. The ACK of a batched request is checked right away and only kept if
+    // it carries an error. Must be called with the mutex held.
+    void store_response(
+        const request_t& request, const ctrl_payload& rx_ctrl, response_status_t resp_status)
+    {
+        auto req_it = _batch_requests.find(request.id);
+        if (req_it != _batch_requests.end()) {
+            auto it = _batches.find(req_it->second);
+            _batch_requests.erase(req_it);
+            batch_t& batch = it->second;
+            if (!batch.error) {
+                try {
+                    check_response(request, rx_ctrl, resp_status);
+                } catch (...) {
+                    batch.error = std::current_exception();
+                }
+            }
+            if (--batch.num_pending == 0) {
+                if (!batch.error) {
+                    _batches.erase(it);
+                }
+                _resp_ready_cond.notify_all();
+            }
+            return;
+        }
+        auto it = _resp_map.find(request.id);
+        if (it != _resp_map.end()) {
+            it->second = std::make_tuple(rx_ctrl, resp_status);
+            _resp_ready_cond.notify_all();
+        }
+    }
+
+    //! Forgets a batched request whose ACK was not received yet. Must be called
+    // with the mutex held.
+    void drop_batched_request(uint64_t id)
+    {
+        auto req_it = _batch_requests.find(id);
+        if (req_it == _batch_requests.end()) {
+            return;
+        }
+        auto it = _batches.find(req_it->second);
+        _batch_requests.erase(req_it);
+        if (--it->second.num_pending == 0 && !it->second.error) {
+            _batches.erase(it);
+        }
+    }
+
+    //! Sends a request control packet to a remote device. If await_ack is set,
+    // the response is kept until it is collected with wait_for_ack(). If
+    // batched is set, the request is added to the batch of the calling thread.
+    const request_t send_request_packet(ctrl_opcode_t op_code,
         uint32_t address,
-        const std::vector<uint32_t>& data_vtr,
+        const ctrl_data_vtr_t& data_vtr,
         const uhd::time_spec_t& time_spec,
-        const steady_clock::time_point& timeout_time)
+        const steady_clock::time_point& timeout_time,
+        bool await_ack,
+        bool batched = false)
     {
 
         if (!_client_clk.is_running()) {
@@ -420,63 +568,83 @@ private:
             }
         }
         _buff_occupied += pyld_size;
-        _req_queue.push_back(tx_ctrl);
+        const request_t request = {tx_ctrl, _next_req_id++};
+        _req_queue.push_back(request);
+        if (await_ack) {
+            _resp_map[request.id] = boost::none;
+        }
+        if (batched) {
+            const auto tid = std::this_thread::get_id();
+            batch_t& batch = _batches[tid];
+            batch.num_pending++;
+            batch.timed = batch.timed || timestamp.is_initialized();
+            _batch_requests[request.id] = tid;
+        }
 
         // Send the payload as soon as there is room in the buffer
-        _handle_send(tx_ctrl, _policy.timeout);
+        try {
+            _handle_send(tx_ctrl, _policy.timeout);
+        } catch (...) {
+            _resp_map.erase(request.id);
+            drop_batched_request(request.id);
+            throw;
+        }
         _tx_seq_num = (_tx_seq_num + 1) % 64;
 
-        return tx_ctrl;
+        return request;
     }
 
     //! Waits for and returns the ACK for the specified request
     const ctrl_payload wait_for_ack(
-        const ctrl_payload& request, const steady_clock::time_point& timeout_time)
+        const request_t& request, const steady_clock::time_point& timeout_time)
     {
-        auto resp_ready = [this]() -> bool { return !_resp_queue.empty(); };
-        while (true) {
+        ctrl_payload rx_ctrl;
+        response_status_t resp_status;
+        {
             std::unique_lock<std::mutex> lock(_mutex);
-            // Wait until there is a response in the response queue
-            if (!resp_ready()) {
-                if (not _resp_ready_cond.wait_until(lock, timeout_time, resp_ready)) {
-                    throw uhd::op_timeout("Control operation timed out waiting for ACK");
-                }
-            }
-            // Extract the response packet
-            ctrl_payload rx_ctrl;
-            response_status_t resp_status;
-            std::tie(rx_ctrl, resp_status) = _resp_queue.front();
-            _resp_queue.pop();
-            // Check if this is the response meant for the request
-            // Filter by op_code, address and seq_num
-            if (rx_ctrl.seq_num == request.seq_num && rx_ctrl.op_code == request.op_code
-                && rx_ctrl.address == request.address) {
-                // Validate transaction status
-                if (rx_ctrl.status == CMD_CMDERR) {
-                    throw uhd::op_failed("Control operation returned a failing status");
-                } else if (rx_ctrl.status == CMD_TSERR) {
-                    throw uhd::op_timerr("Control operation returned a timestamp error");
-                }
-                // Check data vector size
-                if (rx_ctrl.data_vtr.size() == 0) {
-                    throw uhd::op_failed(
-                        "Control operation returned a malformed response");
-                }
-                // Validate response status
-                if (resp_status == RESP_DROPPED) {
-                    throw uhd::op_seqerr(
-                        "Response for a control transaction was dropped");
-                } else if (resp_status == RESP_RTERR) {
-                    throw uhd::op_timerr("Control operation encountered a routing error");
-                }
-                return rx_ctrl;
-            } else {
-                // This response does not belong to the request we passed in. Move on.
-                continue;
+            // Wait until the response for this request was received. Responses
+            // for other requests don't touch this entry.
+            auto& response  = _resp_map.at(request.id);
+            auto resp_ready = [&response]() -> bool { return bool(response); };
+            if (not _resp_ready_cond.wait_until(lock, timeout_time, resp_ready)) {
+                _resp_map.erase(request.id);
+                throw uhd::op_timeout("Control operation timed out waiting for ACK");
             }
+            std::tie(rx_ctrl, resp_status) = response.get();
+            _resp_map.erase(request.id);
         }
+        check_response(request, rx_ctrl, resp_status);
+        return rx_ctrl;
     }
 
+    //! Throws if the response signals that the request failed
+    static void check_response(const request_t& request,
+        const ctrl_payload& rx_ctrl,
+        response_status_t resp_status)
+    {
+        // Check that the response matches the request
+        if (rx_ctrl.seq_num != request.payload.seq_num
+            || rx_ctrl.op_code != request.payload.op_code
+            || rx_ctrl.address != request.payload.address) {
+            throw uhd::op_failed("Control operation returned a mismatched response");
+        }
+        // Validate transaction status
+        if (rx_ctrl.status == CMD_CMDERR) {
+            throw uhd::op_failed("Control operation returned a failing status");
+        } else if (rx_ctrl.status == CMD_TSERR) {
+            throw uhd::op_timerr("Control operation returned a timestamp error");
+        }
+        // Check data vector size
+        if (rx_ctrl.data_vtr.size() == 0) {
+            throw uhd::op_failed("Control operation returned a malformed response");
+        }
+        // Validate response status
+        if (resp_status == RESP_DROPPED) {
+            throw uhd::op_seqerr("Response for a control transaction was dropped");
+        } else if (resp_status == RESP_RTERR) {
+            throw uhd::op_timerr("Control operation encountered a routing error");
+        }
+    }
 
     //! The parameters associated with the policy that governs this object
     struct policy_args
@@ -484,9 +652,6 @@ private:
         double timeout  = DEFAULT_TIMEOUT;
         bool force_acks = DEFAULT_FORCE_ACKS;
     };
-    //! The software status (different from the transaction status) of the response
-    enum response_status_t { RESP_VALID, RESP_DROPPED, RESP_RTERR, RESP_SIZEERR };
-
     //! Function to call to send a control packet
     const send_fn_t _handle_send;
     //! The endpoint ID of this software endpoint
@@ -517,9 +682,28 @@ private:
     //! A condition variable that hold the "downstream buffer is free" condition
     std::condition_variable _buff_free_cond;
     //! A queue that holds all outstanding requests
-    std::deque<ctrl_payload> _req_queue;
-    //! A queue that holds all outstanding responses and their status
-    std::queue<std::tuple<ctrl_payload, response_status_t>> _resp_queue;
+    std::deque<request_t> _req_queue;
+    //! The ID of the next request
+    uint64_t _next_req_id = 0;
+    //! The state of the batch_poke32() requests of a thread that wait_for_batch()
+    // has not collected yet
+    struct batch_t
+    {
+        //! The number of requests whose ACK was not received yet
+        size_t num_pending = 0;
+        //! Set if any of the outstanding batches was timed
+        bool timed = false;
+        //! The first error any of the ACKs carried
+        std::exception_ptr error;
+    };
+    //! Outstanding batches of each thread. A thread only waits for its own. A
+    // batch is removed once all its ACKs arrived without an error.
+    std::map<std::thread::id, batch_t> _batches;
+    //! The thread that sent each batched request whose ACK was not received yet
+    std::unordered_map<uint64_t, std::thread::id> _batch_requests;
+    //! The responses of all requests that a caller waits for, by request ID.
+    // An entry is empty until the response was received.
+    std::unordered_map<uint64_t, boost::optional<response_t>> _resp_map;
     //! A condition variable that hold the "response is available" condition
     std::condition_variable _resp_ready_cond;
     //! A mutex to protect all state in this class
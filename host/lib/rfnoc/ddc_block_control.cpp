@@ -7,6 +7,7 @@
 #include <uhd/exception.hpp>
 #include <uhd/rfnoc/ddc_block_control.hpp>
 #include <uhd/rfnoc/defaults.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
 #include <uhd/rfnoc/property.hpp>
 #include <uhd/rfnoc/registry.hpp>
 #include <uhd/types/ranges.hpp>
@@ -14,9 +15,6 @@
 #include <uhd/utils/math.hpp>
 #include <uhdlib/usrp/cores/dsp_core_utils.hpp>
 #include <uhdlib/utils/compat_check.hpp>
-#include <uhdlib/utils/math.hpp>
-#include <boost/math/special_functions/round.hpp>
-#include <set>
 #include <string>
 
 namespace {
@@ -56,6 +54,7 @@ public:
     , _fpga_compat(regs().peek32(RB_COMPAT_NUM)),
         _num_halfbands(regs().peek32(RB_NUM_HB)),
         _cic_max_decim(regs().peek32(RB_CIC_MAX_DECIM)),
+        _planner(dsp_rate_planner::DECIMATION, _num_halfbands, _cic_max_decim),
         _residual_scaling(get_num_input_ports(), DEFAULT_SCALING)
     {
         UHD_ASSERT_THROW(get_num_input_ports() == get_num_output_ports());
@@ -72,17 +71,6 @@ public:
                                                "max CIC decimation "
                                             << _cic_max_decim);
         set_mtu_forwarding_policy(forwarding_policy_t::ONE_TO_ONE);
-        // Load list of valid decimation values
-        std::set<size_t> decims{1}; // 1 is always a valid decimation
-        for (size_t hb = 0; hb < _num_halfbands; hb++) {
-            for (size_t cic_decim = 1; cic_decim <= _cic_max_decim; cic_decim++) {
-                decims.insert((1 << hb) * cic_decim);
-            }
-        }
-        for (size_t decim : decims) {
-            _valid_decims.push_back(uhd::range_t(double(decim)));
-        }
-
         // Initialize properties. It is very important to first reserve the
         // space, because we use push_back() further down, and properties must
         // not change their base address after registration and resolver
@@ -149,7 +137,8 @@ public:
         const double input_rate = _samp_rate_in.at(chan).get();
         // The decimations are stored in order (from smallest to biggest), so
         // iterate in reverse order so we can add rates from smallest to biggest
-        for (auto it = _valid_decims.rbegin(); it != _valid_decims.rend(); ++it) {
+        const auto& valid_decims = _planner.get_valid_rate_changes();
+        for (auto it = valid_decims.rbegin(); it != valid_decims.rend(); ++it) {
             result.push_back(uhd::range_t(input_rate / it->start()));
         }
         return result;
@@ -170,6 +159,11 @@ public:
         return _samp_rate_out.at(chan).get();
     }
 
+    const dsp_rate_planner& get_rate_planner() const
+    {
+        return _planner;
+    }
+
     // Somewhat counter-intuitively, we post a stream command as a message to
     // ourselves. That's because it's easier to re-use the message handler than
     // it is to reuse the issue_stream_cmd() API call, because this API call
@@ -428,22 +422,17 @@ private:
     /*! Update the decimation value
      *
      * \param decim The new decimation value. It must be valid decimation value.
-     * \throws uhd::assertion_error if decim is not valid.
+     * \throws uhd::value_error if decim is not valid.
      */
     void set_decim(int decim, const size_t chan)
     {
         RFNOC_LOG_TRACE("Set decim to " << decim);
-        // Step 1: Calculate number of halfbands
-        uint32_t hb_enable = 0;
-        uint32_t cic_decim = decim;
-        while ((cic_decim % 2 == 0) and hb_enable < _num_halfbands) {
-            hb_enable++;
-            cic_decim /= 2;
-        }
-        // Step 2: Make sure we can handle the rest with the CIC
-        UHD_ASSERT_THROW(hb_enable <= _num_halfbands);
-        UHD_ASSERT_THROW(cic_decim > 0 and cic_decim <= _cic_max_decim);
-        const uint32_t decim_word = (hb_enable << 8) | cic_decim;
+        // The planner has precomputed the register values for every valid
+        // decimation value
+        const auto& setting       = _planner.get_rate_setting(decim);
+        const uint32_t hb_enable  = setting.num_halfbands;
+        const uint32_t cic_decim  = setting.cic_rate_change;
+        const uint32_t decim_word = setting.rate_word;
         regs().poke32(get_addr(SR_DECIM_ADDR, chan), decim_word);
 
         // Rate change = M/N
@@ -465,37 +454,11 @@ private:
                 << decim);
         }
 
-        constexpr double DDS_GAIN = 2.0;
-        // Calculate algorithmic gain of CIC for a given decimation.
-        // For Ettus CIC R=decim, M=1, N=4. Gain = (R * M) ^ N
-        // The Ettus CIC also tries its best to compensate for the gain by
-        // shifting the CIC output. This reduces the gain by a factor of
-        // 2**ceil(log2(cic_gain))
-        const double cic_gain = std::pow(double(cic_decim * 1), 4);
-        // DDS gain:
-        const double total_gain =
-            DDS_GAIN * cic_gain / std::pow(2, uhd::math::ceil_log2(cic_gain));
-        update_scaling(total_gain, chan);
-    }
-
-    //! Update scaling based on the current gain
-    //
-    // Calculates the closest fixpoint value that this block can correct for in
-    // hardware (fixpoint). The residual gain is written to _residual_scaling.
-    void update_scaling(const double dsp_gain, const size_t chan)
-    {
-        constexpr double FIXPOINT_SCALING = 1 << 15;
-        const double compensation_factor  = 1. / dsp_gain;
-        // Convert to fixpoint
-        const double target_factor  = FIXPOINT_SCALING * compensation_factor;
-        const int32_t actual_factor = boost::math::iround(target_factor);
         // Write DDC with scaling correction for CIC and DDS that maximizes
-        // dynamic range
-        regs().poke32(get_addr(SR_SCALE_IQ_ADDR, chan), actual_factor);
-
-        // Calculate the error introduced by using fixedpoint representation for
-        // the scaler, can be corrected in host later.
-        _residual_scaling[chan] = dsp_gain * double(actual_factor) / FIXPOINT_SCALING;
+        // dynamic range. The error introduced by using a fixpoint representation
+        // for the scaler is corrected in host later.
+        regs().poke32(get_addr(SR_SCALE_IQ_ADDR, chan), setting.scale_word);
+        _residual_scaling[chan] = setting.residual_scaling;
     }
 
     /*! Return the closest possible decimation value to the one requested
@@ -503,7 +466,7 @@ private:
     int coerce_decim(const double requested_decim) const
     {
         UHD_ASSERT_THROW(requested_decim >= 0);
-        return static_cast<int>(_valid_decims.clip(requested_decim, true));
+        return _planner.coerce_rate_change(requested_decim);
     }
 
     //! Set the DDS frequency shift the signal to \p requested_freq
@@ -529,8 +492,8 @@ private:
     //! Max CIC decim
     const size_t _cic_max_decim;
 
-    //! List of valid decimation values
-    uhd::meta_range_t _valid_decims;
+    //! Precomputed rate change and scaling settings
+    const dsp_rate_planner _planner;
 
     //! Cache the current residual scaling
     std::vector<double> _residual_scaling;
@@ -0,0 +1,176 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
+#include <uhdlib/usrp/cores/dsp_core_utils.hpp>
+#include <uhdlib/utils/math.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <cmath>
+#include <string>
+
+using namespace uhd::rfnoc;
+
+namespace {
+
+//! Gain of the CORDIC
+constexpr double DDS_GAIN = 2.0;
+//! The IQ scaling register is a fixpoint value with 15 fractional bits
+constexpr double FIXPOINT_SCALING = 1 << 15;
+//! Limits the size of the lookup tables, real blocks have far fewer halfbands
+constexpr size_t MAX_NUM_HALFBANDS = 8;
+
+} // namespace
+
+dsp_rate_planner::dsp_rate_planner(const rate_change_type_t type,
+    const size_t num_halfbands,
+    const size_t cic_max_rate_change)
+    : _type(type)
+{
+    if (cic_max_rate_change == 0 || cic_max_rate_change > 0xFF) {
+        throw uhd::value_error("Invalid max CIC rate change: "
+                               + std::to_string(cic_max_rate_change));
+    }
+    if (num_halfbands > MAX_NUM_HALFBANDS) {
+        throw uhd::value_error(
+            "Invalid number of halfbands: " + std::to_string(num_halfbands));
+    }
+    const size_t max_rate_change =
+        (num_halfbands == 0) ? 1
+                             : (size_t(1) << (num_halfbands - 1)) * cic_max_rate_change;
+
+    // Mark all valid rate changes. 1 is always valid. The largest valid rate
+    // change is max_rate_change, so it's also the last entry of the tables.
+    rate_setting_t invalid_setting;
+    invalid_setting.rate_change = 0;
+    _settings.resize(max_rate_change + 1, invalid_setting);
+    _settings[1].rate_change = 1;
+    for (size_t hb = 0; hb < num_halfbands; hb++) {
+        for (size_t cic = 1; cic <= cic_max_rate_change; cic++) {
+            _settings[(size_t(1) << hb) * cic].rate_change = 1;
+        }
+    }
+
+    for (size_t rate_change = 1; rate_change < _settings.size(); rate_change++) {
+        rate_setting_t& setting = _settings[rate_change];
+        if (setting.rate_change == 0) {
+            continue;
+        }
+        // Use as many halfbands as possible, the CIC does the rest
+        uint32_t hb_enable = 0;
+        uint32_t cic       = rate_change;
+        while ((cic % 2 == 0) and hb_enable < num_halfbands) {
+            hb_enable++;
+            cic /= 2;
+        }
+        UHD_ASSERT_THROW(cic > 0 and cic <= cic_max_rate_change);
+        setting.rate_change     = static_cast<int>(rate_change);
+        setting.num_halfbands   = hb_enable;
+        setting.cic_rate_change = cic;
+        setting.rate_word       = (hb_enable << 8) | cic;
+
+        // Calculate algorithmic gain of CIC for a given rate change. For Ettus
+        // CIC R=rate_change, M=1, N=4. The gain is (R * M) ^ N for decimation,
+        // and (R * M) ^ (N - 1) for interpolation.
+        // The Ettus CIC also tries its best to compensate for the gain by
+        // shifting the CIC output. This reduces the gain by a factor of
+        // 2**ceil(log2(cic_gain))
+        const double cic_gain = std::pow(double(cic), (type == DECIMATION) ? 4 : 3);
+        setting.dsp_gain =
+            DDS_GAIN * cic_gain / std::pow(2, uhd::math::ceil_log2(cic_gain));
+        // Calculate the closest fixpoint value that the block can correct for
+        // in hardware. The residual gain can be corrected on the host.
+        const int32_t scale_factor =
+            boost::math::iround(FIXPOINT_SCALING / setting.dsp_gain);
+        setting.scale_word = static_cast<uint32_t>(scale_factor);
+        setting.residual_scaling =
+            setting.dsp_gain * double(scale_factor) / FIXPOINT_SCALING;
+
+        _valid_rate_changes.push_back(uhd::range_t(double(rate_change)));
+    }
+
+    // Neighbour tables for coercion
+    _lower_valid.resize(_settings.size());
+    _upper_valid.resize(_settings.size());
+    int lower = 1;
+    for (size_t k = 0; k < _settings.size(); k++) {
+        if (_settings[k].rate_change != 0) {
+            lower = int(k);
+        }
+        _lower_valid[k] = lower;
+    }
+    int upper = int(max_rate_change);
+    for (size_t k = _settings.size(); k-- > 0;) {
+        if (_settings[k].rate_change != 0) {
+            upper = int(k);
+        }
+        _upper_valid[k] = upper;
+    }
+}
+
+dsp_rate_planner::rate_change_type_t dsp_rate_planner::get_type() const
+{
+    return _type;
+}
+
+const uhd::meta_range_t& dsp_rate_planner::get_valid_rate_changes() const
+{
+    return _valid_rate_changes;
+}
+
+int dsp_rate_planner::coerce_rate_change(const double requested_rate_change) const
+{
+    // Note: This also catches NaN
+    if (!(requested_rate_change >= 0)) {
+        throw uhd::value_error("Invalid rate change requested: "
+                               + std::to_string(requested_rate_change));
+    }
+    const size_t max_index = _settings.size() - 1;
+    if (requested_rate_change >= double(max_index)) {
+        return _lower_valid[max_index];
+    }
+    const int lower = _lower_valid[size_t(std::floor(requested_rate_change))];
+    const int upper = _upper_valid[size_t(std::ceil(requested_rate_change))];
+    // On a tie, pick the smaller value (like meta_range_t::clip())
+    return (upper - requested_rate_change < requested_rate_change - lower) ? upper
+                                                                           : lower;
+}
+
+const dsp_rate_planner::rate_setting_t& dsp_rate_planner::get_rate_setting(
+    const int rate_change) const
+{
+    if (rate_change <= 0 || size_t(rate_change) >= _settings.size()
+        || _settings[rate_change].rate_change == 0) {
+        throw uhd::value_error("Invalid rate change: " + std::to_string(rate_change));
+    }
+    return _settings[rate_change];
+}
+
+dsp_rate_planner::plan_t dsp_rate_planner::plan(const double dsp_rate,
+    const double requested_rate,
+    const double requested_freq) const
+{
+    if (!(dsp_rate > 0) || !(requested_rate > 0)) {
+        throw uhd::value_error("Sampling rates must be positive!");
+    }
+    return plan_rate_change(
+        dsp_rate, coerce_rate_change(dsp_rate / requested_rate), requested_freq);
+}
+
+dsp_rate_planner::plan_t dsp_rate_planner::plan_rate_change(
+    const double dsp_rate, const int rate_change, const double requested_freq) const
+{
+    if (!(dsp_rate > 0)) {
+        throw uhd::value_error("Sampling rates must be positive!");
+    }
+    plan_t result;
+    result.setting = get_rate_setting(rate_change);
+    result.rate    = dsp_rate / rate_change;
+    int32_t freq_word;
+    get_freq_and_freq_word(requested_freq, dsp_rate, result.freq, freq_word);
+    result.freq_word = static_cast<uint32_t>(freq_word);
+    return result;
+}
@@ -6,6 +6,7 @@
 
 #include <uhd/exception.hpp>
 #include <uhd/rfnoc/defaults.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
 #include <uhd/rfnoc/duc_block_control.hpp>
 #include <uhd/rfnoc/property.hpp>
 #include <uhd/rfnoc/registry.hpp>
@@ -14,9 +15,6 @@
 #include <uhd/utils/math.hpp>
 #include <uhdlib/usrp/cores/dsp_core_utils.hpp>
 #include <uhdlib/utils/compat_check.hpp>
-#include <uhdlib/utils/math.hpp>
-#include <boost/math/special_functions/round.hpp>
-#include <set>
 #include <string>
 
 namespace {
@@ -54,6 +52,7 @@ public:
     , _fpga_compat(regs().peek32(RB_COMPAT_NUM)),
         _num_halfbands(regs().peek32(RB_NUM_HB)),
         _cic_max_interp(regs().peek32(RB_CIC_MAX_INTERP)),
+        _planner(dsp_rate_planner::INTERPOLATION, _num_halfbands, _cic_max_interp),
         _residual_scaling(get_num_input_ports(), DEFAULT_SCALING)
     {
         UHD_ASSERT_THROW(get_num_input_ports() == get_num_output_ports());
@@ -69,17 +68,6 @@ public:
                                             << " halfbands and "
                                                "max CIC interpolation "
                                             << _cic_max_interp);
-        // Load list of valid interpolation values
-        std::set<size_t> interps{1}; // 1 is always a valid interpolation
-        for (size_t hb = 0; hb < _num_halfbands; hb++) {
-            for (size_t cic_interp = 1; cic_interp <= _cic_max_interp; cic_interp++) {
-                interps.insert((1 << hb) * cic_interp);
-            }
-        }
-        for (size_t interp : interps) {
-            _valid_interps.push_back(uhd::range_t(double(interp)));
-        }
-
         // Initialize properties. It is very important to first reserve the
         // space, because we use push_back() further down, and properties must
         // not change their base address after registration and resolver
@@ -146,7 +134,8 @@ public:
         const double output_rate = _samp_rate_out.at(chan).get();
         // The interpolations are stored in order (from smallest to biggest), so
         // iterate in reverse order so we can add rates from smallest to biggest
-        for (auto it = _valid_interps.rbegin(); it != _valid_interps.rend(); ++it) {
+        const auto& valid_interps = _planner.get_valid_rate_changes();
+        for (auto it = valid_interps.rbegin(); it != valid_interps.rend(); ++it) {
             result.push_back(uhd::range_t(output_rate / it->start()));
         }
         return result;
@@ -167,6 +156,11 @@ public:
         return _samp_rate_in.at(chan).get();
     }
 
+    const dsp_rate_planner& get_rate_planner() const
+    {
+        return _planner;
+    }
+
 private:
     //! Shorthand for num ports, since num input ports always equals num output ports
     inline size_t get_num_ports()
@@ -438,22 +432,17 @@ private:
     /*! Update the interpolation value
      *
      * \param interp The new interpolation value.
-     * \throws uhd::assertion_error if interp is not valid.
+     * \throws uhd::value_error if interp is not valid.
      */
     void set_interp(int interp, const size_t chan)
     {
         RFNOC_LOG_TRACE("Set interp to " << interp);
-        // Step 1: Calculate number of halfbands
-        uint32_t hb_enable  = 0;
-        uint32_t cic_interp = interp;
-        while ((cic_interp % 2 == 0) and hb_enable < _num_halfbands) {
-            hb_enable++;
-            cic_interp /= 2;
-        }
-        // Step 2: Make sure we can handle the rest with the CIC
-        UHD_ASSERT_THROW(hb_enable <= _num_halfbands);
-        UHD_ASSERT_THROW(cic_interp > 0 and cic_interp <= _cic_max_interp);
-        const uint32_t interp_word = (hb_enable << 8) | cic_interp;
+        // The planner has precomputed the register values for every valid
+        // interpolation value
+        const auto& setting        = _planner.get_rate_setting(interp);
+        const uint32_t hb_enable   = setting.num_halfbands;
+        const uint32_t cic_interp  = setting.cic_rate_change;
+        const uint32_t interp_word = setting.rate_word;
         regs().poke32(get_addr(SR_INTERP_ADDR, chan), interp_word);
 
         // Rate change = M/N, where N = 1
@@ -470,37 +459,11 @@ private:
                 "enabled.\n");
         }
 
-        // DDS gain:
-        constexpr double DDS_GAIN = 2.0;
-        // Calculate algorithmic gain of CIC for a given interpolation.
-        // For Ettus CIC R=interp, M=1, N=4. Gain = (R * M) ^ (N - 1)
-        const double cic_gain = std::pow(double(cic_interp * 1), /*N*/ 4 - 1);
-        // The Ettus CIC also tries its best to compensate for the gain by
-        // shifting the CIC output. This reduces the gain by a factor of
-        // 2**ceil(log2(cic_gain))
-        const double total_gain =
-            DDS_GAIN * cic_gain / std::pow(2, uhd::math::ceil_log2(cic_gain));
-        update_scaling(total_gain, chan);
-    }
-
-    //! Update scaling based on the current gain
-    //
-    // Calculates the closest fixpoint value that this block can correct for in
-    // hardware (fixpoint). The residual gain is written to _residual_scaling.
-    void update_scaling(const double dsp_gain, const size_t chan)
-    {
-        constexpr double FIXPOINT_SCALING = 1 << 15;
-        const double compensation_factor  = 1. / dsp_gain;
-        // Convert to fixpoint
-        const double target_factor  = FIXPOINT_SCALING * compensation_factor;
-        const int32_t actual_factor = boost::math::iround(target_factor);
         // Write DUC with scaling correction for CIC and DDS that maximizes
-        // dynamic range
-        regs().poke32(get_addr(SR_SCALE_IQ_ADDR, chan), actual_factor);
-
-        // Calculate the error introduced by using fixedpoint representation for
-        // the scaler, can be corrected in host later.
-        _residual_scaling[chan] = dsp_gain * double(actual_factor) / FIXPOINT_SCALING;
+        // dynamic range. The error introduced by using a fixpoint representation
+        // for the scaler is corrected in host later.
+        regs().poke32(get_addr(SR_SCALE_IQ_ADDR, chan), setting.scale_word);
+        _residual_scaling[chan] = setting.residual_scaling;
     }
 
     /*! Return the closest possible interpolation value to the one requested
@@ -508,7 +471,7 @@ private:
     int coerce_interp(const double requested_interp) const
     {
         UHD_ASSERT_THROW(requested_interp >= 0);
-        return static_cast<int>(_valid_interps.clip(requested_interp, true));
+        return _planner.coerce_rate_change(requested_interp);
     }
 
     //! Set the DDS frequency shift the signal to \p requested_freq
@@ -534,8 +497,8 @@ private:
     //! Max CIC interpolation
     const size_t _cic_max_interp;
 
-    //! List of valid interpolation values
-    uhd::meta_range_t _valid_interps;
+    //! Precomputed rate change and scaling settings
+    const dsp_rate_planner _planner;
 
     //! Cache the current residual scaling
     std::vector<double> _residual_scaling;
@@ -23,6 +23,7 @@ rfnoc_rx_streamer::rfnoc_rx_streamer(
     : rx_streamer_impl<chdr_rx_data_xport>(num_chans, stream_args)
     , _unique_id(STREAMER_ID + "#" + std::to_string(streamer_inst_ctr++))
     , _stream_args(stream_args)
+    , _fc_xports(num_chans, nullptr)
 {
     set_overrun_handler([this]() { this->_handle_overrun(); });
 
@@ -88,6 +89,12 @@ rfnoc_rx_streamer::rfnoc_rx_streamer(
     node_accessor.init_props(this);
 }
 
+rfnoc_rx_streamer::~rfnoc_rx_streamer()
+{
+    // Channel streamers that outlive this streamer must not post actions to it
+    _detach_channel_streamers();
+}
+
 std::string rfnoc_rx_streamer::get_unique_id() const
 {
     return _unique_id;
@@ -105,7 +112,7 @@ size_t rfnoc_rx_streamer::get_num_output_ports() const
 
 void rfnoc_rx_streamer::issue_stream_cmd(const stream_cmd_t& stream_cmd)
 {
-    if (get_num_channels() > 1 and stream_cmd.stream_now
+    if (get_num_channels() > 1 and stream_cmd.stream_now and !has_independent_channels()
         and stream_cmd.stream_mode != stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS) {
         throw uhd::runtime_error(
             "Invalid recv stream command - stream now on multiple channels in a "
@@ -121,6 +128,14 @@ void rfnoc_rx_streamer::issue_stream_cmd(const stream_cmd_t& stream_cmd)
     }
 }
 
+void rfnoc_rx_streamer::issue_channel_stream_cmd(
+    const size_t chan, const stream_cmd_t& stream_cmd)
+{
+    auto cmd        = stream_cmd_action_info::make(stream_cmd.stream_mode);
+    cmd->stream_cmd = stream_cmd;
+    post_action({res_source_info::INPUT_EDGE, chan}, cmd);
+}
+
 const uhd::stream_args_t& rfnoc_rx_streamer::get_stream_args() const
 {
     return _stream_args;
@@ -157,7 +172,23 @@ void rfnoc_rx_streamer::connect_channel(
     const size_t mtu = xport->get_max_payload_size();
     set_property<size_t>(PROP_KEY_MTU, mtu, {res_source_info::INPUT_EDGE, channel});
 
+    const chdr_rx_data_xport* xport_ptr = xport.get();
     rx_streamer_impl<chdr_rx_data_xport>::connect_channel(channel, std::move(xport));
+    _fc_xports[channel] = xport_ptr;
+}
+
+rx_streamer::flow_control_stats_t rfnoc_rx_streamer::get_flow_control_stats() const
+{
+    flow_control_stats_t stats;
+    for (const chdr_rx_data_xport* xport : _fc_xports) {
+        if (xport) {
+            const auto xport_stats = xport->get_fc_stats();
+            stats.num_resps_sent += xport_stats.num_resps_sent;
+            stats.num_resps_deferred += xport_stats.num_resps_deferred;
+            stats.num_bytes_received += xport_stats.num_bytes_received;
+        }
+    }
+    return stats;
 }
 
 void rfnoc_rx_streamer::_register_props(const size_t chan,
@@ -247,7 +278,7 @@ void rfnoc_rx_streamer::_handle_rx_event_action(
     } else if (rx_event_action->error_code
                == uhd::rx_metadata_t::ERROR_CODE_LATE_COMMAND) {
         RFNOC_LOG_DEBUG("Received late command message on port " << src.instance);
-        set_stopped_due_to_late_command();
+        set_stopped_due_to_late_command(src.instance);
     }
 }
 
@@ -142,6 +142,21 @@ bool rfnoc_tx_streamer::recv_async_msg(uhd::async_metadata_t& async_metadata,
     return _async_msg_queue->recv_async_msg(async_metadata, timeout_ms);
 }
 
+void rfnoc_tx_streamer::set_async_msg_callback(const async_msg_callback_t& callback)
+{
+    _async_msg_queue->set_callback(callback);
+}
+
+int rfnoc_tx_streamer::get_async_msg_fd(void)
+{
+    return _async_msg_queue->get_event_fd();
+}
+
+size_t rfnoc_tx_streamer::get_num_dropped_async_msgs(void) const
+{
+    return _async_msg_queue->get_num_dropped();
+}
+
 void rfnoc_tx_streamer::_register_props(const size_t chan,
     const std::string& otw_format)
 {
@@ -4,9 +4,16 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 //
 
+#include <uhd/exception.hpp>
 #include <uhdlib/rfnoc/tx_async_msg_queue.hpp>
 #include <chrono>
+#include <cstring>
 #include <thread>
+#ifdef UHD_PLATFORM_LINUX
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#    include <cerrno>
+#endif
 
 using namespace uhd;
 using namespace uhd::rfnoc;
@@ -16,6 +23,16 @@ tx_async_msg_queue::tx_async_msg_queue(size_t capacity)
 {
 }
 
+tx_async_msg_queue::~tx_async_msg_queue()
+{
+#ifdef UHD_PLATFORM_LINUX
+    const int fd = _event_fd.load();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+#endif
+}
+
 bool tx_async_msg_queue::recv_async_msg(uhd::async_metadata_t& async_metadata,
     int32_t timeout_ms)
 {
@@ -48,5 +65,66 @@ bool tx_async_msg_queue::recv_async_msg(uhd::async_metadata_t& async_metadata,
 
 void tx_async_msg_queue::enqueue(const async_metadata_t& async_metadata)
 {
-    _queue.push(async_metadata);
+    const auto callback = std::atomic_load(&_callback);
+    if (callback) {
+        (*callback)(async_metadata);
+        return;
+    }
+
+    // Don't grow the queue past its capacity, drop the oldest message instead.
+    // Messages usually report errors, and the application is more interested
+    // in the current state than in the history.
+    while (!_queue.bounded_push(async_metadata)) {
+        async_metadata_t oldest;
+        if (_queue.pop(oldest)) {
+            _num_dropped++;
+        }
+    }
+
+#ifdef UHD_PLATFORM_LINUX
+    const int fd = _event_fd.load();
+    if (fd >= 0) {
+        // This can only fail if the counter overflows, in which case the fd
+        // is readable anyway
+        const uint64_t one = 1;
+        if (::write(fd, &one, sizeof(one)) < 0) {
+            // nop
+        }
+    }
+#endif
+}
+
+void tx_async_msg_queue::set_callback(const callback_t& callback)
+{
+    std::atomic_store(&_callback,
+        callback ? std::make_shared<callback_t>(callback)
+                 : std::shared_ptr<callback_t>());
+}
+
+int tx_async_msg_queue::get_event_fd()
+{
+#ifdef UHD_PLATFORM_LINUX
+    std::lock_guard<std::mutex> lock(_event_fd_mutex);
+    if (_event_fd.load() < 0) {
+        const int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0) {
+            throw uhd::os_error(
+                std::string("Failed to create eventfd: ") + std::strerror(errno));
+        }
+        _event_fd.store(fd);
+        // Messages queued before the fd existed didn't signal it. Signal them
+        // once, so a caller waiting on the fd doesn't miss them. Messages
+        // queued from here on signal the fd themselves.
+        if (!_queue.empty()) {
+            const uint64_t one = 1;
+            if (::write(fd, &one, sizeof(one)) < 0) {
+                // nop
+            }
+        }
+    }
+    return _event_fd.load();
+#else
+    throw uhd::not_implemented_error(
+        "Async message file descriptors are only available on Linux");
+#endif
 }
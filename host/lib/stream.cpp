@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 //
 
+#include <uhd/exception.hpp>
 #include <uhd/stream.hpp>
 
 using namespace uhd;
@@ -14,7 +15,83 @@ rx_streamer::~rx_streamer(void)
     //empty
 }
 
+size_t rx_streamer::recv_bulk(const buffs_type& buffs,
+    const size_t nsamps_per_buff,
+    rx_metadata_t& metadata,
+    rx_packet_info_t* packet_infos,
+    const size_t max_num_packets,
+    const double timeout)
+{
+    // The generic streamer doesn't know the size of a host sample, so it can't
+    // place packets back-to-back. Receiving one packet at a time is always a
+    // valid implementation of this call.
+    if (max_num_packets == 0) {
+        metadata.reset();
+        return 0;
+    }
+    const size_t num_samps = recv(buffs, nsamps_per_buff, metadata, timeout, true);
+    if (num_samps == 0) {
+        return 0;
+    }
+    packet_infos[0].offset        = 0;
+    packet_infos[0].num_samps     = num_samps;
+    packet_infos[0].has_time_spec = metadata.has_time_spec;
+    packet_infos[0].time_spec     = metadata.time_spec;
+    packet_infos[0].end_of_burst  = metadata.end_of_burst;
+    packet_infos[0].end_of_vector = metadata.eov_positions_count > 0;
+    return 1;
+}
+
+bool rx_streamer::supports_recv_view(void) const
+{
+    return false;
+}
+
+size_t rx_streamer::recv_view(rx_view_t&, rx_metadata_t&, const double)
+{
+    throw uhd::not_implemented_error("This streamer does not support recv_view()");
+}
+
+void rx_streamer::release_view(rx_view_t&)
+{
+    throw uhd::not_implemented_error("This streamer does not support recv_view()");
+}
+
+rx_streamer::sptr rx_streamer::get_channel_streamer(const size_t)
+{
+    throw uhd::not_implemented_error(
+        "This streamer does not support independent channels");
+}
+
+rx_streamer::flow_control_stats_t rx_streamer::get_flow_control_stats(void) const
+{
+    throw uhd::not_implemented_error(
+        "This streamer does not report flow control statistics");
+}
+
 tx_streamer::~tx_streamer(void)
 {
     //empty
 }
+
+void tx_streamer::set_async_msg_callback(const async_msg_callback_t&)
+{
+    throw uhd::not_implemented_error(
+        "This streamer does not support async message callbacks");
+}
+
+int tx_streamer::get_async_msg_fd(void)
+{
+    throw uhd::not_implemented_error(
+        "This streamer does not support an async message file descriptor");
+}
+
+size_t tx_streamer::get_num_dropped_async_msgs(void) const
+{
+    return 0;
+}
+
+tx_streamer::pacing_stats_t tx_streamer::get_pacing_stats(void) const
+{
+    throw uhd::not_implemented_error("This streamer does not support TX pacing");
+}
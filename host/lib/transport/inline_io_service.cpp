@@ -279,6 +279,11 @@ public:
             return true;
         }
 
+        if (!_fc_cb(num_bytes)) {
+            // The destination can't free up space for packets that are still
+            // held back by the link
+            _send_link->flush_send_buffs();
+        }
         while (!_fc_cb(num_bytes)) {
             const bool updated =
                 _io_srv->recv_flow_ctrl(this, _recv_link.get(), timeout_ms);
@@ -308,6 +313,18 @@ public:
         _num_frames_in_use--;
     }
 
+    bool supports_send_gather() const
+    {
+        // Packets are sent in the caller's thread, so the link is done with
+        // any gather payload by the time release_send_buff returns
+        return _send_link->supports_send_gather();
+    }
+
+    void flush_send_buffs()
+    {
+        _send_link->flush_send_buffs();
+    }
+
 private:
     inline_io_service::sptr _io_srv;
     send_link_if::sptr _send_link;
@@ -6,6 +6,7 @@
 
 #include <uhd/config.hpp>
 #include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
 #include <uhd/utils/thread.hpp>
 #include <uhdlib/transport/frame_reservation_mgr.hpp>
 #include <uhdlib/transport/offload_io_service.hpp>
@@ -13,11 +14,14 @@
 #include <uhdlib/utils/semaphore.hpp>
 #include <condition_variable>
 #include <boost/lockfree/queue.hpp>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
+#include <shared_mutex>
 #include <thread>
 
 namespace uhd { namespace transport {
@@ -26,6 +30,44 @@ namespace {
 
 constexpr int32_t blocking_timeout_ms = 10;
 
+// Time an adaptive offload thread that waits for several links blocks on one
+// of them before checking the others
+constexpr int32_t park_poll_interval_ms = 1;
+
+// Wakes up an offload thread that is parked in the adaptive wait mode. The
+// thread advertises that it is parked so that clients only pay for a
+// notification while it is actually asleep.
+class offload_thread_waker
+{
+public:
+    void notify()
+    {
+        // Pairs with the store in park(), so that either the client sees the
+        // thread parked or the thread sees the work the client queued
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_relaxed)) {
+            _sem.notify();
+        }
+    }
+
+    template <typename pred_t>
+    bool park(int32_t timeout_ms, pred_t work_pending)
+    {
+        _parked.store(true);
+        const bool woken = work_pending() || _sem.wait_for(timeout_ms);
+        _parked.store(false);
+
+        // Drop notifications that raced with waking up
+        while (_sem.try_wait()) {
+        }
+        return woken;
+    }
+
+private:
+    std::atomic<bool> _parked{false};
+    semaphore _sem;
+};
+
 // Fixed-size queue that supports blocking semantics
 template <typename queue_item_t>
 class offload_thread_queue {
@@ -102,9 +144,10 @@ struct client_port_impl_t
 public:
     using sptr = std::shared_ptr<client_port_impl_t>;
 
-    client_port_impl_t(size_t size)
+    client_port_impl_t(size_t size, offload_thread_waker* waker = nullptr)
         : _from_offload_thread(size)
         , _to_offload_thread(size + 1) // add one for disconnect command
+        , _waker(waker)
     {
     }
 
@@ -134,6 +177,9 @@ public:
     {
         to_offload_thread_t queue_element{buff, false};
         _to_offload_thread.push(queue_element);
+        if (_waker) {
+            _waker->notify();
+        }
     }
 
     void client_wait_until_connected()
@@ -146,6 +192,9 @@ public:
     {
         to_offload_thread_t queue_element{nullptr, true};
         _to_offload_thread.push(queue_element);
+        if (_waker) {
+            _waker->notify();
+        }
 
         // Need to wait for the disconnect to occur before returning, since the
         // caller (the xport object) has callbacks installed in the inline I/O
@@ -184,6 +233,11 @@ public:
         return std::make_tuple(queue_element.buff, queue_element.disconnect);
     }
 
+    size_t offload_thread_read_available()
+    {
+        return _to_offload_thread.read_available();
+    }
+
     void offload_thread_set_connected(const bool value)
     {
         {
@@ -232,6 +286,9 @@ private:
     from_offload_thread_queue_t _from_offload_thread;
     to_offload_thread_queue_t _to_offload_thread;
 
+    // Used to wake the offload thread when it is parked, may be null
+    offload_thread_waker* _waker;
+
     // Mutex and condition variable to wait for connect and disconnect
     std::condition_variable _connect_cv;
     std::mutex _connect_cv_mutex;
@@ -281,6 +338,10 @@ public:
         recv_callback_t recv_cb,
         send_io_if::fc_callback_t fc_cb);
 
+    wait_stats_t get_wait_stats() const;
+
+    std::vector<thread_load_t> get_thread_load() const;
+
 private:
     offload_io_service_impl(const offload_io_service_impl&) = delete;
 
@@ -295,6 +356,25 @@ private:
     };
     using client_req_queue_t = boost::lockfree::queue<client_req_t>;
 
+    // Scheduling state of a link when running multiple offload threads. A
+    // thread must claim all links of a client before servicing it.
+    struct link_sched_t
+    {
+        std::atomic<bool> claimed{false};
+        size_t home_thread = 0;
+        size_t num_clients = 0;
+    };
+
+    // Load counters and state of each offload thread
+    struct thread_load_info_t
+    {
+        std::atomic<uint64_t> num_buffs{0};
+        std::atomic<uint64_t> num_stolen_buffs{0};
+        std::atomic<uint64_t> num_idle_passes{0};
+        std::atomic<uint64_t> num_links{0};
+        std::atomic<bool> busy{false};
+    };
+
     // Values used by offload thread for each client
     struct recv_client_info_t
     {
@@ -302,6 +382,9 @@ private:
         recv_io_if::sptr inline_io;
         size_t num_frames_in_use = 0;
         frame_reservation_t frames_reserved;
+        // Only used with multiple offload threads
+        link_sched_t* links[2] = {nullptr, nullptr};
+        bool disconnect_pending = false;
     };
     struct send_client_info_t
     {
@@ -309,27 +392,60 @@ private:
         send_io_if::sptr inline_io;
         size_t num_frames_in_use = 0;
         frame_reservation_t frames_reserved;
+        // Only used with multiple offload threads
+        link_sched_t* links[2] = {nullptr, nullptr};
+        bool disconnect_pending = false;
     };
 
     void _queue_client_req(std::function<void()> fn);
-    void _get_recv_buff(recv_client_info_t& info, int32_t timeout_ms);
-    void _get_send_buff(send_client_info_t& info);
+    bool _get_recv_buff(recv_client_info_t& info, int32_t timeout_ms);
+    bool _get_send_buff(send_client_info_t& info);
     void _release_recv_buff(recv_client_info_t& info, frame_buff* buff);
     void _release_send_buff(send_client_info_t& info, frame_buff* buff);
     void _disconnect_recv_client(recv_client_info_t& info);
     void _disconnect_send_client(send_client_info_t& info);
 
+    template <bool allow_recv, bool allow_send>
+    bool _service_clients();
+
+    template <bool allow_recv, bool allow_send>
+    bool _park();
+
+    bool _has_pending_work();
+
     template <bool allow_recv, bool allow_send>
     void _do_work_polling();
 
     template <bool allow_recv, bool allow_send>
     void _do_work_blocking();
 
+    template <bool allow_recv, bool allow_send>
+    void _do_work_adaptive();
+
+    template <typename client_info_t>
+    void _assign_links(client_info_t& info, const void* primary, const void* secondary);
+    template <typename client_info_t>
+    void _unassign_links(client_info_t& info);
+    template <typename client_info_t>
+    bool _claim_links(client_info_t& info);
+    template <typename client_info_t>
+    void _unclaim_links(client_info_t& info);
+    size_t _service_recv_client(recv_client_info_t& info);
+    size_t _service_send_client(send_client_info_t& info);
+
+    template <bool allow_recv, bool allow_send>
+    size_t _service_clients_shared(const size_t thread_index, const bool steal);
+
+    void _service_requests_exclusive();
+
+    template <bool allow_recv, bool allow_send>
+    void _do_work_stealing(const size_t thread_index);
+
     // The I/O service that executes within the offload thread
     io_service::sptr _io_srv;
 
-    // Offload thread, its stop flag, and thread-related parameters
-    std::unique_ptr<std::thread> _offload_thread;
+    // Offload threads, their stop flag, and thread-related parameters
+    std::vector<std::unique_ptr<std::thread>> _offload_threads;
     std::atomic<bool> _stop_offload_thread{false};
     offload_io_service::params_t _offload_thread_params;
 
@@ -342,6 +458,31 @@ private:
 
     // Keep track of frame reservations
     frame_reservation_mgr _reservation_mgr;
+
+    // Wakes the offload thread when parked in the adaptive wait mode
+    offload_thread_waker _waker;
+
+    // Offload thread statistics, only updated in the adaptive wait mode
+    struct
+    {
+        std::atomic<uint64_t> busy_ns{0};
+        std::atomic<uint64_t> spin_ns{0};
+        std::atomic<uint64_t> yield_ns{0};
+        std::atomic<uint64_t> park_ns{0};
+        std::atomic<uint64_t> num_parks{0};
+        std::atomic<uint64_t> num_wakeups{0};
+    } _wait_stats;
+
+    // With multiple offload threads, the threads service clients while
+    // holding this mutex shared. Changes to the lists of clients and links
+    // are made while holding it exclusively.
+    std::shared_timed_mutex _clients_mutex;
+
+    // Scheduling state of links and load of each thread, only used with
+    // multiple offload threads
+    std::map<const void*, std::unique_ptr<link_sched_t>> _link_sched;
+    std::vector<std::unique_ptr<thread_load_info_t>> _thread_load;
+    std::atomic<size_t> _num_pending_disconnects{0};
 };
 
 //
@@ -369,6 +510,37 @@ offload_io_service_impl::offload_io_service_impl(
             "the other");
     }
 
+    if (params.num_threads == 0) {
+        throw uhd::value_error("An offload I/O service needs at least one thread");
+    }
+
+    if (params.num_threads > 1) {
+        if (params.wait_mode != POLL) {
+            throw uhd::value_error(
+                "An I/O service with multiple offload threads must be configured "
+                "to poll");
+        }
+
+        for (size_t i = 0; i < params.num_threads; i++) {
+            _thread_load.push_back(std::make_unique<thread_load_info_t>());
+        }
+
+        for (size_t i = 0; i < params.num_threads; i++) {
+            std::function<void()> thread_fn;
+            if (params.client_type == RECV_ONLY) {
+                thread_fn = [this, i]() { _do_work_stealing<true, false>(i); };
+            } else if (params.client_type == SEND_ONLY) {
+                thread_fn = [this, i]() { _do_work_stealing<false, true>(i); };
+            } else if (params.client_type == BOTH_SEND_AND_RECV) {
+                thread_fn = [this, i]() { _do_work_stealing<true, true>(i); };
+            } else {
+                UHD_THROW_INVALID_CODE_PATH();
+            }
+            _offload_threads.push_back(std::make_unique<std::thread>(thread_fn));
+        }
+        return;
+    }
+
     std::function<void()> thread_fn;
 
     if (params.wait_mode == BLOCK) {
@@ -389,19 +561,46 @@ offload_io_service_impl::offload_io_service_impl(
         } else {
             UHD_THROW_INVALID_CODE_PATH();
         }
+    } else if (params.wait_mode == ADAPTIVE) {
+        if (params.client_type == RECV_ONLY) {
+            thread_fn = [this]() { _do_work_adaptive<true, false>(); };
+        } else if (params.client_type == SEND_ONLY) {
+            thread_fn = [this]() { _do_work_adaptive<false, true>(); };
+        } else if (params.client_type == BOTH_SEND_AND_RECV) {
+            thread_fn = [this]() { _do_work_adaptive<true, true>(); };
+        } else {
+            UHD_THROW_INVALID_CODE_PATH();
+        }
     } else {
         UHD_THROW_INVALID_CODE_PATH();
     }
 
-    _offload_thread = std::make_unique<std::thread>(thread_fn);
+    _offload_threads.push_back(std::make_unique<std::thread>(thread_fn));
 }
 
 offload_io_service_impl::~offload_io_service_impl()
 {
     _stop_offload_thread = true;
 
-    if (_offload_thread) {
-        _offload_thread->join();
+    for (auto& thread : _offload_threads) {
+        thread->join();
+    }
+
+    if (_offload_thread_params.wait_mode == ADAPTIVE) {
+        const wait_stats_t stats = get_wait_stats();
+        UHD_LOG_DEBUG("IO_SRV",
+            "Adaptive offload thread: busy " << stats.busy_ns / 1000 << " us, spinning "
+                << stats.spin_ns / 1000 << " us, yielding " << stats.yield_ns / 1000
+                << " us, parked " << stats.park_ns / 1000 << " us ("
+                << stats.num_parks << " parks, " << stats.num_wakeups
+                << " ended by work)");
+    }
+    const auto thread_load = get_thread_load();
+    for (size_t i = 0; i < thread_load.size(); i++) {
+        UHD_LOG_DEBUG("IO_SRV",
+            "Offload thread " << i << ": " << thread_load[i].num_buffs << " buffers ("
+                              << thread_load[i].num_stolen_buffs << " stolen), "
+                              << thread_load[i].num_idle_passes << " idle passes");
     }
 
     assert(_recv_clients.empty());
@@ -427,12 +626,7 @@ void offload_io_service_impl::attach_send_link(send_link_if::sptr link)
         _io_srv->attach_send_link(link);
     };
 
-    client_req_t queue_element;
-    queue_element.req  = {new std::function<void()>(req_fn)};
-    const bool success = _client_connect_queue.push(queue_element);
-    if (!success) {
-        throw uhd::runtime_error("Failed to push attach_send_link request");
-    }
+    _queue_client_req(req_fn);
 }
 
 void offload_io_service_impl::detach_recv_link(recv_link_if::sptr link)
@@ -464,13 +658,14 @@ recv_io_if::sptr offload_io_service_impl::make_recv_client(recv_link_if::sptr re
     size_t num_send_frames,
     recv_io_if::fc_callback_t fc_cb)
 {
-    UHD_ASSERT_THROW(_offload_thread);
+    UHD_ASSERT_THROW(!_offload_threads.empty());
 
     if (_offload_thread_params.client_type == SEND_ONLY) {
         throw uhd::runtime_error("Recv client not supported by this I/O service");
     }
 
-    auto port = std::make_shared<client_port_t>(num_recv_frames);
+    auto port = std::make_shared<client_port_t>(
+        num_recv_frames, _offload_thread_params.wait_mode == ADAPTIVE ? &_waker : nullptr);
 
     // Create a request to create a new receiver in the offload thread
     auto req_fn =
@@ -485,6 +680,7 @@ recv_io_if::sptr offload_io_service_impl::make_recv_client(recv_link_if::sptr re
             client_info.inline_io       = inline_recv_io;
             client_info.port            = port;
             client_info.frames_reserved = frames;
+            _assign_links(client_info, recv_link.get(), fc_link.get());
 
             _recv_clients.push_back(client_info);
 
@@ -513,13 +709,14 @@ send_io_if::sptr offload_io_service_impl::make_send_client(send_link_if::sptr se
     recv_callback_t recv_cb,
     send_io_if::fc_callback_t fc_cb)
 {
-    UHD_ASSERT_THROW(_offload_thread);
+    UHD_ASSERT_THROW(!_offload_threads.empty());
 
     if (_offload_thread_params.client_type == RECV_ONLY) {
         throw uhd::runtime_error("Send client not supported by this I/O service");
     }
 
-    auto port = std::make_shared<client_port_t>(num_send_frames);
+    auto port = std::make_shared<client_port_t>(
+        num_send_frames, _offload_thread_params.wait_mode == ADAPTIVE ? &_waker : nullptr);
 
     // Create a request to create a new receiver in the offload thread
     auto req_fn = [this,
@@ -541,6 +738,7 @@ send_io_if::sptr offload_io_service_impl::make_send_client(send_link_if::sptr se
         client_info.inline_io       = inline_send_io;
         client_info.port            = port;
         client_info.frames_reserved = frames;
+        _assign_links(client_info, send_link.get(), recv_link.get());
 
         _send_clients.push_back(client_info);
 
@@ -574,28 +772,60 @@ void offload_io_service_impl::_queue_client_req(std::function<void()> fn)
     if (!success) {
         throw uhd::runtime_error("Failed to queue client request");
     }
+    _waker.notify();
+}
+
+offload_io_service::wait_stats_t offload_io_service_impl::get_wait_stats() const
+{
+    wait_stats_t stats;
+    stats.busy_ns     = _wait_stats.busy_ns.load(std::memory_order_relaxed);
+    stats.spin_ns     = _wait_stats.spin_ns.load(std::memory_order_relaxed);
+    stats.yield_ns    = _wait_stats.yield_ns.load(std::memory_order_relaxed);
+    stats.park_ns     = _wait_stats.park_ns.load(std::memory_order_relaxed);
+    stats.num_parks   = _wait_stats.num_parks.load(std::memory_order_relaxed);
+    stats.num_wakeups = _wait_stats.num_wakeups.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::vector<offload_io_service::thread_load_t>
+offload_io_service_impl::get_thread_load() const
+{
+    std::vector<thread_load_t> result;
+    for (const auto& load_info : _thread_load) {
+        thread_load_t load;
+        load.num_buffs        = load_info->num_buffs.load(std::memory_order_relaxed);
+        load.num_stolen_buffs = load_info->num_stolen_buffs.load(std::memory_order_relaxed);
+        load.num_idle_passes  = load_info->num_idle_passes.load(std::memory_order_relaxed);
+        load.num_links        = load_info->num_links.load(std::memory_order_relaxed);
+        result.push_back(load);
+    }
+    return result;
 }
 
 // Get a single receive buffer if available and update client info
-void offload_io_service_impl::_get_recv_buff(recv_client_info_t& info, int32_t timeout_ms)
+bool offload_io_service_impl::_get_recv_buff(recv_client_info_t& info, int32_t timeout_ms)
 {
     if (info.num_frames_in_use < info.frames_reserved.num_recv_frames) {
         if (frame_buff::uptr buff = info.inline_io->get_recv_buff(timeout_ms)) {
             info.port->offload_thread_push(buff.release());
             info.num_frames_in_use++;
+            return true;
         }
     }
+    return false;
 }
 
 // Get a single send buffer if available and update client info
-void offload_io_service_impl::_get_send_buff(send_client_info_t& info)
+bool offload_io_service_impl::_get_send_buff(send_client_info_t& info)
 {
     if (info.num_frames_in_use < info.frames_reserved.num_send_frames) {
         if (frame_buff::uptr buff = info.inline_io->get_send_buff(0)) {
             info.port->offload_thread_push(buff.release());
             info.num_frames_in_use++;
+            return true;
         }
     }
+    return false;
 }
 
 // Release a single recv buffer and update client info
@@ -612,6 +842,11 @@ void offload_io_service_impl::_release_send_buff(send_client_info_t& info, frame
     info.inline_io->release_send_buff(frame_buff::uptr(buff));
     assert(info.num_frames_in_use > 0);
     info.num_frames_in_use--;
+    // The buffer is still in the queue. Once the client has nothing else
+    // queued, make sure the link doesn't hold back any packets.
+    if (info.port->offload_thread_read_available() <= 1) {
+        info.inline_io->flush_send_buffs();
+    }
 }
 
 // Flush client queues and unreserve its frames
@@ -624,6 +859,7 @@ void offload_io_service_impl::_disconnect_recv_client(recv_client_info_t& info)
     info.num_frames_in_use -= info.port->offload_thread_flush(release_buff);
     assert(info.num_frames_in_use == 0);
     _reservation_mgr.unreserve_frames(info.frames_reserved);
+    _unassign_links(info);
 
     // Client waits for a notification after requesting disconnect, so notify it
     info.port->offload_thread_set_connected(false);
@@ -638,73 +874,192 @@ void offload_io_service_impl::_disconnect_send_client(send_client_info_t& info)
     info.num_frames_in_use -= info.port->offload_thread_flush(release_buff);
     assert(info.num_frames_in_use == 0);
     _reservation_mgr.unreserve_frames(info.frames_reserved);
+    _unassign_links(info);
 
     // Client waits for a notification after requesting disconnect, so notify it
     info.port->offload_thread_set_connected(false);
 }
 
+// Make one pass over all clients without blocking. Returns true if any buffer
+// or client request was processed.
 template <bool allow_recv, bool allow_send>
-void offload_io_service_impl::_do_work_polling()
+bool offload_io_service_impl::_service_clients()
 {
-    uhd::set_thread_affinity(_offload_thread_params.cpu_affinity_list);
+    bool did_work = false;
 
-    client_req_t client_req;
+    if (allow_recv) {
+        // Get recv buffers
+        for (auto& recv_info : _recv_clients) {
+            did_work |= _get_recv_buff(recv_info, 0);
+        }
 
-    while (!_stop_offload_thread) {
-        if (allow_recv) {
-            // Get recv buffers
-            for (auto& recv_info : _recv_clients) {
-                _get_recv_buff(recv_info, 0);
+        // Release recv buffers
+        for (auto it = _recv_clients.begin(); it != _recv_clients.end();) {
+            frame_buff* buff;
+            bool disconnect;
+            std::tie(buff, disconnect) = it->port->offload_thread_pop();
+            if (buff) {
+                _release_recv_buff(*it, buff);
+                did_work = true;
+            } else if (disconnect) {
+                _disconnect_recv_client(*it);
+                it       = _recv_clients.erase(it); // increments it
+                did_work = true;
+                continue;
             }
+            ++it;
+        }
+    }
 
-            // Release recv buffers
-            for (auto it = _recv_clients.begin(); it != _recv_clients.end();) {
-                frame_buff* buff;
-                bool disconnect;
-                std::tie(buff, disconnect) = it->port->offload_thread_pop();
-                if (buff) {
-                    _release_recv_buff(*it, buff);
-                } else if (disconnect) {
-                    _disconnect_recv_client(*it);
-                    it = _recv_clients.erase(it); // increments it
-                    continue;
+    if (allow_send) {
+        // Get send buffers
+        for (auto& send_info : _send_clients) {
+            did_work |= _get_send_buff(send_info);
+        }
+
+        // Release send buffers
+        for (auto it = _send_clients.begin(); it != _send_clients.end();) {
+            frame_buff* buff;
+            bool disconnect;
+            std::tie(buff, disconnect) = it->port->offload_thread_peek();
+            if (buff) {
+                if (it->inline_io->wait_for_dest_ready(buff->packet_size(), 0)) {
+                    _release_send_buff(*it, buff);
+                    it->port->offload_thread_pop();
+                    did_work = true;
                 }
-                ++it;
+            } else if (disconnect) {
+                it->port->offload_thread_pop();
+                _disconnect_send_client(*it);
+                it       = _send_clients.erase(it); // increments it
+                did_work = true;
+                continue;
             }
+            ++it;
         }
+    }
 
-        if (allow_send) {
-            // Get send buffers
-            for (auto& send_info : _send_clients) {
-                _get_send_buff(send_info);
-            }
+    // Execute one client connect command per main loop iteration
+    client_req_t client_req;
+    if (_client_connect_queue.pop(client_req)) {
+        (*client_req.req)();
+        delete client_req.req;
+        did_work = true;
+    }
 
-            // Release send buffers
-            for (auto it = _send_clients.begin(); it != _send_clients.end();) {
-                frame_buff* buff;
-                bool disconnect;
-                std::tie(buff, disconnect) = it->port->offload_thread_peek();
-                if (buff) {
-                    if (it->inline_io->wait_for_dest_ready(buff->packet_size(), 0)) {
-                        _release_send_buff(*it, buff);
-                        it->port->offload_thread_pop();
-                    }
-                } else if (disconnect) {
-                    it->port->offload_thread_pop();
-                    _disconnect_send_client(*it);
-                    it = _send_clients.erase(it); // increments it
-                    continue;
+    return did_work;
+}
+
+// Check whether clients have queued anything for the offload thread
+bool offload_io_service_impl::_has_pending_work()
+{
+    if (!_client_connect_queue.empty()) {
+        return true;
+    }
+    for (auto& recv_info : _recv_clients) {
+        if (recv_info.port->offload_thread_read_available()) {
+            return true;
+        }
+    }
+    for (auto& send_info : _send_clients) {
+        if (send_info.port->offload_thread_read_available()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Put the idle offload thread to sleep until there is work to do or the park
+// timeout expires. Clients wake the thread when they queue a buffer or a
+// request, but links do not offer a way to wake another thread. If there is
+// a single link to wait for, the thread parks inside the link itself: a single
+// recv client blocks on its link, and a single send client whose buffer is
+// held back by flow control blocks on the flow control response. If there are
+// several, the thread blocks on one of them for park_poll_interval_ms at a
+// time, and checks all clients in between. Returns true if the thread was
+// woken by work.
+template <bool allow_recv, bool allow_send>
+bool offload_io_service_impl::_park()
+{
+    const int32_t timeout_ms = _offload_thread_params.adaptive_park_timeout_ms;
+    _wait_stats.num_parks.fetch_add(1, std::memory_order_relaxed);
+
+    // Recv clients with free frames wait for their link
+    recv_client_info_t* recv_wait_info = nullptr;
+    size_t num_recv_waits              = 0;
+    if (allow_recv) {
+        for (auto& recv_info : _recv_clients) {
+            if (recv_info.num_frames_in_use < recv_info.frames_reserved.num_recv_frames) {
+                if (!recv_wait_info) {
+                    recv_wait_info = &recv_info;
                 }
-                ++it;
+                num_recv_waits++;
             }
         }
+    }
 
-        // Execute one client connect command per main loop iteration
-        if (_client_connect_queue.pop(client_req)) {
-            (*client_req.req)();
-            delete client_req.req;
+    // Send clients with a queued buffer wait for flow control
+    send_client_info_t* fc_wait_info = nullptr;
+    frame_buff* fc_wait_buff         = nullptr;
+    if (allow_send) {
+        for (auto& send_info : _send_clients) {
+            std::tie(fc_wait_buff, std::ignore) = send_info.port->offload_thread_peek();
+            if (fc_wait_buff) {
+                fc_wait_info = &send_info;
+                break;
+            }
         }
     }
+
+    auto wait_for_fc = [this, &fc_wait_info, &fc_wait_buff](const int32_t wait_ms) {
+        if (fc_wait_info->inline_io->wait_for_dest_ready(
+                fc_wait_buff->packet_size(), wait_ms)) {
+            _release_send_buff(*fc_wait_info, fc_wait_buff);
+            fc_wait_info->port->offload_thread_pop();
+            return true;
+        }
+        return false;
+    };
+
+    bool woken = false;
+    if (num_recv_waits == 0 && !fc_wait_info) {
+        woken = _waker.park(timeout_ms, [this]() { return _has_pending_work(); });
+    } else if (!fc_wait_info && num_recv_waits == 1 && _recv_clients.size() == 1
+               && _send_clients.empty()) {
+        woken = _get_recv_buff(*recv_wait_info, timeout_ms);
+    } else if (num_recv_waits == 0 && _recv_clients.empty()
+               && _send_clients.size() == 1) {
+        woken = wait_for_fc(timeout_ms);
+    } else {
+        const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        const int32_t interval_ms = std::min(timeout_ms, park_poll_interval_ms);
+        do {
+            if (fc_wait_info) {
+                woken = wait_for_fc(interval_ms);
+            } else {
+                woken = _get_recv_buff(*recv_wait_info, interval_ms);
+            }
+            // A pass that does work may change the lists of clients, so stop
+            // waiting after it
+            woken = woken || _service_clients<allow_recv, allow_send>();
+        } while (!woken && std::chrono::steady_clock::now() < deadline);
+    }
+
+    if (woken) {
+        _wait_stats.num_wakeups.fetch_add(1, std::memory_order_relaxed);
+    }
+    return woken;
+}
+
+template <bool allow_recv, bool allow_send>
+void offload_io_service_impl::_do_work_polling()
+{
+    uhd::set_thread_affinity(_offload_thread_params.cpu_affinity_list);
+
+    while (!_stop_offload_thread) {
+        _service_clients<allow_recv, allow_send>();
+    }
 }
 
 template <bool allow_recv, bool allow_send>
@@ -784,4 +1139,286 @@ void offload_io_service_impl::_do_work_blocking()
     }
 }
 
+template <bool allow_recv, bool allow_send>
+void offload_io_service_impl::_do_work_adaptive()
+{
+    using clock = std::chrono::steady_clock;
+
+    uhd::set_thread_affinity(_offload_thread_params.cpu_affinity_list);
+
+    const auto spin_budget =
+        std::chrono::microseconds(_offload_thread_params.adaptive_spin_us);
+    const auto yield_budget =
+        spin_budget + std::chrono::microseconds(_offload_thread_params.adaptive_yield_us);
+
+    auto add_time = [](std::atomic<uint64_t>& counter, clock::duration duration) {
+        counter.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+            std::memory_order_relaxed);
+    };
+
+    // The thread is considered idle once a pass over the clients finds no
+    // work. It then spins until the spin budget is used up, yields until the
+    // yield budget is used up, and parks after that.
+    auto last_time  = clock::now();
+    auto idle_since = last_time;
+
+    while (!_stop_offload_thread) {
+        if (_service_clients<allow_recv, allow_send>()) {
+            const auto now = clock::now();
+            add_time(_wait_stats.busy_ns, now - last_time);
+            last_time  = now;
+            idle_since = now;
+            continue;
+        }
+
+        const auto idle_time = last_time - idle_since;
+        std::atomic<uint64_t>* counter;
+        bool woken = false;
+        if (idle_time < spin_budget) {
+            counter = &_wait_stats.spin_ns;
+        } else if (idle_time < yield_budget) {
+            std::this_thread::yield();
+            counter = &_wait_stats.yield_ns;
+        } else {
+            woken   = _park<allow_recv, allow_send>();
+            counter = &_wait_stats.park_ns;
+        }
+
+        const auto now = clock::now();
+        add_time(*counter, now - last_time);
+        last_time = now;
+        if (woken) {
+            idle_since = now;
+        }
+    }
+}
+
+// Give the links of a new client a home thread. Links that are already in use
+// keep their home thread, new ones go to the thread with the fewest links.
+template <typename client_info_t>
+void offload_io_service_impl::_assign_links(
+    client_info_t& info, const void* primary, const void* secondary)
+{
+    if (_thread_load.empty()) {
+        return;
+    }
+
+    const void* link_ptrs[2] = {primary, secondary};
+    for (size_t i = 0; i < 2; i++) {
+        if (!link_ptrs[i]) {
+            continue;
+        }
+
+        auto& sched = _link_sched[link_ptrs[i]];
+        if (!sched) {
+            sched = std::make_unique<link_sched_t>();
+        }
+        if (sched->num_clients == 0) {
+            auto cmp = [](const std::unique_ptr<thread_load_info_t>& left,
+                           const std::unique_ptr<thread_load_info_t>& right) {
+                return left->num_links < right->num_links;
+            };
+            auto it = std::min_element(_thread_load.begin(), _thread_load.end(), cmp);
+            sched->home_thread = std::distance(_thread_load.begin(), it);
+            (*it)->num_links++;
+        }
+        sched->num_clients++;
+        info.links[i] = sched.get();
+    }
+}
+
+template <typename client_info_t>
+void offload_io_service_impl::_unassign_links(client_info_t& info)
+{
+    for (auto sched : info.links) {
+        if (sched && --sched->num_clients == 0) {
+            _thread_load.at(sched->home_thread)->num_links--;
+        }
+    }
+}
+
+// Try to take exclusive ownership of all the links used by a client
+template <typename client_info_t>
+bool offload_io_service_impl::_claim_links(client_info_t& info)
+{
+    if (info.links[0]->claimed.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    if (info.links[1] && info.links[1] != info.links[0]
+        && info.links[1]->claimed.exchange(true, std::memory_order_acquire)) {
+        info.links[0]->claimed.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+template <typename client_info_t>
+void offload_io_service_impl::_unclaim_links(client_info_t& info)
+{
+    if (info.links[1] && info.links[1] != info.links[0]) {
+        info.links[1]->claimed.store(false, std::memory_order_release);
+    }
+    info.links[0]->claimed.store(false, std::memory_order_release);
+}
+
+// Move buffers of a recv client, the caller must have claimed its links.
+// Disconnect requests are deferred until the client lists can be modified.
+size_t offload_io_service_impl::_service_recv_client(recv_client_info_t& info)
+{
+    size_t count = _get_recv_buff(info, 0) ? 1 : 0;
+
+    frame_buff* buff;
+    bool disconnect;
+    std::tie(buff, disconnect) = info.port->offload_thread_pop();
+    if (buff) {
+        _release_recv_buff(info, buff);
+        count++;
+    } else if (disconnect) {
+        info.disconnect_pending = true;
+        _num_pending_disconnects++;
+    }
+    return count;
+}
+
+// Move buffers of a send client, the caller must have claimed its links.
+// Disconnect requests are deferred until the client lists can be modified.
+size_t offload_io_service_impl::_service_send_client(send_client_info_t& info)
+{
+    size_t count = _get_send_buff(info) ? 1 : 0;
+
+    frame_buff* buff;
+    bool disconnect;
+    std::tie(buff, disconnect) = info.port->offload_thread_peek();
+    if (buff) {
+        if (info.inline_io->wait_for_dest_ready(buff->packet_size(), 0)) {
+            _release_send_buff(info, buff);
+            info.port->offload_thread_pop();
+            count++;
+        }
+    } else if (disconnect) {
+        info.port->offload_thread_pop();
+        info.disconnect_pending = true;
+        _num_pending_disconnects++;
+    }
+    return count;
+}
+
+// Make one pass over the clients whose links are homed on this thread, or,
+// if steal is set, over those homed on busy peers. Must be called with the
+// clients mutex held shared. Returns the number of buffers moved.
+template <bool allow_recv, bool allow_send>
+size_t offload_io_service_impl::_service_clients_shared(
+    const size_t thread_index, const bool steal)
+{
+    auto should_service = [this, thread_index, steal](link_sched_t* sched) {
+        const size_t home = sched->home_thread;
+        if (steal) {
+            return home != thread_index
+                   && _thread_load[home]->busy.load(std::memory_order_relaxed);
+        }
+        return home == thread_index;
+    };
+
+    size_t count = 0;
+
+    if (allow_recv) {
+        for (auto& recv_info : _recv_clients) {
+            if (should_service(recv_info.links[0]) && _claim_links(recv_info)) {
+                if (!recv_info.disconnect_pending) {
+                    count += _service_recv_client(recv_info);
+                }
+                _unclaim_links(recv_info);
+            }
+        }
+    }
+
+    if (allow_send) {
+        for (auto& send_info : _send_clients) {
+            if (should_service(send_info.links[0]) && _claim_links(send_info)) {
+                if (!send_info.disconnect_pending) {
+                    count += _service_send_client(send_info);
+                }
+                _unclaim_links(send_info);
+            }
+        }
+    }
+
+    return count;
+}
+
+// Execute deferred client disconnects and all queued client requests. Must be
+// called with the clients mutex held exclusively.
+void offload_io_service_impl::_service_requests_exclusive()
+{
+    if (_num_pending_disconnects) {
+        for (auto it = _recv_clients.begin(); it != _recv_clients.end();) {
+            if (it->disconnect_pending) {
+                _disconnect_recv_client(*it);
+                it = _recv_clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = _send_clients.begin(); it != _send_clients.end();) {
+            if (it->disconnect_pending) {
+                _disconnect_send_client(*it);
+                it = _send_clients.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _num_pending_disconnects = 0;
+    }
+
+    client_req_t client_req;
+    while (_client_connect_queue.pop(client_req)) {
+        (*client_req.req)();
+        delete client_req.req;
+    }
+}
+
+template <bool allow_recv, bool allow_send>
+void offload_io_service_impl::_do_work_stealing(const size_t thread_index)
+{
+    const auto& cpu_lists = _offload_thread_params.thread_cpu_affinity_lists;
+    uhd::set_thread_affinity(thread_index < cpu_lists.size()
+                                 ? cpu_lists[thread_index]
+                                 : _offload_thread_params.cpu_affinity_list);
+
+    thread_load_info_t& load = *_thread_load[thread_index];
+
+    while (!_stop_offload_thread) {
+        // Check for requests before taking the mutex shared, so that pending
+        // requests cannot be starved by the other threads
+        if (_num_pending_disconnects || !_client_connect_queue.empty()) {
+            std::unique_lock<std::shared_timed_mutex> lock(_clients_mutex);
+            _service_requests_exclusive();
+        }
+
+        size_t num_buffs        = 0;
+        size_t num_stolen_buffs = 0;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(_clients_mutex);
+            num_buffs = _service_clients_shared<allow_recv, allow_send>(
+                thread_index, false);
+
+            // Help out busy peers when our own links are idle
+            if (num_buffs == 0) {
+                num_stolen_buffs = _service_clients_shared<allow_recv, allow_send>(
+                    thread_index, true);
+            }
+        }
+
+        load.busy.store(num_buffs != 0, std::memory_order_relaxed);
+        if (num_buffs + num_stolen_buffs) {
+            load.num_buffs.fetch_add(
+                num_buffs + num_stolen_buffs, std::memory_order_relaxed);
+            load.num_stolen_buffs.fetch_add(num_stolen_buffs, std::memory_order_relaxed);
+        } else {
+            load.num_idle_passes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
 }} // namespace uhd::transport
@@ -18,7 +18,7 @@
 #include <uhd/utils/byteswap.hpp>
 #include <uhd/utils/log.hpp>
 #include <uhd/utils/tasks.hpp>
-#include <boost/dynamic_bitset.hpp>
+#include <uhdlib/transport/alignment_tracker.hpp>
 #include <boost/format.hpp>
 #include <functional>
 #include <memory>
@@ -325,27 +325,21 @@ private:
     {
         buffers_info_type(const size_t size)
             : std::vector<per_buffer_info_type>(size)
-            , indexes_todo(size, true)
-            , alignment_time(0)
-            , alignment_time_valid(false)
+            , alignment(size)
             , data_bytes_to_copy(0)
             , fragment_offset_in_samps(0)
         { /* NOP */
         }
         void reset()
         {
-            indexes_todo.set();
-            alignment_time           = 0;
-            alignment_time_valid     = false;
+            alignment.reset();
             data_bytes_to_copy       = 0;
             fragment_offset_in_samps = 0;
             metadata.reset();
             for (size_t i = 0; i < size(); i++)
                 at(i).reset();
         }
-        boost::dynamic_bitset<> indexes_todo; // used in alignment logic
-        uint64_t alignment_time; // used in alignment logic
-        bool alignment_time_valid; // used in alignment logic
+        alignment_tracker alignment; // used in alignment logic
         size_t data_bytes_to_copy; // keeps track of state
         size_t fragment_offset_in_samps; // keeps track of state
         rx_metadata_t metadata; // packet description
@@ -522,44 +516,36 @@ private:
      ******************************************************************/
     UHD_INLINE void alignment_check(const size_t index, buffers_info_type& info)
     {
-        // if alignment time was not valid or if the sequence id is newer:
-        //  use this index's time as the alignment time
-        //  reset the indexes list and remove this index
-        if (not info.alignment_time_valid or info[index].time > info.alignment_time) {
-            info.alignment_time_valid = true;
-            info.alignment_time       = info[index].time;
-            info.indexes_todo.set();
-            info.indexes_todo.reset(index);
-            // release the other buffers
-            for (size_t i = 0; i < info.size(); i++) {
-                if (i != index) {
-                    info[i].reset();
-                }
-            }
-            info.data_bytes_to_copy = info[index].ifpi.num_payload_bytes;
-            // reset start_of_burst and end_of_burst states
-            info.metadata.start_of_burst = info[index].ifpi.sob;
-            info.metadata.end_of_burst   = info[index].ifpi.eob;
-        }
+        switch (info.alignment.update(index, info[index].time)) {
+            // if alignment time was not valid or if the sequence id is newer:
+            //  use this index's time as the alignment time
+            //  the other indexes are todo again, and their buffers get
+            //  released when they are received into next
+            case alignment_tracker::NEW_TIME:
+                info.data_bytes_to_copy = info[index].ifpi.num_payload_bytes;
+                // reset start_of_burst and end_of_burst states
+                info.metadata.start_of_burst = info[index].ifpi.sob;
+                info.metadata.end_of_burst   = info[index].ifpi.eob;
+                break;
 
-        // if the sequence id matches:
-        //  remove this index from the list and continue
-        else if (info[index].time == info.alignment_time) {
-            info.indexes_todo.reset(index);
-            // All channels should have sob set at the same time, so only
-            // set start_of burst if all channels have sob set.
-            info.metadata.start_of_burst &= info[index].ifpi.sob;
-            // If any channel indicates eob, no more data will be received for
-            // that channel so set end_of_burst for any eob.
-            info.metadata.end_of_burst |= info[index].ifpi.eob;
-        } else {
-            // Not going to use this buffer, so release it
-            info[index].reset();
-        }
+            // if the sequence id matches:
+            //  remove this index from the list and continue
+            case alignment_tracker::ALIGNED:
+                // All channels should have sob set at the same time, so only
+                // set start_of burst if all channels have sob set.
+                info.metadata.start_of_burst &= info[index].ifpi.sob;
+                // If any channel indicates eob, no more data will be received for
+                // that channel so set end_of_burst for any eob.
+                info.metadata.end_of_burst |= info[index].ifpi.eob;
+                break;
 
-        // if the sequence id is older:
-        //  continue with the same index to try again
-        // else if (info[index].time < info.alignment_time)...
+            // if the sequence id is older:
+            //  continue with the same index to try again
+            case alignment_tracker::OLDER:
+                // Not going to use this buffer, so release it
+                info[index].reset();
+                break;
+        }
     }
 
     /*******************************************************************
@@ -586,11 +572,17 @@ private:
         // - Handle the packet type yielded by the receive.
         // - Check the timestamps for alignment conditions.
         size_t iterations = 0;
-        while (curr_info.indexes_todo.any()) {
+        while (not curr_info.alignment.done()) {
             // get the index to process for this iteration
-            const size_t index = curr_info.indexes_todo.find_first();
+            const size_t index = curr_info.alignment.next_pending();
             packet_type packet;
 
+            // release a buffer that was aligned to an older time before
+            // receiving the next one
+            if (curr_info[index].buff) {
+                curr_info[index].reset();
+            }
+
             // receive a single packet from the transport
             try {
                 packet = get_and_process_single_packet(
@@ -619,9 +611,9 @@ private:
                     // packet in time. This could cause the alignment logic to discard
                     // future received packets. Therefore, when this occurs, we reset the
                     // info to restart from scratch.
-                    if (curr_info.alignment_time_valid
-                        and curr_info.alignment_time != curr_info[index].time) {
-                        curr_info.alignment_time_valid = false;
+                    if (curr_info.alignment.is_time_valid()
+                        and curr_info.alignment.get_time() != curr_info[index].time) {
+                        curr_info.alignment.invalidate_time();
                     }
                     alignment_check(index, curr_info);
                     break;
@@ -5,6 +5,7 @@
 //
 
 #include <uhd/utils/log.hpp>
+#include <uhd/utils/safe_call.hpp>
 #include <uhdlib/transport/adapter.hpp>
 #include <uhdlib/transport/udp_boost_asio_link.hpp>
 #include <boost/format.hpp>
@@ -13,8 +14,11 @@ using namespace uhd::transport;
 
 namespace asio = boost::asio;
 
-udp_boost_asio_link::udp_boost_asio_link(
-    const std::string& addr, const std::string& port, const link_params_t& params)
+udp_boost_asio_link::udp_boost_asio_link(const std::string& addr,
+    const std::string& port,
+    const link_params_t& params,
+    const bool enable_gso,
+    const bool enable_gro)
     : recv_link_base_t(params.num_recv_frames, params.recv_frame_size)
     , send_link_base_t(params.num_send_frames, params.send_frame_size)
     , _recv_memory_pool(buffer_pool::make(params.num_recv_frames, params.recv_frame_size))
@@ -40,15 +44,105 @@ udp_boost_asio_link::udp_boost_asio_link(
     _socket  = open_udp_socket(addr, port, _io_service);
     _sock_fd = _socket->native_handle();
 
+#ifdef UHD_PLATFORM_LINUX
+    if (enable_gso) {
+        // Setting the default segment size tells whether the kernel knows GSO
+        const int gso_size = 0;
+        if (::setsockopt(_sock_fd, SOL_UDP, UDP_SEGMENT, &gso_size, sizeof(gso_size))
+            == 0) {
+            _gso_max_segments = std::min(UDP_MAX_GSO_SEGMENTS, params.num_send_frames);
+            for (size_t i = params.num_send_frames; i > 0; i--) {
+                _gso_free_slots.push_back(i - 1);
+            }
+            _gso_slots.reserve(_gso_max_segments);
+            _gso_iovs.reserve(_gso_max_segments);
+        } else {
+            UHD_LOG_WARNING("UDP",
+                "UDP GSO is not supported by the kernel (" << std::strerror(errno)
+                                                           << "), disabling it");
+        }
+    }
+    if (enable_gro) {
+        const int enable = 1;
+        if (::setsockopt(_sock_fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0) {
+            _gro_enabled = true;
+            // The arena holds as many frames as the link would without GRO,
+            // plus the memory for one receive. The bounce buffer for when the
+            // arena is full follows it.
+            _gro_arena_size =
+                params.num_recv_frames * params.recv_frame_size + UDP_MAX_GSO_BYTES;
+            _gro_arena_pool = buffer_pool::make(
+                1, _gro_arena_size + UDP_MAX_GSO_BYTES, GRO_CHUNK_ALIGN);
+            _gro_arena      = static_cast<char*>(_gro_arena_pool->at(0));
+            // Each chunk in use holds a frame, or waits for an older chunk
+            // that holds one
+            _gro_chunks.resize(2 * params.num_recv_frames + 1);
+        } else {
+            UHD_LOG_WARNING("UDP",
+                "UDP GRO is not supported by the kernel (" << std::strerror(errno)
+                                                           << "), disabling it");
+        }
+    }
+#else
+    if (enable_gso || enable_gro) {
+        UHD_LOG_WARNING("UDP", "UDP GSO and GRO are only supported on Linux");
+    }
+#endif
+
     auto info   = udp_boost_asio_adapter_info(*_socket);
     auto& ctx   = adapter_ctx::get();
     _adapter_id = ctx.register_adapter(info);
 
-    UHD_LOGGER_TRACE("UDP") << boost::format("Created UDP link to %s:%s") % addr % port;
+    UHD_LOGGER_TRACE("UDP")
+        << boost::format("Created UDP link to %s:%s (GSO: %s, GRO: %s)") % addr % port
+               % (is_gso_enabled() ? "on" : "off") % (is_gro_enabled() ? "on" : "off");
     UHD_LOGGER_TRACE("UDP") << boost::format("Local UDP socket endpoint: %s:%s")
                                    % get_local_addr() % get_local_port();
 }
 
+udp_boost_asio_link::~udp_boost_asio_link()
+{
+    UHD_SAFE_CALL(flush_send_buffs();)
+}
+
+#ifdef UHD_PLATFORM_LINUX
+void udp_boost_asio_link::_gso_flush()
+{
+    if (_gso_slots.empty()) {
+        return;
+    }
+    // The slots are not reused before this returns, so they can be freed up
+    // front. That way, they aren't lost if sending throws.
+    _gso_free_slots.insert(_gso_free_slots.end(), _gso_slots.begin(), _gso_slots.end());
+    _gso_slots.clear();
+    const size_t num_bytes = _gso_bytes;
+    _gso_bytes             = 0;
+
+    try {
+        if (_gso_iovs.size() == 1) {
+            send_udp_packet(_sock_fd, _gso_iovs[0].iov_base, _gso_iovs[0].iov_len);
+        } else if (!send_udp_packets_gso(_sock_fd,
+                       _gso_iovs.data(),
+                       _gso_iovs.size(),
+                       num_bytes,
+                       uint16_t(_gso_seg_size))) {
+            UHD_LOG_WARNING("UDP",
+                "UDP GSO is not supported on the route to "
+                    << _socket->remote_endpoint().address().to_string()
+                    << ", sending packets one at a time");
+            _gso_max_segments = 1;
+            for (const auto& iov : _gso_iovs) {
+                send_udp_packet(_sock_fd, iov.iov_base, iov.iov_len);
+            }
+        }
+    } catch (...) {
+        _gso_iovs.clear();
+        throw;
+    }
+    _gso_iovs.clear();
+}
+#endif
+
 uint16_t udp_boost_asio_link::get_local_port() const
 {
     return _socket->local_endpoint().port();
@@ -75,7 +169,9 @@ udp_boost_asio_link::sptr udp_boost_asio_link::make(const std::string& addr,
     const std::string& port,
     const link_params_t& params,
     size_t& recv_socket_buff_size,
-    size_t& send_socket_buff_size)
+    size_t& send_socket_buff_size,
+    const bool enable_gso,
+    const bool enable_gro)
 {
     UHD_ASSERT_THROW(params.num_recv_frames != 0);
     UHD_ASSERT_THROW(params.num_send_frames != 0);
@@ -95,7 +191,8 @@ udp_boost_asio_link::sptr udp_boost_asio_link::make(const std::string& addr,
     }
 #endif
 
-    udp_boost_asio_link::sptr link(new udp_boost_asio_link(addr, port, params));
+    udp_boost_asio_link::sptr link(
+        new udp_boost_asio_link(addr, port, params, enable_gso, enable_gro));
 
     // call the helper to resize send and recv buffers
 
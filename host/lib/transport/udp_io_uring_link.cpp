@@ -0,0 +1,378 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/safe_call.hpp>
+#include <uhdlib/transport/adapter.hpp>
+#include <uhdlib/transport/udp_io_uring_link.hpp>
+#include <boost/format.hpp>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <thread>
+
+using namespace uhd::transport;
+using namespace uhd::transport::detail;
+
+namespace asio = boost::asio;
+
+namespace {
+
+//! Buffer group of the receive frames
+constexpr uint16_t RECV_BUFF_GROUP = 0;
+
+//! Time the kernel thread polls an idle submission queue before it sleeps
+constexpr unsigned SQ_THREAD_IDLE_MS = 10;
+
+int io_uring_setup(const unsigned entries, io_uring_params* params)
+{
+    return int(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(const int fd,
+    const unsigned to_submit,
+    const unsigned min_complete,
+    const unsigned flags,
+    const void* arg,
+    const size_t arg_size)
+{
+    return int(::syscall(
+        __NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int io_uring_register(
+    const int fd, const unsigned opcode, const void* arg, const unsigned nr_args)
+{
+    return int(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+unsigned next_power_of_two(const size_t value)
+{
+    unsigned result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void* map_ring(const int fd, const size_t len, const off_t offset)
+{
+    void* ptr = ::mmap(
+        nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (ptr == MAP_FAILED) {
+        throw uhd::runtime_error(
+            std::string("io_uring: Could not map ring: ") + std::strerror(errno));
+    }
+    return ptr;
+}
+
+} // namespace
+
+/******************************************************************************
+ * io_uring_queue
+ *****************************************************************************/
+io_uring_queue::io_uring_queue(
+    const unsigned sq_entries, const unsigned cq_entries, const bool sqpoll)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = std::max(next_power_of_two(cq_entries), sq_entries);
+    if (sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = SQ_THREAD_IDLE_MS;
+        _fd = io_uring_setup(sq_entries, &params);
+        if (_fd < 0) {
+            UHD_LOG_DEBUG("IO_URING",
+                "Could not create a submission queue polling thread ("
+                    << std::strerror(errno) << "), submitting sends one at a time");
+            params.flags &= ~IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = 0;
+        }
+    }
+    if (_fd < 0) {
+        _fd = io_uring_setup(sq_entries, &params);
+    }
+    if (_fd < 0) {
+        throw uhd::runtime_error(
+            std::string("io_uring: Could not create ring: ") + std::strerror(errno));
+    }
+    _sqpoll = (params.flags & IORING_SETUP_SQPOLL) != 0;
+
+    try {
+        if (!(params.features & IORING_FEAT_EXT_ARG)) {
+            throw uhd::runtime_error("io_uring: Kernel does not support timed waits");
+        }
+
+        _sq_ring_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_ring_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        _sqes_len    = params.sq_entries * sizeof(io_uring_sqe);
+        _sq_ring     = map_ring(_fd, _sq_ring_len, IORING_OFF_SQ_RING);
+        _cq_ring     = map_ring(_fd, _cq_ring_len, IORING_OFF_CQ_RING);
+        _sqes = static_cast<io_uring_sqe*>(map_ring(_fd, _sqes_len, IORING_OFF_SQES));
+    } catch (...) {
+        _cleanup();
+        throw;
+    }
+
+    char* sq_ring  = static_cast<char*>(_sq_ring);
+    _sq_head       = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.head);
+    _sq_tail       = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+    _sq_flags      = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.flags);
+    _sq_array      = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+    _sq_mask       = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+    _sq_entries    = params.sq_entries;
+    _sqe_tail      = *_sq_tail;
+    _sqe_submitted = _sqe_tail;
+
+    char* cq_ring = static_cast<char*>(_cq_ring);
+    _cq_head      = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+    _cq_tail      = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+    _cqes         = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+    _cq_mask      = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+}
+
+io_uring_queue::~io_uring_queue()
+{
+    _cleanup();
+}
+
+void io_uring_queue::_cleanup()
+{
+    if (_sqes) {
+        ::munmap(_sqes, _sqes_len);
+    }
+    if (_cq_ring) {
+        ::munmap(_cq_ring, _cq_ring_len);
+    }
+    if (_sq_ring) {
+        ::munmap(_sq_ring, _sq_ring_len);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool io_uring_queue::wait_cqe(const int32_t timeout_ms)
+{
+    if (peek_cqe()) {
+        return true;
+    }
+    __kernel_timespec ts;
+    io_uring_getevents_arg arg;
+    std::memset(&arg, 0, sizeof(arg));
+    if (timeout_ms >= 0) {
+        ts.tv_sec  = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000;
+        arg.ts     = reinterpret_cast<uint64_t>(&ts);
+    }
+    _enter(0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg);
+    return peek_cqe() != nullptr;
+}
+
+void io_uring_queue::_enter(const unsigned to_submit,
+    const unsigned min_complete,
+    const unsigned flags,
+    const io_uring_getevents_arg* arg)
+{
+    const size_t arg_size = arg ? sizeof(*arg) : 0;
+    while (io_uring_enter(_fd, to_submit, min_complete, flags, arg, arg_size) < 0) {
+        // A timeout or signal ends a wait, but is not an error
+        if (errno == ETIME || errno == EINTR) {
+            return;
+        }
+        if (errno != EAGAIN && errno != EBUSY) {
+            throw uhd::io_error(
+                std::string("io_uring: io_uring_enter failed: ") + std::strerror(errno));
+        }
+    }
+}
+
+/******************************************************************************
+ * udp_io_uring_link
+ *****************************************************************************/
+udp_io_uring_link::udp_io_uring_link(const std::string& addr,
+    const std::string& port,
+    const link_params_t& params,
+    const bool batch_sends)
+    : recv_link_base_t(params.num_recv_frames, params.recv_frame_size)
+    , send_link_base_t(params.num_send_frames, params.send_frame_size)
+    , _recv_memory_pool(buffer_pool::make(params.num_recv_frames, params.recv_frame_size))
+    , _send_memory_pool(buffer_pool::make(params.num_send_frames, params.send_frame_size))
+    , _recv_buffs(params.num_recv_frames)
+    , _send_buffs(params.num_send_frames)
+    , _send_lens(params.num_send_frames, 0)
+    , _send_results(params.num_send_frames, 0)
+{
+    // Hold back up to half of the frames, so the next batch can be filled
+    // while one is in flight
+    if (batch_sends) {
+        _send_batch_size = std::max<size_t>(1, params.num_send_frames / 2);
+    }
+    // Buffer IDs are 16 bits, and the kernel limits the buffer ring to 32768
+    // entries
+    UHD_ASSERT_THROW(params.num_recv_frames <= 32768);
+    UHD_ASSERT_THROW(params.num_send_frames <= 32768);
+
+    for (auto& buff : _recv_buffs) {
+        recv_link_base_t::preload_free_buff(&buff);
+    }
+    for (auto& buff : _send_buffs) {
+        send_link_base_t::preload_free_buff(&buff);
+    }
+    for (size_t i = params.num_send_frames; i > 0; i--) {
+        _free_send_slots.push_back(uint16_t(i - 1));
+    }
+
+    // create, open, and connect the socket
+    _socket  = open_udp_socket(addr, port, _io_service);
+    _sock_fd = _socket->native_handle();
+
+    // Receive: The completion queue holds a completion for every frame, plus
+    // one to report that the frames ran out
+    const unsigned num_recv_entries = next_power_of_two(params.num_recv_frames);
+    _recv_ring.reset(new io_uring_queue(4, 2 * num_recv_entries, false));
+
+    // The buffer ring must be page-aligned, and start out with a tail of 0
+    const size_t buf_ring_len = num_recv_entries * sizeof(io_uring_buf);
+    _recv_buf_ring_pool       = buffer_pool::make(1, buf_ring_len, ::getpagesize());
+    std::memset(_recv_buf_ring_pool->at(0), 0, buf_ring_len);
+    _recv_buf_ring      = static_cast<io_uring_buf*>(_recv_buf_ring_pool->at(0));
+    _recv_buf_ring_mask = uint16_t(num_recv_entries - 1);
+
+    io_uring_buf_reg buf_reg;
+    std::memset(&buf_reg, 0, sizeof(buf_reg));
+    buf_reg.ring_addr    = reinterpret_cast<uint64_t>(_recv_buf_ring);
+    buf_reg.ring_entries = num_recv_entries;
+    buf_reg.bgid         = RECV_BUFF_GROUP;
+    if (io_uring_register(_recv_ring->get_fd(), IORING_REGISTER_PBUF_RING, &buf_reg, 1)
+        < 0) {
+        throw uhd::runtime_error(
+            std::string("io_uring: Could not register buffer ring: ")
+            + std::strerror(errno));
+    }
+    for (size_t i = 0; i < params.num_recv_frames; i++) {
+        _provide_recv_buff(uint16_t(i));
+    }
+    _arm_recv();
+
+    // Send: The submission queue has an entry for every frame, so it never
+    // runs full. A polling kernel thread only pays off if it doesn't have to
+    // share a CPU with the application.
+    const unsigned num_send_entries = next_power_of_two(params.num_send_frames);
+    const bool sqpoll               = std::thread::hardware_concurrency() > 1;
+    _send_ring.reset(new io_uring_queue(num_send_entries, num_send_entries, sqpoll));
+
+    // Registering the send frames pins their memory, which counts against
+    // RLIMIT_MEMLOCK. Fall back to regular sends if that fails.
+    std::vector<iovec> iovs(params.num_send_frames);
+    for (size_t i = 0; i < params.num_send_frames; i++) {
+        iovs[i].iov_base = _send_memory_pool->at(i);
+        iovs[i].iov_len  = params.send_frame_size;
+    }
+    _send_fixed_buffs = io_uring_register(_send_ring->get_fd(),
+                            IORING_REGISTER_BUFFERS,
+                            iovs.data(),
+                            unsigned(iovs.size()))
+                        == 0;
+    if (!_send_fixed_buffs) {
+        UHD_LOG_DEBUG("IO_URING",
+            "Could not register send frames (" << std::strerror(errno)
+                                               << "), using regular sends");
+    }
+
+    auto info   = udp_boost_asio_adapter_info(*_socket);
+    auto& ctx   = adapter_ctx::get();
+    _adapter_id = ctx.register_adapter(info);
+
+    UHD_LOGGER_TRACE("IO_URING")
+        << boost::format("Created io_uring UDP link to %s:%s (send polling: %s)") % addr
+               % port % (_send_ring->has_sqpoll() ? "yes" : "no");
+    UHD_LOGGER_TRACE("IO_URING") << boost::format("Local UDP socket endpoint: %s:%s")
+                                        % get_local_addr() % get_local_port();
+}
+
+udp_io_uring_link::~udp_io_uring_link()
+{
+    // Send the frames that are held back, and let them complete
+    UHD_SAFE_CALL(
+        flush_send_buffs();
+        while (!_inflight_sends.empty() && _send_ring->wait_cqe(100)) {
+            _reap_send_completions();
+        })
+    // Closing the rings cancels the pending operations, so close them before
+    // the frames and the buffer ring are freed
+    _recv_ring.reset();
+    _send_ring.reset();
+}
+
+void udp_io_uring_link::_arm_recv()
+{
+    io_uring_sqe* sqe = _recv_ring->get_sqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = _sock_fd;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = RECV_BUFF_GROUP;
+    sqe->ioprio    = _recv_multishot ? IORING_RECV_MULTISHOT : 0;
+    _recv_ring->submit();
+    _recv_armed = true;
+}
+
+uint16_t udp_io_uring_link::get_local_port() const
+{
+    return _socket->local_endpoint().port();
+}
+
+std::string udp_io_uring_link::get_local_addr() const
+{
+    return _socket->local_endpoint().address().to_string();
+}
+
+size_t udp_io_uring_link::resize_recv_socket_buffer(size_t num_bytes)
+{
+    return resize_udp_socket_buffer<asio::socket_base::receive_buffer_size>(
+        _socket, num_bytes);
+}
+
+size_t udp_io_uring_link::resize_send_socket_buffer(size_t num_bytes)
+{
+    return resize_udp_socket_buffer<asio::socket_base::send_buffer_size>(
+        _socket, num_bytes);
+}
+
+udp_io_uring_link::sptr udp_io_uring_link::make(const std::string& addr,
+    const std::string& port,
+    const link_params_t& params,
+    size_t& recv_socket_buff_size,
+    size_t& send_socket_buff_size,
+    const bool batch_sends)
+{
+    UHD_ASSERT_THROW(params.num_recv_frames != 0);
+    UHD_ASSERT_THROW(params.num_send_frames != 0);
+    UHD_ASSERT_THROW(params.recv_frame_size != 0);
+    UHD_ASSERT_THROW(params.send_frame_size != 0);
+    UHD_ASSERT_THROW(params.recv_buff_size != 0);
+    UHD_ASSERT_THROW(params.send_buff_size != 0);
+
+    udp_io_uring_link::sptr link(new udp_io_uring_link(addr, port, params, batch_sends));
+
+    // call the helper to resize send and recv buffers
+    recv_socket_buff_size = resize_udp_socket_buffer_with_warning(
+        [link](size_t size) { return link->resize_recv_socket_buffer(size); },
+        params.recv_buff_size,
+        "recv");
+    send_socket_buff_size = resize_udp_socket_buffer_with_warning(
+        [link](size_t size) { return link->resize_send_socket_buffer(size); },
+        params.send_buff_size,
+        "send");
+
+    return link;
+}
@@ -7,124 +7,91 @@
 
 #include <uhdlib/usrp/common/apply_corrections.hpp>
 #include <uhd/usrp/dboard_eeprom.hpp>
+#include <uhd/usrp/fe_cal_table.hpp>
 #include <uhd/utils/paths.hpp>
 #include <uhd/utils/log.hpp>
-#include <uhd/utils/csv.hpp>
-#include <uhd/types/dict.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/thread/mutex.hpp>
-#include <cstdio>
 #include <complex>
-#include <fstream>
+#include <map>
+#include <memory>
 
 namespace fs = boost::filesystem;
 
-boost::mutex corrections_mutex;
-
-/***********************************************************************
- * Helper routines
- **********************************************************************/
-static double linear_interp(double x, double x0, double y0, double x1, double y1){
-    return y0 + (x - x0)*(y1 - y0)/(x1 - x0);
-}
-
 /***********************************************************************
- * FE apply corrections implementation
+ * Calibration table cache
  **********************************************************************/
-struct fe_cal_t{
-    double lo_freq;
-    double iq_corr_real;
-    double iq_corr_imag;
-};
+typedef std::map<std::string, uhd::usrp::fe_cal_table::sptr> fe_cal_cache_t;
 
-static bool fe_cal_comp(fe_cal_t a, fe_cal_t b){
-    return (a.lo_freq < b.lo_freq);
-}
-
-static uhd::dict<std::string, std::vector<fe_cal_t> > fe_cal_cache;
+// The cache is replaced as a whole when a table is added, so lookups only
+// need an atomic load, and never wait for a table to be loaded
+static std::shared_ptr<const fe_cal_cache_t> fe_cal_cache =
+    std::make_shared<const fe_cal_cache_t>();
 
-static bool is_same_freq(const double f1, const double f2)
+static uhd::usrp::fe_cal_table::sptr get_fe_cal_table(const fs::path& cal_data_base)
 {
-    const double epsilon = 0.1;
-    return ((f1 - epsilon) < f2 and (f1 + epsilon) > f2);
-}
-
-static std::complex<double> get_fe_correction(
-    const std::string &key, const double lo_freq
-){
-    const std::vector<fe_cal_t> &datas = fe_cal_cache[key];
-    if (datas.empty()) throw uhd::runtime_error("empty calibration table " + key);
-
-    //search for lo freq
-    size_t lo_index = 0;
-    size_t hi_index = datas.size()-1;
-    for (size_t i = 0; i < datas.size(); i++){
-        if (is_same_freq(datas[i].lo_freq, lo_freq))
-        {
-            hi_index = i;
-            lo_index = i;
-            break;
+    const std::string key = cal_data_base.string();
+    auto cache = std::atomic_load(&fe_cal_cache);
+    auto it = cache->find(key);
+    if (it != cache->end()) return it->second;
+
+    // Prefer the binary format, fall back to the legacy CSV files. A CSV file
+    // that is newer than the binary file was written by another version of
+    // UHD (or edited), so it takes precedence.
+    fs::path bin_path = cal_data_base;
+    bin_path += ".bin";
+    fs::path csv_path = cal_data_base;
+    csv_path += ".csv";
+    const bool has_bin = fs::exists(bin_path);
+    const bool has_csv = fs::exists(csv_path);
+    fs::path cal_data_path;
+    if (has_bin
+        and (not has_csv
+                or fs::last_write_time(bin_path) >= fs::last_write_time(csv_path))) {
+        cal_data_path = bin_path;
+    } else if (has_csv) {
+        if (has_bin) {
+            UHD_LOGGER_WARNING("CAL")
+                << "Calibration file " << bin_path.string() << " is older than "
+                << csv_path.string() << ", loading the CSV file instead";
         }
-        if (datas[i].lo_freq > lo_freq){
-            hi_index = i;
-            break;
-        }
-        lo_index = i;
+        cal_data_path = csv_path;
+    } else {
+        return uhd::usrp::fe_cal_table::sptr();
     }
-
-    if (lo_index == 0) return std::complex<double>(datas[lo_index].iq_corr_real, datas[lo_index].iq_corr_imag);
-    if (hi_index == lo_index) return std::complex<double>(datas[hi_index].iq_corr_real, datas[hi_index].iq_corr_imag);
-
-    //interpolation time
-    return std::complex<double>(
-        linear_interp(lo_freq, datas[lo_index].lo_freq, datas[lo_index].iq_corr_real, datas[hi_index].lo_freq, datas[hi_index].iq_corr_real),
-        linear_interp(lo_freq, datas[lo_index].lo_freq, datas[lo_index].iq_corr_imag, datas[hi_index].lo_freq, datas[hi_index].iq_corr_imag)
-    );
+    auto table = uhd::usrp::fe_cal_table::load(cal_data_path.string());
+
+    // If another thread loaded the same table in the meantime, use theirs
+    auto new_cache = std::make_shared<fe_cal_cache_t>();
+    do {
+        it = cache->find(key);
+        if (it != cache->end()) return it->second;
+        *new_cache = *cache;
+        (*new_cache)[key] = table;
+    } while (not std::atomic_compare_exchange_weak(
+        &fe_cal_cache, &cache, std::shared_ptr<const fe_cal_cache_t>(new_cache)));
+    UHD_LOGGER_INFO("CAL") << "Calibration data loaded: " << cal_data_path.string();
+    return table;
 }
 
+/***********************************************************************
+ * FE apply corrections implementation
+ **********************************************************************/
 static void apply_fe_corrections(uhd::property_tree::sptr sub_tree,
     const std::string& db_serial,
     const uhd::fs_path& fe_path,
     const std::string& file_prefix,
     const double lo_freq)
 {
-    //make the calibration file path
-    const fs::path cal_data_path = fs::path(uhd::get_app_path()) / ".uhd" / "cal"
-                                   / (file_prefix + db_serial + ".csv");
-    if (not fs::exists(cal_data_path)) return;
+    //make the calibration file path, without the extension
+    const fs::path cal_data_base = fs::path(uhd::get_app_path()) / ".uhd" / "cal"
+                                   / (file_prefix + db_serial);
 
-    //parse csv file or get from cache
-    if (not fe_cal_cache.has_key(cal_data_path.string())){
-        std::ifstream cal_data(cal_data_path.string().c_str());
-        const uhd::csv::rows_type rows = uhd::csv::to_rows(cal_data);
-
-        bool read_data = false, skip_next = false;;
-        std::vector<fe_cal_t> datas;
-        for(const uhd::csv::row_type &row:  rows){
-            if (not read_data and not row.empty() and row[0] == "DATA STARTS HERE"){
-                read_data = true;
-                skip_next = true;
-                continue;
-            }
-            if (not read_data) continue;
-            if (skip_next){
-                skip_next = false;
-                continue;
-            }
-            fe_cal_t data;
-            std::sscanf(row[0].c_str(), "%lf" , &data.lo_freq);
-            std::sscanf(row[1].c_str(), "%lf" , &data.iq_corr_real);
-            std::sscanf(row[2].c_str(), "%lf" , &data.iq_corr_imag);
-            datas.push_back(data);
-        }
-        std::sort(datas.begin(), datas.end(), fe_cal_comp);
-        fe_cal_cache[cal_data_path.string()] = datas;
-        UHD_LOGGER_INFO("CAL") << "Calibration data loaded: " << cal_data_path.string();
-
-    }
+    //load the table or get it from the cache
+    const uhd::usrp::fe_cal_table::sptr table = get_fe_cal_table(cal_data_base);
+    if (not table) return;
 
     sub_tree->access<std::complex<double> >(fe_path)
-        .set(get_fe_correction(cal_data_path.string(), lo_freq));
+        .set(table->get_correction(lo_freq));
 }
 
 /***********************************************************************
@@ -138,7 +105,6 @@ void uhd::usrp::apply_tx_fe_corrections( // overloading to work according to rfn
     const double lo_freq // actual lo freq
 )
 {
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(sub_tree,
             db_serial,
@@ -161,8 +127,6 @@ void uhd::usrp::apply_tx_fe_corrections(
     const std::string &slot, //name of dboard slot
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
-
     // extract eeprom serial
     const uhd::fs_path db_path = "dboards/" + slot + "/tx_eeprom";
     const std::string db_serial =
@@ -193,7 +157,6 @@ void uhd::usrp::apply_rx_fe_corrections( // overloading to work according to rfn
     const double lo_freq // actual lo freq
 )
 {
-    boost::mutex::scoped_lock l(corrections_mutex);
     try{
         apply_fe_corrections(sub_tree,
             db_serial,
@@ -211,7 +174,6 @@ void uhd::usrp::apply_rx_fe_corrections(
     const std::string &slot, //name of dboard slot
     const double lo_freq //actual lo freq
 ){
-    boost::mutex::scoped_lock l(corrections_mutex);
     const uhd::fs_path db_path = "dboards/" + slot + "/rx_eeprom";
     const std::string db_serial =
         sub_tree->access<uhd::usrp::dboard_eeprom_t>(db_path).get().serial;
@@ -0,0 +1,386 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/usrp/fe_cal_table.hpp>
+#include <uhd/utils/byteswap.hpp>
+#include <uhd/utils/csv.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace uhd::usrp;
+namespace ipc = boost::interprocess;
+
+namespace {
+
+/* Binary file layout (all fields little-endian):
+ *
+ * file_header_t
+ * point_t points[num_points]          (sorted by LO frequency)
+ * uint32_t buckets[num_buckets]       (index of the first point of the
+ *                                      segment that holds the bucket start)
+ */
+constexpr char FILE_MAGIC[8]     = {'U', 'H', 'D', 'F', 'E', 'C', 'A', 'L'};
+constexpr uint32_t FILE_VERSION  = 1;
+constexpr size_t SERIAL_LEN      = 16;
+constexpr size_t MAX_NUM_BUCKETS = 1 << 16;
+
+struct file_header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_points;
+    uint32_t num_buckets;
+    uint32_t reserved;
+    double bucket_start;
+    double bucket_step;
+    int64_t timestamp;
+    char serial[SERIAL_LEN];
+};
+
+static_assert(sizeof(file_header_t) == 64, "Unexpected file header size");
+static_assert(sizeof(fe_cal_table::point_t) == 3 * sizeof(double),
+    "Unexpected calibration point size");
+
+uint64_t double_to_wire(const double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return uhd::htowx(bits);
+}
+
+double wire_to_double(const double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = uhd::wtohx(bits);
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+double linear_interp(double x, double x0, double y0, double x1, double y1)
+{
+    return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
+}
+
+} // namespace
+
+/***********************************************************************
+ * fe_cal_table implementation
+ **********************************************************************/
+class fe_cal_table_impl : public fe_cal_table
+{
+public:
+    //! Create a table from calibration points, and compute the bucket table
+    fe_cal_table_impl(
+        std::vector<point_t> points, const std::string& serial, const int64_t timestamp)
+        : _serial(serial), _timestamp(timestamp), _point_storage(std::move(points))
+    {
+        if (_point_storage.empty()) {
+            throw uhd::value_error("Calibration table has no calibration points");
+        }
+        if (_serial.size() > SERIAL_LEN) {
+            throw uhd::value_error("Serial is too long: " + _serial);
+        }
+        std::stable_sort(_point_storage.begin(),
+            _point_storage.end(),
+            [](const point_t& lhs, const point_t& rhs) {
+                return lhs.lo_freq < rhs.lo_freq;
+            });
+        _points     = _point_storage.data();
+        _num_points = _point_storage.size();
+        _init_buckets();
+    }
+
+    //! Map a binary calibration file
+    fe_cal_table_impl(const std::string& path)
+    {
+        try {
+            ipc::file_mapping file(path.c_str(), ipc::read_only);
+            _region = ipc::mapped_region(file, ipc::read_only);
+        } catch (const ipc::interprocess_exception& ex) {
+            throw uhd::runtime_error(
+                "Could not map calibration file " + path + ": " + ex.what());
+        }
+        const size_t size   = _region.get_size();
+        const uint8_t* base = static_cast<const uint8_t*>(_region.get_address());
+        if (size < sizeof(file_header_t)) {
+            throw uhd::runtime_error("Calibration file is too short: " + path);
+        }
+        file_header_t header;
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            throw uhd::runtime_error("Not a calibration file: " + path);
+        }
+        if (uhd::wtohx(header.version) != FILE_VERSION) {
+            throw uhd::runtime_error("Unsupported calibration file version "
+                                     + std::to_string(uhd::wtohx(header.version))
+                                     + ": " + path);
+        }
+        _num_points   = uhd::wtohx(header.num_points);
+        _num_buckets  = uhd::wtohx(header.num_buckets);
+        _bucket_start = wire_to_double(header.bucket_start);
+        _bucket_scale = 1.0 / wire_to_double(header.bucket_step);
+        _timestamp    = int64_t(uhd::wtohx(uint64_t(header.timestamp)));
+        _serial = std::string(header.serial, strnlen(header.serial, SERIAL_LEN));
+
+        const size_t points_size  = _num_points * sizeof(point_t);
+        const size_t buckets_size = _num_buckets * sizeof(uint32_t);
+        if (_num_points == 0 || _num_buckets == 0 || _num_buckets > MAX_NUM_BUCKETS
+            || !(std::isfinite(_bucket_scale) && _bucket_scale > 0)
+            || size < sizeof(file_header_t) + points_size + buckets_size) {
+            throw uhd::runtime_error("Calibration file is corrupt: " + path);
+        }
+        const uint8_t* points  = base + sizeof(file_header_t);
+        const uint8_t* buckets = points + points_size;
+
+#ifdef UHD_BIG_ENDIAN
+        // Byte-swap into memory, and drop the mapping
+        _point_storage.resize(_num_points);
+        std::memcpy(_point_storage.data(), points, points_size);
+        for (auto& point : _point_storage) {
+            point.lo_freq   = wire_to_double(point.lo_freq);
+            point.corr_real = wire_to_double(point.corr_real);
+            point.corr_imag = wire_to_double(point.corr_imag);
+        }
+        _bucket_storage.resize(_num_buckets);
+        std::memcpy(_bucket_storage.data(), buckets, buckets_size);
+        for (auto& bucket : _bucket_storage) {
+            bucket = uhd::wtohx(bucket);
+        }
+        _points  = _point_storage.data();
+        _buckets = _bucket_storage.data();
+        _region  = ipc::mapped_region();
+#else
+        // The file is used in place. The points are 8-byte aligned, because
+        // the header is, and the mapping starts on a page boundary.
+        _points  = reinterpret_cast<const point_t*>(points);
+        _buckets = reinterpret_cast<const uint32_t*>(buckets);
+#endif
+        for (size_t i = 0; i < _num_buckets; i++) {
+            // Every bucket must start a segment, i.e., not the last point
+            if (_buckets[i] + 1 >= std::max<size_t>(_num_points, 2)) {
+                throw uhd::runtime_error("Calibration file is corrupt: " + path);
+            }
+        }
+    }
+
+    std::complex<double> get_correction(const double lo_freq) const
+    {
+        const point_t* first = _points;
+        const point_t* last  = _points + _num_points - 1;
+        if (lo_freq <= first->lo_freq) {
+            return {first->corr_real, first->corr_imag};
+        }
+        if (lo_freq >= last->lo_freq) {
+            return {last->corr_real, last->corr_imag};
+        }
+        // Find the segment [p0, p0 + 1] that holds lo_freq. The bucket gives
+        // the segment at the bucket start. Buckets are never wider than the
+        // narrowest segment (unless there would be too many of them), so at
+        // most one step forward is needed.
+        const size_t bucket = std::min(
+            size_t((lo_freq - _bucket_start) * _bucket_scale), _num_buckets - 1);
+        const point_t* p0 = _points + _buckets[bucket];
+        while (p0 > first && p0->lo_freq > lo_freq) {
+            p0--;
+        }
+        while ((p0 + 1)->lo_freq < lo_freq) {
+            p0++;
+        }
+        const point_t* p1 = p0 + 1;
+        if (p1->lo_freq <= p0->lo_freq) {
+            return {p1->corr_real, p1->corr_imag};
+        }
+        return {linear_interp(
+                    lo_freq, p0->lo_freq, p0->corr_real, p1->lo_freq, p1->corr_real),
+            linear_interp(
+                lo_freq, p0->lo_freq, p0->corr_imag, p1->lo_freq, p1->corr_imag)};
+    }
+
+    std::vector<point_t> get_points(void) const
+    {
+        return std::vector<point_t>(_points, _points + _num_points);
+    }
+
+    std::string get_serial(void) const
+    {
+        return _serial;
+    }
+
+    int64_t get_timestamp(void) const
+    {
+        return _timestamp;
+    }
+
+    void save(const std::string& path) const
+    {
+        file_header_t header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version     = uhd::htowx(FILE_VERSION);
+        header.num_points  = uhd::htowx(uint32_t(_num_points));
+        header.num_buckets = uhd::htowx(uint32_t(_num_buckets));
+        header.timestamp   = int64_t(uhd::htowx(uint64_t(_timestamp)));
+        const uint64_t start = double_to_wire(_bucket_start);
+        const uint64_t step  = double_to_wire(1.0 / _bucket_scale);
+        std::memcpy(&header.bucket_start, &start, sizeof(start));
+        std::memcpy(&header.bucket_step, &step, sizeof(step));
+        std::memcpy(header.serial, _serial.data(), std::min(_serial.size(), SERIAL_LEN));
+
+        // Other processes may have the file mapped, and truncating it would
+        // crash them. Write a new file next to it, and replace the old one.
+        const std::string tmp_path =
+            path + "." + boost::filesystem::unique_path().string() + ".tmp";
+        std::ofstream file(tmp_path.c_str(), std::ofstream::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t i = 0; i < _num_points; i++) {
+            const uint64_t point[3] = {double_to_wire(_points[i].lo_freq),
+                double_to_wire(_points[i].corr_real),
+                double_to_wire(_points[i].corr_imag)};
+            file.write(reinterpret_cast<const char*>(point), sizeof(point));
+        }
+        for (size_t i = 0; i < _num_buckets; i++) {
+            const uint32_t bucket = uhd::htowx(_buckets[i]);
+            file.write(reinterpret_cast<const char*>(&bucket), sizeof(bucket));
+        }
+        file.close();
+        boost::system::error_code ec;
+        if (file) {
+            boost::filesystem::rename(tmp_path, path, ec);
+        }
+        if (!file || ec) {
+            boost::filesystem::remove(tmp_path, ec);
+            throw uhd::runtime_error("Could not write calibration file " + path);
+        }
+    }
+
+private:
+    //! Divide the range of the points into buckets no wider than the narrowest
+    // segment, and store the segment that holds the start of each bucket
+    void _init_buckets()
+    {
+        const double span = _points[_num_points - 1].lo_freq - _points[0].lo_freq;
+        double min_step   = span;
+        for (size_t i = 1; i < _num_points; i++) {
+            const double step = _points[i].lo_freq - _points[i - 1].lo_freq;
+            if (step > 0) {
+                min_step = std::min(min_step, step);
+            }
+        }
+        _bucket_start = _points[0].lo_freq;
+        if (span <= 0) {
+            _bucket_scale = 1.0;
+            _num_buckets  = 1;
+        } else {
+            _num_buckets  = std::min(size_t(std::ceil(span / min_step)), MAX_NUM_BUCKETS);
+            _bucket_scale = _num_buckets / span;
+        }
+        _bucket_storage.resize(_num_buckets);
+        size_t segment = 0;
+        for (size_t i = 0; i < _num_buckets; i++) {
+            const double bucket_freq = _bucket_start + i / _bucket_scale;
+            while (segment + 2 < _num_points
+                   && _points[segment + 1].lo_freq <= bucket_freq) {
+                segment++;
+            }
+            _bucket_storage[i] = uint32_t(segment);
+        }
+        _buckets = _bucket_storage.data();
+    }
+
+    std::string _serial;
+    int64_t _timestamp = 0;
+
+    //! The points and buckets are either owned, or in the mapped file
+    const point_t* _points   = nullptr;
+    size_t _num_points       = 0;
+    const uint32_t* _buckets = nullptr;
+    size_t _num_buckets      = 0;
+    double _bucket_start     = 0.0;
+    double _bucket_scale     = 1.0;
+    std::vector<point_t> _point_storage;
+    std::vector<uint32_t> _bucket_storage;
+    ipc::mapped_region _region;
+};
+
+/***********************************************************************
+ * fe_cal_table factory
+ **********************************************************************/
+fe_cal_table::~fe_cal_table(void)
+{
+    /* NOP */
+}
+
+fe_cal_table::sptr fe_cal_table::make(const std::vector<point_t>& points,
+    const std::string& serial,
+    const int64_t timestamp)
+{
+    return sptr(new fe_cal_table_impl(points, serial, timestamp));
+}
+
+fe_cal_table::sptr fe_cal_table::make_from_csv(std::istream& csv)
+{
+    std::string serial;
+    int64_t timestamp = 0;
+    std::vector<point_t> points;
+    bool read_data = false, skip_next = false;
+    for (const uhd::csv::row_type& row : uhd::csv::to_rows(csv)) {
+        if (row.empty()) {
+            continue;
+        }
+        if (not read_data) {
+            const std::string key = boost::algorithm::trim_copy(row[0]);
+            if (key == "DATA STARTS HERE") {
+                read_data = true;
+                skip_next = true;
+            } else if (key == "serial" and row.size() > 1) {
+                serial = boost::algorithm::trim_copy(row[1]);
+            } else if (key == "timestamp" and row.size() > 1) {
+                timestamp = std::strtoll(row[1].c_str(), nullptr, 10);
+            }
+            continue;
+        }
+        if (skip_next) {
+            skip_next = false;
+            continue;
+        }
+        if (row.size() < 3) {
+            continue;
+        }
+        point_t point;
+        std::sscanf(row[0].c_str(), "%lf", &point.lo_freq);
+        std::sscanf(row[1].c_str(), "%lf", &point.corr_real);
+        std::sscanf(row[2].c_str(), "%lf", &point.corr_imag);
+        points.push_back(point);
+    }
+    return make(points, serial, timestamp);
+}
+
+fe_cal_table::sptr fe_cal_table::load(const std::string& path)
+{
+    if (boost::algorithm::iends_with(path, ".csv")) {
+        std::ifstream csv(path.c_str());
+        if (!csv) {
+            throw uhd::runtime_error("Could not open calibration file " + path);
+        }
+        try {
+            return make_from_csv(csv);
+        } catch (const uhd::value_error& ex) {
+            throw uhd::runtime_error(
+                "Invalid calibration file " + path + ": " + ex.what());
+        }
+    }
+    return sptr(new fe_cal_table_impl(path));
+}
@@ -13,11 +13,14 @@
 
 static const std::string LOG_ID = "IO_SRV";
 
-static const char* recv_offload_str             = "recv_offload";
-static const char* send_offload_str             = "send_offload";
-static const char* recv_offload_wait_mode_str   = "recv_offload_wait_mode";
-static const char* send_offload_wait_mode_str   = "send_offload_wait_mode";
-static const char* num_poll_offload_threads_str = "num_poll_offload_threads";
+static const char* recv_offload_str               = "recv_offload";
+static const char* send_offload_str               = "send_offload";
+static const char* recv_offload_wait_mode_str     = "recv_offload_wait_mode";
+static const char* send_offload_wait_mode_str     = "send_offload_wait_mode";
+static const char* num_poll_offload_threads_str   = "num_poll_offload_threads";
+static const char* poll_offload_work_stealing_str = "poll_offload_work_stealing";
+static const char* offload_spin_us_str            = "offload_spin_us";
+static const char* offload_yield_us_str           = "offload_yield_us";
 
 static const std::regex recv_offload_thread_cpu_expr("^recv_offload_thread_(\\d+)_cpu");
 static const std::regex send_offload_thread_cpu_expr("^send_offload_thread_(\\d+)_cpu");
@@ -42,7 +45,9 @@ io_service_args_t::wait_mode_t get_wait_mode_arg(const device_addr_t& args,
 {
     constrained_device_args_t::enum_arg<io_service_args_t::wait_mode_t> arg(key,
         def,
-        {{"poll", io_service_args_t::POLL}, {"block", io_service_args_t::BLOCK}});
+        {{"poll", io_service_args_t::POLL},
+            {"block", io_service_args_t::BLOCK},
+            {"adaptive", io_service_args_t::ADAPTIVE}});
 
     if (args.has_key(key)) {
         arg.parse(args[key]);
@@ -75,6 +80,14 @@ io_service_args_t read_io_service_args(
         io_srv_args.num_poll_offload_threads = 1;
     }
 
+    io_srv_args.poll_offload_work_stealing = get_bool_arg(
+        args, poll_offload_work_stealing_str, defaults.poll_offload_work_stealing);
+
+    io_srv_args.offload_spin_us =
+        args.cast<size_t>(offload_spin_us_str, defaults.offload_spin_us);
+    io_srv_args.offload_yield_us =
+        args.cast<size_t>(offload_yield_us_str, defaults.offload_yield_us);
+
     auto read_thread_args = [&args](const std::regex& expr, std::map<size_t, size_t>& dest) {
         auto keys = args.keys();
         for (const auto& key : keys) {
@@ -115,6 +128,9 @@ device_addr_t merge_io_service_dev_args(
     merge_args(dev_args, args, recv_offload_wait_mode_str);
     merge_args(dev_args, args, send_offload_wait_mode_str);
     merge_args(dev_args, args, num_poll_offload_threads_str);
+    merge_args(dev_args, args, poll_offload_work_stealing_str);
+    merge_args(dev_args, args, offload_spin_us_str);
+    merge_args(dev_args, args, offload_yield_us_str);
 
     auto merge_thread_args = [&merge_args](const device_addr_t& dev_args,
                                  device_addr_t& stream_args,
@@ -105,10 +105,10 @@ void inline_io_service_mgr::disconnect_links(
 
 /* Blocking I/O service manager
  *
- * I/O service manager for offload I/O services configured to block. This
- * manager creates one offload I/O service for each transport adapter used by
- * a streamer. If there are multiple streamers, this manager creates a separate
- * set of I/O services for each streamer.
+ * I/O service manager for offload I/O services configured to block or to be
+ * adaptive. This manager creates one offload I/O service for each transport
+ * adapter used by a streamer. If there are multiple streamers, this manager
+ * creates a separate set of I/O services for each streamer.
  */
 class blocking_io_service_mgr
 {
@@ -245,11 +245,19 @@ void blocking_io_service_mgr::disconnect_links(
 io_service::sptr blocking_io_service_mgr::_create_new_io_service(
     const io_service_args_t& args, const link_type_t link_type, const size_t thread_index)
 {
+    const auto wait_mode = (link_type == link_type_t::RX_DATA)
+                               ? args.recv_offload_wait_mode
+                               : args.send_offload_wait_mode;
+
     offload_io_service::params_t params;
-    params.wait_mode   = offload_io_service::BLOCK;
+    params.wait_mode   = (wait_mode == io_service_args_t::ADAPTIVE)
+                             ? offload_io_service::ADAPTIVE
+                             : offload_io_service::BLOCK;
     params.client_type = (link_type == link_type_t::RX_DATA)
                              ? offload_io_service::RECV_ONLY
                              : offload_io_service::SEND_ONLY;
+    params.adaptive_spin_us  = static_cast<uint32_t>(args.offload_spin_us);
+    params.adaptive_yield_us = static_cast<uint32_t>(args.offload_yield_us);
 
     const auto& cpu_map = (link_type == link_type_t::RX_DATA)
                               ? args.recv_offload_thread_cpu
@@ -267,8 +275,13 @@ io_service::sptr blocking_io_service_mgr::_create_new_io_service(
     std::string link_type_str = (link_type == link_type_t::RX_DATA) ? "RX data"
                                                                     : "TX data";
 
+    std::string wait_mode_str = (params.wait_mode == offload_io_service::ADAPTIVE)
+                                    ? "adaptive"
+                                    : "blocking";
+
     UHD_LOG_INFO(LOG_ID,
-        "Creating new blocking I/O service for " << link_type_str << cpu_affinity_str);
+        "Creating new " << wait_mode_str << " I/O service for " << link_type_str
+                        << cpu_affinity_str);
 
     return offload_io_service::make(inline_io_service::make(), params);
 }
@@ -279,6 +292,10 @@ io_service::sptr blocking_io_service_mgr::_create_new_io_service(
  * number of I/O services specified by the user in stream_args, and distributes
  * links among them. New connections always go to the offload thread containing
  * the fewest connections, with lowest numbered thread as a second criterion.
+ *
+ * If work stealing is enabled, all links are instead connected to a single I/O
+ * service that runs the requested number of offload threads. That service
+ * balances the links among its threads as the load changes.
  */
 class polling_io_service_mgr
 {
@@ -309,6 +326,9 @@ private:
 
     // For each I/O service, keep track of the number of connections
     std::map<io_service::sptr, io_srv_info_t> _io_srv_info_map;
+
+    // I/O service shared by all links if work stealing is enabled
+    io_service::sptr _work_stealing_io_srv;
 };
 
 io_service::sptr polling_io_service_mgr::connect_links(recv_link_if::sptr recv_link,
@@ -329,7 +349,15 @@ io_service::sptr polling_io_service_mgr::connect_links(recv_link_if::sptr recv_l
     // the args, create a new service and add the links to it. Otherwise, add it
     // to the service that has the fewest connections.
     io_service::sptr io_srv;
-    if (_io_srv_info_map.size() < args.num_poll_offload_threads) {
+    if (args.poll_offload_work_stealing) {
+        if (!_work_stealing_io_srv) {
+            _work_stealing_io_srv                   = _create_new_io_service(args, 0);
+            _io_srv_info_map[_work_stealing_io_srv] = {0 /*connection_count*/};
+        }
+        io_srv                = _work_stealing_io_srv;
+        _link_info_map[links] = {io_srv, 1 /*mux_ref_count*/};
+        _io_srv_info_map[io_srv].connection_count++;
+    } else if (_io_srv_info_map.size() < args.num_poll_offload_threads) {
         const size_t thread_index = _io_srv_info_map.size();
         io_srv                    = _create_new_io_service(args, thread_index);
         _link_info_map[links]     = {io_srv, 1 /*mux_ref_count*/};
@@ -374,7 +402,14 @@ void polling_io_service_mgr::disconnect_links(
         }
 
         _link_info_map.erase(it);
-        _io_srv_info_map.erase(io_srv);
+        if (io_srv == _work_stealing_io_srv) {
+            if (--_io_srv_info_map[io_srv].connection_count == 0) {
+                _io_srv_info_map.erase(io_srv);
+                _work_stealing_io_srv.reset();
+            }
+        } else {
+            _io_srv_info_map.erase(io_srv);
+        }
     }
 }
 
@@ -387,6 +422,23 @@ io_service::sptr polling_io_service_mgr::_create_new_io_service(
 
     const auto& cpu_map = args.poll_offload_thread_cpu;
 
+    if (args.poll_offload_work_stealing) {
+        params.num_threads = args.num_poll_offload_threads;
+        for (size_t i = 0; i < params.num_threads; i++) {
+            if (cpu_map.count(i) != 0) {
+                params.thread_cpu_affinity_lists.push_back({cpu_map.at(i)});
+            } else {
+                params.thread_cpu_affinity_lists.push_back({});
+            }
+        }
+
+        UHD_LOG_INFO(LOG_ID,
+            "Creating new work-stealing polling I/O service with "
+                << params.num_threads << " threads");
+
+        return offload_io_service::make(inline_io_service::make(), params);
+    }
+
     std::string cpu_affinity_str;
     if (cpu_map.count(thread_index) != 0) {
         const size_t cpu         = cpu_map.at(thread_index);
@@ -0,0 +1,139 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/usrp/common/nmea_parser.hpp>
+#include <cstring>
+
+using namespace uhd::usrp;
+
+namespace {
+
+//! Shortest line that can be a valid sentence
+constexpr size_t MIN_LINE_LEN = 6;
+
+//! Return the value of an uppercase hex digit, or -1
+int hex_value(const char ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+bool is_digit(const char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+} // namespace
+
+size_t nmea_parser::push(
+    const char* data, const size_t len, const clock_t::time_point now)
+{
+    size_t num_stored = 0;
+    for (size_t i = 0; i < len; i++) {
+        const char ch = data[i];
+        if (ch == '\n') {
+            if (_line_overflow) {
+                _num_malformed++;
+                _line_overflow = false;
+            } else if (_line_len > 0 && _handle_line(now)) {
+                num_stored++;
+            }
+            _line_len = 0;
+        } else if (ch == '\r') {
+            // Line endings are "\r\n", but carriage returns are ignored
+            // anywhere
+            continue;
+        } else if (_line_len < MAX_LINE_LEN) {
+            _line[_line_len++] = ch;
+        } else {
+            _line_overflow = true;
+        }
+    }
+    return num_stored;
+}
+
+bool nmea_parser::get_sentence_type(const std::string& name, sentence_t& which)
+{
+    if (name == "GPGGA") {
+        which = GPGGA;
+    } else if (name == "GPRMC") {
+        which = GPRMC;
+    } else if (name == "SERVO") {
+        which = SERVO;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool nmea_parser::is_nmea_sentence_ok(const char* line, const size_t len)
+{
+    // Sentences look like "$GP<type>,<fields>,*<checksum>", where the
+    // checksum is the XOR of all characters between '$' and '*' as two
+    // uppercase hex digits
+    if (len < MIN_LINE_LEN || std::strncmp(line, "$GP", 3) != 0
+        || line[len - 3] != '*' || line[len - 4] != ',') {
+        return false;
+    }
+    const int hi = hex_value(line[len - 2]);
+    const int lo = hex_value(line[len - 1]);
+    if (hi < 0 || lo < 0) {
+        return false;
+    }
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < len - 3; i++) {
+        checksum ^= uint8_t(line[i]);
+    }
+    return checksum == ((hi << 4) | lo);
+}
+
+bool nmea_parser::is_servo_line(const char* line, const size_t len)
+{
+    // SERVO lines start with the date as "YY-MM-DD"
+    return len >= 8 && is_digit(line[0]) && is_digit(line[1]) && line[2] == '-'
+           && is_digit(line[3]) && is_digit(line[4]) && line[5] == '-'
+           && is_digit(line[6]) && is_digit(line[7]);
+}
+
+bool nmea_parser::_handle_line(const clock_t::time_point now)
+{
+    const char* line = _line.data();
+    if (_line_len >= MIN_LINE_LEN) {
+        if (is_servo_line(line, _line_len)) {
+            _store(_sentences[SERVO], now);
+            return true;
+        }
+        if (is_nmea_sentence_ok(line, _line_len)) {
+            // Other valid sentences are not needed, but are not malformed
+            if (std::strncmp(line + 1, "GPGGA", 5) == 0) {
+                _store(_sentences[GPGGA], now);
+                return true;
+            }
+            if (std::strncmp(line + 1, "GPRMC", 5) == 0) {
+                _store(_sentences[GPRMC], now);
+                return true;
+            }
+            return false;
+        }
+    }
+    _num_malformed++;
+    std::memcpy(_last_malformed.data(), line, _line_len);
+    _last_malformed_len = _line_len;
+    return false;
+}
+
+void nmea_parser::_store(slot_t& slot, const clock_t::time_point now)
+{
+    std::memcpy(slot.data.data(), _line.data(), _line_len);
+    slot.len  = _line_len;
+    slot.time = now;
+    slot.count++;
+}
@@ -17,6 +17,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <sstream>
+#include <thread>
 
 using namespace uhd;
 using namespace uhd::usrp;
@@ -10,14 +10,15 @@
 #include <uhd/utils/log.hpp>
 #include <uhd/exception.hpp>
 #include <uhd/types/sensors.hpp>
+#include <uhdlib/usrp/common/nmea_parser.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/format.hpp>
-#include <regex>
-#include <boost/thread/mutex.hpp>
 #include <boost/date_time.hpp>
+#include <condition_variable>
 #include <ctime>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <thread>
@@ -25,6 +26,7 @@
 #include <stdint.h>
 
 using namespace uhd;
+using namespace uhd::usrp;
 using namespace boost::posix_time;
 using namespace boost::algorithm;
 
@@ -47,149 +49,96 @@ gps_ctrl::~gps_ctrl(void){
 
 class gps_ctrl_impl : public gps_ctrl{
 private:
-    std::map<std::string, std::tuple<std::string, boost::system_time, bool>> sentences;
-    boost::mutex cache_mutex;
-    boost::system_time _last_cache_update;
+    using clock_t = nmea_parser::clock_t;
+
+    //! Holds the latest sentences received from the GPSDO
+    nmea_parser _parser;
+    //! Protects _parser and _reading
+    std::mutex _cache_mutex;
+    //! Notified whenever the reading thread received a line, or is done reading
+    std::condition_variable _cache_cond;
+    //! Set while a thread is reading from the UART
+    bool _reading = false;
 
     std::string get_sentence(const std::string which, const int max_age_ms, const int timeout, const bool wait_for_next = false)
     {
-        std::string sentence;
-        boost::system_time now = boost::get_system_time();
-        boost::system_time exit_time = now + milliseconds(timeout);
-        boost::posix_time::time_duration age;
-
-        if (wait_for_next)
-        {
-            boost::lock_guard<boost::mutex> lock(cache_mutex);
-            update_cache();
-            //mark sentence as touched
-            if (sentences.find(which) != sentences.end())
-                std::get<2>(sentences[which]) = true;
+        nmea_parser::sentence_t type;
+        if (not gps_detected() or not nmea_parser::get_sentence_type(which, type)) {
+            throw uhd::value_error("gps ctrl: No " + which + " message found");
         }
-        while (1)
-        {
-            try
-            {
-                boost::lock_guard<boost::mutex> lock(cache_mutex);
-
-                // update cache if older than a millisecond
-                if (now - _last_cache_update > milliseconds(1))
-                {
-                    update_cache();
-                }
-
-                if (sentences.find(which) == sentences.end())
-                {
-                    age = milliseconds(max_age_ms);
-                } else {
-                    age = boost::get_system_time() - std::get<1>(sentences[which]);
-                }
-                if (age < milliseconds(max_age_ms) and (not (wait_for_next and std::get<2>(sentences[which]))))
-                {
-                    sentence = std::get<0>(sentences[which]);
-                    std::get<2>(sentences[which]) = true;
-                }
-            } catch(std::exception &e) {
-                UHD_LOGGER_DEBUG("GPS") << "get_sentence: " << e.what();
+        const auto exit_time = clock_t::now() + std::chrono::milliseconds(timeout);
+        const auto max_age   = std::chrono::milliseconds(max_age_ms);
+
+        std::unique_lock<std::mutex> lock(_cache_mutex);
+        update_cache(lock, 0.0);
+        // When waiting for the next sentence, the one received so far doesn't
+        // count
+        const uint64_t min_count =
+            wait_for_next ? _parser.get_count(type) + 1 : uint64_t(1);
+
+        while (true) {
+            const auto now = clock_t::now();
+            if (_parser.get_count(type) >= min_count
+                and now - _parser.get_time(type) < max_age) {
+                return _parser.get_sentence(type);
             }
-
-            if (not sentence.empty() or now > exit_time)
-            {
+            if (now >= exit_time) {
                 break;
             }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            now = boost::get_system_time();
+            update_cache(lock, std::chrono::duration<double>(exit_time - now).count());
         }
 
-        if (sentence.empty())
-        {
-            throw uhd::value_error("gps ctrl: No " + which + " message found");
-        }
-
-        return sentence;
-    }
-
-    static bool is_nmea_checksum_ok(std::string nmea)
-    {
-        if (nmea.length() < 5 || nmea[0] != '$' || nmea[nmea.length()-3] != '*')
-            return false;
-
-        std::stringstream ss;
-        uint32_t string_crc;
-        uint32_t calculated_crc = 0;
-
-        // get crc from string
-        ss << std::hex << nmea.substr(nmea.length()-2, 2);
-        ss >> string_crc;
-
-        // calculate crc
-        for (size_t i = 1; i < nmea.length()-3; i++)
-            calculated_crc ^= nmea[i];
-
-        // return comparison
-        return (string_crc == calculated_crc);
-    }
-
-  void update_cache() {
-    if(not gps_detected()) {
-        return;
+        throw uhd::value_error("gps ctrl: No " + which + " message found");
     }
 
-    const std::list<std::string> keys{"GPGGA", "GPRMC", "SERVO"};
-    static const std::regex servo_regex("^\\d\\d-\\d\\d-\\d\\d.*$");
-    static const std::regex gp_msg_regex("^\\$GP.*,\\*[0-9A-F]{2}$");
-    std::map<std::string,std::string> msgs;
-
-    // Get all GPSDO messages available
-    // Creating a map here because we only want the latest of each message type
-    for (std::string msg = _recv(0); not msg.empty(); msg = _recv(0))
+    /*!
+     * Read lines from the GPSDO into the parser
+     *
+     * Only one thread reads from the UART at a time. Other threads wait until
+     * the reading thread received a line, or stopped reading, and then check
+     * the parser for the sentence they need.
+     *
+     * \param lock A lock on _cache_mutex. It is released while reading.
+     * \param timeout The time to wait for a line, in seconds. All lines that
+     *                are available after the first one are read, too.
+     */
+    void update_cache(std::unique_lock<std::mutex>& lock, const double timeout)
     {
-        // Strip any end of line characters
-        erase_all(msg, "\r");
-        erase_all(msg, "\n");
-
-        if (msg.empty())
-        {
-            // Ignore empty strings
-            continue;
-        }
-
-        if (msg.length() < 6)
-        {
-            UHD_LOGGER_WARNING("GPS") << __FUNCTION__ << ": Short GPSDO string: " << msg ;
-            continue;
-        }
-
-        // Look for SERVO message
-        if (std::regex_search(msg, servo_regex, std::regex_constants::match_continuous))
-        {
-            msgs["SERVO"] = msg;
-        }
-        else if (std::regex_match(msg, gp_msg_regex) and is_nmea_checksum_ok(msg))
-        {
-            msgs[msg.substr(1,5)] = msg;
-        }
-        else
-        {
-            UHD_LOGGER_WARNING("GPS") << __FUNCTION__ << ": Malformed GPSDO string: " << msg ;
+        if (_reading) {
+            if (timeout > 0.0) {
+                _cache_cond.wait_for(lock, std::chrono::duration<double>(timeout));
+            }
+            return;
         }
-    }
 
-    boost::system_time time = boost::get_system_time();
-
-    // Update sentences with newly read data
-    for(std::string key:  keys)
-    {
-        if (not msgs[key].empty())
-        {
-            sentences[key] = std::make_tuple(msgs[key], time, false);
+        _reading = true;
+        lock.unlock();
+        try {
+            for (std::string msg = _recv(timeout); not msg.empty(); msg = _recv(0)) {
+                lock.lock();
+                const uint64_t num_malformed = _parser.get_num_malformed();
+                _parser.push(msg);
+                if (_parser.get_num_malformed() != num_malformed) {
+                    UHD_LOGGER_WARNING("GPS")
+                        << __FUNCTION__
+                        << ": Malformed GPSDO string: " << _parser.get_last_malformed();
+                }
+                _cache_cond.notify_all();
+                lock.unlock();
+            }
+        } catch (...) {
+            if (not lock.owns_lock()) {
+                lock.lock();
+            }
+            _reading = false;
+            _cache_cond.notify_all();
+            throw;
         }
+        lock.lock();
+        _reading = false;
+        _cache_cond.notify_all();
     }
 
-    _last_cache_update = time;
-  }
-
 public:
   gps_ctrl_impl(uart_iface::sptr uart) :
       _uart(uart),
@@ -256,7 +205,10 @@ public:
     }
 
     // initialize cache
-    update_cache();
+    if (gps_detected()) {
+        std::unique_lock<std::mutex> lock(_cache_mutex);
+        update_cache(lock, 0.0);
+    }
   }
 
   ~gps_ctrl_impl(void){
@@ -21,6 +21,9 @@
 //#    include <uhdlib/transport/dpdk_simple.hpp>
 #    include <uhdlib/transport/udp_dpdk_link.hpp>
 #endif
+#ifdef HAVE_IO_URING
+#    include <uhdlib/transport/udp_io_uring_link.hpp>
+#endif
 
 using namespace uhd;
 using namespace uhd::transport;
@@ -376,11 +379,40 @@ uhd::transport::both_links_t mpmd_link_if_ctrl_udp::get_link(const size_t link_i
         UHD_LOG_WARNING("X300", "Cannot create DPDK transport, falling back to UDP");
 #endif
     }
+    if (_mb_args.cast<bool>("use_io_uring", false)) {
+#ifdef HAVE_IO_URING
+        try {
+            auto link = uhd::transport::udp_io_uring_link::make(ip_addr,
+                udp_port,
+                link_params,
+                link_params.recv_buff_size,
+                link_params.send_buff_size,
+                link_type == link_type_t::TX_DATA);
+            return std::make_tuple(link,
+                link_params.send_buff_size,
+                link,
+                link_params.recv_buff_size,
+                true,
+                false);
+        } catch (const uhd::runtime_error& ex) {
+            UHD_LOG_WARNING("MPMD",
+                "Cannot create io_uring transport, falling back to UDP: " << ex.what());
+        }
+#else
+        UHD_LOG_WARNING("MPMD", "io_uring support not built in, falling back to UDP");
+#endif
+    }
+    const bool use_gso = link_type == link_type_t::TX_DATA
+                         && _mb_args.cast<bool>("use_udp_gso", false);
+    const bool use_gro = link_type == link_type_t::RX_DATA
+                         && _mb_args.cast<bool>("use_udp_gro", false);
     auto link = uhd::transport::udp_boost_asio_link::make(ip_addr,
         udp_port,
         link_params,
         link_params.recv_buff_size,
-        link_params.send_buff_size);
+        link_params.send_buff_size,
+        use_gso,
+        use_gro);
     return std::make_tuple(
         link, link_params.send_buff_size, link, link_params.recv_buff_size, true, false);
 }
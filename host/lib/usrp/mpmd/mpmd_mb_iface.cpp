@@ -253,6 +253,7 @@ mpmd_mboard_impl::mpmd_mb_iface::make_rx_data_transport(
         fc_freq,
         fc_headroom,
         lossy_xport);
+    chdr_rx_data_xport::read_fc_coalescing_args(xport_args, fc_params);
 
     get_io_srv_mgr()->disconnect_links(recv_link, send_link);
     cfg_io_srv.reset();
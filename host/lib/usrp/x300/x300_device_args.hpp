@@ -37,6 +37,9 @@ public:
         , _blank_eeprom("blank_eeprom", false)
         , _enable_tx_dual_eth("enable_tx_dual_eth", false)
         , _use_dpdk("use_dpdk", false)
+        , _use_io_uring("use_io_uring", false)
+        , _use_udp_gso("use_udp_gso", false)
+        , _use_udp_gro("use_udp_gro", false)
         , _fpga_option("fpga", "")
         , _download_fpga("download-fpga", false)
         , _recv_frame_size("recv_frame_size", DATA_FRAME_MAX_SIZE)
@@ -125,6 +128,18 @@ public:
     {
         return _use_dpdk.get();
     }
+    bool get_use_io_uring() const
+    {
+        return _use_io_uring.get();
+    }
+    bool get_use_udp_gso() const
+    {
+        return _use_udp_gso.get();
+    }
+    bool get_use_udp_gro() const
+    {
+        return _use_udp_gro.get();
+    }
     std::string get_fpga_option() const
     {
         return _fpga_option.get();
@@ -261,6 +276,9 @@ private:
                 "Detected use_dpdk argument, but DPDK support not built in.");
 #endif
         }
+        PARSE_DEFAULT(_use_io_uring)
+        PARSE_DEFAULT(_use_udp_gso)
+        PARSE_DEFAULT(_use_udp_gro)
         PARSE_DEFAULT(_recv_frame_size)
         PARSE_DEFAULT(_send_frame_size)
 
@@ -291,6 +309,9 @@ private:
     constrained_device_args_t::bool_arg _blank_eeprom;
     constrained_device_args_t::bool_arg _enable_tx_dual_eth;
     constrained_device_args_t::bool_arg _use_dpdk;
+    constrained_device_args_t::bool_arg _use_io_uring;
+    constrained_device_args_t::bool_arg _use_udp_gso;
+    constrained_device_args_t::bool_arg _use_udp_gro;
     constrained_device_args_t::str_arg<true> _fpga_option;
     constrained_device_args_t::bool_arg _download_fpga;
     constrained_device_args_t::num_arg<size_t> _recv_frame_size;
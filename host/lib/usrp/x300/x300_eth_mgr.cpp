@@ -29,6 +29,9 @@
 #    include <uhdlib/transport/dpdk_simple.hpp>
 #    include <uhdlib/transport/udp_dpdk_link.hpp>
 #endif
+#ifdef HAVE_IO_URING
+#    include <uhdlib/transport/udp_io_uring_link.hpp>
+#endif
 #include <boost/asio.hpp>
 #include <string>
 
@@ -281,11 +284,38 @@ both_links_t eth_manager::get_links(link_type_t link_type,
         UHD_LOG_WARNING("X300", "Cannot create DPDK transport, falling back to UDP");
 #endif
     }
+    if (_args.get_use_io_uring()) {
+#ifdef HAVE_IO_URING
+        try {
+            auto link = uhd::transport::udp_io_uring_link::make(conn.addr,
+                BOOST_STRINGIZE(X300_VITA_UDP_PORT),
+                link_params,
+                link_params.recv_buff_size,
+                link_params.send_buff_size,
+                link_type == link_type_t::TX_DATA);
+            return std::make_tuple(link,
+                link_params.send_buff_size,
+                link,
+                link_params.recv_buff_size,
+                true,
+                false);
+        } catch (const uhd::runtime_error& ex) {
+            UHD_LOG_WARNING("X300",
+                "Cannot create io_uring transport, falling back to UDP: " << ex.what());
+        }
+#else
+        UHD_LOG_WARNING("X300", "io_uring support not built in, falling back to UDP");
+#endif
+    }
+    const bool use_gso = link_type == link_type_t::TX_DATA && _args.get_use_udp_gso();
+    const bool use_gro = link_type == link_type_t::RX_DATA && _args.get_use_udp_gro();
     auto link = uhd::transport::udp_boost_asio_link::make(conn.addr,
         BOOST_STRINGIZE(X300_VITA_UDP_PORT),
         link_params,
         link_params.recv_buff_size,
-        link_params.send_buff_size);
+        link_params.send_buff_size,
+        use_gso,
+        use_gro);
     return std::make_tuple(
         link, link_params.send_buff_size, link, link_params.recv_buff_size, true, false);
 }
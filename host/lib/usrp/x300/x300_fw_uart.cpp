@@ -13,6 +13,7 @@
 #include <uhd/utils/log.hpp>
 #include <boost/format.hpp>
 #include <chrono>
+#include <thread>
 
 using namespace uhd;
 
@@ -146,6 +147,9 @@ struct x300_uart_iface : uart_iface
             if (std::chrono::steady_clock::now() > exit_time) {
                 break;
             }
+
+            // Don't hog the control interface while waiting for characters
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
 
         return buff;
@@ -183,6 +183,7 @@ uhd::rfnoc::chdr_rx_data_xport::uptr x300_impl::x300_mb_iface::make_rx_data_tran
         fc_freq,
         fc_headroom,
         lossy_xport);
+    uhd::rfnoc::chdr_rx_data_xport::read_fc_coalescing_args(xport_args, fc_params);
 
     get_io_srv_mgr()->disconnect_links(recv_link, send_link);
     cfg_io_srv.reset();
@@ -0,0 +1,127 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/utils/fft.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace uhd;
+
+namespace {
+
+using fc32_t = std::complex<float>;
+
+//! Complex multiplication without the NaN/Inf handling of operator*(), which
+// would otherwise prevent inlining and vectorization
+inline fc32_t cmul(const fc32_t& a, const fc32_t& b)
+{
+    return fc32_t(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+//! Multiply by j
+inline fc32_t mul_j(const fc32_t& a)
+{
+    return fc32_t(-a.imag(), a.real());
+}
+
+} // namespace
+
+fft::fft(const size_t size) : _size(size)
+{
+    if (size == 0 || (size & (size - 1))) {
+        throw uhd::value_error(
+            "FFT size must be a power of two, got " + std::to_string(size));
+    }
+    // Plan the stages, and precompute the twiddles for every radix-4 stage
+    size_t n = size;
+    size_t s = 1;
+    while (n >= 4) {
+        _stages.push_back({n, s, _twiddles.size()});
+        const double theta0 = -2.0 * M_PI / double(n);
+        for (size_t p = 0; p < n / 4; p++) {
+            for (size_t k = 1; k <= 3; k++) {
+                const double theta = theta0 * double(p * k);
+                _twiddles.push_back(
+                    fc32_t(float(std::cos(theta)), float(std::sin(theta))));
+            }
+        }
+        n /= 4;
+        s *= 4;
+    }
+    _radix2_stage = (n == 2);
+    _work.resize(size);
+}
+
+void fft::execute(fc32_t* data)
+{
+    fc32_t* x = data;
+    fc32_t* y = _work.data();
+
+    for (const auto& stage : _stages) {
+        const size_t s      = stage.s;
+        const size_t n1     = stage.n / 4;
+        const fc32_t* twids = &_twiddles[stage.twiddle_offset];
+        if (s == 1) {
+            // First stage: The sub-transforms are not interleaved
+            for (size_t p = 0; p < n1; p++) {
+                const fc32_t a    = x[p];
+                const fc32_t b    = x[p + n1];
+                const fc32_t c    = x[p + 2 * n1];
+                const fc32_t d    = x[p + 3 * n1];
+                const fc32_t apc  = a + c;
+                const fc32_t amc  = a - c;
+                const fc32_t bpd  = b + d;
+                const fc32_t jbmd = mul_j(b - d);
+                y[4 * p + 0]      = apc + bpd;
+                y[4 * p + 1]      = cmul(twids[3 * p + 0], amc - jbmd);
+                y[4 * p + 2]      = cmul(twids[3 * p + 1], apc - bpd);
+                y[4 * p + 3]      = cmul(twids[3 * p + 2], amc + jbmd);
+            }
+            std::swap(x, y);
+            continue;
+        }
+        for (size_t p = 0; p < n1; p++) {
+            const fc32_t w1 = twids[3 * p + 0];
+            const fc32_t w2 = twids[3 * p + 1];
+            const fc32_t w3 = twids[3 * p + 2];
+            const fc32_t* xa = x + s * (p + 0 * n1);
+            const fc32_t* xb = x + s * (p + 1 * n1);
+            const fc32_t* xc = x + s * (p + 2 * n1);
+            const fc32_t* xd = x + s * (p + 3 * n1);
+            fc32_t* yp       = y + s * 4 * p;
+            for (size_t q = 0; q < s; q++) {
+                const fc32_t apc  = xa[q] + xc[q];
+                const fc32_t amc  = xa[q] - xc[q];
+                const fc32_t bpd  = xb[q] + xd[q];
+                const fc32_t jbmd = mul_j(xb[q] - xd[q]);
+                yp[q + 0 * s]     = apc + bpd;
+                yp[q + 1 * s]     = cmul(w1, amc - jbmd);
+                yp[q + 2 * s]     = cmul(w2, apc - bpd);
+                yp[q + 3 * s]     = cmul(w3, amc + jbmd);
+            }
+        }
+        std::swap(x, y);
+    }
+
+    if (_radix2_stage) {
+        const size_t s = _size / 2;
+        for (size_t q = 0; q < s; q++) {
+            const fc32_t a = x[q];
+            const fc32_t b = x[q + s];
+            y[q]           = a + b;
+            y[q + s]       = a - b;
+        }
+        std::swap(x, y);
+    }
+
+    // After an odd number of stages, the result is in the scratch buffer
+    if (x != data) {
+        std::copy(x, x + _size, data);
+    }
+}
@@ -0,0 +1,543 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/rx_capture_ring.hpp>
+#include <uhd/utils/thread.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef UHD_PLATFORM_LINUX
+#    include <sys/mman.h>
+#    include <cerrno>
+#endif
+
+using namespace uhd;
+
+namespace {
+
+//! Timeout of the recv() calls, after which the receive thread checks if it
+//  should stop
+constexpr double RECV_TIMEOUT = 0.1;
+
+//! Time after which an export stops waiting for the samples of its window
+constexpr auto EXPORT_DATA_TIMEOUT = std::chrono::seconds(1);
+
+#ifdef UHD_PLATFORM_LINUX
+//! Size of the huge pages requested with MAP_HUGETLB
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+#endif
+
+} // namespace
+
+/***********************************************************************
+ * rx capture ring implementation
+ **********************************************************************/
+class rx_capture_ring_impl : public rx_capture_ring
+{
+public:
+    rx_capture_ring_impl(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double samp_rate,
+        const size_t capacity)
+        : _rx_stream(rx_stream)
+        , _bytes_per_samp(convert::get_bytes_per_item(cpu_format))
+        , _num_chans(rx_stream->get_num_channels())
+        , _samp_rate(samp_rate)
+        , _capacity(capacity)
+        , _spp(std::max<size_t>(rx_stream->get_max_num_samps(), 1))
+    {
+        if (samp_rate <= 0.0) {
+            throw uhd::value_error("rx_capture_ring: Invalid sample rate");
+        }
+        if (capacity == 0) {
+            throw uhd::value_error("rx_capture_ring: Capacity must not be zero");
+        }
+
+        _allocate();
+        for (size_t i = 0; i < _num_chans; i++) {
+            _rings.push_back(_mem + i * _capacity * _bytes_per_samp);
+        }
+        _scratch.resize(_num_chans, std::vector<uint8_t>(_spp * _bytes_per_samp));
+        // Every entry covers at least one packet, unless there are gaps. If
+        // there are more gaps than that, the oldest entries are dropped.
+        _index.resize(_capacity / _spp + 16);
+
+        _recv_thread = std::thread([this]() { _recv_loop(); });
+        set_thread_name(&_recv_thread, "rx_capture");
+    }
+
+    ~rx_capture_ring_impl(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+        _recv_thread.join();
+        if (_export_thread.joinable()) {
+            _export_thread.join();
+        }
+        _free();
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _num_chans;
+    }
+
+    size_t get_capacity(void) const
+    {
+        return _capacity;
+    }
+
+    bool uses_huge_pages(void) const
+    {
+        return _huge_pages;
+    }
+
+    size_t get_num_recvd_samps(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _write_end;
+    }
+
+    size_t get_num_dropped_samps(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _num_dropped;
+    }
+
+    bool trigger(const time_spec_t& start_time,
+        const size_t nsamps,
+        const export_callback_t& callback)
+    {
+        if (nsamps == 0 || nsamps > _capacity) {
+            throw uhd::value_error("rx_capture_ring: Invalid window size");
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_exporting) {
+                return false;
+            }
+            // Freeze the window
+            _exporting = true;
+            _pin_start = _locate(start_time);
+        }
+        if (_export_thread.joinable()) {
+            _export_thread.join();
+        }
+        _export_thread =
+            std::thread([this, start_time, nsamps, cb = callback]() mutable {
+                _export(start_time, nsamps, std::move(cb));
+            });
+        set_thread_name(&_export_thread, "rx_capture_exp");
+        return true;
+    }
+
+    bool trigger(
+        const time_spec_t& start_time, const size_t nsamps, const std::string& path)
+    {
+        auto files = std::make_shared<std::vector<std::ofstream>>(_num_chans);
+        for (size_t i = 0; i < _num_chans; i++) {
+            const std::string filename =
+                _num_chans == 1 ? path : path + "." + std::to_string(i);
+            (*files)[i].open(filename.c_str(), std::ofstream::binary);
+            if (!(*files)[i]) {
+                throw uhd::os_error("rx_capture_ring: Failed to open " + filename);
+            }
+        }
+        return trigger(start_time,
+            nsamps,
+            [this, files](const size_t chan,
+                const void* buff,
+                const size_t nsamps,
+                const time_spec_t&) {
+                auto& file = (*files)[chan];
+                file.write(static_cast<const char*>(buff), nsamps * _bytes_per_samp);
+                if (!file) {
+                    throw uhd::os_error("rx_capture_ring: Failed to write samples");
+                }
+            });
+    }
+
+    bool wait_for_export(const double timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _cond.wait_for(lock, std::chrono::duration<double>(timeout), [this]() {
+            return !_exporting;
+        });
+    }
+
+    export_result_t get_last_export(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _last_export;
+    }
+
+private:
+    //! A run of contiguous samples in the ring
+    struct index_entry_t
+    {
+        //! Position of the first sample, counting all samples ever written
+        uint64_t first_samp;
+        size_t nsamps;
+        time_spec_t time_spec;
+
+        uint64_t end() const
+        {
+            return first_samp + nsamps;
+        }
+    };
+
+    void _allocate(void)
+    {
+        _mem_size = _num_chans * _capacity * _bytes_per_samp;
+#ifdef UHD_PLATFORM_LINUX
+        // Try explicit huge pages first. They have to be reserved by the
+        // administrator, so this usually fails. Pre-fault the memory either
+        // way, so receiving doesn't take page faults on the first pass.
+        _mem_size  = (_mem_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void* addr = ::mmap(nullptr,
+            _mem_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE,
+            -1,
+            0);
+        _huge_pages = (addr != MAP_FAILED);
+        if (!_huge_pages) {
+            addr = ::mmap(nullptr,
+                _mem_size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS,
+                -1,
+                0);
+            if (addr == MAP_FAILED) {
+                throw uhd::os_error(std::string("rx_capture_ring: mmap() failed: ")
+                                    + std::strerror(errno));
+            }
+            // Ask for transparent huge pages before the memory is touched
+            ::madvise(addr, _mem_size, MADV_HUGEPAGE);
+            std::memset(addr, 0, _mem_size);
+        }
+        UHD_LOG_DEBUG("RX CAPTURE",
+            "Allocated " << _mem_size << " bytes"
+                         << (_huge_pages ? " of huge pages" : ""));
+        _mem = static_cast<uint8_t*>(addr);
+#else
+        _mem = new uint8_t[_mem_size];
+#endif
+    }
+
+    void _free(void)
+    {
+#ifdef UHD_PLATFORM_LINUX
+        ::munmap(_mem, _mem_size);
+#else
+        delete[] _mem;
+#endif
+    }
+
+    /*** Index ***************************************************************/
+    //! Return the i-th oldest index entry. Must be called with _mutex held.
+    index_entry_t& _entry(const size_t i)
+    {
+        return _index[(_index_first + i) % _index.size()];
+    }
+
+    //! Return the position of the oldest sample which is still in the ring.
+    //  Must be called with _mutex held.
+    uint64_t _get_oldest_samp(void) const
+    {
+        return _reserved_end > _capacity ? _reserved_end - _capacity : 0;
+    }
+
+    //! Add received samples to the index. Must be called with _mutex held.
+    void _add_to_index(const uint64_t first_samp,
+        const size_t nsamps,
+        const bool has_time_spec,
+        const time_spec_t& time_spec)
+    {
+        if (_index_size > 0) {
+            index_entry_t& last = _entry(_index_size - 1);
+            const double offset =
+                has_time_spec ? (time_spec - last.time_spec).get_real_secs() * _samp_rate
+                              : double(last.nsamps);
+            // Extend the last entry if the samples are contiguous
+            if (last.end() == first_samp && std::abs(offset - last.nsamps) < 0.5) {
+                last.nsamps += nsamps;
+                return;
+            }
+        }
+        if (!has_time_spec) {
+            // Can't locate the samples without a time
+            return;
+        }
+
+        // Drop the entries which are overwritten, or the oldest one if the
+        // index is full
+        const uint64_t oldest_samp = _get_oldest_samp();
+        while (_index_size > 0
+               && (_entry(0).end() <= oldest_samp || _index_size == _index.size())) {
+            _index_first = (_index_first + 1) % _index.size();
+            _index_size--;
+        }
+        _entry(_index_size) = {first_samp, nsamps, time_spec};
+        _index_size++;
+    }
+
+    //! Return the number of the first entry which ends after samp, or
+    //  _index_size if there is none. Must be called with _mutex held.
+    size_t _find_entry(const uint64_t samp)
+    {
+        size_t lo = 0, hi = _index_size;
+        while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (_entry(mid).end() <= samp) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    //! Return the position of the sample at time_spec, or of the next one if
+    //  there is a gap, or of the oldest sample in the ring if it is newer. If
+    //  the time was not received yet, the next sample to be received is
+    //  returned. Must be called with _mutex held.
+    uint64_t _locate(const time_spec_t& time_spec)
+    {
+        const uint64_t oldest_samp = _get_oldest_samp();
+        for (size_t i = _find_entry(oldest_samp); i < _index_size; i++) {
+            const index_entry_t& entry = _entry(i);
+            const long long offset =
+                (time_spec - entry.time_spec).to_ticks(_samp_rate);
+            if (offset < static_cast<long long>(entry.nsamps)) {
+                const uint64_t samp = entry.first_samp + std::max(offset, 0LL);
+                return std::max(samp, oldest_samp);
+            }
+        }
+        return _write_end;
+    }
+
+    /*** Receive *************************************************************/
+    void _recv_loop(void)
+    {
+        std::vector<void*> buffs(_num_chans);
+        rx_metadata_t md;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop) {
+            // Receive up to the end of the ring, but don't overwrite a frozen
+            // window
+            const uint64_t write_pos = _write_end;
+            const size_t ring_offset = write_pos % _capacity;
+            const size_t nsamps      = std::min(_spp, _capacity - ring_offset);
+            const bool drop = _exporting && write_pos + nsamps > _pin_start + _capacity;
+            if (drop) {
+                for (size_t i = 0; i < _num_chans; i++) {
+                    buffs[i] = _scratch[i].data();
+                }
+            } else {
+                _reserved_end = write_pos + nsamps;
+                for (size_t i = 0; i < _num_chans; i++) {
+                    buffs[i] = _rings[i] + ring_offset * _bytes_per_samp;
+                }
+            }
+            lock.unlock();
+
+            size_t nsamps_recvd = 0;
+            try {
+                nsamps_recvd = _rx_stream->recv(buffs, nsamps, md, RECV_TIMEOUT, true);
+            } catch (const uhd::exception& ex) {
+                UHD_LOG_ERROR("RX CAPTURE", "Receive failed: " << ex.what());
+                md.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+            }
+            if (md.error_code != rx_metadata_t::ERROR_CODE_NONE
+                && md.error_code != rx_metadata_t::ERROR_CODE_TIMEOUT
+                && md.error_code != rx_metadata_t::ERROR_CODE_OVERFLOW) {
+                UHD_LOG_WARNING("RX CAPTURE", "Receive error: " << md.strerror());
+            }
+
+            lock.lock();
+            if (drop) {
+                _num_dropped += nsamps_recvd;
+            } else if (nsamps_recvd > 0) {
+                _add_to_index(write_pos, nsamps_recvd, md.has_time_spec, md.time_spec);
+                _write_end = write_pos + nsamps_recvd;
+            }
+            _reserved_end = _write_end;
+            if (_exporting && nsamps_recvd > 0) {
+                _cond.notify_all();
+            }
+        }
+    }
+
+    /*** Export **************************************************************/
+    void _export(
+        const time_spec_t start_time, const size_t nsamps, export_callback_t callback)
+    {
+        const time_spec_t end_time =
+            start_time + time_spec_t::from_ticks(nsamps, _samp_rate);
+        export_result_t result;
+        result.success = true;
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        // The export position. Samples before it are released from the frozen
+        // window, so the ring can reuse them.
+        uint64_t pos = _pin_start;
+        while (!_stop) {
+            if (_find_entry(pos) == _index_size) {
+                // Wait for the rest of the window
+                if (!_cond.wait_for(lock, EXPORT_DATA_TIMEOUT, [this, pos]() {
+                        return _stop || _find_entry(pos) < _index_size;
+                    })) {
+                    result.success = false;
+                    break;
+                }
+                continue;
+            }
+
+            const index_entry_t entry = _entry(_find_entry(pos));
+            if (entry.time_spec >= end_time) {
+                break;
+            }
+            // Clip the entry to the window and to the export position. The last
+            // entry may still grow, so the window only ends within an entry if
+            // the entry is long enough.
+            const long long first_offset =
+                (start_time - entry.time_spec).to_ticks(_samp_rate);
+            const long long end_offset = first_offset + static_cast<long long>(nsamps);
+            const bool window_ends = end_offset <= static_cast<long long>(entry.nsamps);
+            const uint64_t first = std::max<uint64_t>(
+                pos, entry.first_samp + std::max(first_offset, 0LL));
+            const uint64_t end =
+                window_ends ? entry.first_samp + std::max(end_offset, 0LL) : entry.end();
+
+            if (first < end) {
+                lock.unlock();
+                const time_spec_t chunk_time =
+                    entry.time_spec
+                    + time_spec_t::from_ticks(first - entry.first_samp, _samp_rate);
+                if (result.nsamps == 0) {
+                    result.start_time = chunk_time;
+                }
+                try {
+                    _export_chunk(first, end - first, chunk_time, callback);
+                    result.nsamps += end - first;
+                } catch (const std::exception& ex) {
+                    UHD_LOG_ERROR("RX CAPTURE", "Export failed: " << ex.what());
+                    result.success = false;
+                }
+                lock.lock();
+                if (!result.success) {
+                    break;
+                }
+            }
+            if (window_ends) {
+                break;
+            }
+            pos        = end;
+            _pin_start = pos;
+        }
+
+        // Release the callback before reporting the end of the export, so the
+        // state it holds (e.g., the files of a file export) is cleaned up
+        lock.unlock();
+        callback = nullptr;
+        lock.lock();
+        _last_export = result;
+        _exporting   = false;
+        lock.unlock();
+        _cond.notify_all();
+    }
+
+    //! Pass samples to the callback, split where they wrap around the ring
+    void _export_chunk(const uint64_t first,
+        const size_t nsamps,
+        const time_spec_t& time_spec,
+        const export_callback_t& callback)
+    {
+        const size_t ring_offset = first % _capacity;
+        const size_t len1        = std::min(nsamps, _capacity - ring_offset);
+        for (size_t chan = 0; chan < _num_chans; chan++) {
+            callback(chan, _rings[chan] + ring_offset * _bytes_per_samp, len1, time_spec);
+            if (len1 < nsamps) {
+                callback(chan,
+                    _rings[chan],
+                    nsamps - len1,
+                    time_spec + time_spec_t::from_ticks(len1, _samp_rate));
+            }
+        }
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const size_t _bytes_per_samp;
+    const size_t _num_chans;
+    const double _samp_rate;
+    const size_t _capacity;
+    //! The number of samples received per call
+    const size_t _spp;
+
+    //! The memory of all rings
+    uint8_t* _mem     = nullptr;
+    size_t _mem_size  = 0;
+    bool _huge_pages  = false;
+    std::vector<uint8_t*> _rings;
+    //! Buffers into which samples are received to drop them
+    std::vector<std::vector<uint8_t>> _scratch;
+
+    //! Protects all following members
+    mutable std::mutex _mutex;
+    //! Signals new samples and the end of exports
+    std::condition_variable _cond;
+    bool _stop = false;
+
+    //! Ring of index entries, ordered by the position of their samples
+    std::vector<index_entry_t> _index;
+    size_t _index_first = 0;
+    size_t _index_size  = 0;
+
+    //! The number of samples written to the ring
+    uint64_t _write_end = 0;
+    //! The end of the samples which are written to the ring, including the
+    //  ones being received
+    uint64_t _reserved_end = 0;
+    size_t _num_dropped    = 0;
+
+    //! True while a window is exported
+    bool _exporting = false;
+    //! The position of the first sample of the frozen window
+    uint64_t _pin_start = 0;
+    export_result_t _last_export;
+
+    std::thread _recv_thread;
+    std::thread _export_thread;
+};
+
+/***********************************************************************
+ * rx capture ring factory
+ **********************************************************************/
+rx_capture_ring::~rx_capture_ring(void)
+{
+    /* NOP */
+}
+
+rx_capture_ring::sptr rx_capture_ring::make(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double samp_rate,
+    const size_t capacity)
+{
+    return sptr(new rx_capture_ring_impl(rx_stream, cpu_format, samp_rate, capacity));
+}
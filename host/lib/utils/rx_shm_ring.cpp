@@ -0,0 +1,664 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/rx_shm_ring.hpp>
+#include <uhd/utils/thread.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+#ifdef UHD_PLATFORM_LINUX
+#    include <linux/futex.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <cerrno>
+#    include <climits>
+#    include <ctime>
+#endif
+
+using namespace uhd;
+
+#ifdef UHD_PLATFORM_LINUX
+
+namespace {
+
+//! While no samples arrive, the receive thread wakes up this often (in seconds)
+//  to notice that the publisher is being destroyed
+constexpr double RECV_TIMEOUT = 0.1;
+
+//! Identifies a sample ring ("UHDSHMRG")
+constexpr uint64_t SHM_MAGIC   = 0x47524d4853444855;
+constexpr uint32_t SHM_VERSION = 1;
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+//! Alignment of the sample data
+constexpr size_t DATA_ALIGNMENT = 4096;
+
+constexpr uint64_t PACKET_HAS_TIME_SPEC = 1 << 0;
+constexpr uint64_t PACKET_OVERFLOW      = 1 << 1;
+
+// The ring is shared between processes, so its atomics must not use locks
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+    "Shared memory ring requires lock-free atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+    "Futex word must be 32 bits");
+
+/*! Header at the start of the shared memory
+ *
+ * The header is followed by the packet slots and then by the sample data of
+ * every channel. The layout fields are written before the ring is published,
+ * the counters are updated by the publisher while it receives.
+ */
+struct shm_header_t
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_chans;
+    uint64_t bytes_per_samp;
+    uint64_t capacity;
+    uint64_t num_slots;
+    uint64_t slots_offset;
+    uint64_t data_offset;
+    uint64_t chan_stride;
+    double samp_rate;
+    char cpu_format[32];
+
+    //! The number of packets which were published
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> num_packets;
+    //! The end of the samples which are written to the ring, including the
+    //  packet being received
+    std::atomic<uint64_t> reserve_end;
+    //! Incremented when a packet is published, or when the publisher is gone.
+    //  Consumers wait on it.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> futex;
+    std::atomic<uint32_t> closed;
+};
+
+/*! Descriptor of a published packet
+ *
+ * The slot of packet p is p % num_slots. Slots are written like a seqlock: seq
+ * is zero while the slot is written, and p + 1 when it holds packet p.
+ */
+struct shm_packet_t
+{
+    std::atomic<uint64_t> seq;
+    //! The position of the first sample, counting all samples ever published
+    std::atomic<uint64_t> first_samp;
+    std::atomic<uint64_t> nsamps;
+    std::atomic<int64_t> full_secs;
+    //! The bits of the fractional seconds
+    std::atomic<uint64_t> frac_secs;
+    std::atomic<uint64_t> flags;
+};
+
+//! Copy of a packet descriptor
+struct packet_t
+{
+    uint64_t first_samp;
+    size_t nsamps;
+    time_spec_t time_spec;
+    uint64_t flags;
+};
+
+size_t round_up(const size_t value, const size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+/***********************************************************************
+ * rx shm publisher implementation
+ **********************************************************************/
+class rx_shm_publisher_impl : public rx_shm_publisher
+{
+public:
+    rx_shm_publisher_impl(rx_streamer::sptr rx_stream,
+        const std::string& cpu_format,
+        const double samp_rate,
+        const size_t capacity)
+        : _rx_stream(rx_stream)
+        , _bytes_per_samp(convert::get_bytes_per_item(cpu_format))
+        , _num_chans(rx_stream->get_num_channels())
+        , _capacity(capacity)
+        , _spp(std::max<size_t>(rx_stream->get_max_num_samps(), 1))
+    {
+        if (samp_rate <= 0.0) {
+            throw uhd::value_error("rx_shm_publisher: Invalid sample rate");
+        }
+        if (capacity == 0) {
+            throw uhd::value_error("rx_shm_publisher: Capacity must not be zero");
+        }
+        if (cpu_format.size() >= sizeof(shm_header_t::cpu_format)) {
+            throw uhd::value_error("rx_shm_publisher: Invalid CPU format");
+        }
+
+        // Packets may be shorter than spp where they wrap around the ring, so
+        // there are more slots than packets in the ring
+        const size_t num_slots    = 2 * (_capacity / _spp) + 2;
+        const size_t slots_offset = round_up(sizeof(shm_header_t), CACHE_LINE_SIZE);
+        const size_t data_offset =
+            round_up(slots_offset + num_slots * sizeof(shm_packet_t), DATA_ALIGNMENT);
+        const size_t chan_stride = round_up(_capacity * _bytes_per_samp, CACHE_LINE_SIZE);
+        _mem_size                = data_offset + _num_chans * chan_stride;
+
+        _fd = ::memfd_create("uhd_rx_shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (_fd < 0) {
+            throw uhd::os_error(std::string("rx_shm_publisher: memfd_create() failed: ")
+                                + std::strerror(errno));
+        }
+        // Consumers with write access must not be able to resize the ring
+        // under our feet
+        if (::ftruncate(_fd, _mem_size) < 0
+            || ::fcntl(_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+                   < 0) {
+            const int err = errno;
+            ::close(_fd);
+            throw uhd::os_error(
+                std::string("rx_shm_publisher: Failed to size the ring: ")
+                + std::strerror(err));
+        }
+        void* addr =
+            ::mmap(nullptr, _mem_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (addr == MAP_FAILED) {
+            const int err = errno;
+            ::close(_fd);
+            throw uhd::os_error(
+                std::string("rx_shm_publisher: mmap() failed: ") + std::strerror(err));
+        }
+        _mem = static_cast<uint8_t*>(addr);
+
+        _hdr = new (_mem) shm_header_t();
+        _hdr->version        = SHM_VERSION;
+        _hdr->num_chans      = static_cast<uint32_t>(_num_chans);
+        _hdr->bytes_per_samp = _bytes_per_samp;
+        _hdr->capacity       = _capacity;
+        _hdr->num_slots      = num_slots;
+        _hdr->slots_offset   = slots_offset;
+        _hdr->data_offset    = data_offset;
+        _hdr->chan_stride    = chan_stride;
+        _hdr->samp_rate      = samp_rate;
+        cpu_format.copy(_hdr->cpu_format, cpu_format.size());
+        _hdr->num_packets = 0;
+        _hdr->reserve_end = 0;
+        _hdr->futex       = 0;
+        _hdr->closed      = 0;
+        _slots            = reinterpret_cast<shm_packet_t*>(_mem + slots_offset);
+        for (size_t i = 0; i < num_slots; i++) {
+            new (&_slots[i]) shm_packet_t();
+        }
+        for (size_t i = 0; i < _num_chans; i++) {
+            _rings.push_back(_mem + data_offset + i * chan_stride);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        _hdr->magic = SHM_MAGIC;
+
+        UHD_LOG_DEBUG("RX SHM",
+            "Publishing " << _num_chans << " channels in " << _mem_size
+                          << " bytes at " << get_path());
+        _recv_thread = std::thread([this]() { _recv_loop(); });
+        set_thread_name(&_recv_thread, "rx_shm_pub");
+    }
+
+    ~rx_shm_publisher_impl(void)
+    {
+        _stop = true;
+        _recv_thread.join();
+        _hdr->closed = 1;
+        _hdr->futex.fetch_add(1, std::memory_order_release);
+        _futex_wake();
+        ::munmap(_mem, _mem_size);
+        ::close(_fd);
+    }
+
+    std::string get_path(void) const
+    {
+        return "/proc/" + std::to_string(::getpid()) + "/fd/" + std::to_string(_fd);
+    }
+
+    int get_fd(void) const
+    {
+        return _fd;
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _num_chans;
+    }
+
+    size_t get_capacity(void) const
+    {
+        return _capacity;
+    }
+
+    uint64_t get_num_recvd_samps(void) const
+    {
+        return _write_end.load();
+    }
+
+private:
+    void _recv_loop(void)
+    {
+        std::vector<void*> buffs(_num_chans);
+        rx_metadata_t md;
+        uint64_t num_packets = 0;
+        bool overflow        = false;
+        while (!_stop) {
+            // Receive up to the end of the ring
+            const uint64_t write_pos = _write_end.load(std::memory_order_relaxed);
+            const size_t ring_offset = write_pos % _capacity;
+            const size_t nsamps      = std::min(_spp, _capacity - ring_offset);
+            for (size_t i = 0; i < _num_chans; i++) {
+                buffs[i] = _rings[i] + ring_offset * _bytes_per_samp;
+            }
+            // Reserve the samples before they are overwritten, so consumers
+            // which read them at the same time can tell
+            _hdr->reserve_end.store(write_pos + nsamps, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            size_t nsamps_recvd = 0;
+            md.error_code       = rx_metadata_t::ERROR_CODE_NONE;
+            try {
+                nsamps_recvd = _rx_stream->recv(buffs, nsamps, md, RECV_TIMEOUT, true);
+            } catch (const uhd::exception& ex) {
+                // Nothing is published, and the reservation is withdrawn below
+                UHD_LOG_ERROR(
+                    "RX SHM", "Failed to receive into the ring: " << ex.what());
+            }
+            switch (md.error_code) {
+                case rx_metadata_t::ERROR_CODE_NONE:
+                case rx_metadata_t::ERROR_CODE_TIMEOUT:
+                    break;
+                case rx_metadata_t::ERROR_CODE_OVERFLOW:
+                    // Marks the next published packet
+                    overflow = true;
+                    break;
+                default:
+                    UHD_LOG_WARNING("RX SHM", "Receive error: " << md.strerror());
+            }
+
+            if (nsamps_recvd > 0) {
+                double frac_secs = md.time_spec.get_frac_secs();
+                uint64_t frac_bits;
+                std::memcpy(&frac_bits, &frac_secs, sizeof(frac_bits));
+                const uint64_t flags = (md.has_time_spec ? PACKET_HAS_TIME_SPEC : 0)
+                                       | (overflow ? PACKET_OVERFLOW : 0);
+
+                shm_packet_t& slot = _slots[num_packets % _hdr->num_slots];
+                slot.seq.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                slot.first_samp.store(write_pos, std::memory_order_relaxed);
+                slot.nsamps.store(nsamps_recvd, std::memory_order_relaxed);
+                slot.full_secs.store(
+                    md.time_spec.get_full_secs(), std::memory_order_relaxed);
+                slot.frac_secs.store(frac_bits, std::memory_order_relaxed);
+                slot.flags.store(flags, std::memory_order_relaxed);
+                slot.seq.store(num_packets + 1, std::memory_order_release);
+
+                num_packets++;
+                overflow = false;
+                _write_end.store(write_pos + nsamps_recvd, std::memory_order_relaxed);
+                _hdr->num_packets.store(num_packets, std::memory_order_release);
+                _hdr->futex.fetch_add(1, std::memory_order_release);
+                // Consumers map the ring read-only, so they can't tell us if
+                // they are waiting
+                _futex_wake();
+            }
+            _hdr->reserve_end.store(_write_end.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        }
+    }
+
+    void _futex_wake(void)
+    {
+        ::syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&_hdr->futex),
+            FUTEX_WAKE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+    }
+
+    rx_streamer::sptr _rx_stream;
+    const size_t _bytes_per_samp;
+    const size_t _num_chans;
+    const size_t _capacity;
+    //! The number of samples received per call
+    const size_t _spp;
+
+    int _fd          = -1;
+    uint8_t* _mem    = nullptr;
+    size_t _mem_size = 0;
+    shm_header_t* _hdr;
+    shm_packet_t* _slots;
+    std::vector<uint8_t*> _rings;
+
+    //! The number of samples published
+    std::atomic<uint64_t> _write_end{0};
+    std::atomic<bool> _stop{false};
+    std::thread _recv_thread;
+};
+
+/***********************************************************************
+ * rx shm consumer implementation
+ **********************************************************************/
+class rx_shm_consumer_impl : public rx_shm_consumer
+{
+public:
+    rx_shm_consumer_impl(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw uhd::os_error("rx_shm_consumer: Failed to open " + path + ": "
+                                + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(shm_header_t)) {
+            ::close(fd);
+            throw uhd::value_error("rx_shm_consumer: Not a sample ring: " + path);
+        }
+        _mem_size  = st.st_size;
+        void* addr = ::mmap(nullptr, _mem_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw uhd::os_error(
+                std::string("rx_shm_consumer: mmap() failed: ") + std::strerror(errno));
+        }
+        _mem = static_cast<const uint8_t*>(addr);
+        _hdr = reinterpret_cast<const shm_header_t*>(_mem);
+
+        if (_hdr->magic != SHM_MAGIC || _hdr->version != SHM_VERSION
+            || _hdr->data_offset + _hdr->num_chans * _hdr->chan_stride > _mem_size) {
+            ::munmap(const_cast<uint8_t*>(_mem), _mem_size);
+            throw uhd::value_error("rx_shm_consumer: Not a sample ring: " + path);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        _slots = reinterpret_cast<const shm_packet_t*>(_mem + _hdr->slots_offset);
+        for (size_t i = 0; i < _hdr->num_chans; i++) {
+            _rings.push_back(_mem + _hdr->data_offset + i * _hdr->chan_stride);
+        }
+        _cpu_format = std::string(_hdr->cpu_format,
+            strnlen(_hdr->cpu_format, sizeof(_hdr->cpu_format)));
+
+        // Start with the samples published from now on
+        _next_packet = _hdr->num_packets.load(std::memory_order_acquire);
+    }
+
+    ~rx_shm_consumer_impl(void)
+    {
+        ::munmap(const_cast<uint8_t*>(_mem), _mem_size);
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return _hdr->num_chans;
+    }
+
+    size_t get_capacity(void) const
+    {
+        return _hdr->capacity;
+    }
+
+    std::string get_cpu_format(void) const
+    {
+        return _cpu_format;
+    }
+
+    double get_samp_rate(void) const
+    {
+        return _hdr->samp_rate;
+    }
+
+    size_t recv(const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout)
+    {
+        metadata = rx_metadata_t();
+        if (_overrun_pending) {
+            _overrun_pending    = false;
+            metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+            return 0;
+        }
+
+        const auto exit_time =
+            std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        const size_t bytes_per_samp = _hdr->bytes_per_samp;
+        size_t nsamps_recvd         = 0;
+        while (nsamps_recvd < nsamps_per_buff) {
+            // Load the futex word first, so a packet that is published after
+            // the check ends the wait
+            const uint32_t futex_val = _hdr->futex.load(std::memory_order_acquire);
+            const uint64_t num_packets =
+                _hdr->num_packets.load(std::memory_order_acquire);
+            if (_next_packet >= num_packets) {
+                if (nsamps_recvd > 0) {
+                    break;
+                }
+                const double time_left =
+                    std::chrono::duration<double>(
+                        exit_time - std::chrono::steady_clock::now())
+                        .count();
+                if (_hdr->closed.load(std::memory_order_acquire) || time_left <= 0.0) {
+                    metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                    return 0;
+                }
+                _futex_wait(futex_val, time_left);
+                continue;
+            }
+
+            packet_t packet;
+            if (num_packets - _next_packet > _hdr->num_slots
+                || !_read_packet(_next_packet, packet)) {
+                _overrun();
+                break;
+            }
+            if (_packet_offset == 0 && (packet.flags & PACKET_OVERFLOW)
+                && !_overflow_reported) {
+                if (nsamps_recvd > 0) {
+                    break;
+                }
+                _overflow_reported  = true;
+                metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+                return 0;
+            }
+            const time_spec_t time_spec =
+                packet.time_spec
+                + time_spec_t::from_ticks(_packet_offset, _hdr->samp_rate);
+            const bool has_time_spec = packet.flags & PACKET_HAS_TIME_SPEC;
+            if (nsamps_recvd > 0 && has_time_spec && metadata.has_time_spec) {
+                // Stop before a gap
+                const time_spec_t expected_time =
+                    metadata.time_spec
+                    + time_spec_t::from_ticks(nsamps_recvd, _hdr->samp_rate);
+                if (std::abs((time_spec - expected_time).get_real_secs())
+                        * _hdr->samp_rate
+                    >= 0.5) {
+                    break;
+                }
+            }
+
+            const size_t nsamps = std::min(
+                packet.nsamps - _packet_offset, nsamps_per_buff - nsamps_recvd);
+            const uint64_t first_samp = packet.first_samp + _packet_offset;
+            const size_t ring_offset  = first_samp % _hdr->capacity;
+            for (size_t i = 0; i < _rings.size(); i++) {
+                uint8_t* buff = static_cast<uint8_t*>(buffs[i]);
+                std::memcpy(buff + nsamps_recvd * bytes_per_samp,
+                    _rings[i] + ring_offset * bytes_per_samp,
+                    nsamps * bytes_per_samp);
+            }
+            // Check if the publisher started to overwrite the samples while we
+            // copied them
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_hdr->reserve_end.load(std::memory_order_relaxed) - first_samp
+                > _hdr->capacity) {
+                _overrun();
+                break;
+            }
+
+            if (nsamps_recvd == 0) {
+                metadata.has_time_spec = has_time_spec;
+                metadata.time_spec     = time_spec;
+            }
+            nsamps_recvd += nsamps;
+            _packet_offset += nsamps;
+            if (_packet_offset == packet.nsamps) {
+                _next_packet++;
+                _packet_offset     = 0;
+                _overflow_reported = false;
+            }
+        }
+
+        if (nsamps_recvd == 0 && _overrun_pending) {
+            _overrun_pending    = false;
+            metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+        }
+        return nsamps_recvd;
+    }
+
+    size_t get_num_overruns(void) const
+    {
+        return _num_overruns;
+    }
+
+    bool is_closed(void) const
+    {
+        return _hdr->closed.load(std::memory_order_acquire);
+    }
+
+private:
+    //! Read the descriptor of a packet. Returns false if the slot was already
+    //  reused for a newer packet.
+    bool _read_packet(const uint64_t packet_num, packet_t& packet) const
+    {
+        const shm_packet_t& slot = _slots[packet_num % _hdr->num_slots];
+        if (slot.seq.load(std::memory_order_acquire) != packet_num + 1) {
+            return false;
+        }
+        packet.first_samp        = slot.first_samp.load(std::memory_order_relaxed);
+        packet.nsamps            = slot.nsamps.load(std::memory_order_relaxed);
+        const int64_t full_secs  = slot.full_secs.load(std::memory_order_relaxed);
+        const uint64_t frac_bits = slot.frac_secs.load(std::memory_order_relaxed);
+        packet.flags             = slot.flags.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != packet_num + 1) {
+            return false;
+        }
+        double frac_secs;
+        std::memcpy(&frac_secs, &frac_bits, sizeof(frac_secs));
+        packet.time_spec = time_spec_t(full_secs, frac_secs);
+        return true;
+    }
+
+    //! Handle falling behind the publisher: Skip ahead to the first packet in
+    //  the newer half of the ring, so there is time to catch up
+    void _overrun(void)
+    {
+        _num_overruns++;
+        _overrun_pending   = true;
+        _packet_offset     = 0;
+        _overflow_reported = false;
+
+        const uint64_t num_packets = _hdr->num_packets.load(std::memory_order_acquire);
+        const uint64_t reserve_end = _hdr->reserve_end.load(std::memory_order_acquire);
+        const uint64_t min_samp =
+            reserve_end - std::min<uint64_t>(reserve_end, _hdr->capacity / 2);
+        // Packets are ordered by their samples, so search for the first one
+        // which starts late enough
+        uint64_t lo = std::max(
+            _next_packet, num_packets - std::min(num_packets, _hdr->num_slots));
+        uint64_t hi = num_packets;
+        while (lo < hi) {
+            const uint64_t mid = lo + (hi - lo) / 2;
+            packet_t packet;
+            if (!_read_packet(mid, packet) || packet.first_samp < min_samp) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        _next_packet = lo;
+    }
+
+    void _futex_wait(const uint32_t val, const double timeout) const
+    {
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(timeout);
+        ts.tv_nsec = static_cast<long>((timeout - ts.tv_sec) * 1e9);
+        ::syscall(SYS_futex,
+            reinterpret_cast<const uint32_t*>(&_hdr->futex),
+            FUTEX_WAIT,
+            val,
+            &ts,
+            nullptr,
+            0);
+    }
+
+    const uint8_t* _mem = nullptr;
+    size_t _mem_size    = 0;
+    const shm_header_t* _hdr;
+    const shm_packet_t* _slots;
+    std::vector<const uint8_t*> _rings;
+    std::string _cpu_format;
+
+    //! The number of the next packet to read, and the number of its samples
+    //  which were read
+    uint64_t _next_packet = 0;
+    size_t _packet_offset = 0;
+    //! True if the overflow flag of the next packet was reported
+    bool _overflow_reported = false;
+    //! True if an overrun has to be reported by the next recv() call
+    bool _overrun_pending = false;
+    size_t _num_overruns  = 0;
+};
+
+#endif /* UHD_PLATFORM_LINUX */
+
+/***********************************************************************
+ * rx shm publisher and consumer factories
+ **********************************************************************/
+rx_shm_publisher::~rx_shm_publisher(void)
+{
+    /* NOP */
+}
+
+rx_shm_publisher::sptr rx_shm_publisher::make(rx_streamer::sptr rx_stream,
+    const std::string& cpu_format,
+    const double samp_rate,
+    const size_t capacity)
+{
+#ifdef UHD_PLATFORM_LINUX
+    return sptr(new rx_shm_publisher_impl(rx_stream, cpu_format, samp_rate, capacity));
+#else
+    throw uhd::not_implemented_error("rx_shm_publisher is only available on Linux");
+#endif
+}
+
+rx_shm_consumer::~rx_shm_consumer(void)
+{
+    /* NOP */
+}
+
+rx_shm_consumer::sptr rx_shm_consumer::make(const std::string& path)
+{
+#ifdef UHD_PLATFORM_LINUX
+    return sptr(new rx_shm_consumer_impl(path));
+#else
+    throw uhd::not_implemented_error("rx_shm_consumer is only available on Linux");
+#endif
+}
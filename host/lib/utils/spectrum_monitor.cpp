@@ -0,0 +1,254 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/spectrum_monitor.hpp>
+#include <uhdlib/utils/fft.hpp>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+
+using namespace uhd;
+
+namespace {
+
+using fc32_t = std::complex<float>;
+
+std::vector<float> make_window(
+    const spectrum_monitor::window_type_t window_type, const size_t size)
+{
+    std::vector<float> window(size);
+    const double denom = double(size - 1);
+    for (size_t n = 0; n < size; n++) {
+        const double phi = 2 * M_PI * n / denom;
+        double w_n       = 1.0;
+        switch (window_type) {
+            case spectrum_monitor::WINDOW_RECTANGULAR:
+                w_n = 1.0;
+                break;
+            case spectrum_monitor::WINDOW_HANN:
+                w_n = 0.5 - 0.5 * std::cos(phi);
+                break;
+            case spectrum_monitor::WINDOW_HAMMING:
+                w_n = 0.54 - 0.46 * std::cos(phi);
+                break;
+            case spectrum_monitor::WINDOW_BLACKMAN_HARRIS:
+                w_n = 0.35875 - 0.48829 * std::cos(phi) + 0.14128 * std::cos(2 * phi)
+                      - 0.01168 * std::cos(3 * phi);
+                break;
+            default:
+                throw uhd::value_error("Invalid window type");
+        }
+        window[n] = float(w_n);
+    }
+    return window;
+}
+
+} // namespace
+
+/***********************************************************************
+ * spectrum monitor implementation
+ **********************************************************************/
+class spectrum_monitor_impl : public spectrum_monitor
+{
+public:
+    spectrum_monitor_impl(
+        const size_t fft_size, const window_type_t window, const size_t num_averages)
+        : _fft_size(fft_size)
+        , _fft(fft_size)
+        , _window(make_window(window, fft_size))
+        , _frame(fft_size)
+        , _work(fft_size)
+        , _acc(fft_size, 0.0f)
+        , _next_psd_pwr(fft_size)
+    {
+        if (fft_size < 2) {
+            throw uhd::value_error("FFT size must be at least 2");
+        }
+        // Normalize the power to dBFS, and correct for the power of the window
+        double win_pwr = 0;
+        for (const float w_n : _window) {
+            win_pwr += double(w_n) * w_n;
+        }
+        _psd_offset = float(-20 * std::log10(double(fft_size))
+                            - 10 * std::log10(win_pwr / fft_size) + 3);
+        set_num_averages(num_averages);
+    }
+
+    size_t get_fft_size(void) const
+    {
+        return _fft_size;
+    }
+
+    size_t get_num_averages(void) const
+    {
+        return _num_averages;
+    }
+
+    void set_num_averages(const size_t num_averages)
+    {
+        if (num_averages == 0) {
+            throw uhd::value_error("Number of averages must be at least 1");
+        }
+        _num_averages = num_averages;
+        _num_frames   = 0;
+        std::fill(_acc.begin(), _acc.end(), 0.0f);
+    }
+
+    void push(const fc32_t* samps, size_t nsamps)
+    {
+        while (nsamps > 0) {
+            // Process complete frames straight from the input
+            if (_frame_fill == 0 && nsamps >= _fft_size) {
+                _process_frame(samps);
+                samps += _fft_size;
+                nsamps -= _fft_size;
+                continue;
+            }
+            const size_t n = std::min(_fft_size - _frame_fill, nsamps);
+            std::copy(samps, samps + n, _frame.begin() + _frame_fill);
+            _frame_fill += n;
+            samps += n;
+            nsamps -= n;
+            if (_frame_fill == _fft_size) {
+                _process_frame(_frame.data());
+                _frame_fill = 0;
+            }
+        }
+    }
+
+    size_t recv(rx_streamer& rx_stream,
+        const rx_streamer::buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout,
+        const size_t chan)
+    {
+        if (chan >= buffs.size()) {
+            throw uhd::value_error("Invalid channel: " + std::to_string(chan));
+        }
+        const size_t num_rx_samps =
+            rx_stream.recv(buffs, nsamps_per_buff, metadata, timeout);
+        // Don't let a frame straddle a gap in the sample stream
+        if (metadata.error_code == rx_metadata_t::ERROR_CODE_OVERFLOW) {
+            _frame_fill = 0;
+        }
+        push(static_cast<const fc32_t*>(buffs[chan]), num_rx_samps);
+        return num_rx_samps;
+    }
+
+    std::vector<float> get_psd(void) const
+    {
+        std::vector<float> psd;
+        {
+            std::lock_guard<std::mutex> l(_psd_mutex);
+            psd = _psd_pwr;
+        }
+        // The conversion to dB is done here, and not for every estimate, so
+        // its cost only depends on how often the PSD is read
+        for (float& bin : psd) {
+            bin = 10 * std::log10(bin) + _psd_offset;
+        }
+        return psd;
+    }
+
+    size_t get_num_psds(void) const
+    {
+        std::lock_guard<std::mutex> l(_psd_mutex);
+        return _num_psds;
+    }
+
+    void reset(void)
+    {
+        _frame_fill = 0;
+        set_num_averages(_num_averages);
+        std::lock_guard<std::mutex> l(_psd_mutex);
+        _psd_pwr.clear();
+    }
+
+    void compute_psd(const fc32_t* samps, float* log_pwr)
+    {
+        _transform(samps);
+        for (size_t i = 0; i < _fft_size; i++) {
+            log_pwr[i] = 10 * std::log10(std::norm(_work[i])) + _psd_offset;
+        }
+    }
+
+private:
+    //! Window and transform one frame into _work
+    void _transform(const fc32_t* samps)
+    {
+        for (size_t i = 0; i < _fft_size; i++) {
+            _work[i] = samps[i] * _window[i];
+        }
+        _fft.execute(_work.data());
+    }
+
+    //! Add the power spectrum of one frame, and publish the estimate when done
+    void _process_frame(const fc32_t* samps)
+    {
+        _transform(samps);
+        for (size_t i = 0; i < _fft_size; i++) {
+            _acc[i] += _work[i].real() * _work[i].real()
+                       + _work[i].imag() * _work[i].imag();
+        }
+        if (++_num_frames < _num_averages) {
+            return;
+        }
+        const float scale = 1.0f / float(_num_averages);
+        for (size_t i = 0; i < _fft_size; i++) {
+            _next_psd_pwr[i] = _acc[i] * scale;
+        }
+        std::fill(_acc.begin(), _acc.end(), 0.0f);
+        _num_frames = 0;
+        // Swap in the new estimate. The old one gets overwritten next time, so
+        // there's no allocation here after the first estimate.
+        std::lock_guard<std::mutex> l(_psd_mutex);
+        if (_psd_pwr.empty()) {
+            _psd_pwr.resize(_fft_size);
+        }
+        _psd_pwr.swap(_next_psd_pwr);
+        _num_psds++;
+    }
+
+    const size_t _fft_size;
+    uhd::fft _fft;
+    const std::vector<float> _window;
+    //! Offset to convert the power of a bin to dBFS
+    float _psd_offset;
+
+    //! Holds the samples of an incomplete frame
+    std::vector<fc32_t> _frame;
+    size_t _frame_fill = 0;
+    //! The windowed and transformed frame
+    std::vector<fc32_t> _work;
+    //! The sum of the power spectra of the frames of the current estimate
+    std::vector<float> _acc;
+    size_t _num_frames   = 0;
+    size_t _num_averages = 1;
+    //! The next estimate (linear power) is computed here before it's published
+    std::vector<float> _next_psd_pwr;
+
+    mutable std::mutex _psd_mutex;
+    //! The latest estimate, in linear power
+    std::vector<float> _psd_pwr;
+    size_t _num_psds = 0;
+};
+
+/***********************************************************************
+ * spectrum monitor factory
+ **********************************************************************/
+spectrum_monitor::~spectrum_monitor(void)
+{
+    /* NOP */
+}
+
+spectrum_monitor::sptr spectrum_monitor::make(
+    const size_t fft_size, const window_type_t window, const size_t num_averages)
+{
+    return sptr(new spectrum_monitor_impl(fft_size, window, num_averages));
+}
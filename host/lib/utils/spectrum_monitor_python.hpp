@@ -0,0 +1,150 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_UHD_SPECTRUM_MONITOR_PYTHON_HPP
+#define INCLUDED_UHD_SPECTRUM_MONITOR_PYTHON_HPP
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/spectrum_monitor.hpp>
+#include <complex>
+#include <vector>
+
+//! Return the samples of a complex64 NumPy array, one pointer per row
+//
+// The returned array object holds a reference, which the caller must release
+static PyObject* get_fc32_rows(
+    py::object& np_array, std::vector<void*>& rows, size_t& nsamps_per_row)
+{
+    PyObject* array_obj =
+        PyArray_FROM_OTF(np_array.ptr(), NPY_COMPLEX64, NPY_ARRAY_CARRAY);
+    if (!array_obj) {
+        throw py::error_already_set();
+    }
+    PyArrayObject* array_type_obj = reinterpret_cast<PyArrayObject*>(array_obj);
+    const size_t dims             = PyArray_NDIM(array_type_obj);
+    if (dims > 2) {
+        Py_DECREF(array_obj);
+        throw uhd::value_error("The data array must have one or two dimensions");
+    }
+    const npy_intp* shape = PyArray_SHAPE(array_type_obj);
+    char* data            = PyArray_BYTES(array_type_obj);
+    const size_t num_rows = (dims == 2) ? (size_t)shape[0] : 1;
+    rows.clear();
+    for (size_t i = 0; i < num_rows; i++) {
+        rows.push_back(data + i * (dims == 2 ? PyArray_STRIDES(array_type_obj)[0] : 0));
+    }
+    nsamps_per_row = (dims == 2) ? (size_t)shape[1] : PyArray_SIZE(array_type_obj);
+    return array_obj;
+}
+
+//! Return the samples of a one-dimensional complex64 NumPy array
+//
+// The returned array object holds a reference, which the caller must release
+static PyObject* get_fc32_samples(
+    py::object& np_array, const std::complex<float>*& samples, size_t& nsamps)
+{
+    std::vector<void*> rows;
+    PyObject* array_obj = get_fc32_rows(np_array, rows, nsamps);
+    if (PyArray_NDIM(reinterpret_cast<PyArrayObject*>(array_obj)) != 1) {
+        Py_DECREF(array_obj);
+        throw py::value_error("The data array must have one dimension");
+    }
+    samples = static_cast<const std::complex<float>*>(rows[0]);
+    return array_obj;
+}
+
+static void wrap_spectrum_monitor_push(
+    uhd::spectrum_monitor* monitor, py::object& np_array)
+{
+    const std::complex<float>* samples;
+    size_t nsamps;
+    PyObject* array_obj = get_fc32_samples(np_array, samples, nsamps);
+    {
+        py::gil_scoped_release release;
+        monitor->push(samples, nsamps);
+    }
+    Py_DECREF(array_obj);
+}
+
+static size_t wrap_spectrum_monitor_recv(uhd::spectrum_monitor* monitor,
+    uhd::rx_streamer* rx_stream,
+    py::object& np_array,
+    uhd::rx_metadata_t& metadata,
+    const double timeout = 0.1,
+    const size_t chan    = 0)
+{
+    std::vector<void*> rows;
+    size_t nsamps_per_buff;
+    PyObject* array_obj = get_fc32_rows(np_array, rows, nsamps_per_buff);
+    if (rows.size() < rx_stream->get_num_channels()) {
+        Py_DECREF(array_obj);
+        throw uhd::runtime_error(
+            "Number of RX channels does not match the dimensions of the data array");
+    }
+    rows.resize(rx_stream->get_num_channels());
+
+    // Release the GIL only for the recv() call
+    const size_t result = [&]() {
+        py::gil_scoped_release release;
+        return monitor->recv(*rx_stream, rows, nsamps_per_buff, metadata, timeout, chan);
+    }();
+
+    Py_DECREF(array_obj);
+    return result;
+}
+
+static std::vector<float> wrap_spectrum_monitor_compute_psd(
+    uhd::spectrum_monitor* monitor, py::object& np_array)
+{
+    const std::complex<float>* samples;
+    size_t nsamps;
+    PyObject* array_obj = get_fc32_samples(np_array, samples, nsamps);
+    if (nsamps != monitor->get_fft_size()) {
+        Py_DECREF(array_obj);
+        throw uhd::value_error("The data array must hold one frame of samples");
+    }
+    std::vector<float> log_pwr(nsamps);
+    monitor->compute_psd(samples, log_pwr.data());
+    Py_DECREF(array_obj);
+    return log_pwr;
+}
+
+void export_spectrum_monitor(py::module& m)
+{
+    using spectrum_monitor = uhd::spectrum_monitor;
+
+    py::class_<spectrum_monitor, spectrum_monitor::sptr> monitor(
+        m, "spectrum_monitor", "See: uhd::spectrum_monitor");
+
+    py::enum_<spectrum_monitor::window_type_t>(monitor, "window_type")
+        .value("rectangular", spectrum_monitor::WINDOW_RECTANGULAR)
+        .value("hann", spectrum_monitor::WINDOW_HANN)
+        .value("hamming", spectrum_monitor::WINDOW_HAMMING)
+        .value("blackman_harris", spectrum_monitor::WINDOW_BLACKMAN_HARRIS);
+
+    monitor
+        .def(py::init(&spectrum_monitor::make),
+            py::arg("fft_size"),
+            py::arg("window")       = spectrum_monitor::WINDOW_BLACKMAN_HARRIS,
+            py::arg("num_averages") = 1)
+        .def("get_fft_size", &spectrum_monitor::get_fft_size)
+        .def("get_num_averages", &spectrum_monitor::get_num_averages)
+        .def("set_num_averages", &spectrum_monitor::set_num_averages)
+        .def("push", &wrap_spectrum_monitor_push, py::arg("np_array"))
+        .def("recv",
+            &wrap_spectrum_monitor_recv,
+            py::arg("rx_streamer"),
+            py::arg("np_array"),
+            py::arg("metadata"),
+            py::arg("timeout") = 0.1,
+            py::arg("chan")    = 0)
+        .def("get_psd", &spectrum_monitor::get_psd)
+        .def("get_num_psds", &spectrum_monitor::get_num_psds)
+        .def("reset", &spectrum_monitor::reset)
+        .def("compute_psd", &wrap_spectrum_monitor_compute_psd, py::arg("np_array"));
+}
+
+#endif /* INCLUDED_UHD_SPECTRUM_MONITOR_PYTHON_HPP */
@@ -0,0 +1,363 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/convert.hpp>
+#include <uhd/exception.hpp>
+#include <uhd/utils/log.hpp>
+#include <uhd/utils/thread.hpp>
+#include <uhd/utils/tx_burst_scheduler.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+
+//! Timeout of the send() calls, after which the scheduler checks if it
+//  should stop
+constexpr double SEND_TIMEOUT = 0.1;
+
+} // namespace
+
+/***********************************************************************
+ * tx burst scheduler implementation
+ **********************************************************************/
+class tx_burst_scheduler_impl : public tx_burst_scheduler
+{
+public:
+    tx_burst_scheduler_impl(tx_streamer::sptr tx_stream,
+        const std::string& cpu_format,
+        const time_spec_t& device_time,
+        const double lead_time)
+        : _tx_stream(tx_stream)
+        , _bytes_per_samp(convert::get_bytes_per_item(cpu_format))
+        , _num_chans(tx_stream->get_num_channels())
+    {
+        set_lead_time(lead_time);
+        set_device_time(device_time);
+        _thread = std::thread([this]() { _worker(); });
+        set_thread_name(&_thread, "tx_burst_sched");
+    }
+
+    ~tx_burst_scheduler_impl(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+        _thread.join();
+    }
+
+    void set_device_time(const time_spec_t& device_time)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _ref_device_time = device_time;
+            _ref_host_time   = clock_t::now();
+        }
+        _cond.notify_all();
+    }
+
+    double get_lead_time(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _lead_time;
+    }
+
+    void set_lead_time(const double lead_time)
+    {
+        if (lead_time <= 0.0) {
+            throw uhd::value_error("tx_burst_scheduler: Lead time must be positive");
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _lead_time = lead_time;
+        }
+        _cond.notify_all();
+    }
+
+    size_t schedule(const tx_streamer::buffs_type& buffs,
+        const size_t nsamps,
+        const time_spec_t& time_spec)
+    {
+        if (buffs.size() != _num_chans) {
+            throw uhd::value_error("tx_burst_scheduler: Expected one buffer per channel");
+        }
+        if (nsamps == 0) {
+            throw uhd::value_error("tx_burst_scheduler: Bursts must not be empty");
+        }
+
+        // Copy the samples before taking the lock, so the scheduler thread is
+        // not held up by large bursts
+        auto burst       = std::make_shared<burst_t>();
+        burst->time_spec = time_spec;
+        burst->nsamps    = nsamps;
+        burst->samps.resize(_num_chans);
+        for (size_t i = 0; i < _num_chans; i++) {
+            burst->samps[i].resize(nsamps * _bytes_per_samp);
+            std::memcpy(burst->samps[i].data(), buffs[i], nsamps * _bytes_per_samp);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            burst->id = _next_id++;
+            _queue.push(burst);
+        }
+        _cond.notify_all();
+        return burst->id;
+    }
+
+    size_t get_num_pending(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _queue.size() + (_sending ? 1 : 0);
+    }
+
+    bool wait_idle(const double timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        return _idle_cond.wait_for(lock,
+            std::chrono::duration<double>(timeout),
+            [this]() { return _queue.empty() && !_sending; });
+    }
+
+    void set_burst_callback(const burst_callback_t& callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _burst_callback = callback;
+    }
+
+    stats_t get_stats(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        stats_t stats = _stats;
+        if (stats.num_sent > 0) {
+            stats.avg_lead_time = _sum_lead_time / stats.num_sent;
+        }
+        return stats;
+    }
+
+    void reset_stats(void)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats         = stats_t();
+        _sum_lead_time = 0.0;
+    }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    //! A scheduled burst, with its own copy of the samples
+    struct burst_t
+    {
+        size_t id;
+        time_spec_t time_spec;
+        size_t nsamps;
+        std::vector<std::vector<uint8_t>> samps;
+    };
+    using burst_sptr = std::shared_ptr<burst_t>;
+
+    //! Orders the queue by start time, then by the order of scheduling
+    struct burst_later
+    {
+        bool operator()(const burst_sptr& lhs, const burst_sptr& rhs) const
+        {
+            if (lhs->time_spec == rhs->time_spec) {
+                return lhs->id > rhs->id;
+            }
+            return lhs->time_spec > rhs->time_spec;
+        }
+    };
+
+    //! Return the host time at which the device reaches device_time. Must be
+    //  called with _mutex held.
+    clock_t::time_point _to_host_time(const time_spec_t& device_time) const
+    {
+        const std::chrono::duration<double> offset(
+            (device_time - _ref_device_time).get_real_secs());
+        return _ref_host_time + std::chrono::duration_cast<clock_t::duration>(offset);
+    }
+
+    //! Return the estimated current device time
+    time_spec_t _get_device_time(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const std::chrono::duration<double> elapsed = clock_t::now() - _ref_host_time;
+        return _ref_device_time + time_spec_t(elapsed.count());
+    }
+
+    void _worker(void)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop) {
+            if (_queue.empty()) {
+                _cond.wait(lock);
+                continue;
+            }
+            // Wait until the next burst is due. New bursts, or changes of the
+            // time or the lead time, wake us up to check again.
+            const burst_sptr burst = _queue.top();
+            const auto due = _to_host_time(burst->time_spec - time_spec_t(_lead_time));
+            if (clock_t::now() < due) {
+                _cond.wait_until(lock, due);
+                continue;
+            }
+            _queue.pop();
+            _sending = true;
+            lock.unlock();
+
+            burst_info_t info;
+            try {
+                info = _send_burst(*burst);
+            } catch (const uhd::exception& ex) {
+                UHD_LOG_ERROR("TX BURST SCHED",
+                    "Failed to send burst " << burst->id << ": " << ex.what());
+                info.burst_id  = burst->id;
+                info.time_spec = burst->time_spec;
+                info.nsamps    = burst->nsamps;
+                info.dropped   = true;
+            }
+
+            lock.lock();
+            if (info.dropped) {
+                _stats.num_dropped++;
+            } else {
+                if (_stats.num_sent == 0) {
+                    _stats.min_lead_time = info.lead_time;
+                    _stats.max_lead_time = info.lead_time;
+                } else {
+                    _stats.min_lead_time = std::min(_stats.min_lead_time, info.lead_time);
+                    _stats.max_lead_time = std::max(_stats.max_lead_time, info.lead_time);
+                }
+                _stats.num_sent++;
+                _sum_lead_time += info.lead_time;
+            }
+            const burst_callback_t callback = _burst_callback;
+            if (callback) {
+                lock.unlock();
+                callback(info);
+                lock.lock();
+            }
+            _sending = false;
+            if (_queue.empty()) {
+                _idle_cond.notify_all();
+            }
+        }
+    }
+
+    //! Send a complete burst, or drop it if it is late
+    burst_info_t _send_burst(burst_t& burst)
+    {
+        burst_info_t info;
+        info.burst_id  = burst.id;
+        info.time_spec = burst.time_spec;
+        info.nsamps    = burst.nsamps;
+        info.lead_time = (burst.time_spec - _get_device_time()).get_real_secs();
+        if (info.lead_time < 0.0) {
+            UHD_LOG_DEBUG("TX BURST SCHED",
+                "Dropping burst " << burst.id << ", late by " << -info.lead_time
+                                  << " s");
+            info.dropped = true;
+            return info;
+        }
+
+        tx_metadata_t md;
+        md.start_of_burst = true;
+        md.has_time_spec  = true;
+        md.time_spec      = burst.time_spec;
+        md.end_of_burst   = true;
+        std::vector<const void*> buffs(_num_chans);
+        for (size_t i = 0; i < _num_chans; i++) {
+            buffs[i] = burst.samps[i].data();
+        }
+        while (info.nsamps_sent < burst.nsamps) {
+            const size_t nsamps_sent = _tx_stream->send(
+                buffs, burst.nsamps - info.nsamps_sent, md, SEND_TIMEOUT);
+            if (nsamps_sent == 0) {
+                if (_is_stopping()) {
+                    // End the burst, so the device doesn't wait for the rest
+                    // of it
+                    if (!md.start_of_burst) {
+                        _tx_stream->send(buffs, 0, md, SEND_TIMEOUT);
+                    }
+                    break;
+                }
+                continue;
+            }
+            if (md.start_of_burst) {
+                md.start_of_burst = false;
+                md.has_time_spec  = false;
+
+                // The lead time is measured once the streamer has taken the
+                // beginning of the burst, which includes waiting for credit
+                info.lead_time = (burst.time_spec - _get_device_time()).get_real_secs();
+            }
+            info.nsamps_sent += nsamps_sent;
+            for (size_t i = 0; i < _num_chans; i++) {
+                buffs[i] = burst.samps[i].data() + info.nsamps_sent * _bytes_per_samp;
+            }
+        }
+        return info;
+    }
+
+    bool _is_stopping(void) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stop;
+    }
+
+    tx_streamer::sptr _tx_stream;
+    const size_t _bytes_per_samp;
+    const size_t _num_chans;
+
+    //! Protects all following members
+    mutable std::mutex _mutex;
+    //! Wakes up the scheduler thread
+    std::condition_variable _cond;
+    //! Signals that all bursts were sent
+    std::condition_variable _idle_cond;
+
+    std::priority_queue<burst_sptr, std::vector<burst_sptr>, burst_later> _queue;
+    size_t _next_id = 0;
+    //! True while the scheduler thread sends a burst
+    bool _sending = false;
+    bool _stop    = false;
+
+    double _lead_time = 0.0;
+    //! The device time at _ref_host_time
+    time_spec_t _ref_device_time;
+    clock_t::time_point _ref_host_time;
+
+    burst_callback_t _burst_callback;
+    stats_t _stats;
+    double _sum_lead_time = 0.0;
+
+    std::thread _thread;
+};
+
+/***********************************************************************
+ * tx burst scheduler factory
+ **********************************************************************/
+tx_burst_scheduler::~tx_burst_scheduler(void)
+{
+    /* NOP */
+}
+
+tx_burst_scheduler::sptr tx_burst_scheduler::make(tx_streamer::sptr tx_stream,
+    const std::string& cpu_format,
+    const time_spec_t& device_time,
+    const double lead_time)
+{
+    return sptr(
+        new tx_burst_scheduler_impl(tx_stream, cpu_format, device_time, lead_time));
+}
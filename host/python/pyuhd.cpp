@@ -30,6 +30,8 @@ namespace py = pybind11;
 #include "usrp/subdev_spec_python.hpp"
 #include "usrp/multi_usrp_python.hpp"
 
+#include "utils/spectrum_monitor_python.hpp"
+
 // We need this hack because import_array() returns NULL
 // for newer Python versions.
 // This function is also necessary because it ensures access to the C API
@@ -78,5 +80,9 @@ PYBIND11_MODULE(libpyuhd, m)
     // Register RFNoC submodule
     auto rfnoc_module = m.def_submodule("rfnoc", "RFNoC Objects");
     export_rfnoc(rfnoc_module);
+
+    // Register utils submodule
+    auto utils_module = m.def_submodule("utils", "Utilities");
+    export_spectrum_monitor(utils_module);
 }
 
@@ -0,0 +1,13 @@
+#
+# Copyright 2020 Ettus Research, a National Instruments Brand
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+""" @package utils
+Python UHD module containing utilities, e.g., the spectrum monitor.
+"""
+
+from . import libpyuhd as lib
+
+SpectrumMonitor = lib.utils.spectrum_monitor
+WindowType = lib.utils.spectrum_monitor.window_type
@@ -0,0 +1,88 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/transport/alignment_tracker.hpp>
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <set>
+
+using namespace uhd::transport;
+
+BOOST_AUTO_TEST_CASE(test_alignment_tracker_basic)
+{
+    alignment_tracker tracker(3);
+    BOOST_CHECK_EQUAL(tracker.size(), 3);
+    BOOST_CHECK(!tracker.done());
+    BOOST_CHECK(!tracker.is_time_valid());
+    BOOST_CHECK_EQUAL(tracker.next_pending(), 0);
+
+    BOOST_CHECK_EQUAL(tracker.update(0, 100), alignment_tracker::NEW_TIME);
+    BOOST_CHECK_EQUAL(tracker.get_time(), 100);
+    BOOST_CHECK_EQUAL(tracker.next_pending(), 1);
+    BOOST_CHECK_EQUAL(tracker.update(1, 100), alignment_tracker::ALIGNED);
+    BOOST_CHECK_EQUAL(tracker.update(2, 50), alignment_tracker::OLDER);
+    BOOST_CHECK(tracker.is_pending(2));
+    // A newer time makes the other channels pending again
+    BOOST_CHECK_EQUAL(tracker.update(2, 200), alignment_tracker::NEW_TIME);
+    BOOST_CHECK_EQUAL(tracker.get_num_pending(), 2);
+    BOOST_CHECK_EQUAL(tracker.next_pending(), 0);
+    BOOST_CHECK(!tracker.is_pending(2));
+    BOOST_CHECK_EQUAL(tracker.update(0, 200), alignment_tracker::ALIGNED);
+    tracker.set_aligned(1);
+    BOOST_CHECK(tracker.done());
+
+    // After invalidating the time, any time is accepted as the new time
+    tracker.reset();
+    tracker.update(0, 200);
+    tracker.invalidate_time();
+    BOOST_CHECK_EQUAL(tracker.update(1, 10), alignment_tracker::NEW_TIME);
+    BOOST_CHECK_EQUAL(tracker.get_time(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_alignment_tracker_many_chans)
+{
+    // Compare against a plain set, with enough channels for multiple words
+    // and summary words
+    for (const size_t num_chans : {1, 63, 64, 65, 200, 4097}) {
+        alignment_tracker tracker(num_chans);
+        std::set<size_t> pending;
+        for (size_t chan = 0; chan < num_chans; chan++) {
+            pending.insert(chan);
+        }
+        uint64_t time = 0;
+        std::mt19937 rng(num_chans);
+        for (size_t i = 0; i < 20000; i++) {
+            if (pending.empty()) {
+                BOOST_REQUIRE(tracker.done());
+                tracker.reset();
+                time = 0;
+                for (size_t chan = 0; chan < num_chans; chan++) {
+                    pending.insert(chan);
+                }
+            }
+            BOOST_REQUIRE_EQUAL(tracker.get_num_pending(), pending.size());
+            const size_t chan = tracker.next_pending();
+            BOOST_REQUIRE_EQUAL(chan, *pending.begin());
+            // Mostly matching times, sometimes older or newer ones
+            const uint64_t pkt_time = (time == 0 ? 1000 : time) + int(rng() % 7) - 3;
+            const auto result       = tracker.update(chan, pkt_time);
+            if (time == 0 || pkt_time > time) {
+                BOOST_REQUIRE_EQUAL(result, alignment_tracker::NEW_TIME);
+                time = pkt_time;
+                for (size_t c = 0; c < num_chans; c++) {
+                    pending.insert(c);
+                }
+                pending.erase(chan);
+            } else if (pkt_time == time) {
+                BOOST_REQUIRE_EQUAL(result, alignment_tracker::ALIGNED);
+                pending.erase(chan);
+            } else {
+                BOOST_REQUIRE_EQUAL(result, alignment_tracker::OLDER);
+            }
+            BOOST_REQUIRE_EQUAL(tracker.is_pending(chan), pending.count(chan) > 0);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/property_tree.hpp>
+#include <uhd/usrp/fe_cal_table.hpp>
+#include <uhdlib/usrp/common/apply_corrections.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <complex>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+
+using namespace uhd::usrp;
+namespace fs = boost::filesystem;
+
+namespace {
+
+const fs::path cal_dir = fs::temp_directory_path() / fs::unique_path("%%%%%%%%");
+
+//! Write a .bin and a .csv file with different corrections for this serial
+fs::path write_cal_files(const std::string& serial)
+{
+    fs::create_directories(cal_dir / ".uhd" / "cal");
+    const fs::path base = cal_dir / ".uhd" / "cal" / ("rx_iq_cal_v0.2_" + serial);
+    fe_cal_table::make({{1e9, 1.0, 0.0}}, serial)->save(base.string() + ".bin");
+    std::ofstream csv(base.string() + ".csv");
+    csv << "serial, " << serial << "\n"
+        << "DATA STARTS HERE\n"
+        << "lo_frequency, correction_real, correction_imag, measured, delta\n"
+        << "1e9, 2.0, 0.0, 0, 0\n";
+    return base;
+}
+
+double get_applied_correction(const std::string& serial)
+{
+    auto tree = uhd::property_tree::make();
+    tree->create<std::complex<double>>("rx/iq_balance/value");
+    apply_rx_fe_corrections(tree, serial, "rx", 1e9);
+    return tree->access<std::complex<double>>("rx/iq_balance/value").get().real();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_apply_corrections_bin_vs_csv)
+{
+    setenv("UHD_CONFIG_DIR", cal_dir.string().c_str(), 1);
+    const std::time_t now = std::time(nullptr);
+
+    // The binary file is preferred if it is at least as new as the CSV file
+    fs::path base = write_cal_files("NEWBIN");
+    fs::last_write_time(base.string() + ".csv", now - 10);
+    fs::last_write_time(base.string() + ".bin", now - 10);
+    BOOST_CHECK_EQUAL(get_applied_correction("NEWBIN"), 1.0);
+
+    // A newer CSV file takes precedence
+    base = write_cal_files("NEWCSV");
+    fs::last_write_time(base.string() + ".bin", now - 10);
+    fs::last_write_time(base.string() + ".csv", now);
+    BOOST_CHECK_EQUAL(get_applied_correction("NEWCSV"), 2.0);
+
+    // Either file is used if it is the only one
+    base = write_cal_files("ONLYCSV");
+    fs::remove(base.string() + ".bin");
+    BOOST_CHECK_EQUAL(get_applied_correction("ONLYCSV"), 2.0);
+    base = write_cal_files("ONLYBIN");
+    fs::remove(base.string() + ".csv");
+    BOOST_CHECK_EQUAL(get_applied_correction("ONLYBIN"), 1.0);
+
+    fs::remove_all(cal_dir);
+}
@@ -0,0 +1,218 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/rfnoc/chdr_capture_analyzer.hpp>
+#include <uhdlib/rfnoc/chdr_packet.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+using namespace uhd::rfnoc::chdr;
+
+namespace {
+
+constexpr uint16_t CHDR_PORT  = 49153;
+constexpr sep_id_t HOST_EPID  = 1;
+constexpr sep_id_t RX_EPID    = 2;
+constexpr sep_id_t OTHER_EPID = 3;
+constexpr size_t SPP          = 100;
+constexpr size_t CAPACITY     = 100000;
+
+//! Writes a pcap file with one Ethernet/IPv4/UDP frame per CHDR packet
+class pcap_writer
+{
+public:
+    pcap_writer(const std::string& filename) : _file(filename, std::ios::binary)
+    {
+        const uint32_t global_hdr[] = {0xA1B2C3D4, 0x00040002, 0, 0, 65535, 1};
+        _file.write(reinterpret_cast<const char*>(global_hdr), 24);
+    }
+
+    void write(const double time, const void* chdr_pkt, const size_t len)
+    {
+        std::vector<uint8_t> frame(42 + len, 0);
+        frame[12] = 0x08; // IPv4
+        frame[14] = 0x45; // Version 4, 20 byte header
+        frame[23] = 17; // UDP
+        frame[34] = CHDR_PORT >> 8;
+        frame[35] = CHDR_PORT & 0xFF;
+        frame[38] = uint8_t((len + 8) >> 8);
+        frame[39] = uint8_t(len + 8);
+        std::memcpy(&frame[42], chdr_pkt, len);
+
+        const uint32_t record_hdr[] = {uint32_t(time),
+            uint32_t((time - uint32_t(time)) * 1e6 + 0.5),
+            uint32_t(frame.size()),
+            uint32_t(frame.size())};
+        _file.write(reinterpret_cast<const char*>(record_hdr), 16);
+        _file.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    }
+
+private:
+    std::ofstream _file;
+};
+
+//! Generates CHDR packets for the test capture
+class capture_generator
+{
+public:
+    capture_generator(const std::string& filename)
+        : _writer(filename), _pkt_factory(CHDR_W_64, ENDIANNESS_BIG)
+    {
+    }
+
+    void data(const double time,
+        const sep_id_t dst_epid,
+        const uint16_t seq_num,
+        const uint64_t timestamp,
+        const bool eob = false)
+    {
+        auto pkt = _pkt_factory.make_generic();
+        chdr_header header;
+        header.set_pkt_type(PKT_TYPE_DATA_WITH_TS);
+        header.set_dst_epid(dst_epid);
+        header.set_seq_num(seq_num);
+        header.set_eob(eob);
+        pkt->refresh(_buff.data(), header, timestamp);
+        pkt->update_payload_size(SPP * 4);
+        _write(time, *pkt);
+    }
+
+    void strs(const double time, const uint64_t xfer_count_bytes)
+    {
+        auto pkt = _pkt_factory.make_strs();
+        strs_payload payload;
+        payload.src_epid         = RX_EPID;
+        payload.capacity_bytes   = CAPACITY;
+        payload.xfer_count_bytes = xfer_count_bytes;
+        chdr_header header;
+        header.set_dst_epid(HOST_EPID);
+        pkt->refresh(_buff.data(), header, payload);
+        _write_raw(time, header.get_length());
+    }
+
+    void strc_init(const double time)
+    {
+        auto pkt = _pkt_factory.make_strc();
+        strc_payload payload;
+        payload.src_epid = HOST_EPID;
+        payload.op_code  = STRC_INIT;
+        chdr_header header;
+        header.set_dst_epid(RX_EPID);
+        pkt->refresh(_buff.data(), header, payload);
+        _write_raw(time, header.get_length());
+    }
+
+private:
+    void _write(const double time, const chdr_packet& pkt)
+    {
+        _write_raw(time, pkt.get_chdr_header().get_length());
+    }
+
+    void _write_raw(const double time, const size_t len)
+    {
+        _writer.write(time, _buff.data(), len);
+    }
+
+    pcap_writer _writer;
+    chdr_packet_factory _pkt_factory;
+    std::vector<uint64_t> _buff = std::vector<uint64_t>(1024, 0);
+};
+
+boost::filesystem::path make_capture()
+{
+    const auto filename =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    capture_generator gen(filename.string());
+    gen.strc_init(0.0);
+    // 10 packets, one packet lost (seq 5), and a timestamp jump at seq 8
+    uint64_t ts = 1000;
+    for (uint16_t seq = 0; seq < 10; seq++) {
+        if (seq == 8) {
+            ts += 7;
+        }
+        if (seq != 5) {
+            gen.data(0.001 * (seq + 1), RX_EPID, seq, ts);
+        }
+        ts += SPP;
+    }
+    // The endpoint has consumed 4 packets
+    gen.strs(0.0105, 4 * (SPP * 4 + 16));
+    // Another stream, with sequence number wraparound
+    gen.data(0.02, OTHER_EPID, 0xFFFF, 0, true);
+    gen.data(0.021, OTHER_EPID, 0, 500);
+    return filename;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_chdr_capture_analyzer)
+{
+    const auto filename = make_capture();
+    pcap_file capture(filename.string());
+    BOOST_CHECK_EQUAL(capture.get_num_records(), 13);
+    const auto records = capture.get_udp_records(CHDR_PORT);
+    BOOST_REQUIRE_EQUAL(records.size(), 13);
+    BOOST_CHECK_EQUAL(capture.get_udp_records(1234).size(), 0);
+    BOOST_CHECK_CLOSE(records[1].time, 0.001, 1e-3);
+
+    for (const size_t num_threads : {1, 2, 3}) {
+        capture_analyzer_args_t args;
+        args.num_threads = num_threads;
+        args.tick_rate   = 1e5;
+        const auto stats = analyze_capture(records, args);
+        BOOST_REQUIRE_EQUAL(stats.size(), 2);
+
+        const auto& rx = stats[0];
+        BOOST_CHECK_EQUAL(rx.epid, RX_EPID);
+        BOOST_CHECK_EQUAL(rx.num_data_pkts, 9);
+        BOOST_CHECK_EQUAL(rx.num_strc_pkts, 1);
+        BOOST_CHECK_EQUAL(rx.num_strs_pkts, 1);
+        BOOST_CHECK_EQUAL(rx.num_truncated_pkts, 0);
+        BOOST_CHECK_EQUAL(rx.payload_bytes, 9 * SPP * 4);
+        BOOST_CHECK_EQUAL(rx.data_bytes, 9 * (SPP * 4 + 16));
+        BOOST_CHECK_EQUAL(rx.num_seq_gaps, 1);
+        BOOST_CHECK_EQUAL(rx.num_lost_pkts, 1);
+        BOOST_CHECK_EQUAL(rx.num_seq_reorders, 0);
+        // The lost packet, and the jump
+        BOOST_CHECK_EQUAL(rx.num_ts_discontinuities, 2);
+        BOOST_CHECK_EQUAL(rx.interarrival.count, 8);
+        BOOST_CHECK_CLOSE(rx.interarrival.max, 0.002, 1e-3);
+        BOOST_CHECK_EQUAL(rx.ts_offset.count, 9);
+        // The timestamps advance by 1 ms per packet, like the capture time
+        BOOST_CHECK_LT(rx.ts_offset.max - rx.ts_offset.min, 1e-4);
+
+        BOOST_REQUIRE_EQUAL(rx.fc_timeline.size(), 1);
+        const auto& fc = rx.fc_timeline[0];
+        BOOST_CHECK_EQUAL(fc.capacity_bytes, CAPACITY);
+        BOOST_CHECK_EQUAL(fc.sent_bytes, rx.data_bytes);
+        BOOST_CHECK_EQUAL(fc.credits_bytes, int64_t(CAPACITY - 5 * (SPP * 4 + 16)));
+        BOOST_CHECK_EQUAL(rx.num_strs_errors, 0);
+
+        uint64_t total_bytes = 0;
+        for (const uint64_t bytes : rx.throughput_bytes) {
+            total_bytes += bytes;
+        }
+        BOOST_CHECK_EQUAL(total_bytes, rx.data_bytes);
+        BOOST_CHECK_GE(rx.throughput_bytes.size(), 9);
+
+        const auto& other = stats[1];
+        BOOST_CHECK_EQUAL(other.epid, OTHER_EPID);
+        BOOST_CHECK_EQUAL(other.num_data_pkts, 2);
+        BOOST_CHECK_EQUAL(other.num_seq_gaps, 0);
+        BOOST_CHECK_EQUAL(other.num_seq_reorders, 0);
+        // The first packet ended a burst
+        BOOST_CHECK_EQUAL(other.num_ts_discontinuities, 0);
+    }
+
+    boost::filesystem::remove(filename);
+    BOOST_CHECK_THROW(pcap_file(filename.string()), uhd::runtime_error);
+}
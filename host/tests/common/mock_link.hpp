@@ -10,6 +10,7 @@
 #include <uhd/exception.hpp>
 #include <uhdlib/transport/link_base.hpp>
 #include <boost/shared_array.hpp>
+#include <cstring>
 #include <list>
 #include <utility>
 #include <vector>
@@ -133,6 +134,41 @@ public:
         return NULL_ADAPTER_ID;
     }
 
+    /*!
+     * Configures the link to accept frame buffers with a gather payload.
+     * The payload is copied into the stored packet after the frame contents.
+     */
+    void set_supports_send_gather(const bool supports_send_gather)
+    {
+        _supports_send_gather = supports_send_gather;
+    }
+
+    bool supports_send_gather() const
+    {
+        return _supports_send_gather;
+    }
+
+    /*!
+     * Return the number of packets that were sent with a gather payload.
+     */
+    size_t get_num_gather_packets() const
+    {
+        return _num_gather_packets;
+    }
+
+    void flush_send_buffs()
+    {
+        _num_flushes++;
+    }
+
+    /*!
+     * Return the number of calls to flush_send_buffs().
+     */
+    size_t get_num_flushes() const
+    {
+        return _num_flushes;
+    }
+
 private:
     // Friend declaration to allow base class to call private methods
     friend base_t;
@@ -159,8 +195,19 @@ private:
     {
         if (!_reuse_send_memory) {
             auto* buff_ptr = static_cast<mock_frame_buff*>(&buff);
+            size_t len     = buff_ptr->packet_size();
+            if (buff_ptr->gather_payload()) {
+                UHD_ASSERT_THROW(_supports_send_gather);
+                UHD_ASSERT_THROW(
+                    len + buff_ptr->gather_payload_size() <= get_send_frame_size());
+                std::memcpy(buff_ptr->get_mem().get() + len,
+                    buff_ptr->gather_payload(),
+                    buff_ptr->gather_payload_size());
+                len += buff_ptr->gather_payload_size();
+                _num_gather_packets++;
+            }
             _tx_mems.push_back(buff_ptr->get_mem());
-            _tx_lens.push_back(buff_ptr->packet_size());
+            _tx_lens.push_back(len);
             buff_ptr->set_mem(boost::shared_array<uint8_t>());
         }
     }
@@ -171,6 +218,10 @@ private:
     bool _reuse_send_memory;
 
     bool _simulate_io_timeout = false;
+
+    bool _supports_send_gather = false;
+    size_t _num_gather_packets = 0;
+    size_t _num_flushes        = 0;
 };
 
 /*!
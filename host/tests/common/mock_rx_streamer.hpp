@@ -0,0 +1,116 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#ifndef INCLUDED_STREAMER_HPP
+#define INCLUDED_STREAMER_HPP
+
+#include <uhd/stream.hpp>
+#include <uhd/types/metadata.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace uhd {
+
+//! The sample rate of the timestamps of mock_rx_streamer
+constexpr double SAMP_RATE = 1e6;
+//! The maximum number of samples per recv() call of mock_rx_streamer
+constexpr size_t SPP = 100;
+//! The number of channels of mock_rx_streamer
+constexpr size_t NUM_CHANS = 2;
+//! Added to the samples of channel 1, to tell the channels apart
+constexpr uint32_t CHAN1_OFFSET = 0x80000000;
+
+/*!
+ * Mock rx streamer which delivers the samples that the test allows. Samples
+ * are uint32_t (the size of sc16), and their value is their index, so tests
+ * can check which samples got through. The timestamps follow the index, too.
+ */
+class mock_rx_streamer : public rx_streamer
+{
+public:
+    size_t get_num_channels(void) const
+    {
+        return NUM_CHANS;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return SPP;
+    }
+
+    size_t recv(const buffs_type& buffs,
+        const size_t nsamps_per_buff,
+        rx_metadata_t& metadata,
+        const double timeout,
+        const bool)
+    {
+        metadata = rx_metadata_t();
+        const auto exit_time =
+            std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+        while (_allowance.load() <= _next) {
+            if (std::chrono::steady_clock::now() > exit_time) {
+                metadata.error_code = rx_metadata_t::ERROR_CODE_TIMEOUT;
+                return 0;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        if (_overflow.exchange(false)) {
+            metadata.error_code = rx_metadata_t::ERROR_CODE_OVERFLOW;
+            return 0;
+        }
+
+        const size_t first = _next.load();
+        const size_t nsamps =
+            std::min<size_t>(nsamps_per_buff, _allowance.load() - first);
+        for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+            uint32_t* buff = static_cast<uint32_t*>(buffs[chan]);
+            for (size_t i = 0; i < nsamps; i++) {
+                buff[i] = uint32_t(first + i) + (chan ? CHAN1_OFFSET : 0);
+            }
+        }
+        metadata.has_time_spec = true;
+        metadata.time_spec     = time_spec_t::from_ticks(first, SAMP_RATE);
+        _next += nsamps;
+        _num_delivered += nsamps;
+        return nsamps;
+    }
+
+    void issue_stream_cmd(const stream_cmd_t&) {}
+
+    //! Allow the streamer to deliver nsamps more samples
+    void feed(const size_t nsamps)
+    {
+        _allowance += nsamps;
+    }
+
+    //! Skip nsamps samples. With overflow set, an overflow is reported before
+    //  the next samples. Only call this when all allowed samples were
+    //  delivered.
+    void skip(const size_t nsamps, const bool overflow = false)
+    {
+        _overflow = overflow;
+        _next += nsamps;
+        _allowance += nsamps;
+    }
+
+    //! Return the number of samples delivered so far
+    size_t get_num_delivered(void) const
+    {
+        return _num_delivered.load();
+    }
+
+private:
+    std::atomic<size_t> _allowance{0};
+    std::atomic<size_t> _next{0};
+    std::atomic<size_t> _num_delivered{0};
+    std::atomic<bool> _overflow{false};
+};
+
+} // namespace uhd
+
+#endif /* INCLUDED_STREAMER_HPP */
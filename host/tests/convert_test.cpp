@@ -6,10 +6,13 @@
 //
 
 #include <uhd/convert.hpp>
+#include <uhdlib/convert/inline_converter.hpp>
 #include <stdint.h>
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <complex>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -722,3 +725,78 @@ BOOST_AUTO_TEST_CASE(test_convert_types_fc32_and_fc32_chdr)
         test_convert_types_fc32(nsamps, id);
     }
 }
+
+/***********************************************************************
+ * Test that the streamers' inline converter matches the registered one
+ **********************************************************************/
+template <typename in_type, typename out_type>
+static void test_inline_converter(const convert::id_type& id,
+    const double scalar,
+    const std::function<in_type(void)>& make_sample)
+{
+    convert::converter::sptr c0 = convert::get_converter(id)();
+    c0->set_scalar(scalar);
+    convert::inline_converter c1(id);
+    c1.set_scalar(scalar);
+
+    // try various lengths and alignments to test edge cases
+    for (size_t nsamps = 0; nsamps < 20; nsamps++) {
+        for (size_t offset = 0; offset < 2; offset++) {
+            std::vector<in_type> input(nsamps + offset);
+            std::generate(input.begin(), input.end(), make_sample);
+            std::vector<out_type> output0(nsamps + offset), output1(nsamps + offset);
+
+            std::vector<const void*> input0(1, input.data() + offset);
+            std::vector<void*> output0_buffs(1, output0.data() + offset);
+            c0->conv(input0, output0_buffs, nsamps);
+            c1.conv(input.data() + offset, output1.data() + offset, nsamps);
+            for (size_t i = offset; i < nsamps + offset; i++) {
+                BOOST_CHECK_EQUAL(output0[i].real(), output1[i].real());
+                BOOST_CHECK_EQUAL(output0[i].imag(), output1[i].imag());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_inline_converter_chdr)
+{
+    auto make_sc16 = []() {
+        return sc16_t(
+            short(std::rand() - RAND_MAX / 2), short(std::rand() - RAND_MAX / 2));
+    };
+    auto make_fc32 = []() {
+        return fc32_t(float(std::rand()) / RAND_MAX * 2 - 1,
+            float(std::rand()) / RAND_MAX * 2 - 1);
+    };
+
+    convert::id_type id;
+    id.num_inputs  = 1;
+    id.num_outputs = 1;
+
+    id.input_format  = "sc16_chdr";
+    id.output_format = "fc32";
+    test_inline_converter<sc16_t, fc32_t>(id, 1 / 32767., make_sc16);
+    test_inline_converter<sc16_t, fc32_t>(id, 0.5, make_sc16);
+
+    id.input_format  = "fc32";
+    id.output_format = "sc16_chdr";
+    test_inline_converter<fc32_t, sc16_t>(id, 32767., make_fc32);
+    test_inline_converter<fc32_t, sc16_t>(id, 1000., make_fc32);
+
+    id.input_format  = "sc16_chdr";
+    id.output_format = "sc16";
+    test_inline_converter<sc16_t, sc16_t>(id, 1 / 32767., make_sc16);
+
+    id.input_format  = "sc16";
+    id.output_format = "sc16_chdr";
+    test_inline_converter<sc16_t, sc16_t>(id, 32767., make_sc16);
+
+    id.input_format  = "fc32";
+    id.output_format = "fc32_chdr";
+    test_inline_converter<fc32_t, fc32_t>(id, 32767., make_fc32);
+
+    // No inline conversion, uses the registered converter
+    id.input_format  = "sc16_chdr";
+    id.output_format = "fc64";
+    test_inline_converter<sc16_t, fc64_t>(id, 1 / 32767., make_sc16);
+}
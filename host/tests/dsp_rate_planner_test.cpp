@@ -0,0 +1,161 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/rfnoc/dsp_rate_planner.hpp>
+#include <uhd/types/ranges.hpp>
+#include <boost/math/special_functions/round.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <set>
+
+using namespace uhd::rfnoc;
+
+namespace {
+
+//! Reference list of valid rate changes, as built by the DDC/DUC blocks
+uhd::meta_range_t get_ref_rate_changes(size_t num_halfbands, size_t cic_max)
+{
+    std::set<size_t> rate_changes{1};
+    for (size_t hb = 0; hb < num_halfbands; hb++) {
+        for (size_t cic = 1; cic <= cic_max; cic++) {
+            rate_changes.insert((1 << hb) * cic);
+        }
+    }
+    uhd::meta_range_t result;
+    for (size_t rate_change : rate_changes) {
+        result.push_back(uhd::range_t(double(rate_change)));
+    }
+    return result;
+}
+
+//! Reference scaling calculation, as done by the DDC/DUC blocks
+int32_t get_ref_scale_word(uint32_t cic, bool decim, double& residual)
+{
+    const double cic_gain   = std::pow(double(cic), decim ? 4 : 3);
+    const double cic_shift  = std::ceil(std::log(cic_gain) / std::log(2.0));
+    const double total_gain = 2.0 * cic_gain / std::pow(2, cic_shift);
+    const int32_t factor    = boost::math::iround((1 << 15) / total_gain);
+    residual                = total_gain * double(factor) / (1 << 15);
+    return factor;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_rate_table)
+{
+    for (const auto type :
+        {dsp_rate_planner::DECIMATION, dsp_rate_planner::INTERPOLATION}) {
+        for (const size_t num_hb : {0, 1, 2, 3}) {
+            for (const size_t cic_max : {1, 5, 128, 255}) {
+                dsp_rate_planner planner(type, num_hb, cic_max);
+                BOOST_CHECK_EQUAL(planner.get_type(), type);
+                const auto ref = get_ref_rate_changes(num_hb, cic_max);
+                const auto& valid = planner.get_valid_rate_changes();
+                BOOST_REQUIRE_EQUAL(valid.size(), ref.size());
+                for (size_t i = 0; i < ref.size(); i++) {
+                    BOOST_CHECK_EQUAL(valid[i].start(), ref[i].start());
+                    const int rate_change = int(ref[i].start());
+                    const auto& setting   = planner.get_rate_setting(rate_change);
+                    BOOST_CHECK_EQUAL(setting.rate_change, rate_change);
+                    BOOST_CHECK_EQUAL(
+                        int(setting.cic_rate_change << setting.num_halfbands),
+                        rate_change);
+                    BOOST_CHECK_LE(setting.num_halfbands, num_hb);
+                    BOOST_CHECK_LE(setting.cic_rate_change, cic_max);
+                    BOOST_CHECK_EQUAL(setting.rate_word,
+                        (setting.num_halfbands << 8) | setting.cic_rate_change);
+                    double ref_residual;
+                    BOOST_CHECK_EQUAL(setting.scale_word,
+                        uint32_t(get_ref_scale_word(setting.cic_rate_change,
+                            type == dsp_rate_planner::DECIMATION,
+                            ref_residual)));
+                    BOOST_CHECK_EQUAL(setting.residual_scaling, ref_residual);
+                }
+            }
+        }
+    }
+
+    dsp_rate_planner planner(dsp_rate_planner::DECIMATION, 2, 128);
+    // 20 = 4 * 5: Two halfbands, CIC decimates by 5
+    BOOST_CHECK_EQUAL(planner.get_rate_setting(20).rate_word, 2 << 8 | 5);
+    BOOST_CHECK_THROW(planner.get_rate_setting(0), uhd::value_error);
+    BOOST_CHECK_THROW(planner.get_rate_setting(257), uhd::value_error);
+    BOOST_CHECK_THROW(planner.get_rate_setting(1000), uhd::value_error);
+    BOOST_CHECK_THROW(
+        dsp_rate_planner(dsp_rate_planner::DECIMATION, 2, 0), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_coerce)
+{
+    for (const size_t num_hb : {0, 1, 3}) {
+        for (const size_t cic_max : {1, 7, 255}) {
+            dsp_rate_planner planner(dsp_rate_planner::DECIMATION, num_hb, cic_max);
+            const auto ref = get_ref_rate_changes(num_hb, cic_max);
+            for (double requested = 0.0; requested < ref.stop() + 10; requested += 0.25) {
+                BOOST_CHECK_EQUAL(planner.coerce_rate_change(requested),
+                    int(ref.clip(requested, true)));
+            }
+            BOOST_CHECK_EQUAL(planner.coerce_rate_change(1e12), int(ref.stop()));
+        }
+    }
+    dsp_rate_planner planner(dsp_rate_planner::DECIMATION, 2, 128);
+    BOOST_CHECK_THROW(planner.coerce_rate_change(-1.0), uhd::value_error);
+    BOOST_CHECK_THROW(planner.coerce_rate_change(std::nan("")), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_plan)
+{
+    constexpr double DSP_RATE = 200e6;
+    dsp_rate_planner planner(dsp_rate_planner::DECIMATION, 3, 255);
+
+    auto plan = planner.plan(DSP_RATE, 1e6, 10e6);
+    BOOST_CHECK_EQUAL(plan.setting.rate_change, 200);
+    BOOST_CHECK_EQUAL(plan.setting.rate_word, 3 << 8 | 25);
+    BOOST_CHECK_EQUAL(plan.rate, 1e6);
+    // 10 MHz is 1/20 of the DSP rate
+    BOOST_CHECK_EQUAL(plan.freq_word, uint32_t(std::round(std::pow(2.0, 32) / 20)));
+    BOOST_CHECK_CLOSE(plan.freq, 10e6, 1e-6);
+
+    // Negative frequencies use two's complement
+    plan = planner.plan(DSP_RATE, 1e6, -10e6);
+    BOOST_CHECK_EQUAL(int32_t(plan.freq_word), -int32_t(std::pow(2.0, 32) / 20 + 0.5));
+    // Frequencies outside of the Nyquist zone wrap around
+    plan = planner.plan(DSP_RATE, 1e6, DSP_RATE + 10e6);
+    BOOST_CHECK_CLOSE(plan.freq, 10e6, 1e-6);
+
+    // The rate is coerced to the nearest valid decimation
+    plan = planner.plan(DSP_RATE, 1.01e6, 0);
+    BOOST_CHECK_EQUAL(plan.setting.rate_change, 198);
+    BOOST_CHECK_EQUAL(plan.rate, DSP_RATE / 198);
+    BOOST_CHECK_EQUAL(plan.freq_word, 0);
+
+    BOOST_CHECK_EQUAL(planner.plan_rate_change(DSP_RATE, 4, 0).rate, 50e6);
+    BOOST_CHECK_THROW(planner.plan(0, 1e6, 0), uhd::value_error);
+    BOOST_CHECK_THROW(planner.plan(DSP_RATE, -1e6, 0), uhd::value_error);
+    BOOST_CHECK_THROW(planner.plan_rate_change(DSP_RATE, 1021, 0), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_plan_sweep)
+{
+    constexpr double DSP_RATE  = 245.76e6;
+    constexpr size_t NUM_PLANS = 1000000;
+    dsp_rate_planner planner(dsp_rate_planner::INTERPOLATION, 3, 255);
+
+    uint32_t checksum = 0;
+    const auto start  = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_PLANS; i++) {
+        const auto plan = planner.plan(
+            DSP_RATE, 100e3 + 10.0 * i, -DSP_RATE / 2 + DSP_RATE * i / NUM_PLANS);
+        checksum ^= plan.freq_word ^ plan.setting.scale_word;
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Planned " << NUM_PLANS << " settings in " << elapsed.count()
+              << " s (checksum " << checksum << ")" << std::endl;
+}
@@ -0,0 +1,126 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/usrp/fe_cal_table.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <sstream>
+
+using namespace uhd::usrp;
+
+namespace {
+
+//! Reference implementation: linear search and interpolation
+std::complex<double> ref_correction(
+    const std::vector<fe_cal_table::point_t>& points, const double lo_freq)
+{
+    if (lo_freq <= points.front().lo_freq) {
+        return {points.front().corr_real, points.front().corr_imag};
+    }
+    for (size_t i = 1; i < points.size(); i++) {
+        if (points[i].lo_freq >= lo_freq) {
+            const auto& p0 = points[i - 1];
+            const auto& p1 = points[i];
+            const double a = (lo_freq - p0.lo_freq) / (p1.lo_freq - p0.lo_freq);
+            return {p0.corr_real + a * (p1.corr_real - p0.corr_real),
+                p0.corr_imag + a * (p1.corr_imag - p0.corr_imag)};
+        }
+    }
+    return {points.back().corr_real, points.back().corr_imag};
+}
+
+std::vector<fe_cal_table::point_t> make_points()
+{
+    // Uneven spacing, so the buckets are narrower than most segments
+    std::vector<fe_cal_table::point_t> points;
+    double freq = 50e6;
+    for (size_t i = 0; i < 100; i++) {
+        points.push_back({freq, 1.0 + 0.01 * i, -0.5 + 0.003 * (i % 7)});
+        freq += (i % 5 == 0) ? 1e6 : 7.3e6;
+    }
+    return points;
+}
+
+void check_table(const fe_cal_table& table)
+{
+    const auto points = make_points();
+    for (double freq = 0; freq < 1e9; freq += 123457.0) {
+        const auto corr     = table.get_correction(freq);
+        const auto expected = ref_correction(points, freq);
+        BOOST_REQUIRE_CLOSE(corr.real(), expected.real(), 1e-9);
+        BOOST_REQUIRE_CLOSE(corr.imag(), expected.imag(), 1e-6);
+    }
+    for (const auto& point : points) {
+        BOOST_CHECK_EQUAL(table.get_correction(point.lo_freq).real(), point.corr_real);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_interp)
+{
+    auto points = make_points();
+    std::reverse(points.begin(), points.end());
+    auto table = fe_cal_table::make(points, "ABC123", 1234);
+    BOOST_CHECK_EQUAL(table->get_points().size(), points.size());
+    BOOST_CHECK_EQUAL(table->get_points().front().lo_freq, 50e6);
+    check_table(*table);
+
+    auto single = fe_cal_table::make({{1e9, 0.5, 0.25}});
+    BOOST_CHECK_EQUAL(single->get_correction(0), std::complex<double>(0.5, 0.25));
+    BOOST_CHECK_EQUAL(single->get_correction(2e9), std::complex<double>(0.5, 0.25));
+
+    BOOST_CHECK_THROW(fe_cal_table::make({}), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_file)
+{
+    const auto path = boost::filesystem::temp_directory_path()
+                      / boost::filesystem::unique_path("%%%%%%%%.bin");
+    fe_cal_table::make(make_points(), "ABC123", 1234)->save(path.string());
+
+    auto table = fe_cal_table::load(path.string());
+    BOOST_CHECK_EQUAL(table->get_serial(), "ABC123");
+    BOOST_CHECK_EQUAL(table->get_timestamp(), 1234);
+    check_table(*table);
+
+    // Saving over a loaded file leaves the loaded table intact
+    fe_cal_table::make(make_points(), "DEF456", 5678)->save(path.string());
+    check_table(*table);
+    BOOST_CHECK_EQUAL(fe_cal_table::load(path.string())->get_serial(), "DEF456");
+    table.reset();
+
+    // Truncated files must be rejected
+    boost::filesystem::resize_file(path, 100);
+    BOOST_CHECK_THROW(fe_cal_table::load(path.string()), uhd::runtime_error);
+    boost::filesystem::remove(path);
+    BOOST_CHECK_THROW(fe_cal_table::load(path.string()), uhd::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fe_cal_table_csv)
+{
+    std::stringstream csv;
+    csv << "name, TX Frontend Calibration\n"
+        << "serial, ABC123\n"
+        << "timestamp, 1234\n"
+        << "version, 0, 1\n"
+        << "DATA STARTS HERE\n"
+        << "lo_frequency, correction_real, correction_imag, measured, delta\n";
+    csv.precision(17);
+    for (const auto& point : make_points()) {
+        csv << point.lo_freq << ", " << point.corr_real << ", " << point.corr_imag
+            << ", 0, 0\n";
+    }
+    auto table = fe_cal_table::make_from_csv(csv);
+    BOOST_CHECK_EQUAL(table->get_serial(), "ABC123");
+    BOOST_CHECK_EQUAL(table->get_timestamp(), 1234);
+    check_table(*table);
+
+    std::stringstream empty_csv("serial, ABC123\nDATA STARTS HERE\nlo_frequency\n");
+    BOOST_CHECK_THROW(fe_cal_table::make_from_csv(empty_csv), uhd::value_error);
+}
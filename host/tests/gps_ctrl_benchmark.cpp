@@ -0,0 +1,242 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Benchmark for the handling of GPSDO output: parsing a recording of the
+// output with nmea_parser and with the regex-based parsing gps_ctrl used
+// before, and querying GPS sensors through gps_ctrl.
+
+#include <uhd/types/serial.hpp>
+#include <uhd/usrp/gps_ctrl.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhdlib/usrp/common/nmea_parser.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::usrp;
+
+namespace {
+
+//! Output of a Jackson Labs GPSDO for one second, used if no recording is given
+const std::vector<std::string> DEFAULT_RECORDING = {
+    "$GPGGA,161229.000,4010.0345,N,10511.1220,W,1,09,0.9,1565.4,M,-21.3,M,,*5D\r\n",
+    "$GPRMC,161229.000,A,4010.0345,N,10511.1220,W,0.01,241.58,170919,,*10\r\n",
+    "$GPGSV,3,1,11,05,61,290,43,12,45,063,41,13,09,186,33,15,17,150,38,*52\r\n",
+    "19-09-17 384 0.12 -1.22E-11 12 13 0 0x0 -3.15 0 6 1 [GPS]\r\n",
+};
+
+/*!
+ * Parsing as gps_ctrl did before nmea_parser: regex matching, checksums
+ * through a stringstream, and a map of the latest sentences
+ */
+class legacy_parser
+{
+public:
+    static bool is_nmea_checksum_ok(std::string nmea)
+    {
+        if (nmea.length() < 5 || nmea[0] != '$' || nmea[nmea.length() - 3] != '*')
+            return false;
+
+        std::stringstream ss;
+        uint32_t string_crc;
+        uint32_t calculated_crc = 0;
+
+        ss << std::hex << nmea.substr(nmea.length() - 2, 2);
+        ss >> string_crc;
+
+        for (size_t i = 1; i < nmea.length() - 3; i++)
+            calculated_crc ^= nmea[i];
+
+        return (string_crc == calculated_crc);
+    }
+
+    void push(std::string msg)
+    {
+        static const std::regex servo_regex("^\\d\\d-\\d\\d-\\d\\d.*$");
+        static const std::regex gp_msg_regex("^\\$GP.*,\\*[0-9A-F]{2}$");
+
+        boost::algorithm::erase_all(msg, "\r");
+        boost::algorithm::erase_all(msg, "\n");
+        if (msg.length() < 6) {
+            return;
+        }
+        std::map<std::string, std::string> msgs;
+        if (std::regex_search(msg, servo_regex, std::regex_constants::match_continuous)) {
+            msgs["SERVO"] = msg;
+        } else if (std::regex_match(msg, gp_msg_regex) and is_nmea_checksum_ok(msg)) {
+            msgs[msg.substr(1, 5)] = msg;
+        }
+        for (const std::string key : {"GPGGA", "GPRMC", "SERVO"}) {
+            if (not msgs[key].empty()) {
+                sentences[key] = msgs[key];
+            }
+        }
+    }
+
+    std::map<std::string, std::string> sentences;
+};
+
+/*!
+ * Mock UART that replays the recording. Every call to next_second() makes
+ * the output of one more second available. Like a generic NMEA GPS, it
+ * ignores commands, but the first command starts the output.
+ */
+class mock_gpsdo_uart : public uhd::uart_iface
+{
+public:
+    mock_gpsdo_uart(const std::vector<std::string>& lines) : _recording(lines) {}
+
+    void write_uart(const std::string&)
+    {
+        if (not _started) {
+            _started = true;
+            next_second();
+        }
+    }
+
+    std::string read_uart(double timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const auto has_lines = [this]() { return not _lines.empty(); };
+        if (not has_lines()
+            and (timeout <= 0.0
+                    or not _cond.wait_for(
+                           lock, std::chrono::duration<double>(timeout), has_lines))) {
+            return "";
+        }
+        std::string line = _lines.front();
+        _lines.pop_front();
+        return line;
+    }
+
+    void next_second()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _lines.insert(_lines.end(), _recording.begin(), _recording.end());
+        _cond.notify_all();
+    }
+
+private:
+    const std::vector<std::string> _recording;
+    std::deque<std::string> _lines;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _started = false;
+};
+
+template <typename function_t>
+double time_it(const size_t iterations, function_t&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        function();
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::string file;
+    size_t iterations;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("file", po::value<std::string>(&file), "file with recorded GPSDO output (default: built-in sample)")
+        ("iterations", po::value<size_t>(&iterations)->default_value(10000), "number of times to process the recording")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "UHD GPS control benchmark " << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<std::string> lines = DEFAULT_RECORDING;
+    if (not file.empty()) {
+        std::ifstream ifs(file);
+        if (not ifs) {
+            std::cerr << "Could not open " << file << std::endl;
+            return EXIT_FAILURE;
+        }
+        lines.clear();
+        for (std::string line; std::getline(ifs, line);) {
+            lines.push_back(line + "\n");
+        }
+    }
+    std::string data;
+    for (const auto& line : lines) {
+        data += line;
+    }
+    std::cout << "Recording: " << lines.size() << " lines, " << data.size()
+              << " characters" << std::endl;
+
+    legacy_parser legacy;
+    const double legacy_time = time_it(iterations, [&]() {
+        for (const auto& line : lines) {
+            legacy.push(line);
+        }
+    });
+    nmea_parser parser;
+    const double parser_time = time_it(iterations, [&]() {
+        parser.push(data.data(), data.size(), nmea_parser::clock_t::now());
+    });
+    std::cout << "Parsing the recording:" << std::endl
+              << "    regex (legacy): " << legacy_time * 1e6 << " us" << std::endl
+              << "    nmea_parser:    " << parser_time * 1e6 << " us" << std::endl;
+    if (parser.get_sentence(nmea_parser::GPGGA) != legacy.sentences["GPGGA"]
+        or parser.get_sentence(nmea_parser::GPRMC) != legacy.sentences["GPRMC"]
+        or parser.get_sentence(nmea_parser::SERVO) != legacy.sentences["SERVO"]) {
+        std::cerr << "ERROR: The parsers disagree on the latest sentences" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Without an answer to *IDN?, gps_ctrl takes the GPS for a generic NMEA
+    // device once it sees the first sentences
+    auto uart = std::make_shared<mock_gpsdo_uart>(lines);
+    auto gps = uhd::gps_ctrl::make(uart);
+    if (not gps->gps_detected()) {
+        std::cerr << "ERROR: No GPS detected in the recording" << std::endl;
+        return EXIT_FAILURE;
+    }
+    // The sentences must not get older than a second, so the GPSDO outputs
+    // the next second every so often
+    size_t num_queries = 0;
+    uart->next_second();
+    const double cached_time = time_it(iterations, [&]() {
+        if (++num_queries % 1000 == 0) {
+            uart->next_second();
+        }
+        gps->get_sensor("gps_gpgga");
+    });
+    const double fresh_time = time_it(iterations, [&]() {
+        uart->next_second();
+        gps->get_sensor("gps_gpgga");
+    });
+    std::cout << "Querying gps_gpgga:" << std::endl
+              << "    cached sentence:        " << cached_time * 1e6 << " us" << std::endl
+              << "    after new GPSDO output: " << fresh_time * 1e6 << " us" << std::endl;
+
+    return EXIT_SUCCESS;
+}
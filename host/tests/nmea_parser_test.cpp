@@ -0,0 +1,105 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/usrp/common/nmea_parser.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+
+using namespace uhd::usrp;
+
+namespace {
+
+const std::string GPGGA =
+    "$GPGGA,161229.000,4010.0345,N,10511.1220,W,1,09,0.9,1565.4,M,-21.3,M,,*5D";
+const std::string GPRMC =
+    "$GPRMC,161229.000,A,4010.0345,N,10511.1220,W,0.01,241.58,170919,,*10";
+const std::string GPGSV =
+    "$GPGSV,3,1,11,05,61,290,43,12,45,063,41,13,09,186,33,15,17,150,38,*52";
+const std::string SERVO =
+    "19-09-17 384 0.12 -1.22E-11 12 13 0 0x0 -3.15 0 6 1 [GPS]";
+
+bool is_nmea_sentence_ok(const std::string& line)
+{
+    return nmea_parser::is_nmea_sentence_ok(line.data(), line.size());
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_nmea_checksum)
+{
+    BOOST_CHECK(is_nmea_sentence_ok(GPGGA));
+    BOOST_CHECK(is_nmea_sentence_ok(GPRMC));
+    BOOST_CHECK(is_nmea_sentence_ok(GPGSV));
+    // Wrong checksum
+    BOOST_CHECK(!is_nmea_sentence_ok(GPGGA.substr(0, GPGGA.size() - 1) + "E"));
+    // Lowercase checksum
+    BOOST_CHECK(!is_nmea_sentence_ok(GPGSV.substr(0, GPGSV.size() - 2) + "5b"));
+    // Corrupted data
+    std::string corrupted = GPRMC;
+    corrupted[10]         = '7';
+    BOOST_CHECK(!is_nmea_sentence_ok(corrupted));
+    // Not a $GP sentence, or no checksum
+    BOOST_CHECK(!is_nmea_sentence_ok("$GLGSV,1,1,00,*65"));
+    BOOST_CHECK(!is_nmea_sentence_ok(GPGGA.substr(0, GPGGA.size() - 3)));
+    BOOST_CHECK(!is_nmea_sentence_ok("$GP*"));
+
+    BOOST_CHECK(nmea_parser::is_servo_line(SERVO.data(), SERVO.size()));
+    BOOST_CHECK(!nmea_parser::is_servo_line("19-09-1", 7));
+    BOOST_CHECK(!nmea_parser::is_servo_line("19/09/17 384", 12));
+}
+
+BOOST_AUTO_TEST_CASE(test_nmea_parser_chunks)
+{
+    const std::string data = "garbage from startup\r\n" + GPGSV + "\r\n" + GPGGA
+                             + "\r\n" + SERVO + "\r\n\r\n" + GPRMC + "\r\n";
+
+    // The result must not depend on how the data is split up
+    for (size_t chunk_size = 1; chunk_size <= data.size(); chunk_size++) {
+        nmea_parser parser;
+        const auto now    = nmea_parser::clock_t::now();
+        size_t num_stored = 0;
+        for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+            num_stored += parser.push(
+                data.data() + offset, std::min(chunk_size, data.size() - offset), now);
+        }
+        BOOST_REQUIRE_EQUAL(num_stored, 3);
+        BOOST_REQUIRE_EQUAL(parser.get_sentence(nmea_parser::GPGGA), GPGGA);
+        BOOST_REQUIRE_EQUAL(parser.get_sentence(nmea_parser::GPRMC), GPRMC);
+        BOOST_REQUIRE_EQUAL(parser.get_sentence(nmea_parser::SERVO), SERVO);
+        BOOST_REQUIRE(parser.get_time(nmea_parser::GPGGA) == now);
+        BOOST_REQUIRE_EQUAL(parser.get_num_malformed(), 1);
+        BOOST_REQUIRE_EQUAL(parser.get_last_malformed(), "garbage from startup");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_nmea_parser_count)
+{
+    nmea_parser parser;
+    BOOST_CHECK(!parser.has_sentence(nmea_parser::GPGGA));
+    BOOST_CHECK_EQUAL(parser.get_sentence(nmea_parser::GPGGA), "");
+
+    // Incomplete lines are not stored
+    BOOST_CHECK_EQUAL(parser.push(GPGGA), 0);
+    BOOST_CHECK_EQUAL(parser.get_count(nmea_parser::GPGGA), 0);
+    BOOST_CHECK_EQUAL(parser.push("\r\n"), 1);
+    BOOST_CHECK_EQUAL(parser.get_count(nmea_parser::GPGGA), 1);
+    BOOST_CHECK_EQUAL(parser.push(GPGGA + "\r\n" + GPGGA + "\r\n"), 2);
+    BOOST_CHECK_EQUAL(parser.get_count(nmea_parser::GPGGA), 3);
+    BOOST_CHECK_EQUAL(parser.get_count(nmea_parser::GPRMC), 0);
+
+    // Overlong lines are malformed, and don't affect the next line
+    BOOST_CHECK_EQUAL(
+        parser.push(
+            std::string(2 * nmea_parser::MAX_LINE_LEN, 'x') + "\n" + SERVO + "\n"),
+        1);
+    BOOST_CHECK_EQUAL(parser.get_num_malformed(), 1);
+    BOOST_CHECK_EQUAL(parser.get_sentence(nmea_parser::SERVO), SERVO);
+
+    nmea_parser::sentence_t which;
+    BOOST_CHECK(nmea_parser::get_sentence_type("GPRMC", which));
+    BOOST_CHECK_EQUAL(which, nmea_parser::GPRMC);
+    BOOST_CHECK(!nmea_parser::get_sentence_type("GPGSV", which));
+}
@@ -8,7 +8,10 @@
 #include <uhdlib/transport/offload_io_service.hpp>
 #include <boost/test/unit_test.hpp>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <thread>
 
 using namespace uhd::transport;
 
@@ -36,6 +39,9 @@ public:
     {
         if (_frames_allocated > 0) {
             _frames_allocated--;
+            if (_hook) {
+                _hook();
+            }
             return _link->get_recv_buff(timeout_ms);
         }
         return nullptr;
@@ -61,8 +67,16 @@ public:
         _frames_allocated += num_frames;
     }
 
+    //! Call a function before every received frame. Set this before
+    //  allocating frames.
+    void set_hook(std::function<void()> hook)
+    {
+        _hook = hook;
+    }
+
 private:
     std::atomic<size_t> _frames_allocated{0};
+    std::function<void()> _hook;
     recv_link_if::sptr _link;
 };
 
@@ -137,6 +151,12 @@ public:
         _recv_io[client_idx]->allocate_frames(num_frames);
     }
 
+    void set_recv_hook(const size_t client_idx, std::function<void()> hook)
+    {
+        assert(client_idx < _recv_io.size());
+        _recv_io[client_idx]->set_hook(hook);
+    }
+
     void set_detach_callback(std::function<void()>) {}
 
 private:
@@ -148,10 +168,11 @@ constexpr auto SEND_ONLY          = offload_io_service::SEND_ONLY;
 constexpr auto BOTH_SEND_AND_RECV = offload_io_service::BOTH_SEND_AND_RECV;
 
 constexpr auto POLL  = offload_io_service::POLL;
-constexpr auto BLOCK = offload_io_service::BLOCK;
-using params_t       = offload_io_service::params_t;
+constexpr auto BLOCK    = offload_io_service::BLOCK;
+constexpr auto ADAPTIVE = offload_io_service::ADAPTIVE;
+using params_t          = offload_io_service::params_t;
 
-std::vector<offload_io_service::wait_mode_t> wait_modes({POLL, BLOCK});
+std::vector<offload_io_service::wait_mode_t> wait_modes({POLL, BLOCK, ADAPTIVE});
 
 BOOST_AUTO_TEST_CASE(test_construction)
 {
@@ -352,3 +373,240 @@ BOOST_AUTO_TEST_CASE(test_attach_detach)
     mock_io_srv->allocate_recv_frames(2, 1);
     recv_client2->release_recv_buff(recv_client2->get_recv_buff(100));
 }
+
+BOOST_AUTO_TEST_CASE(test_adaptive_wait)
+{
+    params_t params;
+    params.wait_mode                = ADAPTIVE;
+    params.adaptive_spin_us         = 10;
+    params.adaptive_yield_us        = 10;
+    params.adaptive_park_timeout_ms = 1000;
+
+    auto mock_io_srv = std::make_shared<mock_io_service>();
+    auto io_srv      = std::dynamic_pointer_cast<offload_io_service>(
+        offload_io_service::make(mock_io_srv, params));
+    BOOST_REQUIRE(io_srv);
+    auto send_link = make_send_link(5);
+    io_srv->attach_send_link(send_link);
+    auto send_client =
+        io_srv->make_send_client(send_link, 1, nullptr, nullptr, 0, nullptr, nullptr);
+
+    // Let the offload thread go idle, it should park
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto idle_stats = io_srv->get_wait_stats();
+    BOOST_CHECK_GT(idle_stats.num_parks, 0);
+    BOOST_CHECK_GT(idle_stats.busy_ns, 0);
+
+    // Releasing a buffer must wake up the parked thread well before the park
+    // timeout expires
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < 5; i++) {
+        auto buff = send_client->get_send_buff(500);
+        BOOST_REQUIRE(buff != nullptr);
+        send_client->release_send_buff(std::move(buff));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto buff = send_client->get_send_buff(500);
+    BOOST_CHECK(buff != nullptr);
+    send_client->release_send_buff(std::move(buff));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_CHECK(elapsed < std::chrono::milliseconds(500));
+
+    const auto stats = io_srv->get_wait_stats();
+    BOOST_CHECK_GT(stats.num_wakeups, 0);
+    BOOST_CHECK_GT(stats.park_ns, idle_stats.park_ns);
+    BOOST_CHECK_GT(stats.busy_ns, idle_stats.busy_ns);
+
+    send_client.reset();
+    io_srv->detach_send_link(send_link);
+}
+
+BOOST_AUTO_TEST_CASE(test_adaptive_wait_multiple_links)
+{
+    params_t params;
+    params.client_type              = RECV_ONLY;
+    params.wait_mode                = ADAPTIVE;
+    params.adaptive_spin_us         = 10;
+    params.adaptive_yield_us        = 10;
+    params.adaptive_park_timeout_ms = 1000;
+
+    auto mock_io_srv = std::make_shared<mock_io_service>();
+    auto io_srv      = offload_io_service::make(mock_io_srv, params);
+    auto recv_link0  = make_recv_link(5);
+    auto recv_link1  = make_recv_link(5);
+    io_srv->attach_recv_link(recv_link0);
+    io_srv->attach_recv_link(recv_link1);
+    auto recv_client0 =
+        io_srv->make_recv_client(recv_link0, 1, nullptr, nullptr, 0, nullptr);
+    auto recv_client1 =
+        io_srv->make_recv_client(recv_link1, 1, nullptr, nullptr, 0, nullptr);
+
+    // Let the offload thread go idle and park. A packet on any of the links
+    // must be picked up well before the park timeout expires.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (size_t i = 0; i < 2; i++) {
+        recv_link1->push_back_recv_packet(
+            boost::shared_array<uint8_t>(new uint8_t[FRAME_SIZE]), FRAME_SIZE);
+        mock_io_srv->allocate_recv_frames(1, 1);
+        auto buff = recv_client1->get_recv_buff(500);
+        BOOST_REQUIRE(buff != nullptr);
+        recv_client1->release_recv_buff(std::move(buff));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    recv_client0.reset();
+    recv_client1.reset();
+    io_srv->detach_recv_link(recv_link0);
+    io_srv->detach_recv_link(recv_link1);
+}
+
+BOOST_AUTO_TEST_CASE(test_work_stealing)
+{
+    constexpr size_t NUM_LINKS = 4;
+
+    params_t params;
+    params.num_threads = 2;
+
+    auto mock_io_srv = std::make_shared<mock_io_service>();
+    auto io_srv      = std::dynamic_pointer_cast<offload_io_service>(
+        offload_io_service::make(mock_io_srv, params));
+    BOOST_REQUIRE(io_srv);
+
+    std::vector<mock_recv_link::sptr> recv_links;
+    std::vector<mock_send_link::sptr> send_links;
+    std::vector<recv_io_if::sptr> recv_clients;
+    std::vector<send_io_if::sptr> send_clients;
+    for (size_t i = 0; i < NUM_LINKS; i++) {
+        recv_links.push_back(make_recv_link(5));
+        send_links.push_back(make_send_link(5));
+        io_srv->attach_recv_link(recv_links[i]);
+        io_srv->attach_send_link(send_links[i]);
+        recv_clients.push_back(
+            io_srv->make_recv_client(recv_links[i], 1, nullptr, nullptr, 0, nullptr));
+        send_clients.push_back(io_srv->make_send_client(
+            send_links[i], 1, nullptr, nullptr, 0, nullptr, nullptr));
+    }
+
+    // Links are spread evenly over the threads
+    auto load = io_srv->get_thread_load();
+    BOOST_REQUIRE_EQUAL(load.size(), 2);
+    BOOST_CHECK_EQUAL(load[0].num_links, NUM_LINKS);
+    BOOST_CHECK_EQUAL(load[1].num_links, NUM_LINKS);
+
+    for (size_t i = 0; i < 10; i++) {
+        for (size_t j = 0; j < NUM_LINKS; j++) {
+            recv_links[j]->push_back_recv_packet(
+                boost::shared_array<uint8_t>(new uint8_t[FRAME_SIZE]), FRAME_SIZE);
+            mock_io_srv->allocate_recv_frames(j, 1);
+            auto recv_buff = recv_clients[j]->get_recv_buff(100);
+            BOOST_REQUIRE(recv_buff != nullptr);
+            recv_clients[j]->release_recv_buff(std::move(recv_buff));
+
+            auto send_buff = send_clients[j]->get_send_buff(100);
+            BOOST_REQUIRE(send_buff != nullptr);
+            send_buff->set_packet_size(FRAME_SIZE);
+            send_clients[j]->release_send_buff(std::move(send_buff));
+        }
+    }
+
+    // Disconnecting waits for the offload threads to finish with the clients
+    recv_clients.clear();
+    send_clients.clear();
+
+    // Every packet was sent on its own link
+    for (size_t j = 0; j < NUM_LINKS; j++) {
+        BOOST_CHECK_EQUAL(send_links[j]->get_num_packets(), 10);
+    }
+
+    load = io_srv->get_thread_load();
+    BOOST_CHECK_GT(load[0].num_buffs + load[1].num_buffs, 0);
+    BOOST_CHECK_EQUAL(load[0].num_links + load[1].num_links, 0);
+
+    for (size_t i = 0; i < NUM_LINKS; i++) {
+        io_srv->detach_recv_link(recv_links[i]);
+        io_srv->detach_send_link(send_links[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_work_stealing_imbalance)
+{
+    constexpr size_t NUM_LINKS  = 4;
+    constexpr size_t NUM_FRAMES = 4;
+
+    params_t params;
+    params.num_threads = 2;
+
+    auto mock_io_srv = std::make_shared<mock_io_service>();
+    auto io_srv      = std::dynamic_pointer_cast<offload_io_service>(
+        offload_io_service::make(mock_io_srv, params));
+    BOOST_REQUIRE(io_srv);
+
+    // Find out which recv links are homed on thread 0. The send links keep
+    // thread 1 owning links, so it may be left with no recv links at all.
+    std::vector<mock_recv_link::sptr> recv_links;
+    std::vector<mock_send_link::sptr> send_links;
+    std::vector<recv_io_if::sptr> recv_clients;
+    std::vector<send_io_if::sptr> send_clients;
+    std::vector<size_t> thread0_links;
+    for (size_t i = 0; i < NUM_LINKS; i++) {
+        recv_links.push_back(make_recv_link(NUM_FRAMES));
+        send_links.push_back(make_send_link(NUM_FRAMES));
+        io_srv->attach_recv_link(recv_links[i]);
+        io_srv->attach_send_link(send_links[i]);
+
+        const auto num_links = io_srv->get_thread_load()[0].num_links;
+        recv_clients.push_back(io_srv->make_recv_client(
+            recv_links[i], NUM_FRAMES, nullptr, nullptr, 0, nullptr));
+        if (io_srv->get_thread_load()[0].num_links > num_links) {
+            thread0_links.push_back(i);
+        }
+        send_clients.push_back(io_srv->make_send_client(
+            send_links[i], 1, nullptr, nullptr, 0, nullptr, nullptr));
+    }
+    BOOST_REQUIRE_GE(thread0_links.size(), 2);
+
+    // Only the links of thread 0 carry traffic, thread 1 should help out.
+    // When the same thread receives two frames of the slow link in a row, the
+    // second one stalls until thread 1 stole a buffer. If the stalled thread
+    // is thread 0, it was busy in its previous pass, so thread 1 takes over
+    // its other links. If it is thread 1, it already stole the first frame.
+    // This works no matter how the threads are scheduled. The timeout only
+    // keeps a broken scheduler from hanging the test.
+    offload_io_service* io_srv_ptr = io_srv.get();
+    std::thread::id last_thread;
+    mock_io_srv->set_recv_hook(thread0_links[0], [io_srv_ptr, &last_thread]() {
+        const auto this_thread = std::this_thread::get_id();
+        const bool same_thread = (this_thread == last_thread);
+        last_thread            = this_thread;
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (same_thread && io_srv_ptr->get_thread_load()[1].num_stolen_buffs == 0
+               && std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::yield();
+        }
+    });
+    for (const size_t j : thread0_links) {
+        for (size_t k = 0; k < NUM_FRAMES; k++) {
+            recv_links[j]->push_back_recv_packet(
+                boost::shared_array<uint8_t>(new uint8_t[FRAME_SIZE]), FRAME_SIZE);
+        }
+        mock_io_srv->allocate_recv_frames(j, NUM_FRAMES);
+    }
+    for (size_t k = 0; k < NUM_FRAMES; k++) {
+        for (const size_t j : thread0_links) {
+            auto recv_buff = recv_clients[j]->get_recv_buff(1000);
+            BOOST_REQUIRE(recv_buff != nullptr);
+            recv_clients[j]->release_recv_buff(std::move(recv_buff));
+        }
+    }
+
+    const auto load = io_srv->get_thread_load();
+    BOOST_CHECK_GT(load[1].num_stolen_buffs, 0);
+    BOOST_CHECK_GE(load[1].num_buffs, load[1].num_stolen_buffs);
+
+    recv_clients.clear();
+    send_clients.clear();
+    for (size_t i = 0; i < NUM_LINKS; i++) {
+        io_srv->detach_recv_link(recv_links[i]);
+        io_srv->detach_send_link(send_links[i]);
+    }
+}
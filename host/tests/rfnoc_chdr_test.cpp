@@ -10,6 +10,7 @@
 #include <uhdlib/rfnoc/chdr_types.hpp>
 #include <boost/format.hpp>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
 #include <iostream>
 
 using namespace uhd;
@@ -49,6 +50,16 @@ ctrl_payload populate_ctrl_payload()
     return pyld;
 }
 
+ctrl_payload populate_ctrl_payload_multi_data()
+{
+    ctrl_payload pyld = populate_ctrl_payload();
+    pyld.data_vtr.resize(1 + (rand64() % ctrl_data_vtr_t::MAX_SIZE));
+    for (auto& data : pyld.data_vtr) {
+        data = rand64() & 0xFFFFFFFF;
+    }
+    return pyld;
+}
+
 strs_payload populate_strs_payload()
 {
     strs_payload pyld;
@@ -175,6 +186,116 @@ BOOST_AUTO_TEST_CASE(chdr_ctrl_packet_swap_256)
     }
 }
 
+BOOST_AUTO_TEST_CASE(chdr_ctrl_data_vtr)
+{
+    ctrl_data_vtr_t data_vtr = {1, 2, 3};
+    BOOST_CHECK_EQUAL(data_vtr.size(), 3);
+    BOOST_CHECK(data_vtr.to_vector() == std::vector<uint32_t>({1, 2, 3}));
+    data_vtr.resize(5);
+    BOOST_CHECK_EQUAL(data_vtr[4], 0);
+    data_vtr = std::vector<uint32_t>(ctrl_data_vtr_t::MAX_SIZE, 7);
+    BOOST_CHECK_EQUAL(data_vtr.size(), ctrl_data_vtr_t::MAX_SIZE);
+    BOOST_CHECK_THROW(data_vtr.push_back(0), uhd::assertion_error);
+    BOOST_CHECK_THROW(data_vtr.at(ctrl_data_vtr_t::MAX_SIZE), uhd::index_error);
+    BOOST_CHECK_THROW(
+        data_vtr.resize(ctrl_data_vtr_t::MAX_SIZE + 1), uhd::assertion_error);
+    BOOST_CHECK(data_vtr != ctrl_data_vtr_t({7}));
+}
+
+BOOST_AUTO_TEST_CASE(chdr_ctrl_packet_multi_data)
+{
+    uint64_t buff[MAX_BUF_SIZE_WORDS];
+    uint64_t ref_buff[MAX_BUF_SIZE_WORDS];
+
+    for (const auto endianness : {ENDIANNESS_BIG, ENDIANNESS_LITTLE}) {
+        const chdr_packet_factory factory(CHDR_W_64, endianness);
+        chdr_ctrl_packet::uptr tx_pkt  = factory.make_ctrl();
+        chdr_ctrl_packet::cuptr rx_pkt = factory.make_ctrl();
+        chdr_packet::uptr ref_pkt      = factory.make_generic();
+
+        for (size_t i = 0; i < NUM_ITERS; i++) {
+            chdr_header hdr   = chdr_header(rand64());
+            ctrl_payload pyld = populate_ctrl_payload_multi_data();
+
+            memset(buff, 0, MAX_BUF_SIZE_BYTES);
+            tx_pkt->refresh(buff, hdr, pyld);
+            rx_pkt->refresh(buff);
+            BOOST_CHECK(rx_pkt->get_payload() == pyld);
+
+            // The templated serializer must produce the same bytes as the one
+            // that takes a conversion function
+            memset(ref_buff, 0, MAX_BUF_SIZE_BYTES);
+            chdr_header ref_hdr = hdr;
+            pyld.populate_header(ref_hdr);
+            ref_pkt->refresh(ref_buff, ref_hdr);
+            const size_t num_bytes =
+                pyld.serialize(ref_pkt->get_payload_ptr_as<uint64_t>(),
+                    MAX_BUF_SIZE_BYTES,
+                    ref_pkt->conv_from_host<uint64_t>());
+            ref_pkt->update_payload_size(num_bytes);
+            BOOST_CHECK_EQUAL(0, memcmp(buff, ref_buff, MAX_BUF_SIZE_BYTES));
+
+            ctrl_payload ref_pyld;
+            ref_pyld.deserialize(ref_pkt->get_payload_const_ptr_as<uint64_t>(),
+                ref_pkt->get_payload_size() / sizeof(uint64_t),
+                ref_pkt->conv_to_host<uint64_t>());
+            BOOST_CHECK(ref_pyld == pyld);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chdr_ctrl_packet_throughput)
+{
+    constexpr size_t NUM_PKTS = 1000000;
+    uint64_t buff[MAX_BUF_SIZE_WORDS];
+    memset(buff, 0, MAX_BUF_SIZE_BYTES);
+
+    chdr_ctrl_packet::uptr tx_pkt  = chdr64_be_factory.make_ctrl();
+    chdr_ctrl_packet::cuptr rx_pkt = chdr64_be_factory.make_ctrl();
+    chdr_packet::uptr ref_pkt      = chdr64_be_factory.make_generic();
+    const auto conv_from_host      = ref_pkt->conv_from_host<uint64_t>();
+    const auto conv_to_host        = ref_pkt->conv_to_host<uint64_t>();
+
+    chdr_header hdr;
+    ctrl_payload tx_pyld = populate_ctrl_payload();
+    ctrl_payload rx_pyld;
+    tx_pyld.timestamp = rand64();
+
+    // This is the path taken by the control endpoints
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_PKTS; i++) {
+        tx_pyld.seq_num = i % 64;
+        tx_pkt->refresh(buff, hdr, tx_pyld);
+        rx_pkt->refresh(buff);
+        rx_pkt->fill_payload(rx_pyld);
+    }
+    const std::chrono::duration<double> templ_time =
+        std::chrono::steady_clock::now() - start;
+    BOOST_CHECK(rx_pyld == tx_pyld);
+
+    // Same round trip, but using the conversion function overloads
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_PKTS; i++) {
+        tx_pyld.seq_num = i % 64;
+        tx_pyld.populate_header(hdr);
+        ref_pkt->refresh(buff, hdr);
+        ref_pkt->update_payload_size(tx_pyld.serialize(
+            ref_pkt->get_payload_ptr_as<uint64_t>(), MAX_BUF_SIZE_BYTES, conv_from_host));
+        rx_pyld.deserialize(ref_pkt->get_payload_const_ptr_as<uint64_t>(),
+            ref_pkt->get_payload_size() / sizeof(uint64_t),
+            conv_to_host);
+    }
+    const std::chrono::duration<double> func_time =
+        std::chrono::steady_clock::now() - start;
+    BOOST_CHECK(rx_pyld == tx_pyld);
+
+    std::cout << "Control packet round trips: " << NUM_PKTS << std::endl
+              << "  templated byte order:  " << (NUM_PKTS / templ_time.count() / 1e6)
+              << " Mpkts/s" << std::endl
+              << "  conversion function:   " << (NUM_PKTS / func_time.count() / 1e6)
+              << " Mpkts/s" << std::endl;
+}
+
 BOOST_AUTO_TEST_CASE(chdr_strs_packet_no_swap_64)
 {
     uint64_t buff[MAX_BUF_SIZE_WORDS];
@@ -223,6 +344,51 @@ BOOST_AUTO_TEST_CASE(chdr_strc_packet_no_swap_64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(chdr_mgmt_packet_swap_64)
+{
+    uint64_t buff[MAX_BUF_SIZE_WORDS];
+
+    chdr_mgmt_packet::uptr tx_pkt  = chdr64_be_factory.make_mgmt();
+    chdr_mgmt_packet::cuptr rx_pkt = chdr64_le_factory.make_mgmt();
+
+    for (size_t i = 0; i < NUM_ITERS; i++) {
+        mgmt_payload pyld;
+        pyld.set_header(rand64() & 0xFFFF, RFNOC_PROTO_VER, CHDR_W_64);
+        const size_t num_hops = 1 + (rand64() % 4);
+        for (size_t hop_idx = 0; hop_idx < num_hops; hop_idx++) {
+            mgmt_hop_t hop;
+            const size_t num_ops = 1 + (rand64() % 4);
+            for (size_t op_idx = 0; op_idx < num_ops; op_idx++) {
+                hop.add_op(mgmt_op_t(mgmt_op_t::MGMT_OP_CFG_WR_REQ,
+                    mgmt_op_t::cfg_payload(rand64() & 0xFFFF, rand64() & 0xFFFFFFFF)));
+            }
+            pyld.add_hop(hop);
+        }
+
+        chdr_header hdr = chdr_header(rand64());
+        memset(buff, 0, MAX_BUF_SIZE_BYTES);
+        tx_pkt->refresh(buff, hdr, pyld);
+        byte_swap(buff);
+        rx_pkt->refresh(buff);
+
+        const mgmt_payload rx_pyld = rx_pkt->get_payload();
+        BOOST_CHECK_EQUAL(rx_pyld.get_src_epid(), pyld.get_src_epid());
+        BOOST_CHECK_EQUAL(rx_pyld.get_size_bytes(), pyld.get_size_bytes());
+        BOOST_REQUIRE_EQUAL(rx_pyld.get_num_hops(), pyld.get_num_hops());
+        for (size_t hop_idx = 0; hop_idx < num_hops; hop_idx++) {
+            const mgmt_hop_t& tx_hop = pyld.get_hop(hop_idx);
+            const mgmt_hop_t& rx_hop = rx_pyld.get_hop(hop_idx);
+            BOOST_REQUIRE_EQUAL(rx_hop.get_num_ops(), tx_hop.get_num_ops());
+            for (size_t op_idx = 0; op_idx < tx_hop.get_num_ops(); op_idx++) {
+                BOOST_CHECK_EQUAL(rx_hop.get_op(op_idx).get_op_code(),
+                    tx_hop.get_op(op_idx).get_op_code());
+                BOOST_CHECK_EQUAL(rx_hop.get_op(op_idx).get_op_payload(),
+                    tx_hop.get_op(op_idx).get_op_payload());
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(chdr_generic_packet_calculate_pyld_offset_64)
 {
     // Check calculation without timestamp
@@ -0,0 +1,331 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "rfnoc_mock_reg_iface.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/rfnoc/command_batch.hpp>
+#include <uhdlib/rfnoc/chdr_types.hpp>
+#include <uhdlib/rfnoc/clock_iface.hpp>
+#include <uhdlib/rfnoc/ctrlport_endpoint.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace uhd::rfnoc;
+
+namespace {
+
+constexpr double TIMEBASE_FREQ = 100e6;
+
+/*! Emulates the control crossbar of a device
+ *
+ * Requests are recorded, and ACKs are only returned once a configurable
+ * number of requests was received. This lets us check that a batch is sent
+ * entirely before any ACK is awaited.
+ */
+class mock_ctrl_device
+{
+public:
+    mock_ctrl_device()
+        : _client_clk("client", 100e6, false), _timebase_clk("timebase", TIMEBASE_FREQ)
+    {
+        _client_clk.set_running(true);
+        _timebase_clk.set_running(true);
+        _responder = std::thread([this]() { _respond(); });
+    }
+
+    ~mock_ctrl_device()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cond.notify_all();
+        _responder.join();
+    }
+
+    ctrlport_endpoint::sptr make_endpoint(uint16_t port)
+    {
+        auto send_fn = [this](const chdr::ctrl_payload& payload, double) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _requests.push_back(payload);
+            _pending.push_back(payload);
+            _cond.notify_all();
+        };
+        auto ep = ctrlport_endpoint::make(
+            send_fn, 1, port, 256, 1, _client_clk, _timebase_clk);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _endpoints[port] = ep;
+        return ep;
+    }
+
+    //! Hold back all ACKs until this many requests are outstanding
+    void set_ack_threshold(size_t num_requests)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ack_threshold = num_requests;
+        _cond.notify_all();
+    }
+
+    //! Respond to writes to this address with an error status
+    void set_error_addr(uint32_t addr, chdr::ctrl_status_t status)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _errors[addr] = status;
+    }
+
+    //! Respond to reads from this address with this value
+    void set_read_value(uint32_t addr, uint32_t value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _read_values[addr] = value;
+    }
+
+    std::vector<chdr::ctrl_payload> get_requests(uint16_t port)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<chdr::ctrl_payload> requests;
+        for (const auto& request : _requests) {
+            if (request.src_port == port) {
+                requests.push_back(request);
+            }
+        }
+        return requests;
+    }
+
+private:
+    void _respond()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _cond.wait(lock, [this]() {
+                return _stop || (!_pending.empty() && _pending.size() >= _ack_threshold);
+            });
+            if (_stop) {
+                return;
+            }
+            std::deque<chdr::ctrl_payload> pending;
+            pending.swap(_pending);
+            _ack_threshold = 0;
+            for (auto& response : pending) {
+                response.is_ack = true;
+                if (_errors.count(response.address)) {
+                    response.status = _errors.at(response.address);
+                }
+                if (response.op_code == chdr::OP_READ
+                    && _read_values.count(response.address)) {
+                    response.data_vtr[0] = _read_values.at(response.address);
+                }
+                auto ep = _endpoints.at(response.src_port);
+                lock.unlock();
+                ep->handle_recv(response);
+                lock.lock();
+            }
+        }
+    }
+
+    clock_iface _client_clk;
+    clock_iface _timebase_clk;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::map<uint16_t, ctrlport_endpoint::sptr> _endpoints;
+    std::vector<chdr::ctrl_payload> _requests;
+    std::deque<chdr::ctrl_payload> _pending;
+    std::map<uint32_t, chdr::ctrl_status_t> _errors;
+    std::map<uint32_t, uint32_t> _read_values;
+    size_t _ack_threshold = 0;
+    bool _stop            = false;
+    std::thread _responder;
+};
+
+class ack_mock_reg_iface_t : public mock_reg_iface_t
+{
+public:
+    std::vector<bool> acks;
+    std::vector<uhd::time_spec_t> times;
+
+protected:
+    void _poke_cb(uint32_t, uint32_t, uhd::time_spec_t time, bool ack)
+    {
+        acks.push_back(ack);
+        times.push_back(time);
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_command_batch_ctrlport)
+{
+    mock_ctrl_device device;
+    auto ep0 = device.make_endpoint(1);
+    auto ep1 = device.make_endpoint(2);
+    const uhd::time_spec_t cmd_time(1.5);
+
+    command_batch batch(cmd_time);
+    batch.poke32(*ep0, 0x10, 1);
+    batch.multi_poke32(*ep0, {0x18, 0x14}, {3, 2});
+    batch.poke64(*ep1, 0x20, 0x0000000500000004);
+    batch.poke32(*ep1, 0x30, 6);
+    BOOST_CHECK_EQUAL(batch.size(), 6);
+
+    // No ACKs will be returned until all six writes were sent. If committing
+    // waited for one block's ACKs before sending to the next, this would fail.
+    device.set_ack_threshold(6);
+    batch.commit();
+    BOOST_CHECK(batch.empty());
+
+    const std::vector<std::vector<uint32_t>> exp_addrs = {
+        {0x10, 0x18, 0x14}, {0x20, 0x24, 0x30}};
+    const std::vector<std::vector<uint32_t>> exp_data = {{1, 3, 2}, {4, 5, 6}};
+    for (uint16_t port : {1, 2}) {
+        const auto requests = device.get_requests(port);
+        BOOST_REQUIRE_EQUAL(requests.size(), 3);
+        for (size_t i = 0; i < requests.size(); i++) {
+            BOOST_CHECK_EQUAL(requests[i].op_code, chdr::OP_WRITE);
+            BOOST_CHECK_EQUAL(requests[i].address, exp_addrs[port - 1][i]);
+            BOOST_CHECK_EQUAL(requests[i].data_vtr[0], exp_data[port - 1][i]);
+            // Only the first command per block carries the timestamp
+            BOOST_CHECK_EQUAL(requests[i].has_timestamp(), i == 0);
+        }
+        BOOST_CHECK_EQUAL(
+            requests[0].timestamp.get(), uint64_t(cmd_time.to_ticks(TIMEBASE_FREQ)));
+    }
+
+    // Without a batch outstanding, waiting returns immediately
+    ep0->wait_for_batch();
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_deferred_wait)
+{
+    mock_ctrl_device device;
+    auto ep = device.make_endpoint(1);
+
+    // Queue three batches, and only wait for the last one
+    device.set_ack_threshold(3);
+    for (uint32_t i = 0; i < 3; i++) {
+        command_batch batch(uhd::time_spec_t(1.0 + i));
+        batch.poke32(*ep, 0x10, i);
+        batch.commit(i == 2);
+    }
+    BOOST_CHECK_EQUAL(device.get_requests(1).size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_error)
+{
+    mock_ctrl_device device;
+    auto ep0 = device.make_endpoint(1);
+    auto ep1 = device.make_endpoint(2);
+    device.set_error_addr(0x14, chdr::CMD_CMDERR);
+
+    command_batch batch(uhd::time_spec_t(1.0));
+    batch.multi_poke32(*ep0, {0x10, 0x14, 0x18}, {1, 2, 3});
+    batch.poke32(*ep1, 0x10, 4);
+    BOOST_CHECK_THROW(batch.commit(), uhd::op_failed);
+    BOOST_CHECK_THROW(batch.multi_poke32(*ep0, {0x10}, {}), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_interleaved)
+{
+    mock_ctrl_device device;
+    auto ep = device.make_endpoint(1);
+    device.set_read_value(0x40, 0xC0FFEE);
+
+    // A peek between sending a batch and waiting for it must neither consume
+    // the batch's ACKs, nor be confused by them. Use more writes than there
+    // are sequence numbers.
+    std::vector<uint32_t> addrs(100), data(100);
+    for (uint32_t i = 0; i < addrs.size(); i++) {
+        addrs[i] = 0x100 + 4 * i;
+        data[i]  = i;
+    }
+    ep->batch_poke32(addrs, data, uhd::time_spec_t(1.0));
+    BOOST_CHECK_EQUAL(ep->peek32(0x40), 0xC0FFEE);
+    ep->wait_for_batch();
+
+    // Batches waited for in one thread don't consume the ACKs of another
+    std::atomic<size_t> num_peeks{0};
+    std::thread peeker([ep, &num_peeks]() {
+        try {
+            for (size_t i = 0; i < 50; i++) {
+                if (ep->peek32(0x40) == 0xC0FFEE) {
+                    num_peeks++;
+                }
+            }
+        } catch (const uhd::exception&) {
+        }
+    });
+    for (size_t i = 0; i < 50; i++) {
+        ep->batch_poke32({0x10, 0x14}, {1, 2});
+        BOOST_CHECK_NO_THROW(ep->wait_for_batch());
+    }
+    peeker.join();
+    BOOST_CHECK_EQUAL(num_peeks, 50);
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_per_thread)
+{
+    mock_ctrl_device device;
+    auto ep = device.make_endpoint(1);
+    device.set_error_addr(0x14, chdr::CMD_CMDERR);
+
+    // A thread only waits for its own batches, and only sees their errors
+    ep->batch_poke32({0x14}, {1});
+    bool other_failed = false;
+    std::thread other([ep, &other_failed]() {
+        ep->batch_poke32({0x10}, {2});
+        try {
+            ep->wait_for_batch();
+        } catch (const uhd::exception&) {
+            other_failed = true;
+        }
+    });
+    other.join();
+    BOOST_CHECK(!other_failed);
+    BOOST_CHECK_THROW(ep->wait_for_batch(), uhd::op_failed);
+    BOOST_CHECK_NO_THROW(ep->wait_for_batch());
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_never_waited)
+{
+    mock_ctrl_device device;
+    auto ep = device.make_endpoint(1);
+    device.set_error_addr(0x14, chdr::CMD_CMDERR);
+
+    // Batches that nobody waits for are dropped once they are ACKed, but an
+    // error is still reported by the next wait
+    for (size_t i = 0; i < 1000; i++) {
+        ep->batch_poke32({0x10, 0x18}, {1, 2});
+    }
+    ep->batch_poke32({0x14}, {3});
+    for (size_t i = 0; i < 1000; i++) {
+        ep->batch_poke32({0x10, 0x18}, {1, 2});
+    }
+    BOOST_CHECK_THROW(ep->wait_for_batch(), uhd::op_failed);
+    BOOST_CHECK_NO_THROW(ep->wait_for_batch());
+    ep->batch_poke32({0x10}, {4});
+    BOOST_CHECK_NO_THROW(ep->wait_for_batch());
+}
+
+BOOST_AUTO_TEST_CASE(test_command_batch_default_iface)
+{
+    // Register interfaces that don't implement batching execute the writes
+    // with an ACK when the batch is committed
+    ack_mock_reg_iface_t regs;
+    command_batch batch;
+    batch.block_poke32(regs, 0x100, {7, 8});
+    BOOST_CHECK(regs.write_memory.empty());
+    batch.set_time(uhd::time_spec_t(2.0));
+    batch.commit();
+    BOOST_CHECK_EQUAL(regs.write_memory.at(0x100), 7);
+    BOOST_CHECK_EQUAL(regs.write_memory.at(0x104), 8);
+    BOOST_REQUIRE_EQUAL(regs.acks.size(), 2);
+    BOOST_CHECK(regs.acks[0] && regs.acks[1]);
+    BOOST_CHECK(regs.times[0] == uhd::time_spec_t(2.0));
+}
@@ -0,0 +1,241 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Benchmark for the time alignment of multi-channel rx streams. Every channel
+// produces packets with consecutive timestamps. Packets are dropped at random,
+// and channels can start out misaligned, so the alignment logic has to discard
+// packets until the channels line up again.
+
+#include <uhd/utils/safe_main.hpp>
+#include <uhdlib/transport/get_aligned_buffs.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace po = boost::program_options;
+using namespace uhd::transport;
+
+static constexpr uint64_t TICKS_PER_PACKET = 1000;
+
+/*!
+ * Mock rx transport that produces packets with consecutive timestamps, and
+ * randomly drops some of them
+ */
+class mock_rx_xport
+{
+public:
+    using uptr = std::unique_ptr<mock_rx_xport>;
+
+    struct buff_t
+    {
+        using uptr = std::unique_ptr<buff_t>;
+    };
+
+    struct packet_info_t
+    {
+        bool has_tsf = true;
+        uint64_t tsf = 0;
+    };
+
+    mock_rx_xport(const uint64_t start_tsf, const double drop_rate, const size_t seed)
+        : _tsf(start_tsf)
+        , _drop_threshold(uint32_t(drop_rate * std::numeric_limits<uint32_t>::max()))
+        , _rng(uint32_t(seed))
+        , _buff(new buff_t)
+    {
+    }
+
+    std::tuple<buff_t::uptr, packet_info_t, bool> get_recv_buff(const int32_t)
+    {
+        bool seq_error = false;
+        while (_rng() < _drop_threshold) {
+            _tsf += TICKS_PER_PACKET;
+            seq_error = true;
+            num_dropped++;
+        }
+        packet_info_t info;
+        info.tsf = _tsf;
+        _tsf += TICKS_PER_PACKET;
+        num_received++;
+        return std::make_tuple(std::move(_buff), info, seq_error);
+    }
+
+    void release_recv_buff(buff_t::uptr buff)
+    {
+        _buff = std::move(buff);
+    }
+
+    size_t num_received = 0;
+    size_t num_dropped  = 0;
+
+private:
+    uint64_t _tsf;
+    const uint32_t _drop_threshold;
+    std::minstd_rand _rng;
+    buff_t::uptr _buff;
+};
+
+/*!
+ * The alignment logic as it was before alignment_tracker: a dynamic_bitset
+ * that is rescanned, and a release of all aligned buffers on every new time.
+ * Like the get_aligned_buffs instance it is compared with, it ignores
+ * sequence errors.
+ */
+template <typename transport_t>
+class legacy_get_aligned_buffs
+{
+public:
+    using base_t             = get_aligned_buffs<transport_t, true>;
+    using alignment_result_t = typename base_t::alignment_result_t;
+    static constexpr alignment_result_t SUCCESS = base_t::SUCCESS;
+
+    legacy_get_aligned_buffs(std::vector<typename transport_t::uptr>& xports,
+        std::vector<typename transport_t::buff_t::uptr>& frame_buffs,
+        std::vector<typename transport_t::packet_info_t>& infos)
+        : _xports(xports)
+        , _frame_buffs(frame_buffs)
+        , _infos(infos)
+        , _prev_tsf(_xports.size(), 0)
+        , _channels_to_align(_xports.size())
+    {
+    }
+
+    alignment_result_t operator()(const int32_t timeout_ms)
+    {
+        _channels_to_align.set();
+        bool time_valid   = false;
+        uint64_t tsf      = 0;
+        size_t iterations = 0;
+
+        while (_channels_to_align.any()) {
+            const size_t chan = _channels_to_align.find_first();
+            auto& info        = _infos[chan];
+            auto& frame_buff  = _frame_buffs[chan];
+            if (!frame_buff) {
+                std::tie(frame_buff, info, std::ignore) =
+                    _xports[chan]->get_recv_buff(timeout_ms);
+            }
+            const bool time_out_of_order = _prev_tsf[chan] > info.tsf;
+            _prev_tsf[chan]              = info.tsf;
+            if (time_out_of_order) {
+                time_valid = false;
+            }
+            if (!time_valid || info.tsf > tsf) {
+                if (iterations++ > ALIGNMENT_FAILURE_THRESHOLD) {
+                    return base_t::ALIGNMENT_FAILURE;
+                }
+                for (size_t i = 0; i < _xports.size(); i++) {
+                    if (!_channels_to_align.test(i) && _infos[i].has_tsf) {
+                        _xports[i]->release_recv_buff(std::move(_frame_buffs[i]));
+                        _frame_buffs[i] = nullptr;
+                    }
+                }
+                _channels_to_align.set();
+                _channels_to_align.reset(chan);
+                time_valid = true;
+                tsf        = info.tsf;
+            } else if (info.tsf == tsf) {
+                _channels_to_align.reset(chan);
+            } else {
+                _xports[chan]->release_recv_buff(std::move(_frame_buffs[chan]));
+                _frame_buffs[chan] = nullptr;
+            }
+        }
+        return SUCCESS;
+    }
+
+private:
+    std::vector<typename transport_t::uptr>& _xports;
+    std::vector<typename transport_t::buff_t::uptr>& _frame_buffs;
+    std::vector<typename transport_t::packet_info_t>& _infos;
+    std::vector<uint64_t> _prev_tsf;
+    boost::dynamic_bitset<> _channels_to_align;
+};
+
+template <typename aligner_t>
+void benchmark(const std::string& name,
+    const size_t num_chans,
+    const size_t num_sets,
+    const double drop_rate,
+    const size_t max_misalignment)
+{
+    // Seed everything the same way for both implementations
+    std::vector<mock_rx_xport::uptr> xports;
+    std::minstd_rand rng(1);
+    for (size_t chan = 0; chan < num_chans; chan++) {
+        const uint64_t offset = max_misalignment ? rng() % (max_misalignment + 1) : 0;
+        xports.emplace_back(
+            new mock_rx_xport(offset * TICKS_PER_PACKET, drop_rate, chan + 1));
+    }
+    std::vector<mock_rx_xport::buff_t::uptr> frame_buffs(num_chans);
+    std::vector<mock_rx_xport::packet_info_t> infos(num_chans);
+    aligner_t aligner(xports, frame_buffs, infos);
+
+    size_t num_failures = 0;
+    const auto start    = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_sets; i++) {
+        if (aligner(0) != aligner_t::SUCCESS) {
+            num_failures++;
+        }
+        for (size_t chan = 0; chan < num_chans; chan++) {
+            xports[chan]->release_recv_buff(std::move(frame_buffs[chan]));
+        }
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    size_t num_received = 0, num_dropped = 0;
+    for (const auto& xport : xports) {
+        num_received += xport->num_received;
+        num_dropped += xport->num_dropped;
+    }
+    std::cout << name << ":" << std::endl
+              << "    " << num_sets << " aligned sets in " << elapsed.count() << " s ("
+              << elapsed.count() / num_sets * 1e9 << " ns per set, "
+              << elapsed.count() / num_received * 1e9 << " ns per packet)" << std::endl
+              << "    " << num_received << " packets received, " << num_dropped
+              << " dropped, " << num_received - num_sets * num_chans
+              << " discarded for alignment, " << num_failures << " alignment failures"
+              << std::endl;
+}
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    size_t num_chans, num_sets, max_misalignment;
+    double drop_rate;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("channels", po::value<size_t>(&num_chans)->default_value(16), "number of channels")
+        ("sets", po::value<size_t>(&num_sets)->default_value(1000000), "number of aligned sets of packets to receive")
+        ("drop-rate", po::value<double>(&drop_rate)->default_value(1e-3), "probability that a packet is dropped")
+        ("misalignment", po::value<size_t>(&max_misalignment)->default_value(10), "maximum initial misalignment of a channel in packets")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "UHD rx alignment benchmark " << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    benchmark<legacy_get_aligned_buffs<mock_rx_xport>>(
+        "dynamic_bitset (legacy)", num_chans, num_sets, drop_rate, max_misalignment);
+    // Sequence errors are ignored, so dropped packets are only noticed through
+    // the alignment
+    benchmark<get_aligned_buffs<mock_rx_xport, true>>(
+        "alignment_tracker", num_chans, num_sets, drop_rate, max_misalignment);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "common/mock_rx_streamer.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/rx_capture_ring.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+
+struct capture_fixture
+{
+    capture_fixture(const size_t capacity)
+        : rx_stream(std::make_shared<mock_rx_streamer>())
+        , ring(rx_capture_ring::make(rx_stream, "sc16", SAMP_RATE, capacity))
+    {
+    }
+
+    //! Feed samples and wait until the ring received or dropped all of them
+    void feed(const size_t nsamps)
+    {
+        rx_stream->feed(nsamps);
+        const size_t num_delivered = rx_stream->get_num_delivered() + nsamps;
+        const auto exit_time =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (ring->get_num_recvd_samps() + ring->get_num_dropped_samps()
+               < num_delivered) {
+            BOOST_REQUIRE(std::chrono::steady_clock::now() < exit_time);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::shared_ptr<mock_rx_streamer> rx_stream;
+    rx_capture_ring::sptr ring;
+
+    //! The exported samples per channel
+    std::vector<std::vector<uint32_t>> samps{NUM_CHANS};
+    //! The times of the exported chunks of channel 0
+    std::vector<time_spec_t> chunk_times;
+
+    rx_capture_ring::export_callback_t collect = [this](const size_t chan,
+                                                     const void* buff,
+                                                     const size_t nsamps,
+                                                     const time_spec_t& time_spec) {
+        const uint32_t* first = static_cast<const uint32_t*>(buff);
+        samps[chan].insert(samps[chan].end(), first, first + nsamps);
+        if (chan == 0) {
+            chunk_times.push_back(time_spec);
+        }
+    };
+
+    //! Check that the samples [first, first + nsamps) were exported
+    void check_samps(const size_t first, const size_t nsamps)
+    {
+        for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+            BOOST_REQUIRE_EQUAL(samps[chan].size(), nsamps);
+            for (size_t i = 0; i < nsamps; i++) {
+                BOOST_REQUIRE_EQUAL(
+                    samps[chan][i], uint32_t(first + i) + (chan ? CHAN1_OFFSET : 0));
+            }
+        }
+    }
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_capture_window)
+{
+    capture_fixture fix(1000);
+    BOOST_CHECK_EQUAL(fix.ring->get_num_channels(), NUM_CHANS);
+    BOOST_CHECK_EQUAL(fix.ring->get_capacity(), 1000);
+    BOOST_CHECK_THROW(fix.ring->trigger(time_spec_t(0.0), 0, fix.collect), value_error);
+    BOOST_CHECK_THROW(
+        fix.ring->trigger(time_spec_t(0.0), 1001, fix.collect), value_error);
+
+    fix.feed(500);
+    const time_spec_t start_time = time_spec_t::from_ticks(150, SAMP_RATE);
+    BOOST_REQUIRE(fix.ring->trigger(start_time, 200, fix.collect));
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+
+    const auto result = fix.ring->get_last_export();
+    BOOST_CHECK(result.success);
+    BOOST_CHECK_EQUAL(result.nsamps, 200);
+    BOOST_CHECK(result.start_time == start_time);
+    fix.check_samps(150, 200);
+    BOOST_CHECK(fix.chunk_times.front() == start_time);
+}
+
+BOOST_AUTO_TEST_CASE(test_capture_overwritten)
+{
+    capture_fixture fix(1000);
+    fix.feed(2250);
+
+    // The start of the window was overwritten, the rest is exported, split
+    // where the ring wraps around
+    BOOST_REQUIRE(
+        fix.ring->trigger(time_spec_t::from_ticks(1200, SAMP_RATE), 1000, fix.collect));
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+
+    const auto result = fix.ring->get_last_export();
+    BOOST_CHECK(result.success);
+    BOOST_REQUIRE_GT(result.nsamps, 0);
+    BOOST_REQUIRE_LT(result.nsamps, 1000);
+    const size_t first = 2200 - result.nsamps;
+    BOOST_CHECK(result.start_time == time_spec_t::from_ticks(first, SAMP_RATE));
+    fix.check_samps(first, result.nsamps);
+    BOOST_CHECK_EQUAL(fix.chunk_times.size(), 2);
+    BOOST_CHECK(fix.chunk_times.back() == time_spec_t::from_ticks(2000, SAMP_RATE));
+}
+
+BOOST_AUTO_TEST_CASE(test_capture_future)
+{
+    capture_fixture fix(1000);
+    fix.feed(100);
+
+    // The window is only received after the trigger
+    const time_spec_t start_time = time_spec_t::from_ticks(300, SAMP_RATE);
+    BOOST_REQUIRE(fix.ring->trigger(start_time, 400, fix.collect));
+    for (size_t i = 0; i < 8; i++) {
+        fix.feed(SPP);
+    }
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+
+    const auto result = fix.ring->get_last_export();
+    BOOST_CHECK(result.success);
+    BOOST_CHECK_EQUAL(result.nsamps, 400);
+    BOOST_CHECK(result.start_time == start_time);
+    fix.check_samps(300, 400);
+
+    // The stream stops before the end of the window
+    fix.samps = std::vector<std::vector<uint32_t>>(NUM_CHANS);
+    BOOST_REQUIRE(
+        fix.ring->trigger(time_spec_t::from_ticks(800, SAMP_RATE), 400, fix.collect));
+    fix.feed(SPP);
+    BOOST_REQUIRE(fix.ring->wait_for_export(2.0));
+    BOOST_CHECK(!fix.ring->get_last_export().success);
+    BOOST_CHECK_EQUAL(fix.ring->get_last_export().nsamps, 200);
+    fix.check_samps(800, 200);
+}
+
+BOOST_AUTO_TEST_CASE(test_capture_frozen)
+{
+    capture_fixture fix(1000);
+    fix.feed(500);
+
+    // Block the export, so the window stays frozen
+    std::atomic<bool> blocked{true};
+    auto blocking_collect = [&fix, &blocked](const size_t chan,
+                                const void* buff,
+                                const size_t nsamps,
+                                const time_spec_t& time_spec) {
+        while (blocked) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        fix.collect(chan, buff, nsamps, time_spec);
+    };
+    BOOST_REQUIRE(fix.ring->trigger(time_spec_t(0.0), 500, blocking_collect));
+    BOOST_CHECK(!fix.ring->trigger(time_spec_t(0.0), 500, fix.collect));
+
+    // The ring fills up to the frozen window, the rest is dropped
+    fix.feed(700);
+    BOOST_CHECK_EQUAL(fix.ring->get_num_recvd_samps(), 1000);
+    BOOST_CHECK_EQUAL(fix.ring->get_num_dropped_samps(), 200);
+    BOOST_CHECK(!fix.ring->wait_for_export(0.01));
+
+    blocked = false;
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+    BOOST_CHECK(fix.ring->get_last_export().success);
+    fix.check_samps(0, 500);
+
+    // The dropped samples leave a gap, which the index knows about. The
+    // receive thread may still drop the first packet after the export.
+    fix.feed(2 * SPP);
+    const size_t num_recvd = fix.ring->get_num_recvd_samps();
+    BOOST_REQUIRE(num_recvd == 1100 || num_recvd == 1200);
+    const size_t gap_end = 2400 - num_recvd;
+    fix.samps            = std::vector<std::vector<uint32_t>>(NUM_CHANS);
+    fix.chunk_times.clear();
+    BOOST_REQUIRE(
+        fix.ring->trigger(time_spec_t::from_ticks(900, SAMP_RATE), 500, fix.collect));
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+    BOOST_CHECK(fix.ring->get_last_export().success);
+    BOOST_CHECK_EQUAL(fix.ring->get_last_export().nsamps, 100 + 1400 - gap_end);
+    BOOST_REQUIRE_EQUAL(fix.chunk_times.size(), 2);
+    BOOST_CHECK(fix.chunk_times[1] == time_spec_t::from_ticks(gap_end, SAMP_RATE));
+    BOOST_CHECK_EQUAL(fix.samps[0][99], 999);
+    BOOST_CHECK_EQUAL(fix.samps[0][100], gap_end);
+    BOOST_CHECK_EQUAL(fix.samps[0].back(), 1399);
+}
+
+BOOST_AUTO_TEST_CASE(test_capture_gap)
+{
+    capture_fixture fix(1000);
+    fix.feed(300);
+    fix.rx_stream->skip(200);
+    fix.feed(300);
+
+    // The window starts in the gap
+    BOOST_REQUIRE(
+        fix.ring->trigger(time_spec_t::from_ticks(400, SAMP_RATE), 300, fix.collect));
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+    const auto result = fix.ring->get_last_export();
+    BOOST_CHECK(result.success);
+    BOOST_CHECK_EQUAL(result.nsamps, 200);
+    BOOST_CHECK(result.start_time == time_spec_t::from_ticks(500, SAMP_RATE));
+    fix.check_samps(500, 200);
+}
+
+BOOST_AUTO_TEST_CASE(test_capture_to_file)
+{
+    capture_fixture fix(1000);
+    fix.feed(500);
+
+    const std::string path = "rx_capture_ring_test.dat";
+    BOOST_REQUIRE(fix.ring->trigger(time_spec_t::from_ticks(100, SAMP_RATE), 50, path));
+    BOOST_REQUIRE(fix.ring->wait_for_export(1.0));
+    BOOST_CHECK(fix.ring->get_last_export().success);
+
+    for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+        const std::string filename = path + "." + std::to_string(chan);
+        std::vector<uint32_t> file_samps(51);
+        std::ifstream file(filename.c_str(), std::ifstream::binary);
+        file.read(reinterpret_cast<char*>(file_samps.data()),
+            file_samps.size() * sizeof(uint32_t));
+        BOOST_CHECK_EQUAL(file.gcount(), 50 * sizeof(uint32_t));
+        file.close();
+        std::remove(filename.c_str());
+        for (size_t i = 0; i < 50; i++) {
+            BOOST_CHECK_EQUAL(
+                file_samps[i], uint32_t(100 + i) + (chan ? CHAN1_OFFSET : 0));
+        }
+    }
+}
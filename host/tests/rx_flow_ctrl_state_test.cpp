@@ -0,0 +1,85 @@
+//
+// Copyright 2019 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/rfnoc/rx_flow_ctrl_state.hpp>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace uhd::rfnoc;
+
+namespace {
+
+constexpr size_t PKT_SIZE = 1000;
+const sep_id_pair_t EPIDS = {1, 2};
+const stream_buff_params_t CAPACITY = {64 * PKT_SIZE, MAX_FC_CAPACITY_PKTS};
+const stream_buff_params_t FC_FREQ  = {2 * PKT_SIZE, MAX_FC_FREQ_PKTS};
+
+// Receives and releases num_pkts packets, returns the number of responses sent
+size_t xfer_packets(rx_flow_ctrl_state& fc_state, const size_t num_pkts)
+{
+    size_t num_resps = 0;
+    for (size_t i = 0; i < num_pkts; i++) {
+        fc_state.data_received(PKT_SIZE);
+        fc_state.xfer_done(PKT_SIZE);
+        if (fc_state.fc_resp_due()) {
+            fc_state.fc_resp_sent();
+            num_resps++;
+        }
+    }
+    return num_resps;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fc_resp_freq)
+{
+    rx_flow_ctrl_state fc_state(EPIDS, FC_FREQ);
+
+    // Without coalescing, a response goes out every FC_FREQ bytes
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 64), 32);
+    BOOST_CHECK_EQUAL(fc_state.get_xfer_counts().bytes, 64 * PKT_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(test_fc_resp_count_batching)
+{
+    rx_flow_ctrl_state fc_state(EPIDS, FC_FREQ);
+
+    // Batching below the flow control frequency has no effect
+    fc_state.set_coalescing(CAPACITY, {PKT_SIZE, 0}, std::chrono::microseconds(0));
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 64), 32);
+
+    fc_state.set_coalescing(
+        CAPACITY, {8 * PKT_SIZE, MAX_FC_FREQ_PKTS}, std::chrono::microseconds(0));
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 64), 8);
+
+    // Batching is capped at half the capacity
+    fc_state.set_coalescing(
+        CAPACITY, {CAPACITY.bytes, MAX_FC_FREQ_PKTS}, std::chrono::microseconds(0));
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 64), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_fc_resp_time_batching)
+{
+    rx_flow_ctrl_state fc_state(EPIDS, FC_FREQ);
+    fc_state.set_coalescing(CAPACITY, {0, 0}, std::chrono::milliseconds(50));
+
+    // The first response is due as soon as enough data was transferred
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 2), 1);
+
+    // Further responses are held back until the interval expires
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 8), 0);
+    BOOST_CHECK(!fc_state.fc_resp_urgent());
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    BOOST_CHECK(fc_state.fc_resp_due());
+    fc_state.fc_resp_sent();
+
+    // Responses are never held back once half the capacity is outstanding
+    BOOST_CHECK_EQUAL(xfer_packets(fc_state, 31), 0);
+    fc_state.data_received(PKT_SIZE);
+    fc_state.xfer_done(PKT_SIZE);
+    BOOST_CHECK(fc_state.fc_resp_urgent());
+    BOOST_CHECK(fc_state.fc_resp_due());
+}
@@ -0,0 +1,215 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include "common/mock_rx_streamer.hpp"
+#include <uhd/exception.hpp>
+#include <uhd/utils/rx_shm_ring.hpp>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+
+struct shm_fixture
+{
+    shm_fixture(const size_t capacity)
+        : rx_stream(std::make_shared<mock_rx_streamer>())
+        , publisher(rx_shm_publisher::make(rx_stream, "sc16", SAMP_RATE, capacity))
+    {
+    }
+
+    //! Feed samples and wait until the publisher received all of them
+    void feed(const size_t nsamps)
+    {
+        const uint64_t num_recvd = publisher->get_num_recvd_samps() + nsamps;
+        rx_stream->feed(nsamps);
+        const auto exit_time =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (publisher->get_num_recvd_samps() < num_recvd) {
+            BOOST_REQUIRE(std::chrono::steady_clock::now() < exit_time);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::shared_ptr<mock_rx_streamer> rx_stream;
+    rx_shm_publisher::sptr publisher;
+};
+
+//! Receiver of a consumer, which checks the values of the samples
+struct checked_recv
+{
+    checked_recv(rx_shm_consumer::sptr consumer)
+        : consumer(consumer), samps(NUM_CHANS, std::vector<uint32_t>(10000))
+    {
+    }
+
+    //! Read up to nsamps samples and check that they start at first_samp
+    size_t recv(const size_t nsamps, const size_t first_samp, const double timeout = 0.1)
+    {
+        std::vector<void*> buffs = {samps[0].data(), samps[1].data()};
+        const size_t nsamps_recvd = consumer->recv(buffs, nsamps, md, timeout);
+        if (nsamps_recvd > 0) {
+            BOOST_CHECK(md.has_time_spec);
+            BOOST_CHECK_EQUAL(md.time_spec.to_ticks(SAMP_RATE), first_samp);
+        }
+        for (size_t chan = 0; chan < NUM_CHANS; chan++) {
+            for (size_t i = 0; i < nsamps_recvd; i++) {
+                BOOST_REQUIRE_EQUAL(
+                    samps[chan][i], uint32_t(first_samp + i) + (chan ? CHAN1_OFFSET : 0));
+            }
+        }
+        return nsamps_recvd;
+    }
+
+    rx_shm_consumer::sptr consumer;
+    std::vector<std::vector<uint32_t>> samps;
+    rx_metadata_t md;
+};
+
+} // namespace
+
+#ifdef UHD_PLATFORM_LINUX
+
+BOOST_AUTO_TEST_CASE(test_shm_attach)
+{
+    shm_fixture fix(1000);
+    BOOST_CHECK_EQUAL(fix.publisher->get_num_channels(), NUM_CHANS);
+    BOOST_CHECK_EQUAL(fix.publisher->get_capacity(), 1000);
+    BOOST_CHECK_GE(fix.publisher->get_fd(), 0);
+
+    auto consumer = rx_shm_consumer::make(fix.publisher->get_path());
+    BOOST_CHECK_EQUAL(consumer->get_num_channels(), NUM_CHANS);
+    BOOST_CHECK_EQUAL(consumer->get_capacity(), 1000);
+    BOOST_CHECK_EQUAL(consumer->get_cpu_format(), "sc16");
+    BOOST_CHECK_EQUAL(consumer->get_samp_rate(), SAMP_RATE);
+    BOOST_CHECK(!consumer->is_closed());
+
+    // Attaching through a passed file descriptor
+    auto fd_consumer = rx_shm_consumer::make(
+        "/proc/self/fd/" + std::to_string(fix.publisher->get_fd()));
+    BOOST_CHECK_EQUAL(fd_consumer->get_capacity(), 1000);
+
+    BOOST_CHECK_THROW(rx_shm_consumer::make("/nonexistent"), os_error);
+    BOOST_CHECK_THROW(rx_shm_consumer::make("/proc/self/cmdline"), value_error);
+    BOOST_CHECK_THROW(
+        rx_shm_publisher::make(fix.rx_stream, "sc16", SAMP_RATE, 0), value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_consumers)
+{
+    shm_fixture fix(1000);
+    // Samples published before a consumer attaches are not read
+    fix.feed(50);
+    checked_recv fast(rx_shm_consumer::make(fix.publisher->get_path()));
+    checked_recv slow(rx_shm_consumer::make(fix.publisher->get_path()));
+
+    fix.feed(450);
+    // A consumer gets all available samples at once...
+    BOOST_CHECK_EQUAL(fast.recv(1000, 50), 450);
+    BOOST_CHECK_EQUAL(fast.md.error_code, rx_metadata_t::ERROR_CODE_NONE);
+    // ...or reads at its own pace
+    for (size_t i = 0; i < 15; i++) {
+        BOOST_CHECK_EQUAL(slow.recv(30, 50 + i * 30), 30);
+    }
+
+    fix.feed(100);
+    BOOST_CHECK_EQUAL(fast.recv(1000, 500), 100);
+    BOOST_CHECK_EQUAL(fast.recv(1000, 600, 0.01), 0);
+    BOOST_CHECK_EQUAL(fast.md.error_code, rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK_EQUAL(slow.recv(1000, 500), 100);
+    BOOST_CHECK_EQUAL(fast.consumer->get_num_overruns(), 0);
+    BOOST_CHECK_EQUAL(slow.consumer->get_num_overruns(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_wait)
+{
+    shm_fixture fix(1000);
+    checked_recv consumer(rx_shm_consumer::make(fix.publisher->get_path()));
+
+    // A waiting consumer is woken up by the next packet
+    std::thread feeder([&fix]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        fix.rx_stream->feed(SPP);
+    });
+    BOOST_CHECK_EQUAL(consumer.recv(SPP, 0, 5.0), SPP);
+    feeder.join();
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_overrun)
+{
+    shm_fixture fix(1000);
+    checked_recv consumer(rx_shm_consumer::make(fix.publisher->get_path()));
+
+    // The consumer falls behind, and skips to the newer half of the ring
+    fix.feed(2500);
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 0), 0);
+    BOOST_CHECK_EQUAL(consumer.md.error_code, rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(consumer.consumer->get_num_overruns(), 1);
+
+    std::vector<void*> buffs = {consumer.samps[0].data(), consumer.samps[1].data()};
+    const size_t nsamps_recvd = consumer.consumer->recv(buffs, 1000, consumer.md, 0.1);
+    BOOST_REQUIRE_GT(nsamps_recvd, 0);
+    BOOST_REQUIRE_LE(nsamps_recvd, 500);
+    const size_t first_samp = consumer.samps[0][0];
+    BOOST_CHECK_EQUAL(first_samp + nsamps_recvd, 2500);
+    BOOST_CHECK_EQUAL(consumer.md.time_spec.to_ticks(SAMP_RATE), first_samp);
+
+    fix.feed(100);
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 2500), 100);
+    BOOST_CHECK_EQUAL(consumer.consumer->get_num_overruns(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_gaps)
+{
+    shm_fixture fix(1000);
+    checked_recv consumer(rx_shm_consumer::make(fix.publisher->get_path()));
+
+    fix.feed(200);
+    fix.rx_stream->skip(100, false);
+    fix.feed(100);
+    fix.rx_stream->skip(100, true);
+    fix.feed(100);
+
+    // A call stops before a gap, and overflows of the publisher are reported
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 0), 200);
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 300), 100);
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 0), 0);
+    BOOST_CHECK_EQUAL(consumer.md.error_code, rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 500), 100);
+    BOOST_CHECK_EQUAL(consumer.consumer->get_num_overruns(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_shm_close)
+{
+    shm_fixture fix(1000);
+    checked_recv consumer(rx_shm_consumer::make(fix.publisher->get_path()));
+    fix.feed(100);
+    fix.publisher.reset();
+
+    // The samples can still be read after the publisher is gone
+    BOOST_CHECK(consumer.consumer->is_closed());
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 0), 100);
+    const auto start_time = std::chrono::steady_clock::now();
+    BOOST_CHECK_EQUAL(consumer.recv(1000, 100, 5.0), 0);
+    BOOST_CHECK_EQUAL(consumer.md.error_code, rx_metadata_t::ERROR_CODE_TIMEOUT);
+    BOOST_CHECK(std::chrono::steady_clock::now() - start_time < std::chrono::seconds(1));
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(test_shm_not_implemented)
+{
+    auto rx_stream = std::make_shared<mock_rx_streamer>();
+    BOOST_CHECK_THROW(rx_shm_publisher::make(rx_stream, "sc16", SAMP_RATE, 1000),
+        not_implemented_error);
+    BOOST_CHECK_THROW(rx_shm_consumer::make("ring"), not_implemented_error);
+}
+
+#endif /* UHD_PLATFORM_LINUX */
@@ -9,6 +9,7 @@
 #include <memory>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <thread>
 
 namespace uhd { namespace transport {
 
@@ -53,7 +54,10 @@ public:
         const int32_t timeout_ms)
     {
         frame_buff::uptr buff = _recv_link->get_recv_buff(timeout_ms);
-        mock_header_t header  = *(reinterpret_cast<mock_header_t*>(buff->data()));
+        if (!buff) {
+            return std::make_tuple(std::move(buff), packet_info_t(), false);
+        }
+        mock_header_t header = *(reinterpret_cast<mock_header_t*>(buff->data()));
 
         packet_info_t info;
         info.eob           = header.eob;
@@ -90,6 +94,11 @@ public:
         return _recv_link->get_recv_frame_size() - sizeof(packet_info_t);
     }
 
+    size_t get_num_recv_frames() const
+    {
+        return _recv_link->get_num_recv_frames();
+    }
+
 private:
     mock_recv_link::sptr _recv_link;
     size_t _seq_num = 0;
@@ -108,6 +117,11 @@ public:
 
     void issue_stream_cmd(const stream_cmd_t&) {}
 
+    void issue_channel_stream_cmd(const size_t chan, const stream_cmd_t&)
+    {
+        last_stream_cmd_chan = chan;
+    }
+
     void set_tick_rate(double rate)
     {
         rx_streamer_impl::set_tick_rate(rate);
@@ -122,6 +136,18 @@ public:
     {
         rx_streamer_impl::set_scale_factor(chan, scale_factor);
     }
+
+    void set_stopped_due_to_overrun()
+    {
+        rx_streamer_impl::set_stopped_due_to_overrun();
+    }
+
+    void set_overrun_handler(std::function<void()> handler)
+    {
+        rx_streamer_impl::set_overrun_handler(handler);
+    }
+
+    size_t last_stream_cmd_chan = 0;
 };
 
 }} // namespace uhd::transport
@@ -138,9 +164,10 @@ static const double SCALE_FACTOR = 2;
 /*!
  * Helper functions
  */
-static std::vector<mock_recv_link::sptr> make_links(const size_t num)
+static std::vector<mock_recv_link::sptr> make_links(
+    const size_t num, const size_t num_frames = 1)
 {
-    const mock_recv_link::link_params params = {FRAME_SIZE, 1};
+    const mock_recv_link::link_params params = {FRAME_SIZE, num_frames};
 
     std::vector<mock_recv_link::sptr> links;
 
@@ -154,9 +181,11 @@ static std::vector<mock_recv_link::sptr> make_links(const size_t num)
 static std::shared_ptr<mock_rx_streamer> make_rx_streamer(
     std::vector<mock_recv_link::sptr> recv_links,
     const std::string& host_format,
-    const std::string& otw_format = "sc16")
+    const std::string& otw_format = "sc16",
+    const std::string& args       = "")
 {
-    const uhd::stream_args_t stream_args(host_format, otw_format);
+    uhd::stream_args_t stream_args(host_format, otw_format);
+    stream_args.args = uhd::device_addr_t(args);
     auto streamer = std::make_shared<mock_rx_streamer>(recv_links.size(), stream_args);
     streamer->set_tick_rate(TICK_RATE);
     streamer->set_samp_rate(SAMP_RATE);
@@ -746,6 +775,63 @@ BOOST_AUTO_TEST_CASE(test_recv_alignment_error)
     BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_ALIGNMENT);
 }
 
+BOOST_AUTO_TEST_CASE(test_recv_time_reset)
+{
+    // If the device time is set back while streaming, the packets from before
+    // the time change must not be aligned with the ones after it
+    const std::string format("sc16");
+    const size_t num_chans = 2;
+    const size_t num_samps = 2;
+
+    auto recv_links = make_links(num_chans);
+    auto streamer   = make_rx_streamer(recv_links, format);
+
+    std::vector<std::vector<std::complex<uint16_t>>> buffer(num_chans);
+    std::vector<void*> buffers;
+    for (size_t i = 0; i < num_chans; i++) {
+        buffer[i].resize(num_samps);
+        buffers.push_back(&buffer[i].front());
+    }
+
+    uhd::rx_metadata_t metadata;
+    mock_header_t header;
+    header.has_tsf = true;
+
+    header.tsf = 1000;
+    for (size_t ch = 0; ch < num_chans; ch++) {
+        push_back_recv_packet(recv_links[ch], header, num_samps);
+    }
+    BOOST_CHECK_EQUAL(streamer->recv(buffers, num_samps, metadata, 1.0, true), num_samps);
+    BOOST_CHECK_EQUAL(metadata.time_spec.to_ticks(TICK_RATE), 1000);
+
+    // Channel 0 still has a packet from before the time was reset, channel 1
+    // only has packets after it
+    header.tsf = 1020;
+    push_back_recv_packet(recv_links[0], header, num_samps, 100);
+    for (size_t pkt = 0; pkt < 3; pkt++) {
+        header.tsf = 10 + pkt * 20;
+        for (size_t ch = 0; ch < num_chans; ch++) {
+            push_back_recv_packet(recv_links[ch], header, num_samps, pkt);
+        }
+    }
+
+    // The alignment restarts at the new time. The first packet after the time
+    // change may be dropped while the channels find the new time, but the
+    // old packet must not show up in the output.
+    size_t num_sets = 0;
+    while (streamer->recv(buffers, num_samps, metadata, 0.1, true) == num_samps) {
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        const uint64_t tsf = metadata.time_spec.to_ticks(TICK_RATE);
+        BOOST_CHECK_LT(tsf, 1000);
+        const uint16_t pkt = uint16_t((tsf - 10) / 20);
+        for (size_t ch = 0; ch < num_chans; ch++) {
+            BOOST_CHECK_EQUAL(buffer[ch][0], std::complex<uint16_t>(pkt * 2, pkt * 2 + 1));
+        }
+        num_sets++;
+    }
+    BOOST_CHECK_GE(num_sets, 2);
+}
+
 BOOST_AUTO_TEST_CASE(test_recv_one_channel_one_eov)
 {
     const size_t NUM_PACKETS = 5;
@@ -851,3 +937,397 @@ BOOST_AUTO_TEST_CASE(test_recv_two_channel_aggregate_eov)
         BOOST_CHECK_EQUAL(expected_eov_offsets[i], metadata.eov_positions[i]);
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_recv_bulk_two_channel)
+{
+    const size_t NUM_PACKETS = 8;
+    const std::string format("sc16");
+
+    const size_t num_chans = 2;
+
+    auto recv_links = make_links(num_chans, NUM_PACKETS);
+    auto streamer   = make_rx_streamer(recv_links, format);
+
+    const size_t spp       = streamer->get_max_num_samps();
+    const size_t num_samps = spp * NUM_PACKETS;
+
+    std::vector<std::vector<std::complex<uint16_t>>> buffer(num_chans);
+    std::vector<void*> buffers;
+    for (size_t i = 0; i < num_chans; i++) {
+        buffer[i].resize(num_samps);
+        buffers.push_back(&buffer[i].front());
+    }
+
+    // Push back packets of varying size with eov on the third packet and eob
+    // on the last one
+    std::vector<size_t> pkt_samps;
+    size_t samps_pushed = 0;
+    for (size_t i = 0; i < NUM_PACKETS; i++) {
+        const size_t pkt_size = spp - i;
+        mock_header_t header;
+        header.has_tsf = true;
+        header.tsf     = i * 1000;
+        header.eov     = (i == 2);
+        header.eob     = (i == NUM_PACKETS - 1);
+        for (size_t ch = 0; ch < num_chans; ch++) {
+            push_back_recv_packet(recv_links[ch], header, pkt_size, samps_pushed);
+        }
+        pkt_samps.push_back(pkt_size);
+        samps_pushed += pkt_size;
+    }
+
+    std::vector<uhd::rx_packet_info_t> infos(NUM_PACKETS + 2);
+    uhd::rx_metadata_t metadata;
+
+    const size_t num_pkts_ret = streamer->recv_bulk(
+        buffers, num_samps, metadata, infos.data(), infos.size(), 1.0);
+
+    BOOST_CHECK_EQUAL(num_pkts_ret, NUM_PACKETS);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+    BOOST_CHECK_EQUAL(metadata.has_time_spec, true);
+    BOOST_CHECK_EQUAL(metadata.time_spec.to_ticks(TICK_RATE), 0);
+    BOOST_CHECK_EQUAL(metadata.end_of_burst, true);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < NUM_PACKETS; i++) {
+        BOOST_CHECK_EQUAL(infos[i].offset, offset);
+        BOOST_CHECK_EQUAL(infos[i].num_samps, pkt_samps[i]);
+        BOOST_CHECK_EQUAL(infos[i].has_time_spec, true);
+        BOOST_CHECK_EQUAL(infos[i].time_spec.to_ticks(TICK_RATE), i * 1000);
+        BOOST_CHECK_EQUAL(infos[i].end_of_vector, i == 2);
+        BOOST_CHECK_EQUAL(infos[i].end_of_burst, i == NUM_PACKETS - 1);
+        offset += pkt_samps[i];
+    }
+
+    for (size_t ch = 0; ch < num_chans; ch++) {
+        for (size_t samp = 0; samp < samps_pushed; samp++) {
+            const auto value = std::complex<uint16_t>((samp * 2), (samp * 2 + 1));
+            BOOST_CHECK_EQUAL(value, buffer[ch][samp]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_bulk_limits)
+{
+    // recv_bulk must stop at the number of packets requested, at the number
+    // of packets available, and at the size of the buffer
+    const std::string format("fc32");
+
+    auto recv_links = make_links(1, 4);
+    auto streamer   = make_rx_streamer(recv_links, format);
+
+    const size_t spp = streamer->get_max_num_samps();
+    std::vector<std::complex<float>> buff(spp * 3);
+    std::vector<uhd::rx_packet_info_t> infos(4);
+    uhd::rx_metadata_t metadata;
+
+    for (size_t i = 0; i < 7; i++) {
+        mock_header_t header;
+        push_back_recv_packet(recv_links[0], header, spp);
+    }
+
+    // Limited by max_num_packets
+    size_t num_pkts_ret =
+        streamer->recv_bulk(buff.data(), buff.size(), metadata, infos.data(), 2, 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 2);
+
+    // Limited by buffer size
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 3);
+
+    // Limited by packets available
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 2);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+
+    // Nothing left, timeout
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 0.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    // A buffer smaller than a packet returns a fragment
+    push_back_recv_packet(recv_links[0], mock_header_t(), spp);
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), spp / 2, metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 1);
+    BOOST_CHECK_EQUAL(infos[0].num_samps, spp / 2);
+    BOOST_CHECK_EQUAL(metadata.more_fragments, true);
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 1);
+    BOOST_CHECK_EQUAL(infos[0].num_samps, spp - spp / 2);
+    BOOST_CHECK_EQUAL(metadata.more_fragments, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_bulk_seq_error)
+{
+    // A sequence error after the first packet must end the bulk receive and
+    // be returned by the next call
+    const std::string format("fc32");
+
+    auto recv_links = make_links(1, 4);
+    auto streamer   = make_rx_streamer(recv_links, format);
+
+    const size_t spp = streamer->get_max_num_samps();
+    std::vector<std::complex<float>> buff(spp * 4);
+    std::vector<uhd::rx_packet_info_t> infos(4);
+    uhd::rx_metadata_t metadata;
+
+    mock_header_t header;
+    header.has_tsf    = true;
+    header.ignore_seq = false;
+    for (size_t seq_num : {0, 1, 3}) {
+        header.seq_num = seq_num;
+        header.tsf     = seq_num * spp;
+        push_back_recv_packet(recv_links[0], header, spp);
+    }
+
+    size_t num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 2);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(metadata.out_of_sequence, true);
+
+    num_pkts_ret = streamer->recv_bulk(
+        buff.data(), buff.size(), metadata, infos.data(), infos.size(), 1.0);
+    BOOST_CHECK_EQUAL(num_pkts_ret, 1);
+    BOOST_CHECK_EQUAL(infos[0].time_spec.to_ticks(TICK_RATE), 3 * spp);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_view)
+{
+    const size_t num_chans = 2;
+
+    const size_t num_packets = 3;
+
+    auto recv_links = make_links(num_chans, num_packets);
+    auto streamer   = make_rx_streamer(recv_links, "sc16");
+    BOOST_REQUIRE(streamer->supports_recv_view());
+
+    const size_t spp = streamer->get_max_num_samps();
+    for (size_t i = 0; i < num_packets; i++) {
+        mock_header_t header;
+        header.has_tsf = true;
+        header.tsf     = i * 1000;
+        header.eob     = (i == num_packets - 1);
+        for (size_t ch = 0; ch < num_chans; ch++) {
+            push_back_recv_packet(recv_links[ch], header, spp - i, i * spp);
+        }
+    }
+
+    // Hold a view of every packet, which uses up all frames of the links
+    uhd::rx_metadata_t metadata;
+    std::vector<uhd::rx_view_t> views(num_packets);
+    for (size_t i = 0; i < views.size(); i++) {
+        const size_t num_samps = streamer->recv_view(views[i], metadata, 1.0);
+        BOOST_CHECK_EQUAL(num_samps, spp - i);
+        BOOST_CHECK_EQUAL(views[i].num_samps, spp - i);
+        BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_NONE);
+        BOOST_CHECK_EQUAL(metadata.time_spec.to_ticks(TICK_RATE), i * 1000);
+        BOOST_CHECK_EQUAL(metadata.end_of_burst, i == num_packets - 1);
+        BOOST_REQUIRE_EQUAL(views[i].buffs.size(), num_chans);
+        for (size_t ch = 0; ch < num_chans; ch++) {
+            const auto* samps =
+                static_cast<const std::complex<uint16_t>*>(views[i].buffs[ch]);
+            for (size_t j = 0; j < views[i].num_samps; j++) {
+                const uint16_t value = (i * spp + j) * 2;
+                BOOST_CHECK_EQUAL(samps[j], std::complex<uint16_t>(value, value + 1));
+            }
+        }
+    }
+
+    // No frames are left to receive into
+    uhd::rx_view_t extra_view;
+    BOOST_CHECK_THROW(streamer->recv_view(extra_view, metadata, 0.0), uhd::runtime_error);
+
+    // Views may be released in any order, and their frames are returned to
+    // the links
+    streamer->release_view(views[1]);
+    BOOST_CHECK(views[1].buffs.empty());
+    BOOST_CHECK_EQUAL(views[1].num_samps, 0);
+    streamer->release_view(views[0]);
+    BOOST_CHECK_THROW(streamer->release_view(views[0]), uhd::value_error);
+
+    mock_header_t header;
+    header.has_tsf = true;
+    header.tsf     = 5000;
+    for (size_t ch = 0; ch < num_chans; ch++) {
+        push_back_recv_packet(recv_links[ch], header, spp);
+    }
+    BOOST_CHECK_EQUAL(streamer->recv_view(views[0], metadata, 1.0), spp);
+    BOOST_CHECK_EQUAL(metadata.time_spec.to_ticks(TICK_RATE), 5000);
+    streamer->release_view(views[0]);
+    streamer->release_view(views[2]);
+
+    BOOST_CHECK_EQUAL(streamer->recv_view(views[0], metadata, 0.0), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_view_fragment)
+{
+    auto recv_links = make_links(1);
+    auto streamer   = make_rx_streamer(recv_links, "sc16");
+
+    const size_t spp = streamer->get_max_num_samps();
+    mock_header_t header;
+    header.has_tsf = true;
+    header.tsf     = 0;
+    push_back_recv_packet(recv_links[0], header, spp);
+
+    // The rest of a packet that recv() read partially is lent out
+    std::vector<std::complex<uint16_t>> buff(spp / 2);
+    uhd::rx_metadata_t metadata;
+    BOOST_CHECK_EQUAL(
+        streamer->recv(buff.data(), buff.size(), metadata, 1.0, true), buff.size());
+    BOOST_CHECK(metadata.more_fragments);
+
+    uhd::rx_view_t view;
+    BOOST_CHECK_EQUAL(streamer->recv_view(view, metadata, 1.0), spp - buff.size());
+    BOOST_CHECK(!metadata.more_fragments);
+    BOOST_CHECK_EQUAL(metadata.fragment_offset, buff.size());
+    BOOST_CHECK_EQUAL(metadata.time_spec.to_ticks(SAMP_RATE), buff.size());
+    const auto* samps = static_cast<const std::complex<uint16_t>*>(view.buffs[0]);
+    const uint16_t value = buff.size() * 2;
+    BOOST_CHECK_EQUAL(samps[0], std::complex<uint16_t>(value, value + 1));
+    streamer->release_view(view);
+
+    // Streamers that convert samples can't lend out their buffers
+    auto fc32_streamer = make_rx_streamer(recv_links, "fc32");
+    BOOST_CHECK(!fc32_streamer->supports_recv_view());
+    BOOST_CHECK_THROW(
+        fc32_streamer->recv_view(view, metadata, 0.0), uhd::not_implemented_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_independent_channels)
+{
+    const size_t num_chans = 2;
+    const size_t spp       = 20;
+    const size_t num_pkts  = 50;
+
+    auto recv_links = make_links(num_chans);
+    auto streamer =
+        make_rx_streamer(recv_links, "sc16", "sc16", "independent_channels=1");
+    BOOST_CHECK_EQUAL(streamer->get_num_channels(), num_chans);
+    BOOST_CHECK_THROW(streamer->get_channel_streamer(num_chans), uhd::index_error);
+
+    // The channels are only received through their own streamers
+    std::vector<std::complex<uint16_t>> buff(spp);
+    uhd::rx_metadata_t metadata;
+    std::vector<void*> buffs(num_chans, buff.data());
+    BOOST_CHECK_THROW(
+        streamer->recv(buffs, spp, metadata, 0.0, true), uhd::runtime_error);
+    BOOST_CHECK(!streamer->supports_recv_view());
+
+    auto chan0 = streamer->get_channel_streamer(0);
+    auto chan1 = streamer->get_channel_streamer(1);
+    BOOST_CHECK_EQUAL(chan0->get_num_channels(), 1);
+    BOOST_CHECK(chan0->supports_recv_view());
+
+    // A channel without packets doesn't stall the other channel
+    mock_header_t header;
+    header.has_tsf = true;
+    push_back_recv_packet(recv_links[0], header, spp);
+    BOOST_CHECK_EQUAL(chan0->recv(buff.data(), spp, metadata, 0.0, true), spp);
+    BOOST_CHECK_EQUAL(chan1->recv(buff.data(), spp, metadata, 0.0, true), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_TIMEOUT);
+
+    // Stream commands only go to the channel they are issued on
+    chan1->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS);
+    BOOST_CHECK_EQUAL(streamer->last_stream_cmd_chan, 1);
+
+    // The channels can be received concurrently, and their time stamps don't
+    // need to match
+    for (size_t chan = 0; chan < num_chans; chan++) {
+        for (size_t i = 0; i < num_pkts; i++) {
+            header.tsf = (chan + 1) * 1000 + i * spp;
+            push_back_recv_packet(recv_links[chan], header, spp, i);
+        }
+    }
+    // Results are checked after the threads are done, because the test
+    // assertions aren't thread-safe
+    std::vector<std::vector<size_t>> num_samps(num_chans);
+    std::vector<std::vector<long long>> ticks(num_chans);
+    std::vector<std::vector<uint16_t>> values(num_chans);
+    auto recv_channel = [&](const size_t chan) {
+        auto chan_streamer = streamer->get_channel_streamer(chan);
+        std::vector<std::complex<uint16_t>> chan_buff(spp);
+        uhd::rx_metadata_t chan_metadata;
+        for (size_t i = 0; i < num_pkts; i++) {
+            num_samps[chan].push_back(
+                chan_streamer->recv(chan_buff.data(), spp, chan_metadata, 1.0, true));
+            ticks[chan].push_back(chan_metadata.time_spec.to_ticks(TICK_RATE));
+            values[chan].push_back(chan_buff[0].real());
+        }
+    };
+    std::thread thread0(recv_channel, 0);
+    std::thread thread1(recv_channel, 1);
+    thread0.join();
+    thread1.join();
+
+    for (size_t chan = 0; chan < num_chans; chan++) {
+        for (size_t i = 0; i < num_pkts; i++) {
+            BOOST_CHECK_EQUAL(num_samps[chan][i], spp);
+            BOOST_CHECK_EQUAL(ticks[chan][i], (chan + 1) * 1000 + i * spp);
+            BOOST_CHECK_EQUAL(values[chan][i], i * 2);
+        }
+    }
+
+    // After an overrun, streaming is restarted once all channels have read
+    // their buffered packets
+    size_t num_restarts = 0;
+    streamer->set_overrun_handler([&num_restarts]() { num_restarts++; });
+    streamer->set_stopped_due_to_overrun();
+    push_back_recv_packet(recv_links[1], header, spp);
+    BOOST_CHECK_EQUAL(chan0->recv(buff.data(), spp, metadata, 0.0, true), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(num_restarts, 0);
+    BOOST_CHECK_EQUAL(chan1->recv(buff.data(), spp, metadata, 0.0, true), spp);
+    BOOST_CHECK_EQUAL(chan1->recv(buff.data(), spp, metadata, 0.0, true), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(num_restarts, 1);
+
+    // Channel streamers can outlive their parent, but can no longer be
+    // controlled through it
+    streamer->set_stopped_due_to_overrun();
+    streamer.reset();
+    BOOST_CHECK_THROW(
+        chan1->issue_stream_cmd(uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS),
+        uhd::runtime_error);
+    BOOST_CHECK_EQUAL(chan0->recv(buff.data(), spp, metadata, 0.0, true), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(chan1->recv(buff.data(), spp, metadata, 0.0, true), 0);
+    BOOST_CHECK_EQUAL(metadata.error_code, uhd::rx_metadata_t::ERROR_CODE_OVERFLOW);
+    BOOST_CHECK_EQUAL(num_restarts, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_recv_independent_channels_disabled)
+{
+    // The stream arg is a boolean, setting it to 0 keeps the channels aligned
+    auto recv_links = make_links(2);
+    auto streamer = make_rx_streamer(recv_links, "sc16", "sc16", "independent_channels=0");
+    BOOST_CHECK_THROW(streamer->get_channel_streamer(0), uhd::not_implemented_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_flow_control_stats)
+{
+    // Streamers without flow control don't report statistics
+    auto recv_links = make_links(1);
+    auto streamer   = make_rx_streamer(recv_links, "sc16", "sc16");
+    const uhd::rx_streamer& public_streamer = *streamer;
+    BOOST_CHECK_THROW(
+        public_streamer.get_flow_control_stats(), uhd::not_implemented_error);
+
+    uhd::rx_streamer::flow_control_stats_t stats;
+    BOOST_CHECK_EQUAL(stats.get_resps_per_mb(), 0.0);
+    stats.num_resps_sent     = 5;
+    stats.num_bytes_received = 2000000;
+    BOOST_CHECK_EQUAL(stats.get_resps_per_mb(), 2.5);
+}
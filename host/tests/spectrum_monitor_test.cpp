@@ -0,0 +1,168 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/spectrum_monitor.hpp>
+#include <uhdlib/utils/fft.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using fc32_t = std::complex<float>;
+
+namespace {
+
+//! Reference DFT, computed in double precision
+std::vector<std::complex<double>> ref_dft(const std::vector<fc32_t>& samps)
+{
+    const size_t N = samps.size();
+    std::vector<std::complex<double>> result(N);
+    for (size_t k = 0; k < N; k++) {
+        std::complex<double> sum = 0;
+        for (size_t n = 0; n < N; n++) {
+            const double theta = -2.0 * M_PI * double((k * n) % N) / N;
+            sum += std::complex<double>(samps[n]) * std::polar(1.0, theta);
+        }
+        result[k] = sum;
+    }
+    return result;
+}
+
+std::vector<fc32_t> make_noise(const size_t nsamps, const float amplitude = 0.5f)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+    std::vector<fc32_t> samps(nsamps);
+    for (auto& samp : samps) {
+        samp = fc32_t(dist(gen), dist(gen));
+    }
+    return samps;
+}
+
+std::vector<fc32_t> make_tone(
+    const size_t nsamps, const double bin, const size_t fft_size)
+{
+    std::vector<fc32_t> samps(nsamps);
+    for (size_t n = 0; n < nsamps; n++) {
+        samps[n] = std::polar(1.0f, float(2.0 * M_PI * bin * n / fft_size));
+    }
+    return samps;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_fft_vs_dft)
+{
+    for (size_t size = 1; size <= 2048; size *= 2) {
+        const auto samps = make_noise(size);
+        const auto ref   = ref_dft(samps);
+        auto data        = samps;
+        uhd::fft fft(size);
+        BOOST_CHECK_EQUAL(fft.size(), size);
+        fft.execute(data.data());
+        double max_err = 0;
+        for (size_t k = 0; k < size; k++) {
+            max_err =
+                std::max(max_err, std::abs(std::complex<double>(data[k]) - ref[k]));
+        }
+        // Errors grow with log(size) for an FFT, so this is a generous limit
+        BOOST_CHECK_MESSAGE(max_err < 1e-4 * std::sqrt(double(size)),
+            "size=" << size << " err=" << max_err);
+    }
+
+    BOOST_CHECK_THROW(uhd::fft(0), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::fft(48), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_spectrum_monitor_tone)
+{
+    constexpr size_t FFT_SIZE = 256;
+    auto monitor              = uhd::spectrum_monitor::make(FFT_SIZE);
+    BOOST_CHECK_EQUAL(monitor->get_fft_size(), FFT_SIZE);
+    BOOST_CHECK(monitor->get_psd().empty());
+
+    // A full-scale tone centered on a bin
+    const auto samps = make_tone(FFT_SIZE, 16, FFT_SIZE);
+    std::vector<float> psd(FFT_SIZE);
+    monitor->compute_psd(samps.data(), psd.data());
+    const auto peak = std::max_element(psd.begin(), psd.end());
+    BOOST_CHECK_EQUAL(peak - psd.begin(), 16);
+    // Blackman-Harris sidelobes are below -92 dB
+    BOOST_CHECK_LT(psd[16 + 8], *peak - 90);
+    BOOST_CHECK_LT(psd[FFT_SIZE - 16], *peak - 90);
+    // compute_psd() does not change the monitor's state
+    BOOST_CHECK_EQUAL(monitor->get_num_psds(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_spectrum_monitor_stream)
+{
+    constexpr size_t FFT_SIZE = 64;
+    constexpr size_t NUM_AVGS = 4;
+    auto monitor              = uhd::spectrum_monitor::make(
+        FFT_SIZE, uhd::spectrum_monitor::WINDOW_HANN, NUM_AVGS);
+    BOOST_CHECK_EQUAL(monitor->get_num_averages(), NUM_AVGS);
+
+    // Feed the samples in odd chunk sizes, this must not change the result
+    const auto samps = make_noise(FFT_SIZE * NUM_AVGS * 2);
+    size_t offset    = 0;
+    for (const size_t chunk : {1, 63, 100, 64, 200}) {
+        monitor->push(samps.data() + offset, chunk);
+        offset += chunk;
+    }
+    BOOST_REQUIRE_EQUAL(offset, FFT_SIZE * NUM_AVGS * 2 - 84);
+    BOOST_CHECK_EQUAL(monitor->get_num_psds(), 1);
+    monitor->push(samps.data() + offset, samps.size() - offset);
+    BOOST_CHECK_EQUAL(monitor->get_num_psds(), 2);
+    const auto psd = monitor->get_psd();
+    BOOST_REQUIRE_EQUAL(psd.size(), FFT_SIZE);
+
+    // Compare with the average of the single-frame PSDs of the last estimate
+    std::vector<double> ref_pwr(FFT_SIZE, 0.0);
+    std::vector<float> frame_psd(FFT_SIZE);
+    for (size_t i = NUM_AVGS; i < 2 * NUM_AVGS; i++) {
+        monitor->compute_psd(samps.data() + i * FFT_SIZE, frame_psd.data());
+        for (size_t k = 0; k < FFT_SIZE; k++) {
+            ref_pwr[k] += std::pow(10.0, frame_psd[k] / 10.0) / NUM_AVGS;
+        }
+    }
+    for (size_t k = 0; k < FFT_SIZE; k++) {
+        BOOST_CHECK_CLOSE(psd[k], 10 * std::log10(ref_pwr[k]), 0.01);
+    }
+
+    monitor->reset();
+    BOOST_CHECK(monitor->get_psd().empty());
+    monitor->set_num_averages(1);
+    monitor->push(samps.data(), FFT_SIZE - 1);
+    BOOST_CHECK(monitor->get_psd().empty());
+    monitor->push(samps.data(), 1);
+    BOOST_CHECK_EQUAL(monitor->get_psd().size(), FFT_SIZE);
+
+    BOOST_CHECK_THROW(monitor->set_num_averages(0), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::spectrum_monitor::make(1000), uhd::value_error);
+    BOOST_CHECK_THROW(uhd::spectrum_monitor::make(1), uhd::value_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_spectrum_monitor_throughput)
+{
+    constexpr size_t FFT_SIZE  = 1024;
+    constexpr size_t NUM_SAMPS = 1 << 24;
+    auto monitor               = uhd::spectrum_monitor::make(FFT_SIZE);
+    const auto samps           = make_noise(FFT_SIZE * 64);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < NUM_SAMPS / samps.size(); i++) {
+        monitor->push(samps.data(), samps.size());
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    BOOST_CHECK_EQUAL(monitor->get_num_psds(), NUM_SAMPS / FFT_SIZE);
+    std::cout << "Spectrum monitor throughput (" << FFT_SIZE
+              << " bins): " << NUM_SAMPS / elapsed.count() / 1e6 << " Msps" << std::endl;
+}
@@ -83,6 +83,11 @@ public:
         return _buff_size;
     }
 
+    size_t get_num_recv_frames() const
+    {
+        return 1;
+    }
+
 private:
     size_t _buff_size;
     buff_t::uptr _buff;
@@ -104,6 +109,7 @@ public:
         std::vector<uint8_t> data;
 
         void set_packet_size(const size_t) {}
+        void set_gather_payload(const void*, const size_t) {}
     };
 
     struct packet_info_t
@@ -144,6 +150,13 @@ public:
         return _buff_size - sizeof(packet_info_t);
     }
 
+    bool supports_send_gather() const
+    {
+        return false;
+    }
+
+    void flush_send_buffs() {}
+
 private:
     size_t _buff_size;
     buff_t::uptr _buff;
@@ -417,7 +430,9 @@ void benchmark_tx_streamer(tx_streamer::sptr streamer,
 int UHD_SAFE_MAIN(int argc, char* argv[])
 {
     po::options_description desc("Allowed options");
-    desc.add_options()("help", "help message");
+    size_t spp;
+    desc.add_options()("help", "help message")(
+        "spp", po::value<size_t>(&spp)->default_value(1000), "samples per packet");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -434,7 +449,6 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     }
 
     const char* formats[] = {"sc16", "fc32", "fc64"};
-    constexpr size_t spp  = 1000;
     std::cout << "spp: " << spp << "\n";
 
     std::cout << "----------------------------------------------------------\n";
@@ -505,5 +519,27 @@ int UHD_SAFE_MAIN(int argc, char* argv[])
     }
     std::cout << "\n";
 
+    std::cout << "----------------------------------------------------------\n";
+    std::cout << "Benchmark of recv and send with small packets             \n";
+    std::cout << "                                                          \n";
+    std::cout << "   Measures time spent in the streamers only, with mock   \n";
+    std::cout << "   transports. With small packets, the per-packet cost of \n";
+    std::cout << "   the conversion dominates.                              \n";
+    std::cout << "----------------------------------------------------------\n";
+
+    for (const size_t small_spp : {8, 32, 128}) {
+        std::cout << "*** recv, spp: " << small_spp << " ***\n";
+        for (size_t i = 0; i < std::extent<decltype(formats)>::value; i++) {
+            auto streamer = make_rx_streamer_mock_xport(small_spp, formats[i]);
+            benchmark_rx_streamer(streamer, small_spp, formats[i]);
+        }
+        std::cout << "*** send, spp: " << small_spp << " ***\n";
+        for (size_t i = 0; i < std::extent<decltype(formats)>::value; i++) {
+            auto streamer = make_tx_streamer_mock_xport(small_spp, formats[i]);
+            benchmark_tx_streamer(streamer, small_spp, formats[i], false);
+        }
+        std::cout << "\n";
+    }
+
     return EXIT_SUCCESS;
 }
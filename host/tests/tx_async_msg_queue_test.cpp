@@ -0,0 +1,164 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/config.hpp>
+#include <uhdlib/rfnoc/tx_async_msg_queue.hpp>
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <vector>
+#ifdef UHD_PLATFORM_LINUX
+#    include <poll.h>
+#    include <unistd.h>
+#endif
+
+using namespace uhd;
+using namespace uhd::rfnoc;
+
+namespace {
+
+constexpr size_t QUEUE_SIZE = 16;
+
+async_metadata_t make_msg(const size_t channel)
+{
+    async_metadata_t md;
+    md.channel    = channel;
+    md.event_code = async_metadata_t::EVENT_CODE_UNDERFLOW;
+    return md;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_queue_overflow)
+{
+    tx_async_msg_queue queue(QUEUE_SIZE);
+    async_metadata_t md;
+    BOOST_CHECK(!queue.recv_async_msg(md, 0));
+
+    // Fill the queue and more, the oldest messages are dropped
+    for (size_t i = 0; i < 3 * QUEUE_SIZE; i++) {
+        queue.enqueue(make_msg(i));
+    }
+    const size_t num_dropped = queue.get_num_dropped();
+    BOOST_CHECK_GE(num_dropped, 2 * QUEUE_SIZE - 1);
+    for (size_t i = num_dropped; i < 3 * QUEUE_SIZE; i++) {
+        BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+        BOOST_CHECK_EQUAL(md.channel, i);
+    }
+    BOOST_CHECK(!queue.recv_async_msg(md, 0));
+
+    // Messages from several threads are all counted
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&queue]() {
+            for (size_t i = 0; i < 1000; i++) {
+                queue.enqueue(make_msg(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    size_t num_recvd = 0;
+    while (queue.recv_async_msg(md, 0)) {
+        num_recvd++;
+    }
+    BOOST_CHECK_LE(num_recvd, QUEUE_SIZE);
+    BOOST_CHECK_EQUAL(num_recvd + queue.get_num_dropped() - num_dropped, 4000);
+}
+
+BOOST_AUTO_TEST_CASE(test_queue_callback)
+{
+    tx_async_msg_queue queue(QUEUE_SIZE);
+    queue.enqueue(make_msg(0));
+
+    std::vector<size_t> channels;
+    queue.set_callback(
+        [&channels](const async_metadata_t& md) { channels.push_back(md.channel); });
+    for (size_t i = 1; i < 3 * QUEUE_SIZE; i++) {
+        queue.enqueue(make_msg(i));
+    }
+    // Messages are passed to the callback, and never dropped
+    BOOST_REQUIRE_EQUAL(channels.size(), 3 * QUEUE_SIZE - 1);
+    for (size_t i = 0; i < channels.size(); i++) {
+        BOOST_CHECK_EQUAL(channels[i], i + 1);
+    }
+    BOOST_CHECK_EQUAL(queue.get_num_dropped(), 0);
+
+    // The message queued before the callback was set is still available
+    async_metadata_t md;
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 0);
+    BOOST_CHECK(!queue.recv_async_msg(md, 0));
+
+    // Removing the callback queues messages again
+    queue.set_callback(tx_async_msg_queue::callback_t());
+    queue.enqueue(make_msg(42));
+    BOOST_CHECK_EQUAL(channels.size(), 3 * QUEUE_SIZE - 1);
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 42);
+}
+
+#ifdef UHD_PLATFORM_LINUX
+BOOST_AUTO_TEST_CASE(test_queue_event_fd)
+{
+    tx_async_msg_queue queue(QUEUE_SIZE);
+    const int fd = queue.get_event_fd();
+    BOOST_REQUIRE_GE(fd, 0);
+    BOOST_CHECK_EQUAL(queue.get_event_fd(), fd);
+
+    pollfd pfd;
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+
+    // A message from another thread wakes up the poll
+    std::thread sender([&queue]() { queue.enqueue(make_msg(1)); });
+    BOOST_REQUIRE_EQUAL(::poll(&pfd, 1, 1000), 1);
+    sender.join();
+    queue.enqueue(make_msg(2));
+
+    // The counter tells how many messages were queued
+    uint64_t count = 0;
+    BOOST_REQUIRE_EQUAL(::read(fd, &count, sizeof(count)), sizeof(count));
+    BOOST_CHECK_EQUAL(count, 2);
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+    async_metadata_t md;
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 1);
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 2);
+    BOOST_CHECK(!queue.recv_async_msg(md, 0));
+}
+
+BOOST_AUTO_TEST_CASE(test_queue_event_fd_pending_msgs)
+{
+    // Messages queued before the fd is requested make it readable right away
+    tx_async_msg_queue queue(QUEUE_SIZE);
+    queue.enqueue(make_msg(1));
+    queue.enqueue(make_msg(2));
+    const int fd = queue.get_event_fd();
+    BOOST_REQUIRE_GE(fd, 0);
+
+    pollfd pfd;
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    BOOST_REQUIRE_EQUAL(::poll(&pfd, 1, 0), 1);
+    uint64_t count = 0;
+    BOOST_REQUIRE_EQUAL(::read(fd, &count, sizeof(count)), sizeof(count));
+    BOOST_CHECK_EQUAL(count, 1);
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+
+    async_metadata_t md;
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 1);
+    BOOST_REQUIRE(queue.recv_async_msg(md, 0));
+    BOOST_CHECK_EQUAL(md.channel, 2);
+
+    // Requesting the fd again doesn't signal it again
+    BOOST_CHECK_EQUAL(queue.get_event_fd(), fd);
+    BOOST_CHECK_EQUAL(::poll(&pfd, 1, 0), 0);
+}
+#endif
@@ -0,0 +1,224 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/tx_burst_scheduler.hpp>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <vector>
+
+using namespace uhd;
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+using burst_info_t = tx_burst_scheduler::burst_info_t;
+
+constexpr double LEAD_TIME = 0.02;
+
+/*!
+ * Mock tx streamer which records the send() calls. Samples are uint32_t (the
+ * size of sc16), so the tests can check where a call started by value.
+ */
+class mock_tx_streamer : public tx_streamer
+{
+public:
+    struct send_call_t
+    {
+        steady_clock::time_point host_time;
+        size_t nsamps;
+        uint32_t first_samp;
+        tx_metadata_t md;
+    };
+
+    mock_tx_streamer(const size_t max_samps_per_call)
+        : _max_samps_per_call(max_samps_per_call)
+    {
+    }
+
+    size_t get_num_channels(void) const
+    {
+        return 1;
+    }
+
+    size_t get_max_num_samps(void) const
+    {
+        return _max_samps_per_call;
+    }
+
+    size_t send(
+        const buffs_type& buffs, const size_t nsamps, const tx_metadata_t& md, double)
+    {
+        // Pretend there is no credit for the first call of every burst
+        if (md.start_of_burst && !_refused_sob) {
+            _refused_sob = true;
+            return 0;
+        }
+        _refused_sob = false;
+
+        send_call_t call;
+        call.host_time  = steady_clock::now();
+        call.nsamps     = std::min(nsamps, _max_samps_per_call);
+        call.first_samp = nsamps ? *static_cast<const uint32_t*>(buffs[0]) : 0;
+        call.md         = md;
+        calls.push_back(call);
+        return call.nsamps;
+    }
+
+    bool recv_async_msg(async_metadata_t&, double)
+    {
+        return false;
+    }
+
+    std::vector<send_call_t> calls;
+
+private:
+    const size_t _max_samps_per_call;
+    bool _refused_sob = false;
+};
+
+std::vector<uint32_t> make_burst(const uint32_t marker, const size_t nsamps)
+{
+    std::vector<uint32_t> samps(nsamps);
+    for (size_t i = 0; i < nsamps; i++) {
+        samps[i] = marker * 1000 + i;
+    }
+    return samps;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_schedule_in_order)
+{
+    auto tx_stream        = std::make_shared<mock_tx_streamer>(40);
+    const auto start_time = steady_clock::now();
+    auto sched = tx_burst_scheduler::make(tx_stream, "sc16", time_spec_t(1.0), LEAD_TIME);
+    std::vector<burst_info_t> infos;
+    sched->set_burst_callback(
+        [&infos](const burst_info_t& info) { infos.push_back(info); });
+
+    // Schedule out of order, bursts 0 and 3 have the same time
+    const std::vector<double> burst_times = {1.1, 1.05, 1.15, 1.1};
+    for (size_t i = 0; i < burst_times.size(); i++) {
+        const auto samps = make_burst(i, 100);
+        BOOST_CHECK_EQUAL(
+            sched->schedule(samps.data(), samps.size(), time_spec_t(burst_times[i])),
+            i);
+    }
+    BOOST_CHECK(sched->get_num_pending() > 0);
+    BOOST_REQUIRE(sched->wait_idle(2.0));
+    BOOST_CHECK_EQUAL(sched->get_num_pending(), 0);
+
+    // Each burst is split into three calls, the first one carries the time
+    const std::vector<uint32_t> expected_order = {1, 0, 3, 2};
+    BOOST_REQUIRE_EQUAL(tx_stream->calls.size(), 3 * expected_order.size());
+    BOOST_REQUIRE_EQUAL(infos.size(), expected_order.size());
+    for (size_t i = 0; i < expected_order.size(); i++) {
+        const uint32_t burst = expected_order[i];
+        for (size_t j = 0; j < 3; j++) {
+            const auto& call = tx_stream->calls[3 * i + j];
+            BOOST_CHECK_EQUAL(call.first_samp, burst * 1000 + 40 * j);
+            BOOST_CHECK_EQUAL(call.nsamps, j < 2 ? 40 : 20);
+            BOOST_CHECK_EQUAL(call.md.start_of_burst, j == 0);
+            BOOST_CHECK_EQUAL(call.md.has_time_spec, j == 0);
+            BOOST_CHECK(call.md.end_of_burst);
+        }
+        const auto& first_call = tx_stream->calls[3 * i];
+        BOOST_CHECK(first_call.md.time_spec == time_spec_t(burst_times[burst]));
+
+        // Not sent before the burst is due (with some tolerance for the
+        // resolution of the clock)
+        const std::chrono::duration<double> elapsed = first_call.host_time - start_time;
+        BOOST_CHECK_GE(elapsed.count(), burst_times[burst] - 1.0 - LEAD_TIME - 0.001);
+
+        BOOST_CHECK_EQUAL(infos[i].burst_id, burst);
+        BOOST_CHECK_EQUAL(infos[i].nsamps, 100);
+        BOOST_CHECK_EQUAL(infos[i].nsamps_sent, 100);
+        BOOST_CHECK(!infos[i].dropped);
+        BOOST_CHECK_LE(infos[i].lead_time, LEAD_TIME + 0.001);
+    }
+
+    const auto stats = sched->get_stats();
+    BOOST_CHECK_EQUAL(stats.num_sent, 4);
+    BOOST_CHECK_EQUAL(stats.num_dropped, 0);
+    BOOST_CHECK_LE(stats.min_lead_time, stats.avg_lead_time);
+    BOOST_CHECK_LE(stats.avg_lead_time, stats.max_lead_time);
+    sched->reset_stats();
+    BOOST_CHECK_EQUAL(sched->get_stats().num_sent, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_schedule_late)
+{
+    auto tx_stream = std::make_shared<mock_tx_streamer>(1000);
+    auto sched = tx_burst_scheduler::make(tx_stream, "sc16", time_spec_t(1.0), LEAD_TIME);
+    std::vector<burst_info_t> infos;
+    sched->set_burst_callback(
+        [&infos](const burst_info_t& info) { infos.push_back(info); });
+
+    // A burst in the past is dropped, the one after it is sent
+    const auto samps = make_burst(0, 10);
+    sched->schedule(samps.data(), samps.size(), time_spec_t(0.5));
+    sched->schedule(samps.data(), samps.size(), time_spec_t(1.03));
+    BOOST_REQUIRE(sched->wait_idle(2.0));
+
+    BOOST_REQUIRE_EQUAL(infos.size(), 2);
+    BOOST_CHECK(infos[0].dropped);
+    BOOST_CHECK_EQUAL(infos[0].nsamps_sent, 0);
+    BOOST_CHECK_LT(infos[0].lead_time, -0.4);
+    BOOST_CHECK(!infos[1].dropped);
+    BOOST_CHECK_EQUAL(infos[1].nsamps_sent, 10);
+    BOOST_REQUIRE_EQUAL(tx_stream->calls.size(), 1);
+    BOOST_CHECK(tx_stream->calls[0].md.time_spec == time_spec_t(1.03));
+
+    const auto stats = sched->get_stats();
+    BOOST_CHECK_EQUAL(stats.num_sent, 1);
+    BOOST_CHECK_EQUAL(stats.num_dropped, 1);
+
+    // Moving the device time forward makes pending bursts late
+    sched->schedule(samps.data(), samps.size(), time_spec_t(2.0));
+    sched->set_device_time(time_spec_t(3.0));
+    BOOST_REQUIRE(sched->wait_idle(2.0));
+    BOOST_CHECK_EQUAL(sched->get_stats().num_dropped, 2);
+    BOOST_CHECK_EQUAL(tx_stream->calls.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_schedule_stop)
+{
+    auto tx_stream = std::make_shared<mock_tx_streamer>(1000);
+    auto sched = tx_burst_scheduler::make(tx_stream, "sc16", time_spec_t(0.0), LEAD_TIME);
+    const auto samps = make_burst(0, 10);
+    sched->schedule(samps.data(), samps.size(), time_spec_t(100.0));
+    BOOST_CHECK_EQUAL(sched->get_num_pending(), 1);
+    BOOST_CHECK(!sched->wait_idle(0.01));
+
+    // Destroying the scheduler discards the pending bursts
+    const auto start_time = steady_clock::now();
+    sched.reset();
+    BOOST_CHECK(steady_clock::now() - start_time < std::chrono::seconds(1));
+    BOOST_CHECK(tx_stream->calls.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_schedule_invalid)
+{
+    auto tx_stream = std::make_shared<mock_tx_streamer>(1000);
+    BOOST_CHECK_THROW(
+        tx_burst_scheduler::make(tx_stream, "sc16", time_spec_t(0.0), 0.0),
+        uhd::value_error);
+    auto sched = tx_burst_scheduler::make(tx_stream, "sc16", time_spec_t(0.0));
+    BOOST_CHECK_THROW(sched->set_lead_time(-1.0), uhd::value_error);
+    sched->set_lead_time(0.5);
+    BOOST_CHECK_EQUAL(sched->get_lead_time(), 0.5);
+
+    const auto samps = make_burst(0, 10);
+    BOOST_CHECK_THROW(sched->schedule(samps.data(), 0, time_spec_t(1.0)),
+        uhd::value_error);
+    BOOST_CHECK_THROW(
+        sched->schedule(std::vector<const void*>(2, samps.data()),
+            samps.size(),
+            time_spec_t(1.0)),
+        uhd::value_error);
+}
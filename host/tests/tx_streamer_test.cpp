@@ -52,6 +52,16 @@ public:
         _send_link->release_send_buff(std::move(buff));
     }
 
+    bool supports_send_gather() const
+    {
+        return _send_link->supports_send_gather();
+    }
+
+    void flush_send_buffs()
+    {
+        _send_link->flush_send_buffs();
+    }
+
     size_t get_max_payload_size() const
     {
         return _send_link->get_send_frame_size() - sizeof(packet_info_t);
@@ -614,6 +624,82 @@ BOOST_AUTO_TEST_CASE(test_send_two_channel_one_packet)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_send_gather)
+{
+    // When the host format matches the wire format and the links support it,
+    // the payload is sent from the caller's buffer without conversion
+    const size_t num_chans = 2;
+    const std::string format("sc16");
+
+    auto send_links = make_links(num_chans);
+    for (auto& link : send_links) {
+        link->set_supports_send_gather(true);
+    }
+    auto streamer = make_tx_streamer(send_links, format);
+
+    const size_t spp       = streamer->get_max_num_samps();
+    const size_t num_samps = spp * 2 + 7;
+
+    std::vector<std::vector<std::complex<uint16_t>>> buff(num_chans);
+    std::vector<void*> buffs;
+    for (size_t ch = 0; ch < num_chans; ch++) {
+        for (size_t i = 0; i < num_samps; i++) {
+            buff[ch].push_back(std::complex<uint16_t>(i + ch, i * 2));
+        }
+        buffs.push_back(buff[ch].data());
+    }
+
+    uhd::tx_metadata_t metadata;
+    metadata.end_of_burst = true;
+    const size_t num_sent = streamer->send(buffs, num_samps, metadata, 1.0);
+    BOOST_CHECK_EQUAL(num_sent, num_samps);
+
+    for (size_t ch = 0; ch < num_chans; ch++) {
+        BOOST_CHECK_EQUAL(send_links[ch]->get_num_gather_packets(), 3);
+
+        size_t samps_checked = 0;
+        for (size_t pkt = 0; pkt < 3; pkt++) {
+            mock_tx_data_xport::packet_info_t info;
+            std::complex<uint16_t>* data;
+            size_t packet_samps;
+            boost::shared_array<uint8_t> frame_buff;
+
+            std::tie(info, data, packet_samps, frame_buff) =
+                pop_send_packet(send_links[ch]);
+            BOOST_CHECK_EQUAL(packet_samps, pkt < 2 ? spp : 7);
+            BOOST_CHECK_EQUAL(info.eob, pkt == 2);
+            for (size_t j = 0; j < packet_samps; j++) {
+                BOOST_CHECK_EQUAL(data[j], buff[ch][samps_checked + j]);
+            }
+            samps_checked += packet_samps;
+        }
+    }
+
+    // Streamers that convert samples don't use gather sends
+    auto fc32_streamer = make_tx_streamer(send_links, "fc32");
+    std::vector<std::complex<float>> fc32_buff(10);
+    std::vector<void*> fc32_buffs(num_chans, fc32_buff.data());
+    fc32_streamer->send(fc32_buffs, fc32_buff.size(), metadata, 1.0);
+    BOOST_CHECK_EQUAL(send_links[0]->get_num_gather_packets(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_send_flush)
+{
+    // Links that batch packets must be flushed at the end of every send() call
+    auto send_links = make_links(2);
+    auto streamer   = make_tx_streamer(send_links, "fc32");
+
+    std::vector<std::complex<float>> buff(20);
+    std::vector<void*> buffs(2, buff.data());
+    uhd::tx_metadata_t metadata;
+    for (size_t i = 0; i < 3; i++) {
+        streamer->send(buffs, buff.size(), metadata, 1.0);
+        for (auto& link : send_links) {
+            BOOST_CHECK_EQUAL(link->get_num_flushes(), i + 1);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_meta_data_cache)
 {
     auto send_links = make_links(1);
@@ -670,3 +756,53 @@ BOOST_AUTO_TEST_CASE(test_spp)
         BOOST_CHECK_EQUAL(streamer->get_max_num_samps(), max_pyld / sizeof(std::complex<uint16_t>));
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_send_pacing)
+{
+    constexpr double samp_rate = 1e6;
+    constexpr size_t spp       = 100;
+    const double interval      = spp / samp_rate;
+
+    auto send_links = make_links(1);
+    uhd::stream_args_t stream_args("sc16", "sc16");
+    stream_args.args["spp"]       = std::to_string(spp);
+    stream_args.args["tx_pacing"] = "1.0";
+    auto streamer = std::make_shared<mock_tx_streamer>(1, stream_args);
+    streamer->set_tick_rate(TICK_RATE);
+    streamer->set_samp_rate(samp_rate);
+    streamer->connect_channel(0, std::make_unique<mock_tx_data_xport>(send_links[0]));
+
+    // The packets of a burst are spread out to the sample rate, and each one
+    // is flushed on its own
+    std::vector<std::complex<int16_t>> buff(10 * spp);
+    uhd::tx_metadata_t metadata;
+    metadata.end_of_burst = true;
+    streamer->send(buff.data(), buff.size(), metadata, 1.0);
+    BOOST_CHECK_EQUAL(send_links[0]->get_num_packets(), 10);
+    BOOST_CHECK_GE(send_links[0]->get_num_flushes(), 10);
+    // The statistics are available through the public streamer API
+    const uhd::tx_streamer& public_streamer = *streamer;
+    auto stats = public_streamer.get_pacing_stats();
+    BOOST_CHECK_EQUAL(stats.num_gaps, 9);
+    BOOST_CHECK_GE(stats.min_gap, interval * 0.999);
+    BOOST_CHECK_CLOSE(stats.avg_target_gap, interval, 1e-3);
+
+    // The gap between bursts is not counted
+    streamer->send(buff.data(), buff.size(), metadata, 1.0);
+    BOOST_CHECK_EQUAL(streamer->get_pacing_stats().num_gaps, 18);
+
+    // With a deeper bucket, the first packets of a burst are sent
+    // back-to-back
+    stream_args.args["tx_pacing_burst"] = "4";
+    streamer = std::make_shared<mock_tx_streamer>(1, stream_args);
+    streamer->set_tick_rate(TICK_RATE);
+    streamer->set_samp_rate(samp_rate);
+    streamer->connect_channel(0, std::make_unique<mock_tx_data_xport>(send_links[0]));
+    streamer->send(buff.data(), buff.size(), metadata, 1.0);
+    stats = streamer->get_pacing_stats();
+    BOOST_CHECK_EQUAL(stats.num_gaps, 9);
+    BOOST_CHECK_LT(stats.min_gap, interval);
+
+    stream_args.args["tx_pacing"] = "0";
+    BOOST_CHECK_THROW(mock_tx_streamer(1, stream_args), uhd::value_error);
+}
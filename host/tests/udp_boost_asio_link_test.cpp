@@ -0,0 +1,358 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhdlib/transport/inline_io_service.hpp>
+#include <uhdlib/transport/udp_boost_asio_link.hpp>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include <poll.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+namespace {
+
+constexpr size_t FRAME_SIZE = 1500;
+constexpr size_t NUM_FRAMES = 8;
+
+/*!
+ * A link with GSO and GRO enabled, connected to a regular UDP socket on the
+ * loopback interface
+ */
+struct gso_gro_fixture
+{
+    gso_gro_fixture()
+        : peer(io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        link_params_t params;
+        params.recv_frame_size = FRAME_SIZE;
+        params.send_frame_size = FRAME_SIZE;
+        params.num_recv_frames = NUM_FRAMES;
+        params.num_send_frames = NUM_FRAMES;
+        params.recv_buff_size  = 1 << 20;
+        params.send_buff_size  = 1 << 20;
+        size_t recv_buff_size, send_buff_size;
+        link = udp_boost_asio_link::make("127.0.0.1",
+            std::to_string(peer.local_endpoint().port()),
+            params,
+            recv_buff_size,
+            send_buff_size,
+            true,
+            true);
+        peer.connect(asio::ip::udp::endpoint(
+            asio::ip::address_v4::loopback(), link->get_local_port()));
+    }
+
+    void send(const size_t len, const uint8_t value)
+    {
+        auto buff = link->get_send_buff(1000);
+        BOOST_REQUIRE(buff);
+        std::fill_n(static_cast<uint8_t*>(buff->data()), len, value);
+        buff->set_packet_size(len);
+        link->release_send_buff(std::move(buff));
+    }
+
+    void check_peer_recv(const size_t len, const uint8_t value)
+    {
+        std::vector<uint8_t> recv_buf(FRAME_SIZE);
+        BOOST_REQUIRE_EQUAL(peer.receive(asio::buffer(recv_buf)), len);
+        for (size_t i = 0; i < len; i++) {
+            BOOST_REQUIRE_EQUAL(recv_buf[i], value);
+        }
+    }
+
+    //! Send datagrams of the given sizes with a single GSO send. Datagram i
+    //! is filled with first_value + i.
+    void peer_send_gso(const std::vector<size_t>& lens, const uint8_t first_value)
+    {
+        std::vector<std::vector<uint8_t>> packets;
+        std::vector<iovec> iovs;
+        size_t num_bytes = 0;
+        for (size_t i = 0; i < lens.size(); i++) {
+            packets.emplace_back(lens[i], static_cast<uint8_t>(first_value + i));
+            num_bytes += lens[i];
+        }
+        for (auto& packet : packets) {
+            iovec iov;
+            iov.iov_base = packet.data();
+            iov.iov_len  = packet.size();
+            iovs.push_back(iov);
+        }
+        BOOST_REQUIRE(send_udp_packets_gso(
+            peer.native_handle(), iovs.data(), iovs.size(), num_bytes, lens[0]));
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket peer;
+    udp_boost_asio_link::sptr link;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(test_gso_send, gso_gro_fixture)
+{
+    if (!link->is_gso_enabled()) {
+        std::cout << "Skipping test, UDP GSO is not available" << std::endl;
+        return;
+    }
+
+    // Packets of equal size are held back until the link is flushed, and
+    // arrive as separate datagrams
+    for (size_t i = 0; i < 3; i++) {
+        send(100, i);
+    }
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+    link->flush_send_buffs();
+    for (size_t i = 0; i < 3; i++) {
+        check_peer_recv(100, i);
+    }
+
+    // A shorter packet ends the batch
+    for (size_t i = 0; i < 3; i++) {
+        send(100, i);
+    }
+    send(40, 3);
+    for (size_t i = 0; i < 3; i++) {
+        check_peer_recv(100, i);
+    }
+    check_peer_recv(40, 3);
+
+    // A longer packet is sent in the next batch
+    send(50, 0);
+    send(50, 1);
+    send(100, 2);
+    check_peer_recv(50, 0);
+    check_peer_recv(50, 1);
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+    link->flush_send_buffs();
+    check_peer_recv(100, 2);
+
+    // Sending more packets than there are frames reuses the memory of sent
+    // batches
+    for (size_t i = 0; i < 4 * NUM_FRAMES; i++) {
+        send(FRAME_SIZE, i);
+    }
+    link->flush_send_buffs();
+    for (size_t i = 0; i < 4 * NUM_FRAMES; i++) {
+        check_peer_recv(FRAME_SIZE, i);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_gso_send_gather, gso_gro_fixture)
+{
+    if (!link->is_gso_enabled()) {
+        std::cout << "Skipping test, UDP GSO is not available" << std::endl;
+        return;
+    }
+    BOOST_REQUIRE(link->supports_send_gather());
+
+    // A gather payload is owned by the caller, so the held back packets and
+    // the gather packet are sent right away
+    send(100, 0);
+    send(100, 1);
+    const std::vector<uint8_t> payload(60, 3);
+    auto buff = link->get_send_buff(1000);
+    BOOST_REQUIRE(buff);
+    std::fill_n(static_cast<uint8_t*>(buff->data()), 20, 2);
+    buff->set_packet_size(20);
+    buff->set_gather_payload(payload.data(), payload.size());
+    link->release_send_buff(std::move(buff));
+
+    check_peer_recv(100, 0);
+    check_peer_recv(100, 1);
+    std::vector<uint8_t> recv_buf(FRAME_SIZE);
+    BOOST_REQUIRE_EQUAL(peer.receive(asio::buffer(recv_buf)), 80);
+    for (size_t i = 0; i < 80; i++) {
+        BOOST_CHECK_EQUAL(recv_buf[i], i < 20 ? 2 : 3);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_gso_request_response, gso_gro_fixture)
+{
+    if (!link->is_gso_enabled()) {
+        std::cout << "Skipping test, UDP GSO is not available" << std::endl;
+        return;
+    }
+
+    // Send a single request through an inline I/O service, and wait for the
+    // response, like the flow control setup of a TX streamer does. The
+    // request must not be held back while waiting.
+    auto io_srv = inline_io_service::make();
+    io_srv->attach_send_link(link);
+    io_srv->attach_recv_link(link);
+    auto send_io = io_srv->make_send_client(
+        link,
+        1,
+        [](frame_buff::uptr buff, send_link_if* send_link) {
+            send_link->release_send_buff(std::move(buff));
+        },
+        nullptr,
+        0,
+        nullptr,
+        nullptr);
+    auto recv_io = io_srv->make_recv_client(
+        link,
+        1,
+        [](frame_buff::uptr&, recv_link_if*, send_link_if*) { return true; },
+        nullptr,
+        0,
+        [](frame_buff::uptr buff, recv_link_if* recv_link, send_link_if*) {
+            recv_link->release_recv_buff(std::move(buff));
+        });
+
+    std::thread responder([this]() {
+        pollfd pfd = {peer.native_handle(), POLLIN, 0};
+        if (::poll(&pfd, 1, 1000) == 1) {
+            std::vector<uint8_t> recv_buf(FRAME_SIZE);
+            const size_t len = peer.receive(asio::buffer(recv_buf));
+            peer.send(asio::buffer(recv_buf.data(), len));
+        }
+    });
+
+    for (size_t i = 0; i < 2; i++) {
+        auto buff = send_io->get_send_buff(0);
+        BOOST_REQUIRE(buff);
+        std::fill_n(static_cast<uint8_t*>(buff->data()), 16, uint8_t(i));
+        buff->set_packet_size(16);
+        send_io->release_send_buff(std::move(buff));
+        if (i == 0) {
+            // Response to an unflushed request
+            buff = recv_io->get_recv_buff(200);
+            BOOST_CHECK(buff);
+            if (buff) {
+                BOOST_CHECK_EQUAL(buff->packet_size(), 16);
+                recv_io->release_recv_buff(std::move(buff));
+            }
+        }
+    }
+    responder.join();
+
+    // Polling doesn't flush, so packets are still batched
+    BOOST_CHECK(!recv_io->get_recv_buff(0));
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+    send_io->flush_send_buffs();
+    check_peer_recv(16, 1);
+
+    send_io.reset();
+    recv_io.reset();
+}
+
+BOOST_FIXTURE_TEST_CASE(test_gro_recv, gso_gro_fixture)
+{
+    if (!link->is_gro_enabled()) {
+        std::cout << "Skipping test, UDP GRO is not available" << std::endl;
+        return;
+    }
+    BOOST_CHECK(!link->get_recv_buff(0));
+
+    // The datagrams of a GSO send may arrive coalesced, and must be split
+    // into frames again
+    std::vector<size_t> lens(10, 200);
+    lens.push_back(50);
+    peer_send_gso(lens, 0);
+    for (size_t i = 0; i < lens.size(); i++) {
+        auto buff = link->get_recv_buff(1000);
+        BOOST_REQUIRE(buff);
+        BOOST_REQUIRE_EQUAL(buff->packet_size(), lens[i]);
+        const auto* data = static_cast<const uint8_t*>(buff->data());
+        for (size_t j = 0; j < lens[i]; j++) {
+            BOOST_REQUIRE_EQUAL(data[j], i);
+        }
+        link->release_recv_buff(std::move(buff));
+    }
+    BOOST_CHECK(!link->get_recv_buff(10));
+
+    // Regular datagrams are received as well
+    const std::vector<uint8_t> packet(FRAME_SIZE, 42);
+    peer.send(asio::buffer(packet));
+    auto buff = link->get_recv_buff(1000);
+    BOOST_REQUIRE(buff);
+    BOOST_CHECK_EQUAL(buff->packet_size(), FRAME_SIZE);
+    BOOST_CHECK_EQUAL(static_cast<uint8_t*>(buff->data())[FRAME_SIZE - 1], 42);
+    link->release_recv_buff(std::move(buff));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_gro_release_out_of_order, gso_gro_fixture)
+{
+    if (!link->is_gro_enabled()) {
+        std::cout << "Skipping test, UDP GRO is not available" << std::endl;
+        return;
+    }
+
+    // Hold on to all frames, and release them in reverse order. The memory
+    // of the received datagrams must be reused without overwriting frames
+    // that are still held.
+    const std::vector<size_t> lens(NUM_FRAMES / 2, FRAME_SIZE);
+    for (size_t iteration = 0; iteration < 32; iteration++) {
+        const uint8_t first_value = static_cast<uint8_t>(iteration * NUM_FRAMES);
+        peer_send_gso(lens, first_value);
+        peer_send_gso(lens, first_value + NUM_FRAMES / 2);
+
+        std::vector<frame_buff::uptr> buffs;
+        for (size_t i = 0; i < NUM_FRAMES; i++) {
+            buffs.push_back(link->get_recv_buff(1000));
+            BOOST_REQUIRE(buffs.back());
+            BOOST_REQUIRE_EQUAL(buffs.back()->packet_size(), FRAME_SIZE);
+        }
+        for (size_t i = 0; i < NUM_FRAMES; i++) {
+            const auto* data = static_cast<const uint8_t*>(buffs[i]->data());
+            BOOST_CHECK_EQUAL(data[0], static_cast<uint8_t>(first_value + i));
+            BOOST_CHECK_EQUAL(
+                data[FRAME_SIZE - 1], static_cast<uint8_t>(first_value + i));
+        }
+        while (!buffs.empty()) {
+            link->release_recv_buff(std::move(buffs.back()));
+            buffs.pop_back();
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_gro_hold_frame, gso_gro_fixture)
+{
+    if (!link->is_gro_enabled()) {
+        std::cout << "Skipping test, UDP GRO is not available" << std::endl;
+        return;
+    }
+
+    // A frame that is held keeps the arena from being reused. Receiving must
+    // go on regardless, for many more datagrams than the arena holds.
+    peer_send_gso({FRAME_SIZE}, 0xAA);
+    auto held_buff = link->get_recv_buff(1000);
+    BOOST_REQUIRE(held_buff);
+
+    const std::vector<size_t> lens(NUM_FRAMES / 2, FRAME_SIZE);
+    for (size_t iteration = 0; iteration < 64; iteration++) {
+        const uint8_t first_value = static_cast<uint8_t>(iteration * NUM_FRAMES);
+        peer_send_gso(lens, first_value);
+        for (size_t i = 0; i < lens.size(); i++) {
+            auto buff = link->get_recv_buff(1000);
+            BOOST_REQUIRE(buff);
+            BOOST_REQUIRE_EQUAL(buff->packet_size(), FRAME_SIZE);
+            const auto* data = static_cast<const uint8_t*>(buff->data());
+            BOOST_CHECK_EQUAL(data[0], static_cast<uint8_t>(first_value + i));
+            BOOST_CHECK_EQUAL(
+                data[FRAME_SIZE - 1], static_cast<uint8_t>(first_value + i));
+            link->release_recv_buff(std::move(buff));
+        }
+    }
+
+    const auto* data = static_cast<const uint8_t*>(held_buff->data());
+    BOOST_CHECK_EQUAL(data[0], 0xAA);
+    BOOST_CHECK_EQUAL(data[FRAME_SIZE - 1], 0xAA);
+    link->release_recv_buff(std::move(held_buff));
+
+    // With the held frame released, the arena is used again
+    peer_send_gso(lens, 0);
+    for (size_t i = 0; i < lens.size(); i++) {
+        auto buff = link->get_recv_buff(1000);
+        BOOST_REQUIRE(buff);
+        BOOST_CHECK_EQUAL(static_cast<const uint8_t*>(buff->data())[0], i);
+        link->release_recv_buff(std::move(buff));
+    }
+}
@@ -0,0 +1,232 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhdlib/transport/udp_io_uring_link.hpp>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+#include <vector>
+
+using namespace uhd::transport;
+namespace asio = boost::asio;
+
+namespace {
+
+constexpr size_t FRAME_SIZE = 1500;
+constexpr size_t NUM_FRAMES = 8;
+
+/*!
+ * A link connected to a regular UDP socket on the loopback interface
+ */
+struct io_uring_fixture
+{
+    io_uring_fixture(const bool batch_sends = false)
+        : peer(io_service, asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        link_params_t params;
+        params.recv_frame_size = FRAME_SIZE;
+        params.send_frame_size = FRAME_SIZE;
+        params.num_recv_frames = NUM_FRAMES;
+        params.num_send_frames = NUM_FRAMES;
+        params.recv_buff_size  = 1 << 20;
+        params.send_buff_size  = 1 << 20;
+        size_t recv_buff_size, send_buff_size;
+        try {
+            link = udp_io_uring_link::make("127.0.0.1",
+                std::to_string(peer.local_endpoint().port()),
+                params,
+                recv_buff_size,
+                send_buff_size,
+                batch_sends);
+        } catch (const uhd::runtime_error& ex) {
+            std::cout << "Skipping test, io_uring is not available: " << ex.what()
+                      << std::endl;
+            return;
+        }
+        link_endpoint = asio::ip::udp::endpoint(
+            asio::ip::address_v4::loopback(), link->get_local_port());
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket peer;
+    asio::ip::udp::endpoint link_endpoint;
+    udp_io_uring_link::sptr link;
+};
+
+struct io_uring_batch_fixture : public io_uring_fixture
+{
+    io_uring_batch_fixture() : io_uring_fixture(true) {}
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(test_io_uring_send, io_uring_fixture)
+{
+    if (!link) {
+        return;
+    }
+    BOOST_CHECK_EQUAL(link->get_num_send_frames(), NUM_FRAMES);
+    BOOST_CHECK_EQUAL(link->get_send_frame_size(), FRAME_SIZE);
+    BOOST_CHECK(!link->supports_send_gather());
+
+    // Send more packets than there are frames, so frames get reused
+    const size_t num_packets = 4 * NUM_FRAMES;
+    std::vector<uint8_t> recv_buf(FRAME_SIZE);
+    for (size_t i = 0; i < num_packets; i++) {
+        auto buff = link->get_send_buff(1000);
+        BOOST_REQUIRE(buff);
+        auto* data = static_cast<uint8_t*>(buff->data());
+        for (size_t j = 0; j <= i; j++) {
+            data[j] = static_cast<uint8_t>(i + j);
+        }
+        buff->set_packet_size(i + 1);
+        link->release_send_buff(std::move(buff));
+
+        const size_t len = peer.receive(asio::buffer(recv_buf));
+        BOOST_REQUIRE_EQUAL(len, i + 1);
+        for (size_t j = 0; j <= i; j++) {
+            BOOST_REQUIRE_EQUAL(recv_buf[j], static_cast<uint8_t>(i + j));
+        }
+    }
+
+    // Releasing a frame without a packet sends nothing and keeps the frame
+    // available
+    for (size_t i = 0; i < 2 * NUM_FRAMES; i++) {
+        auto buff = link->get_send_buff(0);
+        BOOST_REQUIRE(buff);
+        link->release_send_buff(std::move(buff));
+    }
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_io_uring_send_order, io_uring_fixture)
+{
+    if (!link) {
+        return;
+    }
+    // Packets sent back to back arrive in the order they were released
+    const size_t num_packets = 4 * NUM_FRAMES;
+    for (size_t i = 0; i < num_packets; i++) {
+        auto buff = link->get_send_buff(1000);
+        BOOST_REQUIRE(buff);
+        *static_cast<uint32_t*>(buff->data()) = uint32_t(i);
+        buff->set_packet_size(sizeof(uint32_t));
+        link->release_send_buff(std::move(buff));
+    }
+    uint32_t value;
+    for (size_t i = 0; i < num_packets; i++) {
+        BOOST_REQUIRE_EQUAL(peer.receive(asio::buffer(&value, sizeof(value))),
+            sizeof(value));
+        BOOST_REQUIRE_EQUAL(value, i);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_io_uring_send_batched, io_uring_batch_fixture)
+{
+    if (!link) {
+        return;
+    }
+    BOOST_CHECK(link->is_send_batching_enabled());
+    // Frames are held back until a batch of half the frames is complete
+    const size_t batch_size = NUM_FRAMES / 2;
+    auto send = [this](const uint32_t value) {
+        auto buff = link->get_send_buff(1000);
+        BOOST_REQUIRE(buff);
+        *static_cast<uint32_t*>(buff->data()) = value;
+        buff->set_packet_size(sizeof(value));
+        link->release_send_buff(std::move(buff));
+    };
+    uint32_t value;
+    auto check_recv = [this, &value](const uint32_t expected) {
+        BOOST_REQUIRE_EQUAL(
+            peer.receive(asio::buffer(&value, sizeof(value))), sizeof(value));
+        BOOST_REQUIRE_EQUAL(value, expected);
+    };
+    for (size_t i = 0; i < batch_size - 1; i++) {
+        send(uint32_t(i));
+    }
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+    send(uint32_t(batch_size - 1));
+    for (size_t i = 0; i < batch_size; i++) {
+        check_recv(uint32_t(i));
+    }
+
+    // A flush sends a partial batch
+    send(uint32_t(batch_size));
+    BOOST_CHECK_EQUAL(peer.available(), 0);
+    link->flush_send_buffs();
+    check_recv(uint32_t(batch_size));
+
+    // Frames that are reused many times still go out in order
+    const size_t num_packets = 8 * NUM_FRAMES;
+    for (size_t i = 0; i < num_packets; i++) {
+        send(uint32_t(i));
+    }
+    link->flush_send_buffs();
+    for (size_t i = 0; i < num_packets; i++) {
+        check_recv(uint32_t(i));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(test_io_uring_recv, io_uring_fixture)
+{
+    if (!link) {
+        return;
+    }
+    BOOST_CHECK_EQUAL(link->get_num_recv_frames(), NUM_FRAMES);
+    BOOST_CHECK_EQUAL(link->get_recv_frame_size(), FRAME_SIZE);
+
+    // Nothing was sent yet
+    BOOST_CHECK(!link->get_recv_buff(0));
+    BOOST_CHECK(!link->get_recv_buff(10));
+
+    // Receive more packets than there are frames, so frames get reused
+    const size_t num_packets = 4 * NUM_FRAMES;
+    for (size_t i = 0; i < num_packets; i++) {
+        std::vector<uint8_t> packet(i + 1, static_cast<uint8_t>(i));
+        peer.send_to(asio::buffer(packet), link_endpoint);
+        auto buff = link->get_recv_buff(1000);
+        BOOST_REQUIRE(buff);
+        BOOST_REQUIRE_EQUAL(buff->packet_size(), i + 1);
+        BOOST_REQUIRE_EQUAL(static_cast<uint8_t*>(buff->data())[i], i);
+        link->release_recv_buff(std::move(buff));
+    }
+    BOOST_CHECK(!link->get_recv_buff(0));
+}
+
+BOOST_FIXTURE_TEST_CASE(test_io_uring_recv_all_frames, io_uring_fixture)
+{
+    if (!link) {
+        return;
+    }
+    // Hold on to all frames. The kernel runs out of frames for the next
+    // packets, which must be received once frames are released.
+    const size_t num_packets = 2 * NUM_FRAMES;
+    for (size_t i = 0; i < num_packets; i++) {
+        const uint8_t value = static_cast<uint8_t>(i);
+        peer.send_to(asio::buffer(&value, 1), link_endpoint);
+    }
+    std::vector<frame_buff::uptr> buffs;
+    for (size_t i = 0; i < NUM_FRAMES; i++) {
+        buffs.push_back(link->get_recv_buff(1000));
+        BOOST_REQUIRE(buffs.back());
+        BOOST_CHECK_EQUAL(*static_cast<uint8_t*>(buffs.back()->data()), i);
+    }
+    BOOST_CHECK(!link->get_recv_buff(10));
+    for (auto& buff : buffs) {
+        link->release_recv_buff(std::move(buff));
+    }
+
+    // The packets that found no frame are still queued on the socket and are
+    // received once frames are released
+    for (size_t i = NUM_FRAMES; i < num_packets; i++) {
+        auto buff = link->get_recv_buff(1000);
+        BOOST_REQUIRE(buff);
+        BOOST_CHECK_EQUAL(*static_cast<uint8_t*>(buff->data()), i);
+        link->release_recv_buff(std::move(buff));
+    }
+}
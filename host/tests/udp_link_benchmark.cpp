@@ -0,0 +1,327 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// Benchmark for the UDP links: compares the Boost.Asio link, with and without
+// GSO/GRO, and the io_uring link on the loopback interface. A peer socket in a
+// separate thread sinks, sources or echoes the packets.
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhdlib/transport/udp_boost_asio_link.hpp>
+#ifdef HAVE_IO_URING
+#    include <uhdlib/transport/udp_io_uring_link.hpp>
+#endif
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace po   = boost::program_options;
+namespace asio = boost::asio;
+using namespace uhd::transport;
+
+namespace {
+
+using clock_t = std::chrono::steady_clock;
+
+struct benchmark_params
+{
+    size_t num_packets;
+    size_t packet_size;
+    size_t num_frames;
+    size_t num_pings;
+};
+
+//! Peer socket on the loopback interface
+struct peer_socket
+{
+    peer_socket()
+        : socket(io_service,
+            asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), 0))
+    {
+        socket.set_option(asio::socket_base::receive_buffer_size(1 << 24));
+        socket.set_option(asio::socket_base::send_buffer_size(1 << 24));
+    }
+
+    std::string get_port() const
+    {
+        return std::to_string(socket.local_endpoint().port());
+    }
+
+    asio::io_service io_service;
+    asio::ip::udp::socket socket;
+};
+
+template <typename link_t>
+using link_factory_t = std::function<typename link_t::sptr(
+    const std::string&, const link_params_t&, size_t&, size_t&)>;
+
+//! Benchmarked link type, and how to make it
+template <typename link_t>
+struct link_variant
+{
+    link_factory_t<link_t> make;
+    //! Whether the link receives coalesced datagrams, so the peer should send
+    //! with GSO
+    bool gro;
+};
+
+template <typename link_t>
+typename link_t::sptr make_link(const link_variant<link_t>& variant,
+    const peer_socket& peer,
+    const benchmark_params& bp)
+{
+    link_params_t params;
+    params.recv_frame_size = std::max<size_t>(bp.packet_size, 1500);
+    params.send_frame_size = std::max<size_t>(bp.packet_size, 1500);
+    params.num_recv_frames = bp.num_frames;
+    params.num_send_frames = bp.num_frames;
+    params.recv_buff_size  = 1 << 24;
+    params.send_buff_size  = 1 << 24;
+    size_t recv_buff_size, send_buff_size;
+    return variant.make(peer.get_port(), params, recv_buff_size, send_buff_size);
+}
+
+//! Send packets as fast as possible, returns packets per second
+template <typename link_t>
+double benchmark_send(const link_variant<link_t>& variant, const benchmark_params& bp)
+{
+    peer_socket peer;
+    auto link = make_link(variant, peer, bp);
+
+    std::atomic<size_t> num_received(0);
+    std::atomic<bool> done(false);
+    std::thread sink([&]() {
+        std::vector<uint8_t> buf(bp.packet_size);
+        while (!done) {
+            if (peer.socket.available() == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            peer.socket.receive(asio::buffer(buf));
+            num_received++;
+        }
+    });
+
+    const auto start = clock_t::now();
+    for (size_t i = 0; i < bp.num_packets; i++) {
+        auto buff = link->get_send_buff(1000);
+        if (!buff) {
+            throw uhd::runtime_error("Timed out getting a send frame");
+        }
+        buff->set_packet_size(bp.packet_size);
+        link->release_send_buff(std::move(buff));
+    }
+    link->flush_send_buffs();
+    // Get all frames back, so all sends have completed
+    std::vector<frame_buff::uptr> buffs;
+    for (size_t i = 0; i < link->get_num_send_frames(); i++) {
+        buffs.push_back(link->get_send_buff(1000));
+    }
+    const std::chrono::duration<double> elapsed = clock_t::now() - start;
+    for (auto& buff : buffs) {
+        link->release_send_buff(std::move(buff));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    done = true;
+    sink.join();
+    if (num_received < bp.num_packets) {
+        std::cout << "    (the peer dropped " << bp.num_packets - num_received
+                  << " packets)" << std::endl;
+    }
+    return bp.num_packets / elapsed.count();
+}
+
+//! Receive packets sent by the peer as fast as possible, returns packets per
+//! second
+template <typename link_t>
+double benchmark_recv(const link_variant<link_t>& variant, const benchmark_params& bp)
+{
+    peer_socket peer;
+    auto link = make_link(variant, peer, bp);
+    const asio::ip::udp::endpoint link_endpoint(
+        asio::ip::address_v4::loopback(), link->get_local_port());
+
+    std::atomic<bool> done(false);
+    peer.socket.connect(link_endpoint);
+    std::thread source([&]() {
+        std::vector<uint8_t> buf(bp.packet_size);
+        if (!variant.gro) {
+            while (!done) {
+                peer.socket.send(asio::buffer(buf));
+            }
+            return;
+        }
+        // Send batches of datagrams, which arrive coalesced at the link
+        const size_t num_segments = std::min(UDP_MAX_GSO_SEGMENTS,
+            std::max<size_t>(UDP_MAX_GSO_BYTES / bp.packet_size, 1));
+        std::vector<iovec> iovs(num_segments);
+        for (auto& iov : iovs) {
+            iov.iov_base = buf.data();
+            iov.iov_len  = bp.packet_size;
+        }
+        while (!done) {
+            send_udp_packets_gso(peer.socket.native_handle(),
+                iovs.data(),
+                iovs.size(),
+                num_segments * bp.packet_size,
+                uint16_t(bp.packet_size));
+        }
+    });
+
+    // Wait for the first packet before starting the clock
+    auto buff = link->get_recv_buff(1000);
+    if (!buff) {
+        done = true;
+        source.join();
+        throw uhd::runtime_error("Timed out waiting for the first packet");
+    }
+    link->release_recv_buff(std::move(buff));
+
+    size_t num_received = 0;
+    const auto start    = clock_t::now();
+    while (num_received < bp.num_packets) {
+        buff = link->get_recv_buff(1000);
+        if (!buff) {
+            break;
+        }
+        link->release_recv_buff(std::move(buff));
+        num_received++;
+    }
+    const std::chrono::duration<double> elapsed = clock_t::now() - start;
+    done                                        = true;
+    source.join();
+    return num_received / elapsed.count();
+}
+
+//! Send packets to an echoing peer one at a time, returns the mean round
+//! trip time in seconds
+template <typename link_t>
+double benchmark_ping_pong(
+    const link_variant<link_t>& variant, const benchmark_params& bp)
+{
+    peer_socket peer;
+    auto link = make_link(variant, peer, bp);
+
+    std::thread echo([&]() {
+        std::vector<uint8_t> buf(bp.packet_size);
+        asio::ip::udp::endpoint sender;
+        for (size_t i = 0; i < bp.num_pings; i++) {
+            const size_t len = peer.socket.receive_from(asio::buffer(buf), sender);
+            peer.socket.send_to(asio::buffer(buf.data(), len), sender);
+        }
+    });
+
+    const auto start = clock_t::now();
+    for (size_t i = 0; i < bp.num_pings; i++) {
+        auto send_buff = link->get_send_buff(1000);
+        send_buff->set_packet_size(bp.packet_size);
+        link->release_send_buff(std::move(send_buff));
+        link->flush_send_buffs();
+        auto recv_buff = link->get_recv_buff(1000);
+        if (!recv_buff) {
+            echo.detach();
+            throw uhd::runtime_error("Timed out waiting for the echo");
+        }
+        link->release_recv_buff(std::move(recv_buff));
+    }
+    const std::chrono::duration<double> elapsed = clock_t::now() - start;
+    echo.join();
+    return elapsed.count() / bp.num_pings;
+}
+
+template <typename link_t>
+void run_benchmarks(const std::string& name,
+    const link_variant<link_t>& variant,
+    const benchmark_params& bp)
+{
+    std::cout << name << ":" << std::endl;
+    try {
+        const double send_rate = benchmark_send(variant, bp);
+        const double recv_rate = benchmark_recv(variant, bp);
+        const double rtt       = benchmark_ping_pong(variant, bp);
+        std::cout << std::fixed << std::setprecision(1)
+                  << "    send:      " << send_rate / 1e3 << " kpackets/s" << std::endl
+                  << "    recv:      " << recv_rate / 1e3 << " kpackets/s" << std::endl
+                  << "    ping-pong: " << rtt * 1e6 << " us" << std::endl;
+    } catch (const uhd::runtime_error& ex) {
+        std::cout << "    skipped: " << ex.what() << std::endl;
+    }
+}
+
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    benchmark_params bp;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("num-packets", po::value<size_t>(&bp.num_packets)->default_value(200000), "number of packets for the throughput tests")
+        ("packet-size", po::value<size_t>(&bp.packet_size)->default_value(1472), "packet size in bytes")
+        ("num-frames", po::value<size_t>(&bp.num_frames)->default_value(32), "number of send and receive frames of the links")
+        ("num-pings", po::value<size_t>(&bp.num_pings)->default_value(10000), "number of round trips for the latency test")
+    ;
+    // clang-format on
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << "UHD UDP link benchmark " << desc << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const std::string addr("127.0.0.1");
+    auto make_asio_link = [addr](const std::string& port,
+                              const link_params_t& params,
+                              size_t& recv_buff_size,
+                              size_t& send_buff_size) {
+        return udp_boost_asio_link::make(
+            addr, port, params, recv_buff_size, send_buff_size);
+    };
+    auto make_asio_gso_gro_link = [addr](const std::string& port,
+                                      const link_params_t& params,
+                                      size_t& recv_buff_size,
+                                      size_t& send_buff_size) {
+        return udp_boost_asio_link::make(
+            addr, port, params, recv_buff_size, send_buff_size, true, true);
+    };
+    run_benchmarks<udp_boost_asio_link>(
+        "udp_boost_asio_link", {make_asio_link, false}, bp);
+    run_benchmarks<udp_boost_asio_link>(
+        "udp_boost_asio_link (GSO/GRO)", {make_asio_gso_gro_link, true}, bp);
+#ifdef HAVE_IO_URING
+    auto make_io_uring_link = [addr](const std::string& port,
+                                  const link_params_t& params,
+                                  size_t& recv_buff_size,
+                                  size_t& send_buff_size) {
+        return udp_io_uring_link::make(
+            addr, port, params, recv_buff_size, send_buff_size);
+    };
+    run_benchmarks<udp_io_uring_link>(
+        "udp_io_uring_link", {make_io_uring_link, false}, bp);
+    auto make_io_uring_batch_link = [addr](const std::string& port,
+                                        const link_params_t& params,
+                                        size_t& recv_buff_size,
+                                        size_t& send_buff_size) {
+        return udp_io_uring_link::make(
+            addr, port, params, recv_buff_size, send_buff_size, true);
+    };
+    run_benchmarks<udp_io_uring_link>(
+        "udp_io_uring_link (batched sends)", {make_io_uring_batch_link, false}, bp);
+#endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/exception.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <uhdlib/rfnoc/chdr_capture_analyzer.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace po = boost::program_options;
+using namespace uhd::rfnoc;
+using namespace uhd::rfnoc::chdr;
+
+namespace {
+
+void print_running_stats(const std::string& name,
+    const running_stats_t& stats,
+    const double scale,
+    const std::string& unit)
+{
+    if (stats.count == 0) {
+        return;
+    }
+    std::cout << boost::format("    %-22s mean %.3f, stddev %.3f, min %.3f, max %.3f %s")
+                     % name % (stats.mean * scale) % (stats.get_stddev() * scale)
+                     % (stats.min * scale) % (stats.max * scale) % unit
+              << std::endl;
+}
+
+void print_throughput_histogram(
+    const stream_stats_t& stats, const double interval, const size_t num_bins)
+{
+    // The last interval is usually incomplete, so it's not included
+    if (stats.throughput_bytes.size() < 2 || num_bins == 0) {
+        return;
+    }
+    const auto first = stats.throughput_bytes.cbegin();
+    const auto last  = stats.throughput_bytes.cend() - 1;
+    const uint64_t max_bytes = std::max<uint64_t>(*std::max_element(first, last), 1);
+    std::vector<size_t> bins(num_bins, 0);
+    for (auto it = first; it != last; ++it) {
+        bins[std::min(num_bins - 1, size_t(*it * num_bins / max_bytes))]++;
+    }
+    const size_t max_count = *std::max_element(bins.begin(), bins.end());
+    const double max_rate  = max_bytes * 8 / interval / 1e6;
+    std::cout << boost::format("    Throughput histogram (%d intervals of %.3f ms):")
+                     % (last - first) % (interval * 1e3)
+              << std::endl;
+    for (size_t i = 0; i < num_bins; i++) {
+        std::cout << boost::format("    %9.1f - %9.1f Mbps | %-40s %d")
+                         % (max_rate * i / num_bins) % (max_rate * (i + 1) / num_bins)
+                         % std::string(bins[i] * 40 / max_count, '#') % bins[i]
+                  << std::endl;
+    }
+}
+
+void print_stream_stats(const stream_stats_t& stats,
+    const capture_analyzer_args_t& args,
+    const size_t num_hist_bins)
+{
+    std::cout << boost::format("EPID %d:") % stats.epid << std::endl;
+    std::cout << boost::format("    Packets: %d data, %d strs, %d strc, %d ctrl, %d mgmt"
+                               " (%d truncated in capture)")
+                     % stats.num_data_pkts % stats.num_strs_pkts % stats.num_strc_pkts
+                     % stats.num_ctrl_pkts % stats.num_mgmt_pkts
+                     % stats.num_truncated_pkts
+              << std::endl;
+    if (stats.num_data_pkts > 0) {
+        const double duration = stats.last_time - stats.first_time;
+        std::cout << boost::format("    Data: %d bytes (%d payload) in %.6f s")
+                         % stats.data_bytes % stats.payload_bytes % duration;
+        if (duration > 0) {
+            std::cout << boost::format(", %.3f Mbps")
+                             % (stats.data_bytes * 8 / duration / 1e6);
+        }
+        std::cout << std::endl;
+        std::cout << boost::format("    Sequence: %d gaps, %d lost packets, %d reordered")
+                         % stats.num_seq_gaps % stats.num_lost_pkts
+                         % stats.num_seq_reorders
+                  << std::endl;
+        if (args.bytes_per_item > 0) {
+            std::cout << boost::format("    Timestamp discontinuities: %d")
+                             % stats.num_ts_discontinuities
+                      << std::endl;
+        }
+        print_running_stats("Inter-arrival time:", stats.interarrival, 1e6, "us");
+        if (stats.ts_offset.count > 0) {
+            std::cout << boost::format("    Timestamp jitter:      %.3f us peak-to-peak,"
+                                       " %.3f us stddev")
+                             % ((stats.ts_offset.max - stats.ts_offset.min) * 1e6)
+                             % (stats.ts_offset.get_stddev() * 1e6)
+                      << std::endl;
+        }
+    }
+    if (!stats.fc_timeline.empty()) {
+        const auto min_credits = std::min_element(stats.fc_timeline.cbegin(),
+            stats.fc_timeline.cend(),
+            [](const fc_sample_t& lhs, const fc_sample_t& rhs) {
+                return lhs.credits_bytes < rhs.credits_bytes;
+            });
+        std::cout << boost::format("    Flow control: %d status packets, %d errors,"
+                                   " capacity %d bytes, minimum credits %d bytes"
+                                   " at %.6f s")
+                         % stats.fc_timeline.size() % stats.num_strs_errors
+                         % stats.fc_timeline.back().capacity_bytes
+                         % min_credits->credits_bytes % min_credits->time
+                  << std::endl;
+    }
+    print_throughput_histogram(stats, args.throughput_interval, num_hist_bins);
+}
+
+void write_fc_timeline(const std::string& prefix, const stream_stats_t& stats)
+{
+    const std::string filename = str(boost::format("%s_%d.csv") % prefix % stats.epid);
+    std::ofstream csv(filename);
+    if (!csv) {
+        throw uhd::runtime_error("Could not open " + filename);
+    }
+    csv << "time,capacity_bytes,xfer_count_bytes,sent_bytes,credits_bytes\n";
+    for (const auto& sample : stats.fc_timeline) {
+        csv << boost::format("%.9f,%d,%d,%d,%d\n") % sample.time % sample.capacity_bytes
+                   % sample.xfer_count_bytes % sample.sent_bytes % sample.credits_bytes;
+    }
+    std::cout << "Wrote flow control timeline to " << filename << std::endl;
+}
+
+} // namespace
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::string file, endianness, fc_csv;
+    uint16_t port;
+    size_t chdr_w, num_hist_bins;
+    capture_analyzer_args_t args;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("file", po::value<std::string>(&file), "pcap file with the captured CHDR traffic")
+        ("port", po::value<uint16_t>(&port)->default_value(49153), "UDP port of the CHDR traffic, or 0 for all ports")
+        ("chdr-w", po::value<size_t>(&chdr_w)->default_value(64), "CHDR width in bits (64, 128, 256 or 512)")
+        ("endianness", po::value<std::string>(&endianness)->default_value("big"), "byte order of the CHDR packets (big or little)")
+        ("threads", po::value<size_t>(&args.num_threads)->default_value(0), "number of worker threads, 0 for one per CPU")
+        ("item-size", po::value<size_t>(&args.bytes_per_item)->default_value(4), "bytes per sample for timestamp checks, 0 to disable them")
+        ("tick-rate", po::value<double>(&args.tick_rate)->default_value(0.0), "tick rate of the timestamps in Hz, enables the jitter measurement")
+        ("interval", po::value<double>(&args.throughput_interval)->default_value(1e-3), "length of the throughput histogram intervals in seconds")
+        ("hist-bins", po::value<size_t>(&num_hist_bins)->default_value(10), "number of bins of the throughput histogram")
+        ("fc-csv", po::value<std::string>(&fc_csv), "write the flow control timelines to <prefix>_<epid>.csv")
+    ;
+    // clang-format on
+    po::positional_options_description pos;
+    pos.add("file", 1);
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(),
+        vm);
+    po::notify(vm);
+
+    if (vm.count("help") || !vm.count("file")) {
+        std::cout << "CHDR capture analyzer " << desc << std::endl;
+        std::cout << "Prints per-stream statistics of the CHDR traffic in a pcap file."
+                  << std::endl;
+        return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    switch (chdr_w) {
+        case 64:
+            args.chdr_w = CHDR_W_64;
+            break;
+        case 128:
+            args.chdr_w = CHDR_W_128;
+            break;
+        case 256:
+            args.chdr_w = CHDR_W_256;
+            break;
+        case 512:
+            args.chdr_w = CHDR_W_512;
+            break;
+        default:
+            throw uhd::value_error("Invalid CHDR width: " + std::to_string(chdr_w));
+    }
+    if (endianness != "big" && endianness != "little") {
+        throw uhd::value_error("Invalid endianness: " + endianness);
+    }
+    args.endianness = (endianness == "big") ? uhd::ENDIANNESS_BIG
+                                            : uhd::ENDIANNESS_LITTLE;
+
+    const auto start = std::chrono::steady_clock::now();
+    pcap_file capture(file);
+    const auto records = capture.get_udp_records(port);
+    const auto stats   = analyze_capture(records, args);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << boost::format("Analyzed %d CHDR packets (of %d frames) in %.3f s")
+                     % records.size() % capture.get_num_records() % elapsed.count()
+              << std::endl
+              << std::endl;
+    for (const auto& stream : stats) {
+        print_stream_stats(stream, args, num_hist_bins);
+        if (!fc_csv.empty() && !stream.fc_timeline.empty()) {
+            write_fc_timeline(fc_csv, stream);
+        }
+        std::cout << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
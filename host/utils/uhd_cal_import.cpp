@@ -0,0 +1,85 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <uhd/usrp/fe_cal_table.hpp>
+#include <uhd/utils/paths.hpp>
+#include <uhd/utils/safe_main.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+int UHD_SAFE_MAIN(int argc, char* argv[])
+{
+    std::vector<std::string> files;
+
+    // clang-format off
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "help message")
+        ("file", po::value<std::vector<std::string>>(&files), "CSV calibration files to convert (default: all files in the calibration directory)")
+        ("force", "overwrite existing binary calibration files")
+    ;
+    // clang-format on
+    po::positional_options_description pos;
+    pos.add("file", -1);
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(),
+        vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << boost::format("UHD Calibration Import %s") % desc << std::endl;
+        std::cout << "Converts frontend calibration files from the CSV format to the "
+                     "binary format."
+                  << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const fs::path cal_dir = fs::path(uhd::get_app_path()) / ".uhd" / "cal";
+    if (files.empty() and fs::is_directory(cal_dir)) {
+        for (const auto& entry : fs::directory_iterator(cal_dir)) {
+            const std::string filename = entry.path().filename().string();
+            if (boost::algorithm::contains(filename, "_cal_v0.2_")
+                and boost::algorithm::ends_with(filename, ".csv")) {
+                files.push_back(entry.path().string());
+            }
+        }
+    }
+    if (files.empty()) {
+        std::cout << "No calibration files found in " << cal_dir << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const bool force = vm.count("force") > 0;
+    int result       = EXIT_SUCCESS;
+    for (const std::string& file : files) {
+        const fs::path bin_path = fs::path(file).replace_extension(".bin");
+        if (fs::exists(bin_path) and not force) {
+            std::cout << "Skipping " << file << ": " << bin_path
+                      << " exists (use --force to overwrite)" << std::endl;
+            continue;
+        }
+        try {
+            const auto table = uhd::usrp::fe_cal_table::load(file);
+            table->save(bin_path.string());
+            std::cout << boost::format("Converted %s (serial %s, %d points) to %s")
+                             % file % table->get_serial() % table->get_points().size()
+                             % bin_path.string()
+                      << std::endl;
+        } catch (const std::exception& ex) {
+            std::cerr << "Error converting " << file << ": " << ex.what() << std::endl;
+            result = EXIT_FAILURE;
+        }
+    }
+    return result;
+}
@@ -7,6 +7,7 @@
 
 #include <uhd/property_tree.hpp>
 #include <uhd/usrp/dboard_eeprom.hpp>
+#include <uhd/usrp/fe_cal_table.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 #include <uhd/utils/algorithm.hpp>
 #include <uhd/utils/paths.hpp>
@@ -194,17 +195,24 @@ static void store_results(const std::vector<result_t>& results,
     fs::create_directory(cal_data_path);
     cal_data_path = cal_data_path / "cal";
     fs::create_directory(cal_data_path);
-    cal_data_path =
-        cal_data_path / str(boost::format("%s_%s_cal_v0.2_%s.csv") % xx % what % serial);
-    if (fs::exists(cal_data_path))
-        fs::rename(cal_data_path,
-            cal_data_path.string() + str(boost::format(".%d") % time(NULL)));
+    const fs::path cal_data_base =
+        cal_data_path / str(boost::format("%s_%s_cal_v0.2_%s") % xx % what % serial);
+    const time_t timestamp = time(NULL);
+    for (const std::string ext : {".bin", ".csv"}) {
+        const fs::path old_path = cal_data_base.string() + ext;
+        if (fs::exists(old_path))
+            fs::rename(
+                old_path, old_path.string() + str(boost::format(".%d") % timestamp));
+    }
 
-    // fill the calibration file
+    // write a CSV file, which includes the measurements, for reference and for
+    // older versions of UHD
+    cal_data_path = cal_data_base.string() + ".csv";
     std::ofstream cal_data(cal_data_path.string().c_str());
+    cal_data.precision(10);
     cal_data << boost::format("name, %s Frontend Calibration\n") % XX;
     cal_data << boost::format("serial, %s\n") % serial;
-    cal_data << boost::format("timestamp, %d\n") % time(NULL);
+    cal_data << boost::format("timestamp, %d\n") % timestamp;
     cal_data << boost::format("version, 0, 1\n");
     cal_data << boost::format("DATA STARTS HERE\n");
     cal_data << "lo_frequency, correction_real, correction_imag, measured, delta\n";
@@ -214,7 +222,19 @@ static void store_results(const std::vector<result_t>& results,
                  << results[i].imag_corr << ", " << results[i].best << ", "
                  << results[i].delta << "\n";
     }
+    cal_data.close();
+
+    std::cout << "wrote cal data to " << cal_data_path << std::endl;
 
+    // then write the binary calibration file, which is what UHD loads. It is
+    // written last, as UHD ignores it if it is older than the CSV file.
+    std::vector<uhd::usrp::fe_cal_table::point_t> points;
+    for (const result_t& result : results) {
+        points.push_back({result.freq, result.real_corr, result.imag_corr});
+    }
+    cal_data_path = cal_data_base.string() + ".bin";
+    uhd::usrp::fe_cal_table::make(points, serial, timestamp)
+        ->save(cal_data_path.string());
     std::cout << "wrote cal data to " << cal_data_path << std::endl;
 }
 
@@ -8,6 +8,7 @@
 
 #include <mpm/types/regs_iface.hpp>
 #include <boost/noncopyable.hpp>
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -36,6 +37,23 @@ public:
      */
     virtual uint32_t transfer24_16(const uint32_t data) = 0;
 
+    /*! Write a sequence of 24-bit words, and discard the read data
+     *
+     * Every word is a separate SPI transaction, i.e., chip select is
+     * deasserted between words, exactly as if transfer24_8() was called for
+     * every word. Implementations may coalesce the words into fewer system
+     * calls; the default implementation does not.
+     *
+     * \param data The write data, one word per xfer
+     * \param count The number of words
+     */
+    virtual void write24_batch(const uint32_t* data, const size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            transfer24_8(data[i]);
+        }
+    }
+
     /*!
      * \param device The path to the spidev used (e.g. "/dev/spidev0.0")
      * \param speed_hz Transaction speed in Hz
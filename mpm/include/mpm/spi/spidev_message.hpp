@@ -0,0 +1,47 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#pragma once
+
+#include <linux/spi/spidev.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace mpm { namespace spi {
+
+//! Maximum number of xfers per SPI_IOC_MESSAGE() ioctl
+//
+// The ioctl number can encode at most 511 xfers, and spidev limits the total
+// length of a message to its bufsiz module parameter (4096 bytes by default).
+constexpr size_t SPIDEV_MAX_MESSAGE_XFERS = 256;
+
+//! Sends one spidev message, i.e., calls ioctl(fd, SPI_IOC_MESSAGE(num_xfers), xfers)
+using spidev_send_message_t =
+    std::function<void(struct spi_ioc_transfer* xfers, const size_t num_xfers)>;
+
+/*! Split 24-bit writes into spidev messages
+ *
+ * Every word becomes one write-only xfer, and up to SPIDEV_MAX_MESSAGE_XFERS
+ * xfers are passed to \p send_message at a time. Chip select toggles between
+ * the words of a message, so every word is its own transaction, just like
+ * with individual transfers.
+ *
+ * \param data The write data, one word per xfer
+ * \param count The number of words
+ * \param speed_hz The speed of every xfer
+ * \param bits_per_word The word size of every xfer
+ * \param delay_usecs The delay after every xfer
+ * \param send_message Called once per message
+ */
+void spidev_write24_batch(const uint32_t* data,
+    const size_t count,
+    const uint32_t speed_hz,
+    const uint8_t bits_per_word,
+    const uint16_t delay_usecs,
+    const spidev_send_message_t& send_message);
+
+}}; // namespace mpm::spi
@@ -5,41 +5,85 @@
 //
 #pragma once
 
-#include <unordered_map>
+#include <mpm/spi/spi_iface.hpp>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace mpm {
-class tests_spi_iface : public virtual spi_iface
+
+/*! Mock SPI interface, which emulates a register file
+ *
+ * Every 24-bit word is decoded like a regs_iface created by
+ * mpm::spi::make_spi_regs_iface() with the same shift and flag arguments
+ * would encode it: Words with the read flags set read an 8-bit register, all
+ * other words write one. All words are also recorded, so tests can check that
+ * batched writes produce the same transactions as individual writes. Batched
+ * writes are split into messages by the same code as the spidev
+ * implementation.
+ */
+class tests_spi_iface : public virtual mpm::spi::spi_iface
 {
 public:
-    /**************************************************************************
-     * spi_iface API calls
-     *************************************************************************/
-
     typedef std::shared_ptr<tests_spi_iface> sptr;
-    static sptr make()
+
+    //! A recorded word, and whether chip select was toggled after it within
+    // its message (individual transfers never set it)
+    struct transfer_t
+    {
+        uint32_t data;
+        bool cs_change;
+    };
+
+    static sptr make(const uint32_t addr_shift = 8,
+        const uint32_t data_shift              = 0,
+        const uint32_t read_flags              = 1 << 23)
     {
-        return std::make_shared<tests_spi_iface>();
+        return std::make_shared<tests_spi_iface>(addr_shift, data_shift, read_flags);
     };
 
-    void write_byte(const uint16_t addr, const uint8_t data);
+    tests_spi_iface(
+        const uint32_t addr_shift, const uint32_t data_shift, const uint32_t read_flags);
 
-    void write_bytes(const uint16_t* addr, const uint8_t* data, const uint32_t count);
+    /**************************************************************************
+     * spi_iface API calls
+     *************************************************************************/
+    uint32_t transfer24_8(const uint32_t data);
 
-    uint8_t read_byte(const uint16_t addr);
+    uint32_t transfer24_16(const uint32_t data);
 
-    void write_field(const uint16_t addr,
-        const uint8_t field_val,
-        const uint8_t mask,
-        const uint8_t start_bit);
+    void write24_batch(const uint32_t* data, const size_t count);
 
-    uint8_t read_field(const uint16_t addr, const uint8_t mask, const uint8_t start_bit);
-    spi_wire_mode_t get_wire_mode() const;
-    spi_endianness_t get_endianness() const;
-    size_t get_chip_select() const;
+    /**************************************************************************
+     * Mock API
+     *************************************************************************/
+    //! Return the value of a register, or the default value if it was never written
+    uint8_t get_reg(const uint16_t addr) const;
+
+    //! Return all words transferred so far, in order
+    const std::vector<transfer_t>& get_transfers() const
+    {
+        return _transfers;
+    }
+
+    //! Return the number of xfers of every message sent so far, in order. An
+    // individual transfer is a message with one xfer.
+    const std::vector<size_t>& get_message_sizes() const
+    {
+        return _message_sizes;
+    }
 
 private:
+    //! Decode a word as a register access
+    uint32_t _access_reg(const uint32_t data);
+
+    const uint32_t _addr_shift;
+    const uint32_t _data_shift;
+    const uint32_t _read_flags;
     std::unordered_map<uint16_t, uint8_t> _regs;
     uint8_t _default_val = 0;
+    std::vector<transfer_t> _transfers;
+    std::vector<size_t> _message_sizes;
 };
+
 } // namespace mpm
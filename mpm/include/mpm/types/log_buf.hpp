@@ -6,12 +6,14 @@
 
 #pragma once
 
-#include <boost/circular_buffer.hpp>
 #include <boost/noncopyable.hpp>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <tuple>
+#include <vector>
 
 namespace mpm { namespace types {
 
@@ -32,6 +34,11 @@ struct log_message
     std::string component;
     std::string message;
 
+    log_message() : log_level(log_level_t::NONE)
+    {
+        // nop
+    }
+
     log_message(const log_level_t log_level_,
         const std::string& component_,
         const std::string& message_)
@@ -41,14 +48,24 @@ struct log_message
     }
 };
 
+/*! Buffer for log messages from C++, to be picked up by the Python logger
+ *
+ * Any number of threads may post messages; posting is lock-free and never
+ * calls back into Python (unless a notify callback is set). Messages below the
+ * log level are discarded before they are copied. If the buffer is full, new
+ * messages are dropped and counted rather than overwriting the oldest ones.
+ *
+ * The consumer (mpmlog.py) drains the buffer in batches with pop_batch().
+ */
 class log_buf : public boost::noncopyable
 {
 public:
     using sptr = std::shared_ptr<log_buf>;
 
-    static const size_t BUFSIZE = 20;
+    //! Number of messages the buffer can hold (must be a power of two)
+    static const size_t BUFSIZE = 1024;
 
-    log_buf() : _buf(BUFSIZE) {}
+    log_buf();
     ~log_buf() {}
 
     static sptr make();
@@ -65,16 +82,59 @@ public:
         const std::string& component,
         const std::string& message);
 
+    //! Return true if a message with this log level would be kept by post().
+    //  Use this to skip formatting messages that would be dropped anyway.
+    bool is_enabled(const log_level_t log_level) const
+    {
+        const int min_level = _log_level.load(std::memory_order_relaxed);
+        return log_level != log_level_t::NONE && static_cast<int>(log_level) >= min_level;
+    }
+
+    //! Set the minimum log level of messages that get posted
+    void set_log_level(const log_level_t log_level);
+
     //! Use this to set a callback that gets called when a new message was
-    //  posted.
+    //  posted to an empty buffer. It is not called again until the buffer was
+    //  read with pop() or pop_batch(). The callback is called from the posting
+    //  thread, so it must be safe to call from any thread.
     void set_notify_callback(std::function<void(void)> callback);
 
+    //! Return the oldest message, or a message with log level NONE if the
+    //  buffer is empty
     std::tuple<log_level_t, std::string, std::string> pop();
 
+    //! Return up to \p max_messages of the oldest messages
+    std::vector<log_message> pop_batch(const size_t max_messages);
+
+    //! Return the number of messages dropped because the buffer was full
+    size_t get_num_dropped() const
+    {
+        return _num_dropped.load(std::memory_order_relaxed);
+    }
+
 private:
-    std::mutex _buf_lock;
-    boost::circular_buffer<log_message> _buf;
+    //! Move the oldest message into msg. _read_lock must be held.
+    bool _pop(log_message& msg);
+
+    //! A slot of the ring buffer. The sequence number tells producers and the
+    //  consumer whose turn it is: it equals the write position if the slot is
+    //  free, and the write position + 1 once the message was written.
+    struct slot_t
+    {
+        std::atomic<size_t> seq;
+        log_message msg;
+    };
+
+    std::unique_ptr<slot_t[]> _slots;
+    std::atomic<size_t> _write_pos{0};
+    std::atomic<int> _log_level{static_cast<int>(log_level_t::TRACE)};
+    std::atomic<size_t> _num_dropped{0};
+    std::atomic<bool> _notify_pending{false};
     std::function<void(void)> _notify_callback;
+
+    //! Serializes the consumers, producers never take it
+    std::mutex _read_lock;
+    size_t _read_pos = 0;
 };
 
 }} /* namespace mpm::types */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <boost/noncopyable.hpp>
+#include <cstddef>
 #include <memory>
 
 namespace mpm { namespace types {
@@ -26,6 +27,20 @@ public:
      */
     virtual void poke8(const uint32_t addr, const uint8_t data) = 0;
 
+    /*! Write a sequence of 8-bit values to the given addresses
+     *
+     * This is equivalent to calling poke8() for every address/value pair, in
+     * order, but implementations may coalesce the writes into fewer bus
+     * transactions.
+     */
+    virtual void poke8_batch(
+        const uint32_t* addrs, const uint8_t* data, const size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            poke8(addrs[i], data[i]);
+        }
+    }
+
     /*! Return a 16-bit value from a given address
      */
     virtual uint16_t peek16(const uint32_t addr) = 0;
@@ -33,12 +33,28 @@ void export_types(py::module& top_module)
             +[](log_buf& self, py::object object) {
                 self.set_notify_callback(object);
             })
-        .def("pop", [](log_buf& self) {
-            auto log_msg = self.pop();
-            return py::make_tuple(static_cast<int>(std::get<0>(log_msg)),
-                std::get<1>(log_msg),
-                std::get<2>(log_msg));
-        });
+        .def("pop",
+            [](log_buf& self) {
+                auto log_msg = self.pop();
+                return py::make_tuple(static_cast<int>(std::get<0>(log_msg)),
+                    std::get<1>(log_msg),
+                    std::get<2>(log_msg));
+            })
+        .def("pop_batch",
+            [](log_buf& self, const size_t max_messages) {
+                py::list log_msgs;
+                for (const auto& log_msg : self.pop_batch(max_messages)) {
+                    log_msgs.append(py::make_tuple(static_cast<int>(log_msg.log_level),
+                        log_msg.component,
+                        log_msg.message));
+                }
+                return log_msgs;
+            })
+        .def("set_log_level",
+            [](log_buf& self, const int log_level) {
+                self.set_log_level(static_cast<log_level_t>(log_level));
+            })
+        .def("get_num_dropped", &log_buf::get_num_dropped);
 
     py::class_<mmap_regs_iface, std::shared_ptr<mmap_regs_iface>>(m, "mmap_regs_iface")
         .def(py::init<std::string, size_t, size_t, bool, bool>())
@@ -13,6 +13,7 @@
 #include <iostream>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 ad9371_spiSettings_t::ad9371_spiSettings_t(mpm::types::regs_iface* spi_iface_)
     : spi_iface(spi_iface_)
@@ -104,9 +105,10 @@ commonErr_t CMB_SPIWriteBytes(
 
     ad9371_spiSettings_t* spi = ad9371_spiSettings_t::make(spiSettings);
     try {
-        for (size_t i = 0; i < count; ++i) {
-            spi->spi_iface->poke8(addr[i], data[i]);
-        }
+        // This is used to load the ARM binary and the filter coefficients, so
+        // write all bytes in one batch rather than one transaction at a time
+        const std::vector<uint32_t> addrs(addr, addr + count);
+        spi->spi_iface->poke8_batch(addrs.data(), data, count);
         return COMMONERR_OK;
     } catch (const std::exception& e) {
         // TODO: spit out a reasonable error here (that will survive the C API transition)
@@ -257,13 +259,15 @@ commonErr_t CMB_writeToLog(
     } else {
         mpm_log_level = mpm::types::log_level_t::TRACE;
     }
-    // FIXME: This caused segfault with the async pattern call to c++ from boost python
-    // mpm::types::log_buf::make_singleton()->post(
-    //     mpm_log_level,
-    //     "AD937X",
-    //     str(boost::format("[Device ID %d] [Error code: %d] %s")
-    //         % int(deviceIndex) % errorCode % comment)
-    // );
+    // Posting doesn't call into Python, so this is safe from any thread. Most
+    // messages are trace messages, so don't format them unless they're kept.
+    auto log_buf = mpm::types::log_buf::make_singleton();
+    if (log_buf->is_enabled(mpm_log_level)) {
+        log_buf->post(mpm_log_level,
+            "AD937X",
+            str(boost::format("[Device ID %d] [Error code: %d] %s") % int(deviceIndex)
+                % errorCode % comment));
+    }
 
     return COMMONERR_OK;
 }
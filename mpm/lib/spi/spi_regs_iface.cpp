@@ -8,6 +8,7 @@
 #include <mpm/spi/spi_iface.hpp>
 #include <mpm/spi/spi_regs_iface.hpp>
 #include <mpm/types/regs_iface.hpp>
+#include <vector>
 
 using mpm::types::regs_iface;
 
@@ -52,6 +53,17 @@ public:
         _spi_iface->transfer24_8(transaction);
     }
 
+    void poke8_batch(const uint32_t* addrs, const uint8_t* data, const size_t count)
+    {
+        std::vector<uint32_t> transactions(count);
+        for (size_t i = 0; i < count; i++) {
+            transactions[i] = 0 | _write_flags | (addrs[i] << _addr_shift)
+                              | (data[i] << _data_shift);
+        }
+
+        _spi_iface->write24_batch(transactions.data(), count);
+    }
+
     uint16_t peek16(const uint32_t addr)
     {
         uint32_t transaction = 0 | (addr << _addr_shift) | _read_flags;
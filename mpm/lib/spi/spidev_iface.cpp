@@ -7,16 +7,60 @@
 
 #include <mpm/exception.hpp>
 #include <mpm/spi/spi_iface.hpp>
+#include <mpm/spi/spidev_message.hpp>
 extern "C" {
 #include "spidev.h"
 }
 #include <fcntl.h>
 #include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
 #include <boost/format.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 using namespace mpm::spi;
 
+/******************************************************************************
+ * Message helpers
+ *****************************************************************************/
+void mpm::spi::spidev_write24_batch(const uint32_t* data,
+    const size_t count,
+    const uint32_t speed_hz,
+    const uint8_t bits_per_word,
+    const uint16_t delay_usecs,
+    const spidev_send_message_t& send_message)
+{
+    uint8_t tx[SPIDEV_MAX_MESSAGE_XFERS * 3];
+    struct spi_ioc_transfer xfers[SPIDEV_MAX_MESSAGE_XFERS];
+    for (size_t offset = 0; offset < count; offset += SPIDEV_MAX_MESSAGE_XFERS) {
+        const size_t num_xfers = std::min(count - offset, SPIDEV_MAX_MESSAGE_XFERS);
+        std::memset(xfers, 0, sizeof(struct spi_ioc_transfer) * num_xfers);
+        for (size_t i = 0; i < num_xfers; i++) {
+            const uint32_t word = data[offset + i];
+            uint8_t* tx_word    = &tx[3 * i];
+            tx_word[0]          = uint8_t(word >> 16);
+            tx_word[1]          = uint8_t(word >> 8);
+            tx_word[2]          = uint8_t(word);
+
+            xfers[i].tx_buf        = (unsigned long)tx_word;
+            xfers[i].rx_buf        = 0; // Write only
+            xfers[i].len           = 3;
+            xfers[i].speed_hz      = speed_hz;
+            xfers[i].delay_usecs   = delay_usecs;
+            xfers[i].bits_per_word = bits_per_word;
+            xfers[i].tx_nbits      = 1; // Standard SPI
+            xfers[i].rx_nbits      = 1; // Standard SPI
+            // Toggle chip select between words, so every word is its own
+            // transaction. On the last xfer, this would keep chip select
+            // asserted after the message, so it must not be set there.
+            xfers[i].cs_change = (i + 1 < num_xfers) ? 1 : 0;
+        }
+        send_message(xfers, num_xfers);
+    }
+}
+
 /******************************************************************************
  * Implementation
  *****************************************************************************/
@@ -79,6 +123,22 @@ public:
         return uint32_t(rx[1] << 8 | rx[2]);
     }
 
+    void write24_batch(const uint32_t* data, const size_t count)
+    {
+        spidev_write24_batch(data,
+            count,
+            _speed,
+            _bits,
+            _delay,
+            [this](struct spi_ioc_transfer* xfers, const size_t num_xfers) {
+                if (ioctl(_fd, SPI_IOC_MESSAGE(num_xfers), xfers) < 0) {
+                    throw mpm::runtime_error(
+                        str(boost::format("SPI Transaction failed! (%d words)")
+                            % num_xfers));
+                }
+            });
+    }
+
 private:
     int _fd;
     const uint32_t _mode;
@@ -8,34 +8,105 @@
 
 using namespace mpm::types;
 
+static_assert((log_buf::BUFSIZE & (log_buf::BUFSIZE - 1)) == 0,
+    "log_buf::BUFSIZE must be a power of two");
+
+log_buf::log_buf() : _slots(new slot_t[BUFSIZE])
+{
+    for (size_t i = 0; i < BUFSIZE; i++) {
+        _slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
 void log_buf::post(
     const log_level_t log_level, const std::string& component, const std::string& message)
 {
-    {
-        std::lock_guard<std::mutex> l(_buf_lock);
-        _buf.push_back(log_message(log_level, component, message));
+    if (!is_enabled(log_level)) {
+        return;
     }
 
-    if (bool(_notify_callback)) {
+    // Claim a slot (bounded MPMC queue as described by D. Vyukov, with a single
+    // consumer). Producers only contend on _write_pos.
+    size_t pos   = _write_pos.load(std::memory_order_relaxed);
+    slot_t* slot = nullptr;
+    while (true) {
+        slot             = &_slots[pos & (BUFSIZE - 1)];
+        const size_t seq = slot->seq.load(std::memory_order_acquire);
+        const auto diff  = static_cast<std::ptrdiff_t>(seq - pos);
+        if (diff == 0) {
+            if (_write_pos.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer hasn't caught up with the slot yet: buffer is full
+            _num_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = _write_pos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->msg.log_level = log_level;
+    slot->msg.component = component;
+    slot->msg.message   = message;
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (bool(_notify_callback)
+        && !_notify_pending.exchange(true, std::memory_order_acq_rel)) {
         _notify_callback();
     }
 }
 
+void log_buf::set_log_level(const log_level_t log_level)
+{
+    _log_level.store(static_cast<int>(log_level), std::memory_order_relaxed);
+}
+
 void log_buf::set_notify_callback(std::function<void(void)> callback)
 {
     _notify_callback = callback;
 }
 
+bool log_buf::_pop(log_message& msg)
+{
+    slot_t& slot     = _slots[_read_pos & (BUFSIZE - 1)];
+    const size_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != _read_pos + 1) {
+        // Empty, or the next message is still being written
+        return false;
+    }
+    msg.log_level = slot.msg.log_level;
+    msg.component.swap(slot.msg.component);
+    msg.message.swap(slot.msg.message);
+    slot.seq.store(_read_pos + BUFSIZE, std::memory_order_release);
+    _read_pos++;
+    return true;
+}
+
 std::tuple<log_level_t, std::string, std::string> log_buf::pop()
 {
-    std::lock_guard<std::mutex> l(_buf_lock);
-    if (_buf.empty()) {
+    std::lock_guard<std::mutex> l(_read_lock);
+    // Re-arm the notification before reading, so a message posted after the
+    // last read triggers another one
+    _notify_pending.store(false, std::memory_order_release);
+    log_message msg;
+    if (!_pop(msg)) {
         return std::make_tuple(log_level_t::NONE, "", "");
     }
+    return std::make_tuple(msg.log_level, msg.component, msg.message);
+}
 
-    auto last_msg = _buf.front();
-    _buf.pop_front();
-    return std::make_tuple(last_msg.log_level, last_msg.component, last_msg.message);
+std::vector<log_message> log_buf::pop_batch(const size_t max_messages)
+{
+    std::vector<log_message> msgs;
+    std::lock_guard<std::mutex> l(_read_lock);
+    _notify_pending.store(false, std::memory_order_release);
+    log_message msg;
+    while (msgs.size() < max_messages && _pop(msg)) {
+        msgs.push_back(std::move(msg));
+        msg = log_message();
+    }
+    return msgs;
 }
 
 log_buf::sptr log_buf::make()
@@ -8,8 +8,12 @@ MPM Logging
 """
 
 from __future__ import print_function
+import atexit
 import copy
 import logging
+import os
+import threading
+import time
 from logging import CRITICAL, ERROR, WARNING, INFO, DEBUG
 from logging import handlers
 import collections
@@ -27,6 +31,11 @@ RESET = str('\x1b[0m')
 # Additional log level
 TRACE = 1
 
+# Minimum time between two reads of the C++ log buffer, in seconds
+CPP_LOG_DRAIN_INTERVAL = 0.1
+# Maximum number of C++ log messages to read in one go
+CPP_LOG_DRAIN_BATCH_SIZE = 256
+
 class ColorStreamHandler(logging.StreamHandler):
     """
     StreamHandler that prints colored output
@@ -78,6 +87,7 @@ class MPMLogger(logging.getLoggerClass()):
             self.cpp_log_buf = lib.types.log_buf.make_singleton()
         except ImportError:
             pass
+        self._cpp_num_dropped = 0
         from usrp_mpm import prefs
         self.py_log_buf = collections.deque(
             maxlen=prefs.get_prefs().getint('mpm', 'log_buf_size')
@@ -87,11 +97,38 @@ class MPMLogger(logging.getLoggerClass()):
         """ Extends logging for super-high verbosity """
         self.log(TRACE, *args, **kwargs)
 
+    def drain_cpp_log_buf(self):
+        """
+        Forward the messages from the C++ log buffer to the 'lib' child logger.
+
+        Returns the number of messages that were forwarded.
+        """
+        lib_logger = self.getChild('lib')
+        # Keep the C++ side from posting messages we'd throw away anyway
+        self.cpp_log_buf.set_log_level(lib_logger.getEffectiveLevel())
+        num_msgs = 0
+        while True:
+            log_msgs = self.cpp_log_buf.pop_batch(CPP_LOG_DRAIN_BATCH_SIZE)
+            for log_level, component, message in log_msgs:
+                lib_logger.log(log_level, "[%s] %s", component, message.strip())
+            num_msgs += len(log_msgs)
+            if len(log_msgs) < CPP_LOG_DRAIN_BATCH_SIZE:
+                break
+        num_dropped = self.cpp_log_buf.get_num_dropped()
+        if num_dropped != self._cpp_num_dropped:
+            lib_logger.warning(
+                "C++ log buffer overflowed, dropped %d messages",
+                num_dropped - self._cpp_num_dropped)
+            self._cpp_num_dropped = num_dropped
+        return num_msgs
+
     def get_log_buf(self):
         """
         Return the contents of the logging queue, formatted as a list of
         dictionaries.
         """
+        if self.cpp_log_buf is not None:
+            self.drain_cpp_log_buf()
         records = []
         # Note: This loop does not guarantee that all log items will be
         # returned. The while loop is set up to be bounded, and to return as
@@ -110,6 +147,21 @@ class MPMLogger(logging.getLoggerClass()):
 
 
 LOGGER = None # Logger singleton
+
+def _start_cpp_log_drain():
+    """
+    Start a thread that periodically forwards the messages from the C++ log
+    buffer. Posting from C++ never calls into Python, so the messages are
+    handed over in batches, at most every CPP_LOG_DRAIN_INTERVAL seconds.
+    """
+    def drain_loop():
+        " Drain the C++ log buffer until the process exits "
+        while True:
+            LOGGER.drain_cpp_log_buf()
+            time.sleep(CPP_LOG_DRAIN_INTERVAL)
+    threading.Thread(
+        target=drain_loop, name='cpp_log_drain', daemon=True).start()
+
 def get_main_logger(
         use_console=True,
         use_journal=False,
@@ -152,14 +204,11 @@ def get_main_logger(
     LOGGER.setLevel(default_log_level)
     # Connect to C++ logging:
     if LOGGER.cpp_log_buf is not None:
-        lib_logger = LOGGER.getChild('lib')
-        def log_from_cpp():
-            " Callback for logging from C++ "
-            log_level, component, message = LOGGER.cpp_log_buf.pop()
-            if log_level:
-                lib_logger.log(log_level, "[%s] %s",
-                               component, message.strip())
-        LOGGER.cpp_log_buf.set_notify_callback(log_from_cpp)
+        _start_cpp_log_drain()
+        # Threads don't survive a fork, so the RPC process needs its own
+        if hasattr(os, 'register_at_fork'):
+            os.register_at_fork(after_in_child=_start_cpp_log_drain)
+        atexit.register(LOGGER.drain_cpp_log_buf)
     # Flush errors stuck in the prefs module:
     log = LOGGER.getChild('prefs')
     for err_key, err_msg in mpm_prefs.get_log_errors():
@@ -0,0 +1,108 @@
+//
+// Copyright 2020 Ettus Research, a National Instruments Brand
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+
+#include <mpm/spi/spi_regs_iface.hpp>
+#include <mpm/spi/spidev_message.hpp>
+#include <mpm/tests/tests_spi_iface.hpp>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+using mpm::tests_spi_iface;
+
+namespace {
+
+constexpr uint32_t ADDR_SHIFT = 8;
+constexpr uint32_t DATA_SHIFT = 0;
+constexpr uint32_t READ_FLAGS = 1 << 23;
+
+//! Write the same registers individually and as a batch, and check that both
+//  produce the same words and register contents. Returns the batch mock.
+tests_spi_iface::sptr check_batch(const size_t count)
+{
+    std::vector<uint32_t> addrs(count);
+    std::vector<uint8_t> data(count);
+    for (size_t i = 0; i < count; i++) {
+        addrs[i] = (i * 7) % 0x100;
+        data[i]  = uint8_t(i);
+    }
+
+    auto single_spi  = tests_spi_iface::make(ADDR_SHIFT, DATA_SHIFT, READ_FLAGS);
+    auto single_regs = mpm::spi::make_spi_regs_iface(
+        single_spi, ADDR_SHIFT, DATA_SHIFT, READ_FLAGS);
+    for (size_t i = 0; i < count; i++) {
+        single_regs->poke8(addrs[i], data[i]);
+    }
+
+    auto batch_spi  = tests_spi_iface::make(ADDR_SHIFT, DATA_SHIFT, READ_FLAGS);
+    auto batch_regs = mpm::spi::make_spi_regs_iface(
+        batch_spi, ADDR_SHIFT, DATA_SHIFT, READ_FLAGS);
+    batch_regs->poke8_batch(addrs.data(), data.data(), count);
+
+    const auto& single_xfers = single_spi->get_transfers();
+    const auto& batch_xfers  = batch_spi->get_transfers();
+    BOOST_REQUIRE_EQUAL(single_xfers.size(), count);
+    BOOST_REQUIRE_EQUAL(batch_xfers.size(), count);
+    for (size_t i = 0; i < count; i++) {
+        BOOST_CHECK_EQUAL(batch_xfers[i].data, single_xfers[i].data);
+        BOOST_CHECK(!single_xfers[i].cs_change);
+    }
+    for (uint32_t addr = 0; addr < 0x100; addr++) {
+        BOOST_CHECK_EQUAL(batch_spi->get_reg(addr), single_spi->get_reg(addr));
+    }
+    BOOST_CHECK_EQUAL(single_spi->get_message_sizes().size(), count);
+
+    // Chip select must toggle after every word of a message, but not stay
+    // asserted after its last word
+    size_t xfer_idx = 0;
+    for (const size_t message_size : batch_spi->get_message_sizes()) {
+        BOOST_REQUIRE_LE(message_size, mpm::spi::SPIDEV_MAX_MESSAGE_XFERS);
+        for (size_t i = 0; i < message_size; i++, xfer_idx++) {
+            BOOST_CHECK_EQUAL(batch_xfers[xfer_idx].cs_change, i + 1 < message_size);
+        }
+    }
+    BOOST_CHECK_EQUAL(xfer_idx, count);
+
+    return batch_spi;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(test_poke8_batch)
+{
+    auto spi = check_batch(5);
+    BOOST_CHECK(spi->get_message_sizes() == std::vector<size_t>({5}));
+}
+
+BOOST_AUTO_TEST_CASE(test_poke8_batch_chunked)
+{
+    constexpr size_t MAX_XFERS = mpm::spi::SPIDEV_MAX_MESSAGE_XFERS;
+    auto spi = check_batch(2 * MAX_XFERS + 10);
+    BOOST_CHECK(
+        spi->get_message_sizes() == std::vector<size_t>({MAX_XFERS, MAX_XFERS, 10}));
+
+    spi = check_batch(MAX_XFERS);
+    BOOST_CHECK(spi->get_message_sizes() == std::vector<size_t>({MAX_XFERS}));
+}
+
+BOOST_AUTO_TEST_CASE(test_poke8_batch_empty)
+{
+    auto spi = check_batch(0);
+    BOOST_CHECK(spi->get_message_sizes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_write24_batch)
+{
+    const std::vector<uint32_t> words = {0x000102, 0x000203, 0x800100};
+    auto spi = tests_spi_iface::make(ADDR_SHIFT, DATA_SHIFT, READ_FLAGS);
+    spi->write24_batch(words.data(), words.size());
+    const auto& xfers = spi->get_transfers();
+    BOOST_REQUIRE_EQUAL(xfers.size(), words.size());
+    for (size_t i = 0; i < words.size(); i++) {
+        BOOST_CHECK_EQUAL(xfers[i].data, words[i]);
+    }
+    BOOST_CHECK_EQUAL(spi->get_reg(0x01), 0x02);
+    BOOST_CHECK_EQUAL(spi->get_reg(0x02), 0x03);
+}
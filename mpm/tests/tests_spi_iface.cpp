@@ -4,61 +4,70 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 //
 
+#include <mpm/spi/spidev_message.hpp>
 #include <mpm/tests/tests_spi_iface.hpp>
 
-/**************************************************************************
- * spi_iface API calls
- *************************************************************************/
 namespace mpm {
 
-void tests_spi_iface::write_byte(const uint16_t addr, const uint8_t data)
+tests_spi_iface::tests_spi_iface(
+    const uint32_t addr_shift, const uint32_t data_shift, const uint32_t read_flags)
+    : _addr_shift(addr_shift), _data_shift(data_shift), _read_flags(read_flags)
 {
-    _regs[addr] = data;
+    /* nop */
 }
 
-void tests_spi_iface::write_bytes(
-    const uint16_t* addr, const uint8_t* data, const uint32_t count)
+/**************************************************************************
+ * spi_iface API calls
+ *************************************************************************/
+uint32_t tests_spi_iface::transfer24_8(const uint32_t data)
 {
-    for (size_t i = 0; i < count; i++) {
-        _regs[addr[i]] = data[i];
-    }
+    _transfers.push_back({data, false});
+    _message_sizes.push_back(1);
+    return _access_reg(data);
 }
 
-uint8_t tests_spi_iface::read_byte(const uint16_t addr)
+uint32_t tests_spi_iface::transfer24_16(const uint32_t data)
 {
-    if (_regs.count(addr)) {
-        return _regs.at(addr);
-    }
-    return _default_val;
+    return transfer24_8(data);
 }
 
-void tests_spi_iface::write_field(const uint16_t addr,
-    const uint8_t field_val,
-    const uint8_t mask,
-    const uint8_t start_bit)
+void tests_spi_iface::write24_batch(const uint32_t* data, const size_t count)
 {
-    const uint8_t old_value = read_byte(addr);
-    _regs[addr]             = (old_value & ~mask) | ((field_val << start_bit) & mask);
+    mpm::spi::spidev_write24_batch(data,
+        count,
+        0,
+        8,
+        0,
+        [this](struct spi_ioc_transfer* xfers, const size_t num_xfers) {
+            for (size_t i = 0; i < num_xfers; i++) {
+                const auto tx       = reinterpret_cast<const uint8_t*>(xfers[i].tx_buf);
+                const uint32_t word = (tx[0] << 16) | (tx[1] << 8) | tx[2];
+                _transfers.push_back({word, xfers[i].cs_change != 0});
+                _access_reg(word);
+            }
+            _message_sizes.push_back(num_xfers);
+        });
 }
 
-uint8_t tests_spi_iface::read_field(
-    const uint16_t addr, const uint8_t mask, const uint8_t start_bit)
-{
-    return (read_byte(addr) & mask) >> start_bit;
-}
-
-
-spi_iface::spi_wire_mode_t tests_spi_iface::get_wire_mode() const
+/**************************************************************************
+ * Mock API
+ *************************************************************************/
+uint8_t tests_spi_iface::get_reg(const uint16_t addr) const
 {
-    return spi_iface::spi_wire_mode_t::THREE_WIRE_MODE;
+    if (_regs.count(addr)) {
+        return _regs.at(addr);
+    }
+    return _default_val;
 }
 
-spi_iface::spi_endianness_t tests_spi_iface::get_endianness() const
-{
-    return spi_iface::spi_endianness_t::LSB_FIRST;
-}
-size_t tests_spi_iface::get_chip_select() const
+uint32_t tests_spi_iface::_access_reg(const uint32_t data)
 {
+    const uint16_t addr = uint16_t((data & ~_read_flags & 0xFFFFFF) >> _addr_shift);
+    if (data & _read_flags) {
+        return get_reg(addr);
+    }
+    _regs[addr] = uint8_t(data >> _data_shift);
     return 0;
 }
+
 } // namespace mpm